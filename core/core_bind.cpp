@@ -47,8 +47,8 @@ namespace core_bind {
 
 ResourceLoader *ResourceLoader::singleton = nullptr;
 
-Error ResourceLoader::load_threaded_request(const String &p_path, const String &p_type_hint, bool p_use_sub_threads) {
-	return ::ResourceLoader::load_threaded_request(p_path, p_type_hint, p_use_sub_threads);
+Error ResourceLoader::load_threaded_request(const String &p_path, const String &p_type_hint, bool p_use_sub_threads, LoadPriority p_priority) {
+	return ::ResourceLoader::load_threaded_request(p_path, p_type_hint, p_use_sub_threads, ResourceFormatLoader::CACHE_MODE_REUSE, String(), ::ResourceLoader::LoadPriority(p_priority));
 }
 
 ResourceLoader::ThreadLoadStatus ResourceLoader::load_threaded_get_status(const String &p_path, Array r_progress) {
@@ -59,12 +59,30 @@ ResourceLoader::ThreadLoadStatus ResourceLoader::load_threaded_get_status(const
 	return (ThreadLoadStatus)tls;
 }
 
+Dictionary ResourceLoader::load_threaded_get_stats(const String &p_path) {
+	::ResourceLoader::ThreadLoadStats stats;
+	Dictionary ret;
+	if (!::ResourceLoader::load_threaded_get_stats(p_path, &stats)) {
+		return ret;
+	}
+
+	ret["priority"] = stats.priority;
+	ret["progress"] = stats.progress;
+	ret["queued_usec"] = stats.queued_usec;
+	ret["loading_usec"] = stats.loading_usec;
+	return ret;
+}
+
 RES ResourceLoader::load_threaded_get(const String &p_path) {
 	Error error;
 	RES res = ::ResourceLoader::load_threaded_get(p_path, &error);
 	return res;
 }
 
+bool ResourceLoader::load_threaded_cancel(const String &p_path) {
+	return ::ResourceLoader::load_threaded_cancel(p_path);
+}
+
 RES ResourceLoader::load(const String &p_path, const String &p_type_hint, CacheMode p_cache_mode) {
 	Error err = OK;
 	RES ret = ::ResourceLoader::load(p_path, p_type_hint, ResourceFormatLoader::CacheMode(p_cache_mode), &err);
@@ -113,10 +131,23 @@ ResourceUID::ID ResourceLoader::get_resource_uid(const String &p_path) {
 	return ::ResourceLoader::get_resource_uid(p_path);
 }
 
+Dictionary ResourceLoader::get_deduplication_stats() {
+	uint64_t count = 0;
+	uint64_t bytes = 0;
+	ResourceCache::get_deduplication_stats(&count, &bytes);
+
+	Dictionary ret;
+	ret["resources"] = count;
+	ret["bytes_saved"] = bytes;
+	return ret;
+}
+
 void ResourceLoader::_bind_methods() {
-	ClassDB::bind_method(D_METHOD("load_threaded_request", "path", "type_hint", "use_sub_threads"), &ResourceLoader::load_threaded_request, DEFVAL(""), DEFVAL(false));
+	ClassDB::bind_method(D_METHOD("load_threaded_request", "path", "type_hint", "use_sub_threads", "priority"), &ResourceLoader::load_threaded_request, DEFVAL(""), DEFVAL(false), DEFVAL(LOAD_PRIORITY_VISIBLE));
 	ClassDB::bind_method(D_METHOD("load_threaded_get_status", "path", "progress"), &ResourceLoader::load_threaded_get_status, DEFVAL(Array()));
+	ClassDB::bind_method(D_METHOD("load_threaded_get_stats", "path"), &ResourceLoader::load_threaded_get_stats);
 	ClassDB::bind_method(D_METHOD("load_threaded_get", "path"), &ResourceLoader::load_threaded_get);
+	ClassDB::bind_method(D_METHOD("load_threaded_cancel", "path"), &ResourceLoader::load_threaded_cancel);
 
 	ClassDB::bind_method(D_METHOD("load", "path", "type_hint", "cache_mode"), &ResourceLoader::load, DEFVAL(""), DEFVAL(CACHE_MODE_REUSE));
 	ClassDB::bind_method(D_METHOD("get_recognized_extensions_for_type", "type"), &ResourceLoader::get_recognized_extensions_for_type);
@@ -125,6 +156,7 @@ void ResourceLoader::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("has_cached", "path"), &ResourceLoader::has_cached);
 	ClassDB::bind_method(D_METHOD("exists", "path", "type_hint"), &ResourceLoader::exists, DEFVAL(""));
 	ClassDB::bind_method(D_METHOD("get_resource_uid", "path"), &ResourceLoader::get_resource_uid);
+	ClassDB::bind_method(D_METHOD("get_deduplication_stats"), &ResourceLoader::get_deduplication_stats);
 
 	BIND_ENUM_CONSTANT(THREAD_LOAD_INVALID_RESOURCE);
 	BIND_ENUM_CONSTANT(THREAD_LOAD_IN_PROGRESS);
@@ -134,6 +166,10 @@ void ResourceLoader::_bind_methods() {
 	BIND_ENUM_CONSTANT(CACHE_MODE_IGNORE);
 	BIND_ENUM_CONSTANT(CACHE_MODE_REUSE);
 	BIND_ENUM_CONSTANT(CACHE_MODE_REPLACE);
+
+	BIND_ENUM_CONSTANT(LOAD_PRIORITY_CRITICAL);
+	BIND_ENUM_CONSTANT(LOAD_PRIORITY_VISIBLE);
+	BIND_ENUM_CONSTANT(LOAD_PRIORITY_PREFETCH);
 }
 
 ////// ResourceSaver //////
@@ -167,6 +203,7 @@ void ResourceSaver::_bind_methods() {
 	BIND_ENUM_CONSTANT(FLAG_SAVE_BIG_ENDIAN);
 	BIND_ENUM_CONSTANT(FLAG_COMPRESS);
 	BIND_ENUM_CONSTANT(FLAG_REPLACE_SUBRESOURCE_PATHS);
+	BIND_ENUM_CONSTANT(FLAG_COMPRESS_PACKED_ARRAYS);
 }
 
 ////// OS //////
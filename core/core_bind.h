@@ -67,11 +67,19 @@ public:
 		CACHE_MODE_REPLACE, // Resource and subresource use path cache, but replace existing loaded resources when available with information from disk.
 	};
 
+	enum LoadPriority {
+		LOAD_PRIORITY_CRITICAL,
+		LOAD_PRIORITY_VISIBLE,
+		LOAD_PRIORITY_PREFETCH,
+	};
+
 	static ResourceLoader *get_singleton() { return singleton; }
 
-	Error load_threaded_request(const String &p_path, const String &p_type_hint = "", bool p_use_sub_threads = false);
+	Error load_threaded_request(const String &p_path, const String &p_type_hint = "", bool p_use_sub_threads = false, LoadPriority p_priority = LOAD_PRIORITY_VISIBLE);
 	ThreadLoadStatus load_threaded_get_status(const String &p_path, Array r_progress = Array());
+	Dictionary load_threaded_get_stats(const String &p_path);
 	RES load_threaded_get(const String &p_path);
+	bool load_threaded_cancel(const String &p_path);
 
 	RES load(const String &p_path, const String &p_type_hint = "", CacheMode p_cache_mode = CACHE_MODE_REUSE);
 	Vector<String> get_recognized_extensions_for_type(const String &p_type);
@@ -80,6 +88,7 @@ public:
 	bool has_cached(const String &p_path);
 	bool exists(const String &p_path, const String &p_type_hint = "");
 	ResourceUID::ID get_resource_uid(const String &p_path);
+	Dictionary get_deduplication_stats();
 
 	ResourceLoader() { singleton = this; }
 };
@@ -100,6 +109,7 @@ public:
 		FLAG_SAVE_BIG_ENDIAN = 16,
 		FLAG_COMPRESS = 32,
 		FLAG_REPLACE_SUBRESOURCE_PATHS = 64,
+		FLAG_COMPRESS_PACKED_ARRAYS = 128,
 	};
 
 	static ResourceSaver *get_singleton() { return singleton; }
@@ -718,6 +728,7 @@ public:
 
 VARIANT_ENUM_CAST(core_bind::ResourceLoader::ThreadLoadStatus);
 VARIANT_ENUM_CAST(core_bind::ResourceLoader::CacheMode);
+VARIANT_ENUM_CAST(core_bind::ResourceLoader::LoadPriority);
 
 VARIANT_ENUM_CAST(core_bind::ResourceSaver::SaverFlags);
 
@@ -379,6 +379,25 @@ uint64_t FileAccess::get_buffer(uint8_t *p_dst, uint64_t p_length) const {
 	return i;
 }
 
+Error FileAccess::read_async(const ReadRequest *p_requests, int p_count) {
+	ERR_FAIL_COND_V(!p_requests && p_count > 0, ERR_INVALID_PARAMETER);
+
+	uint64_t prev_pos = get_position();
+
+	for (int i = 0; i < p_count; i++) {
+		const ReadRequest &request = p_requests[i];
+		seek(request.offset);
+		uint64_t read = get_buffer(request.dst, request.length);
+		if (request.callback) {
+			request.callback(request.userdata, read == request.length ? OK : ERR_FILE_EOF, read);
+		}
+	}
+
+	seek(prev_pos);
+
+	return OK;
+}
+
 String FileAccess::get_as_utf8_string() const {
 	Vector<uint8_t> sourcef;
 	uint64_t len = get_length();
@@ -51,6 +51,16 @@ public:
 
 	typedef void (*FileCloseFailNotify)(const String &);
 
+	typedef void (*ReadCallback)(void *p_userdata, Error p_error, uint64_t p_read);
+
+	struct ReadRequest {
+		uint64_t offset = 0;
+		uint64_t length = 0;
+		uint8_t *dst = nullptr;
+		ReadCallback callback = nullptr; // Called when done, possibly from another thread.
+		void *userdata = nullptr;
+	};
+
 	typedef FileAccess *(*CreateFunc)();
 	bool big_endian = false;
 	bool real_is_double = false;
@@ -110,6 +120,7 @@ public:
 	virtual real_t get_real() const;
 
 	virtual uint64_t get_buffer(uint8_t *p_dst, uint64_t p_length) const; ///< get an array of bytes
+	virtual const uint8_t *get_buffer_view(uint64_t p_length) const { return nullptr; } ///< get a read-only view of the next bytes without copying and advance, null if not supported or not enough data left
 	virtual String get_line() const;
 	virtual String get_token() const;
 	virtual Vector<String> get_csv_line(const String &p_delim = ",") const;
@@ -125,6 +136,13 @@ public:
 
 	virtual Error get_error() const = 0; ///< get last error
 
+	virtual const uint8_t *map_region(uint64_t p_offset, uint64_t p_length) { return nullptr; } ///< map a read-only region of the file in memory, null if not supported. Stays valid until unmapped, even after closing.
+	virtual void unmap_region(const uint8_t *p_region, uint64_t p_length) {} ///< release a region returned by map_region
+
+	virtual Error read_async(const ReadRequest *p_requests, int p_count); ///< read regions without changing the position, completes immediately if not supported
+	virtual void wait_async() {} ///< wait until all the reads started with read_async have completed
+	virtual void read_ahead(uint64_t p_offset, uint64_t p_length) {} ///< hint that a region will be read soon, so it can be fetched in the background
+
 	virtual void flush() = 0;
 	virtual void store_8(uint8_t p_dest) = 0; ///< store a byte
 	virtual void store_16(uint16_t p_dest); ///< store 16 bits uint
@@ -30,8 +30,106 @@
 
 #include "file_access_compressed.h"
 
+#include "core/os/os.h"
 #include "core/string/print_string.h"
 
+ThreadWorkPool FileAccessCompressed::thread_pool;
+BinaryMutex FileAccessCompressed::thread_pool_mutex;
+bool FileAccessCompressed::thread_pool_initialized = false;
+
+bool FileAccessCompressed::_lock_thread_pool() {
+#ifdef NO_THREADS
+	return false;
+#else
+	if (thread_pool_mutex.try_lock() != OK) {
+		return false; // Another file is using it, work on the calling thread instead.
+	}
+
+	if (!thread_pool_initialized) {
+		int thread_count = MIN(OS::get_singleton()->get_processor_count(), (int)MAX_THREADS);
+		if (thread_count < 2) {
+			thread_pool_mutex.unlock();
+			return false;
+		}
+		thread_pool.init(thread_count);
+		thread_pool_initialized = true;
+	}
+
+	return true;
+#endif
+}
+
+void FileAccessCompressed::finish_thread_pool() {
+	MutexLock lock(thread_pool_mutex);
+	if (thread_pool_initialized) {
+		thread_pool.finish();
+		thread_pool_initialized = false;
+	}
+}
+
+void FileAccessCompressed::_decompress_block(uint32_t p_index, uint8_t *p_dst) const {
+	const ReadBlock &rb = read_blocks[window_first + p_index];
+	const uint8_t *src = comp_buffer.ptr() + (rb.offset - read_blocks[window_first].offset);
+	Compression::decompress(p_dst + p_index * block_size, read_blocks.size() == 1 ? read_total : block_size, src, rb.csize, cmode);
+}
+
+void FileAccessCompressed::_compress_block(uint32_t p_index, Vector<uint8_t> *p_blocks) const {
+	uint32_t bc = (write_max / block_size) + 1;
+	uint32_t bl = p_index == (bc - 1) ? write_max % block_size : block_size;
+	const uint8_t *bp = &write_ptr[p_index * block_size];
+
+	Vector<uint8_t> &cblock = p_blocks[p_index];
+	cblock.resize(Compression::get_max_compressed_buffer_size(bl, cmode));
+	int s = Compression::compress(cblock.ptrw(), bp, bl, cmode);
+	cblock.resize(s);
+}
+
+void FileAccessCompressed::_load_block(uint32_t p_block) const {
+	read_block = p_block;
+	read_block_size = p_block == read_block_count - 1 ? read_total % block_size : block_size;
+
+	if (p_block < window_first || p_block >= window_first + window_count) {
+		// Decode a run of blocks at once, they are stored contiguously so this is a single read.
+		bool use_pool = _lock_thread_pool();
+		uint32_t count = use_pool ? MIN(MAX(1u, (uint32_t)READ_WINDOW_SIZE / block_size), read_block_count - p_block) : 1;
+
+		const ReadBlock &last = read_blocks[p_block + count - 1];
+		uint64_t comp_size = last.offset + last.csize - read_blocks[p_block].offset;
+		if ((uint64_t)comp_buffer.size() < comp_size) {
+			comp_buffer.resize(comp_size);
+		}
+		if ((uint64_t)buffer.size() < (uint64_t)count * block_size) {
+			buffer.resize(count * block_size);
+		}
+
+		f->seek(read_blocks[p_block].offset);
+		f->get_buffer(comp_buffer.ptrw(), comp_size);
+
+		window_first = p_block;
+		window_count = count;
+
+		uint8_t *dst = buffer.ptrw();
+		if (count > 1) {
+			thread_pool.do_work(count, this, &FileAccessCompressed::_decompress_block, dst);
+		} else {
+			_decompress_block(0, dst);
+		}
+
+		if (use_pool) {
+			thread_pool_mutex.unlock();
+		}
+
+		if (p_block + count < read_block_count) {
+			// Have the next run fetched in the background while this one is consumed.
+			const ReadBlock &next_first = read_blocks[p_block + count];
+			const ReadBlock &next_last = read_blocks[MIN(p_block + count * 2, read_block_count) - 1];
+			f->read_ahead(next_first.offset, next_last.offset + next_last.csize - next_first.offset);
+		}
+	}
+
+	read_ptr = buffer.ptrw() + (p_block - window_first) * block_size;
+}
+
 void FileAccessCompressed::configure(const String &p_magic, Compression::Mode p_mode, uint32_t p_block_size) {
 	magic = p_magic.ascii().get_data();
 	if (magic.length() > 4) {
@@ -81,15 +179,13 @@ Error FileAccessCompressed::open_after_magic(FileAccess *p_base) {
 
 	comp_buffer.resize(max_bs);
 	buffer.resize(block_size);
-	read_ptr = buffer.ptrw();
-	f->get_buffer(comp_buffer.ptrw(), read_blocks[0].csize);
 	at_end = false;
 	read_eof = false;
 	read_block_count = bc;
-	read_block_size = read_blocks.size() == 1 ? read_total : block_size;
+	window_first = 0;
+	window_count = 0;
 
-	Compression::decompress(buffer.ptrw(), read_block_size, comp_buffer.ptr(), read_blocks[0].csize, cmode);
-	read_block = 0;
+	_load_block(0);
 	read_pos = 0;
 
 	return OK;
@@ -154,22 +250,25 @@ void FileAccessCompressed::close() {
 			f->store_32(0); //compressed sizes, will update later
 		}
 
-		Vector<int> block_sizes;
-		for (uint32_t i = 0; i < bc; i++) {
-			uint32_t bl = i == (bc - 1) ? write_max % block_size : block_size;
-			uint8_t *bp = &write_ptr[i * block_size];
-
-			Vector<uint8_t> cblock;
-			cblock.resize(Compression::get_max_compressed_buffer_size(bl, cmode));
-			int s = Compression::compress(cblock.ptrw(), bp, bl, cmode);
+		// Blocks are independent, compress them in parallel when possible.
+		Vector<Vector<uint8_t>> cblocks;
+		cblocks.resize(bc);
+		if (bc > 1 && _lock_thread_pool()) {
+			thread_pool.do_work(bc, this, &FileAccessCompressed::_compress_block, cblocks.ptrw());
+			thread_pool_mutex.unlock();
+		} else {
+			for (uint32_t i = 0; i < bc; i++) {
+				_compress_block(i, cblocks.ptrw());
+			}
+		}
 
-			f->store_buffer(cblock.ptr(), s);
-			block_sizes.push_back(s);
+		for (uint32_t i = 0; i < bc; i++) {
+			f->store_buffer(cblocks[i].ptr(), cblocks[i].size());
 		}
 
 		f->seek(16); //ok write block sizes
 		for (uint32_t i = 0; i < bc; i++) {
-			f->store_32(block_sizes[i]);
+			f->store_32(cblocks[i].size());
 		}
 		f->seek_end();
 		f->store_buffer((const uint8_t *)mgc.get_data(), mgc.length()); //magic at the end too
@@ -207,11 +306,7 @@ void FileAccessCompressed::seek(uint64_t p_position) {
 			read_eof = false;
 			uint32_t block_idx = p_position / block_size;
 			if (block_idx != read_block) {
-				read_block = block_idx;
-				f->seek(read_blocks[read_block].offset);
-				f->get_buffer(comp_buffer.ptrw(), read_blocks[read_block].csize);
-				Compression::decompress(buffer.ptrw(), read_blocks.size() == 1 ? read_total : block_size, comp_buffer.ptr(), read_blocks[read_block].csize, cmode);
-				read_block_size = read_block == read_block_count - 1 ? read_total % block_size : block_size;
+				_load_block(block_idx);
 			}
 
 			read_pos = p_position % block_size;
@@ -268,17 +363,12 @@ uint8_t FileAccessCompressed::get_8() const {
 
 	read_pos++;
 	if (read_pos >= read_block_size) {
-		read_block++;
-
-		if (read_block < read_block_count) {
+		if (read_block + 1 < read_block_count) {
 			//read another block of compressed data
-			f->get_buffer(comp_buffer.ptrw(), read_blocks[read_block].csize);
-			Compression::decompress(buffer.ptrw(), read_blocks.size() == 1 ? read_total : block_size, comp_buffer.ptr(), read_blocks[read_block].csize, cmode);
-			read_block_size = read_block == read_block_count - 1 ? read_total % block_size : block_size;
+			_load_block(read_block + 1);
 			read_pos = 0;
 
 		} else {
-			read_block--;
 			at_end = true;
 		}
 	}
@@ -296,23 +386,22 @@ uint64_t FileAccessCompressed::get_buffer(uint8_t *p_dst, uint64_t p_length) con
 		return 0;
 	}
 
-	for (uint64_t i = 0; i < p_length; i++) {
-		p_dst[i] = read_ptr[read_pos];
-		read_pos++;
-		if (read_pos >= read_block_size) {
-			read_block++;
+	uint64_t i = 0;
+	while (i < p_length) {
+		uint64_t to_copy = MIN(p_length - i, (uint64_t)(read_block_size - read_pos));
+		memcpy(&p_dst[i], &read_ptr[read_pos], to_copy);
+		i += to_copy;
+		read_pos += to_copy;
 
-			if (read_block < read_block_count) {
+		if (read_pos >= read_block_size) {
+			if (read_block + 1 < read_block_count) {
 				//read another block of compressed data
-				f->get_buffer(comp_buffer.ptrw(), read_blocks[read_block].csize);
-				Compression::decompress(buffer.ptrw(), read_blocks.size() == 1 ? read_total : block_size, comp_buffer.ptr(), read_blocks[read_block].csize, cmode);
-				read_block_size = read_block == read_block_count - 1 ? read_total % block_size : block_size;
+				_load_block(read_block + 1);
 				read_pos = 0;
 
 			} else {
-				read_block--;
 				at_end = true;
-				if (i < p_length - 1) {
+				if (i < p_length) {
 					read_eof = true;
 				}
 				return i;
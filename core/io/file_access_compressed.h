@@ -33,8 +33,15 @@
 
 #include "core/io/compression.h"
 #include "core/io/file_access.h"
+#include "core/os/mutex.h"
+#include "core/templates/thread_work_pool.h"
 
 class FileAccessCompressed : public FileAccess {
+	enum {
+		READ_WINDOW_SIZE = 256 * 1024, // Uncompressed bytes decoded ahead when the thread pool is available.
+		MAX_THREADS = 8,
+	};
+
 	Compression::Mode cmode = Compression::MODE_ZSTD;
 	bool writing = false;
 	uint64_t write_pos = 0;
@@ -51,7 +58,7 @@ class FileAccessCompressed : public FileAccess {
 	};
 
 	mutable Vector<uint8_t> comp_buffer;
-	uint8_t *read_ptr = nullptr;
+	mutable uint8_t *read_ptr = nullptr;
 	mutable uint32_t read_block = 0;
 	uint32_t read_block_count = 0;
 	mutable uint32_t read_block_size = 0;
@@ -59,10 +66,25 @@ class FileAccessCompressed : public FileAccess {
 	Vector<ReadBlock> read_blocks;
 	uint64_t read_total = 0;
 
+	// Blocks currently decoded in buffer, one after the other.
+	mutable uint32_t window_first = 0;
+	mutable uint32_t window_count = 0;
+
 	String magic = "GCMP";
 	mutable Vector<uint8_t> buffer;
 	FileAccess *f = nullptr;
 
+	// Shared by all compressed files, used by one file at a time.
+	static ThreadWorkPool thread_pool;
+	static BinaryMutex thread_pool_mutex;
+	static bool thread_pool_initialized;
+
+	static bool _lock_thread_pool();
+
+	void _load_block(uint32_t p_block) const;
+	void _decompress_block(uint32_t p_index, uint8_t *p_dst) const;
+	void _compress_block(uint32_t p_index, Vector<uint8_t> *p_blocks) const;
+
 public:
 	void configure(const String &p_magic, Compression::Mode p_mode = Compression::MODE_ZSTD, uint32_t p_block_size = 4096);
 
@@ -93,6 +115,8 @@ public:
 	virtual uint32_t _get_unix_permissions(const String &p_file);
 	virtual Error _set_unix_permissions(const String &p_file, uint32_t p_permissions);
 
+	static void finish_thread_pool();
+
 	FileAccessCompressed() {}
 	virtual ~FileAccessCompressed();
 };
@@ -46,7 +46,7 @@ Error PackedData::add_pack(const String &p_path, bool p_replace_files, uint64_t
 	return ERR_FILE_UNRECOGNIZED;
 }
 
-void PackedData::add_path(const String &p_pkg_path, const String &p_path, uint64_t p_ofs, uint64_t p_size, const uint8_t *p_md5, PackSource *p_src, bool p_replace_files, bool p_encrypted) {
+void PackedData::add_path(const String &p_pkg_path, const String &p_path, uint64_t p_ofs, uint64_t p_size, const uint8_t *p_md5, PackSource *p_src, bool p_replace_files, bool p_encrypted, const uint8_t *p_mapped) {
 	PathMD5 pmd5(p_path.md5_buffer());
 
 	bool exists = files.has(pmd5);
@@ -60,9 +60,10 @@ void PackedData::add_path(const String &p_pkg_path, const String &p_path, uint64
 		pf.md5[i] = p_md5[i];
 	}
 	pf.src = p_src;
+	pf.mapped = p_encrypted ? nullptr : p_mapped;
 
 	if (!exists || p_replace_files) {
-		files[pmd5] = pf;
+		files.set(pmd5, pf);
 	}
 
 	if (!exists) {
@@ -217,6 +218,19 @@ bool PackedSourcePCK::try_open_pack(const String &p_path, bool p_replace_files,
 		f = fae;
 	}
 
+	Mapping mapping;
+	mapping.f = FileAccess::open(p_path, FileAccess::READ);
+	if (mapping.f) {
+		mapping.length = mapping.f->get_length();
+		mapping.region = mapping.length ? mapping.f->map_region(0, mapping.length) : nullptr;
+		mapping.f->close();
+		if (mapping.region) {
+			mappings.push_back(mapping);
+		} else {
+			memdelete(mapping.f);
+		}
+	}
+
 	for (int i = 0; i < file_count; i++) {
 		uint32_t sl = f->get_32();
 		CharString cs;
@@ -233,7 +247,12 @@ bool PackedSourcePCK::try_open_pack(const String &p_path, bool p_replace_files,
 		f->get_buffer(md5, 16);
 		uint32_t flags = f->get_32();
 
-		PackedData::get_singleton()->add_path(p_path, path, ofs + p_offset, size, md5, this, p_replace_files, (flags & PACK_FILE_ENCRYPTED));
+		const uint8_t *mapped = nullptr;
+		if (mapping.region && ofs + p_offset + size <= mapping.length) {
+			mapped = mapping.region + ofs + p_offset;
+		}
+
+		PackedData::get_singleton()->add_path(p_path, path, ofs + p_offset, size, md5, this, p_replace_files, (flags & PACK_FILE_ENCRYPTED), mapped);
 	}
 
 	f->close();
@@ -245,6 +264,13 @@ FileAccess *PackedSourcePCK::get_file(const String &p_path, PackedData::PackedFi
 	return memnew(FileAccessPack(p_path, *p_file));
 }
 
+PackedSourcePCK::~PackedSourcePCK() {
+	for (int i = 0; i < mappings.size(); i++) {
+		mappings[i].f->unmap_region(mappings[i].region, mappings[i].length);
+		memdelete(mappings[i].f);
+	}
+}
+
 //////////////////////////////////////////////////////////////////
 
 Error FileAccessPack::_open(const String &p_path, int p_mode_flags) {
@@ -253,10 +279,18 @@ Error FileAccessPack::_open(const String &p_path, int p_mode_flags) {
 }
 
 void FileAccessPack::close() {
+	if (mapped) {
+		mapped = nullptr;
+		return;
+	}
+	wait_async();
 	f->close();
 }
 
 bool FileAccessPack::is_open() const {
+	if (!f) {
+		return mapped != nullptr;
+	}
 	return f->is_open();
 }
 
@@ -267,7 +301,9 @@ void FileAccessPack::seek(uint64_t p_position) {
 		eof = false;
 	}
 
-	f->seek(off + p_position);
+	if (f) {
+		f->seek(off + p_position);
+	}
 	pos = p_position;
 }
 
@@ -293,6 +329,10 @@ uint8_t FileAccessPack::get_8() const {
 		return 0;
 	}
 
+	if (mapped) {
+		return mapped[pos++];
+	}
+
 	pos++;
 	return f->get_8();
 }
@@ -310,19 +350,109 @@ uint64_t FileAccessPack::get_buffer(uint8_t *p_dst, uint64_t p_length) const {
 		to_read = (int64_t)pf.size - (int64_t)pos;
 	}
 
+	uint64_t from = pos;
 	pos += p_length;
 
 	if (to_read <= 0) {
 		return 0;
 	}
-	f->get_buffer(p_dst, to_read);
+
+	if (mapped) {
+		memcpy(p_dst, mapped + from, to_read);
+	} else {
+		f->get_buffer(p_dst, to_read);
+	}
 
 	return to_read;
 }
 
+const uint8_t *FileAccessPack::get_buffer_view(uint64_t p_length) const {
+	if (!mapped || eof || pos > pf.size || p_length > pf.size - pos) {
+		return nullptr;
+	}
+
+	const uint8_t *view = mapped + pos;
+	pos += p_length;
+	return view;
+}
+
+Error FileAccessPack::read_async(const ReadRequest *p_requests, int p_count) {
+	ERR_FAIL_COND_V(!p_requests && p_count > 0, ERR_INVALID_PARAMETER);
+
+	if (mapped) {
+		for (int i = 0; i < p_count; i++) {
+			const ReadRequest &request = p_requests[i];
+			uint64_t read = request.offset < pf.size ? MIN(request.length, pf.size - request.offset) : 0;
+			if (read > 0) {
+				memcpy(request.dst, mapped + request.offset, read);
+			}
+			if (request.callback) {
+				request.callback(request.userdata, read == request.length ? OK : ERR_FILE_EOF, read);
+			}
+		}
+		return OK;
+	}
+
+	ERR_FAIL_COND_V(!f, ERR_FILE_CANT_READ);
+
+	// Translate to offsets in the pack, without reading past the end of this file.
+	LocalVector<ReadRequest> requests;
+	requests.reserve(p_count);
+	for (int i = 0; i < p_count; i++) {
+		const ReadRequest &request = p_requests[i];
+		if (request.offset >= pf.size) {
+			if (request.callback) {
+				request.callback(request.userdata, ERR_FILE_EOF, 0);
+			}
+			continue;
+		}
+
+		ReadRequest translated = request;
+		translated.offset = request.offset + off;
+		translated.length = MIN(request.length, pf.size - request.offset);
+		if (translated.length < request.length && request.callback) {
+			// The pack file has more data, report the end of this file from the original request.
+			ReadRequest *clamped = memnew(ReadRequest(request));
+			async_clamped.push_back(clamped);
+			translated.callback = _clamped_read_done;
+			translated.userdata = clamped;
+		}
+		requests.push_back(translated);
+	}
+
+	if (requests.is_empty()) {
+		return OK;
+	}
+	return f->read_async(requests.ptr(), requests.size());
+}
+
+void FileAccessPack::_clamped_read_done(void *p_userdata, Error p_error, uint64_t p_read) {
+	const ReadRequest *request = (const ReadRequest *)p_userdata;
+	request->callback(request->userdata, ERR_FILE_EOF, p_read);
+}
+
+void FileAccessPack::wait_async() {
+	if (f) {
+		f->wait_async();
+	}
+	for (uint32_t i = 0; i < async_clamped.size(); i++) {
+		memdelete(async_clamped[i]);
+	}
+	async_clamped.clear();
+}
+
+void FileAccessPack::read_ahead(uint64_t p_offset, uint64_t p_length) {
+	if (!f || p_offset >= pf.size) {
+		return;
+	}
+	f->read_ahead(p_offset + off, MIN(p_length, pf.size - p_offset));
+}
+
 void FileAccessPack::set_big_endian(bool p_big_endian) {
 	FileAccess::set_big_endian(p_big_endian);
-	f->set_big_endian(p_big_endian);
+	if (f) {
+		f->set_big_endian(p_big_endian);
+	}
 }
 
 Error FileAccessPack::get_error() const {
@@ -349,12 +479,21 @@ bool FileAccessPack::file_exists(const String &p_name) {
 }
 
 FileAccessPack::FileAccessPack(const String &p_path, const PackedData::PackedFile &p_file) :
-		pf(p_file),
-		f(FileAccess::open(pf.pack, FileAccess::READ)) {
+		pf(p_file) {
+	pos = 0;
+	eof = false;
+	off = pf.offset;
+
+	if (pf.mapped) {
+		// Contents are read straight from the mapped pack.
+		mapped = pf.mapped;
+		return;
+	}
+
+	f = FileAccess::open(pf.pack, FileAccess::READ);
 	ERR_FAIL_COND_MSG(!f, "Can't open pack-referenced file '" + String(pf.pack) + "'.");
 
 	f->seek(pf.offset);
-	off = pf.offset;
 
 	if (pf.encrypted) {
 		FileAccessEncrypted *fae = memnew(FileAccessEncrypted);
@@ -375,13 +514,15 @@ FileAccessPack::FileAccessPack(const String &p_path, const PackedData::PackedFil
 		}
 		f = fae;
 		off = 0;
+	} else {
+		// Files are usually read whole, start fetching them right away.
+		f->read_ahead(pf.offset, pf.size);
 	}
-	pos = 0;
-	eof = false;
 }
 
 FileAccessPack::~FileAccessPack() {
 	if (f) {
+		wait_async();
 		f->close();
 		memdelete(f);
 	}
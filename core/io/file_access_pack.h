@@ -34,7 +34,9 @@
 #include "core/io/dir_access.h"
 #include "core/io/file_access.h"
 #include "core/string/print_string.h"
+#include "core/templates/hash_map.h"
 #include "core/templates/list.h"
+#include "core/templates/local_vector.h"
 #include "core/templates/map.h"
 #include "core/templates/set.h"
 
@@ -66,6 +68,7 @@ public:
 		uint8_t md5[16];
 		PackSource *src;
 		bool encrypted;
+		const uint8_t *mapped = nullptr; // file contents if the pack is memory mapped and the file is not encrypted
 	};
 
 private:
@@ -91,6 +94,11 @@ private:
 			return a == p_md5.a && b == p_md5.b;
 		}
 
+		// Already an MD5, so the low bits are good enough as hash.
+		static _FORCE_INLINE_ uint32_t hash(const PathMD5 &p_md5) {
+			return uint32_t(p_md5.a);
+		}
+
 		PathMD5() {}
 
 		PathMD5(const Vector<uint8_t> &p_buf) {
@@ -99,7 +107,7 @@ private:
 		}
 	};
 
-	Map<PathMD5, PackedFile> files;
+	HashMap<PathMD5, PackedFile, PathMD5> files;
 
 	Vector<PackSource *> sources;
 
@@ -112,7 +120,7 @@ private:
 
 public:
 	void add_pack_source(PackSource *p_source);
-	void add_path(const String &p_pkg_path, const String &p_path, uint64_t p_ofs, uint64_t p_size, const uint8_t *p_md5, PackSource *p_src, bool p_replace_files, bool p_encrypted = false); // for PackSource
+	void add_path(const String &p_pkg_path, const String &p_path, uint64_t p_ofs, uint64_t p_size, const uint8_t *p_md5, PackSource *p_src, bool p_replace_files, bool p_encrypted = false, const uint8_t *p_mapped = nullptr); // for PackSource
 
 	void set_disabled(bool p_disabled) { disabled = p_disabled; }
 	_FORCE_INLINE_ bool is_disabled() const { return disabled; }
@@ -138,9 +146,21 @@ public:
 };
 
 class PackedSourcePCK : public PackSource {
+	// Packs are memory mapped when the platform supports it, so unencrypted
+	// files can be read without going through a FileAccess.
+	struct Mapping {
+		FileAccess *f = nullptr;
+		const uint8_t *region = nullptr;
+		uint64_t length = 0;
+	};
+
+	Vector<Mapping> mappings;
+
 public:
 	virtual bool try_open_pack(const String &p_path, bool p_replace_files, uint64_t p_offset);
 	virtual FileAccess *get_file(const String &p_path, PackedData::PackedFile *p_file);
+
+	virtual ~PackedSourcePCK();
 };
 
 class FileAccessPack : public FileAccess {
@@ -150,7 +170,13 @@ class FileAccessPack : public FileAccess {
 	mutable bool eof;
 	uint64_t off;
 
-	FileAccess *f;
+	FileAccess *f = nullptr;
+	const uint8_t *mapped = nullptr;
+
+	// Requests cut at the end of this file, kept until wait_async() to report them as such.
+	LocalVector<ReadRequest *> async_clamped;
+	static void _clamped_read_done(void *p_userdata, Error p_error, uint64_t p_read);
+
 	virtual Error _open(const String &p_path, int p_mode_flags);
 	virtual uint64_t _get_modified_time(const String &p_file) { return 0; }
 	virtual uint32_t _get_unix_permissions(const String &p_file) { return 0; }
@@ -170,6 +196,11 @@ public:
 	virtual uint8_t get_8() const;
 
 	virtual uint64_t get_buffer(uint8_t *p_dst, uint64_t p_length) const;
+	virtual const uint8_t *get_buffer_view(uint64_t p_length) const;
+
+	virtual Error read_async(const ReadRequest *p_requests, int p_count);
+	virtual void wait_async();
+	virtual void read_ahead(uint64_t p_offset, uint64_t p_length);
 
 	virtual void set_big_endian(bool p_big_endian);
 
@@ -188,15 +219,15 @@ public:
 
 FileAccess *PackedData::try_open_path(const String &p_path) {
 	PathMD5 pmd5(p_path.md5_buffer());
-	Map<PathMD5, PackedFile>::Element *E = files.find(pmd5);
-	if (!E) {
+	PackedFile *pf = files.getptr(pmd5);
+	if (!pf) {
 		return nullptr; //not found
 	}
-	if (E->get().offset == 0) {
+	if (pf->offset == 0) {
 		return nullptr; //was erased
 	}
 
-	return E->get().src->get_file(p_path, &E->get());
+	return pf->src->get_file(p_path, pf);
 }
 
 bool PackedData::has_path(const String &p_path) {
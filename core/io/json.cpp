@@ -45,106 +45,357 @@ const char *JSON::tk_name[TK_MAX] = {
 	"EOF",
 };
 
-String JSON::_make_indent(const String &p_indent, int p_size) {
-	String indent_text = "";
-	if (!p_indent.is_empty()) {
-		for (int i = 0; i < p_size; i++) {
-			indent_text += p_indent;
+void JSON::Writer::_append(const char *p_data, int p_len) {
+	uint32_t ofs = buffer.size();
+	buffer.resize(ofs + p_len);
+	memcpy(buffer.ptr() + ofs, p_data, p_len);
+}
+
+void JSON::Writer::_append_escaped(const String &p_string) {
+	buffer.push_back('"');
+
+	const char32_t *str = p_string.ptr();
+	int len = p_string.length();
+	for (int i = 0; i < len; i++) {
+		char32_t c = str[i];
+		switch (c) {
+			case '\\':
+				_append("\\\\", 2);
+				break;
+			case '\b':
+				_append("\\b", 2);
+				break;
+			case '\f':
+				_append("\\f", 2);
+				break;
+			case '\n':
+				_append("\\n", 2);
+				break;
+			case '\r':
+				_append("\\r", 2);
+				break;
+			case '\t':
+				_append("\\t", 2);
+				break;
+			case '\v':
+				_append("\\v", 2);
+				break;
+			case '"':
+				_append("\\\"", 2);
+				break;
+			default: {
+				// Encode straight to UTF-8, no intermediate CharString.
+				if (c < 0x80) {
+					buffer.push_back(c);
+				} else if (c < 0x800) {
+					buffer.push_back(0xC0 | (c >> 6));
+					buffer.push_back(0x80 | (c & 0x3F));
+				} else if (c < 0x10000) {
+					buffer.push_back(0xE0 | (c >> 12));
+					buffer.push_back(0x80 | ((c >> 6) & 0x3F));
+					buffer.push_back(0x80 | (c & 0x3F));
+				} else {
+					buffer.push_back(0xF0 | (c >> 18));
+					buffer.push_back(0x80 | ((c >> 12) & 0x3F));
+					buffer.push_back(0x80 | ((c >> 6) & 0x3F));
+					buffer.push_back(0x80 | (c & 0x3F));
+				}
+			} break;
+		}
+	}
+
+	buffer.push_back('"');
+}
+
+void JSON::Writer::_begin_element() {
+	if (after_key) {
+		// The value goes right after the colon.
+		after_key = false;
+		return;
+	}
+
+	if (levels.is_empty()) {
+		return;
+	}
+
+	Level &level = levels[levels.size() - 1];
+	if (!level.first) {
+		buffer.push_back(',');
+		if (indent.length()) {
+			buffer.push_back('\n');
+		}
+	}
+	level.first = false;
+
+	for (uint32_t i = 0; i < levels.size(); i++) {
+		_append(indent.get_data(), indent.length());
+	}
+}
+
+void JSON::Writer::_end_container(char p_close) {
+	ERR_FAIL_COND_MSG(levels.is_empty(), "No array or object to close.");
+	levels.resize(levels.size() - 1);
+
+	if (indent.length()) {
+		buffer.push_back('\n');
+		for (uint32_t i = 0; i < levels.size(); i++) {
+			_append(indent.get_data(), indent.length());
 		}
 	}
-	return indent_text;
+	buffer.push_back(p_close);
+}
+
+void JSON::Writer::begin_object() {
+	_begin_element();
+	buffer.push_back('{');
+	if (indent.length()) {
+		buffer.push_back('\n');
+	}
+	levels.push_back(Level());
 }
 
-String JSON::_stringify(const Variant &p_var, const String &p_indent, int p_cur_indent, bool p_sort_keys, Set<const void *> &p_markers, bool p_full_precision) {
-	String colon = ":";
-	String end_statement = "";
+void JSON::Writer::key(const String &p_key) {
+	ERR_FAIL_COND_MSG(levels.is_empty() || after_key, "Keys can only be written inside objects, before their value.");
+	_begin_element();
+	_append_escaped(p_key);
+	buffer.push_back(':');
+	if (indent.length()) {
+		buffer.push_back(' ');
+	}
+	after_key = true;
+}
+
+void JSON::Writer::end_object() {
+	_end_container('}');
+}
 
-	if (!p_indent.is_empty()) {
-		colon += " ";
-		end_statement += "\n";
+void JSON::Writer::begin_array() {
+	_begin_element();
+	buffer.push_back('[');
+	if (indent.length()) {
+		buffer.push_back('\n');
 	}
+	levels.push_back(Level());
+}
+
+void JSON::Writer::end_array() {
+	_end_container(']');
+}
 
+void JSON::Writer::_write(const Variant &p_var, Set<const void *> &p_markers) {
 	switch (p_var.get_type()) {
-		case Variant::NIL:
-			return "null";
-		case Variant::BOOL:
-			return p_var.operator bool() ? "true" : "false";
-		case Variant::INT:
-			return itos(p_var);
+		case Variant::NIL: {
+			_begin_element();
+			_append("null", 4);
+		} break;
+		case Variant::BOOL: {
+			_begin_element();
+			if (p_var.operator bool()) {
+				_append("true", 4);
+			} else {
+				_append("false", 5);
+			}
+		} break;
+		case Variant::INT: {
+			_begin_element();
+			CharString num = itos(p_var).ascii();
+			_append(num.get_data(), num.length());
+		} break;
 		case Variant::FLOAT: {
+			_begin_element();
 			double num = p_var;
-			if (p_full_precision) {
+			CharString str;
+			if (full_precision) {
 				// Store unreliable digits (17) instead of just reliable
 				// digits (14) so that the value can be decoded exactly.
-				return String::num(num, 17 - (int)floor(log10(num)));
+				str = String::num(num, 17 - (int)floor(log10(num))).ascii();
 			} else {
 				// Store only reliable digits (14) by default.
-				return String::num(num, 14 - (int)floor(log10(num)));
+				str = String::num(num, 14 - (int)floor(log10(num))).ascii();
 			}
-		}
+			_append(str.get_data(), str.length());
+		} break;
 		case Variant::PACKED_INT32_ARRAY:
 		case Variant::PACKED_INT64_ARRAY:
 		case Variant::PACKED_FLOAT32_ARRAY:
 		case Variant::PACKED_FLOAT64_ARRAY:
 		case Variant::PACKED_STRING_ARRAY:
 		case Variant::ARRAY: {
-			String s = "[";
-			s += end_statement;
 			Array a = p_var;
-
-			ERR_FAIL_COND_V_MSG(p_markers.has(a.id()), "\"[...]\"", "Converting circular structure to JSON.");
+			if (p_markers.has(a.id())) {
+				_begin_element();
+				_append("\"[...]\"", 7);
+				ERR_FAIL_MSG("Converting circular structure to JSON.");
+			}
 			p_markers.insert(a.id());
 
+			begin_array();
 			for (int i = 0; i < a.size(); i++) {
-				if (i > 0) {
-					s += ",";
-					s += end_statement;
-				}
-				s += _make_indent(p_indent, p_cur_indent + 1) + _stringify(a[i], p_indent, p_cur_indent + 1, p_sort_keys, p_markers);
+				_write(a[i], p_markers);
 			}
-			s += end_statement + _make_indent(p_indent, p_cur_indent) + "]";
+			end_array();
+
 			p_markers.erase(a.id());
-			return s;
-		}
+		} break;
 		case Variant::DICTIONARY: {
-			String s = "{";
-			s += end_statement;
 			Dictionary d = p_var;
-
-			ERR_FAIL_COND_V_MSG(p_markers.has(d.id()), "\"{...}\"", "Converting circular structure to JSON.");
+			if (p_markers.has(d.id())) {
+				_begin_element();
+				_append("\"{...}\"", 7);
+				ERR_FAIL_MSG("Converting circular structure to JSON.");
+			}
 			p_markers.insert(d.id());
 
 			List<Variant> keys;
 			d.get_key_list(&keys);
 
-			if (p_sort_keys) {
+			if (sort_keys) {
 				keys.sort();
 			}
 
-			bool first_key = true;
+			begin_object();
 			for (const Variant &E : keys) {
-				if (first_key) {
-					first_key = false;
-				} else {
-					s += ",";
-					s += end_statement;
-				}
-				s += _make_indent(p_indent, p_cur_indent + 1) + _stringify(String(E), p_indent, p_cur_indent + 1, p_sort_keys, p_markers);
-				s += colon;
-				s += _stringify(d[E], p_indent, p_cur_indent + 1, p_sort_keys, p_markers);
+				key(String(E));
+				_write(d[E], p_markers);
 			}
+			end_object();
 
-			s += end_statement + _make_indent(p_indent, p_cur_indent) + "}";
 			p_markers.erase(d.id());
-			return s;
+		} break;
+		default: {
+			_begin_element();
+			_append_escaped(String(p_var));
+		} break;
+	}
+}
+
+void JSON::Writer::write(const Variant &p_var) {
+	Set<const void *> markers;
+	_write(p_var, markers);
+}
+
+void JSON::Writer::clear() {
+	buffer.clear();
+	levels.clear();
+	after_key = false;
+}
+
+String JSON::Writer::get_string() const {
+	String ret;
+	if (buffer.size()) {
+		ret.parse_utf8(buffer.ptr(), buffer.size());
+	}
+	return ret;
+}
+
+JSON::Writer::Writer(const String &p_indent, bool p_sort_keys, bool p_full_precision) {
+	indent = p_indent.utf8();
+	sort_keys = p_sort_keys;
+	full_precision = p_full_precision;
+}
+
+static bool _is_hex_digit(char c) {
+	return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+}
+
+static uint32_t _hex_value(char c) {
+	if (c >= '0' && c <= '9') {
+		return c - '0';
+	} else if (c >= 'a' && c <= 'f') {
+		return c - 'a' + 10;
+	} else {
+		return c - 'A' + 10;
+	}
+}
+
+// Reads the four hex digits after "\u", p_str pointing to the 'u'.
+static bool _parse_hex4(const char *p_str, int p_index, int p_len, uint32_t &r_value, String &r_err_str) {
+	r_value = 0;
+	for (int j = 1; j <= 4; j++) {
+		if (p_index + j >= p_len || p_str[p_index + j] == 0) {
+			r_err_str = "Unterminated String";
+			return false;
+		}
+		char c = p_str[p_index + j];
+		if (!_is_hex_digit(c)) {
+			r_err_str = "Malformed hex constant in string";
+			return false;
+		}
+		r_value = (r_value << 4) | _hex_value(c);
+	}
+	return true;
+}
+
+static void _push_utf8(LocalVector<char> &r_buffer, uint32_t p_char) {
+	if (p_char < 0x80) {
+		r_buffer.push_back(p_char);
+	} else if (p_char < 0x800) {
+		r_buffer.push_back(0xC0 | (p_char >> 6));
+		r_buffer.push_back(0x80 | (p_char & 0x3F));
+	} else if (p_char < 0x10000) {
+		r_buffer.push_back(0xE0 | (p_char >> 12));
+		r_buffer.push_back(0x80 | ((p_char >> 6) & 0x3F));
+		r_buffer.push_back(0x80 | (p_char & 0x3F));
+	} else {
+		r_buffer.push_back(0xF0 | (p_char >> 18));
+		r_buffer.push_back(0x80 | ((p_char >> 12) & 0x3F));
+		r_buffer.push_back(0x80 | ((p_char >> 6) & 0x3F));
+		r_buffer.push_back(0x80 | (p_char & 0x3F));
+	}
+}
+
+static bool _is_digit(char c) {
+	return c >= '0' && c <= '9';
+}
+
+// Advances past a number following the JSON grammar: -?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][+-]?[0-9]+)?
+// Fails if the number doesn't match it, or runs into more number characters (as in "1-2" or "1.5.5").
+static bool _scan_number(const char *p_str, int &index, int p_len) {
+	if (index < p_len && p_str[index] == '-') {
+		index++;
+	}
+	if (index >= p_len || !_is_digit(p_str[index])) {
+		return false;
+	}
+	if (p_str[index] == '0') {
+		index++;
+	} else {
+		while (index < p_len && _is_digit(p_str[index])) {
+			index++;
+		}
+	}
+	if (index < p_len && p_str[index] == '.') {
+		index++;
+		if (index >= p_len || !_is_digit(p_str[index])) {
+			return false;
+		}
+		while (index < p_len && _is_digit(p_str[index])) {
+			index++;
+		}
+	}
+	if (index < p_len && (p_str[index] == 'e' || p_str[index] == 'E')) {
+		index++;
+		if (index < p_len && (p_str[index] == '+' || p_str[index] == '-')) {
+			index++;
+		}
+		if (index >= p_len || !_is_digit(p_str[index])) {
+			return false;
+		}
+		while (index < p_len && _is_digit(p_str[index])) {
+			index++;
+		}
+	}
+	if (index < p_len) {
+		char c = p_str[index];
+		if (_is_digit(c) || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E') {
+			return false;
 		}
-		default:
-			return "\"" + String(p_var).json_escape() + "\"";
 	}
+	return true;
 }
 
-Error JSON::_get_token(const char32_t *p_str, int &index, int p_len, Token &r_token, int &line, String &r_err_str) {
-	while (p_len > 0) {
+Error JSON::_get_token(const char *p_str, int &index, int p_len, Token &r_token, int &line, String &r_err_str, LocalVector<char> &r_scratch) {
+	while (index < p_len) {
 		switch (p_str[index]) {
 			case '\n': {
 				line++;
@@ -187,23 +438,32 @@ Error JSON::_get_token(const char32_t *p_str, int &index, int p_len, Token &r_to
 			}
 			case '"': {
 				index++;
-				String str;
+				int start = index;
+				bool escaped = false;
+
 				while (true) {
-					if (p_str[index] == 0) {
+					if (index >= p_len || p_str[index] == 0) {
 						r_err_str = "Unterminated String";
 						return ERR_PARSE_ERROR;
 					} else if (p_str[index] == '"') {
-						index++;
 						break;
 					} else if (p_str[index] == '\\') {
-						//escaped characters...
+						if (!escaped) {
+							// From here on the string is unescaped into the scratch buffer.
+							escaped = true;
+							r_scratch.resize(index - start);
+							if (index > start) {
+								memcpy(r_scratch.ptr(), &p_str[start], index - start);
+							}
+						}
+
 						index++;
-						char32_t next = p_str[index];
-						if (next == 0) {
+						if (index >= p_len || p_str[index] == 0) {
 							r_err_str = "Unterminated String";
 							return ERR_PARSE_ERROR;
 						}
-						char32_t res = 0;
+						char next = p_str[index];
+						uint32_t res = 0;
 
 						switch (next) {
 							case 'b':
@@ -222,73 +482,24 @@ Error JSON::_get_token(const char32_t *p_str, int &index, int p_len, Token &r_to
 								res = 13;
 								break;
 							case 'u': {
-								// hex number
-								for (int j = 0; j < 4; j++) {
-									char32_t c = p_str[index + j + 1];
-									if (c == 0) {
-										r_err_str = "Unterminated String";
-										return ERR_PARSE_ERROR;
-									}
-									if (!((c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F'))) {
-										r_err_str = "Malformed hex constant in string";
-										return ERR_PARSE_ERROR;
-									}
-									char32_t v;
-									if (c >= '0' && c <= '9') {
-										v = c - '0';
-									} else if (c >= 'a' && c <= 'f') {
-										v = c - 'a';
-										v += 10;
-									} else if (c >= 'A' && c <= 'F') {
-										v = c - 'A';
-										v += 10;
-									} else {
-										ERR_PRINT("Bug parsing hex constant.");
-										v = 0;
-									}
-
-									res <<= 4;
-									res |= v;
+								if (!_parse_hex4(p_str, index, p_len, res, r_err_str)) {
+									return ERR_PARSE_ERROR;
 								}
-								index += 4; //will add at the end anyway
+								index += 4;
 
 								if ((res & 0xfffffc00) == 0xd800) {
-									if (p_str[index + 1] != '\\' || p_str[index + 2] != 'u') {
+									if (index + 2 >= p_len || p_str[index + 1] != '\\' || p_str[index + 2] != 'u') {
 										r_err_str = "Invalid UTF-16 sequence in string, unpaired lead surrogate";
 										return ERR_PARSE_ERROR;
 									}
 									index += 2;
-									char32_t trail = 0;
-									for (int j = 0; j < 4; j++) {
-										char32_t c = p_str[index + j + 1];
-										if (c == 0) {
-											r_err_str = "Unterminated String";
-											return ERR_PARSE_ERROR;
-										}
-										if (!((c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F'))) {
-											r_err_str = "Malformed hex constant in string";
-											return ERR_PARSE_ERROR;
-										}
-										char32_t v;
-										if (c >= '0' && c <= '9') {
-											v = c - '0';
-										} else if (c >= 'a' && c <= 'f') {
-											v = c - 'a';
-											v += 10;
-										} else if (c >= 'A' && c <= 'F') {
-											v = c - 'A';
-											v += 10;
-										} else {
-											ERR_PRINT("Bug parsing hex constant.");
-											v = 0;
-										}
-
-										trail <<= 4;
-										trail |= v;
+									uint32_t trail = 0;
+									if (!_parse_hex4(p_str, index, p_len, trail, r_err_str)) {
+										return ERR_PARSE_ERROR;
 									}
 									if ((trail & 0xfffffc00) == 0xdc00) {
 										res = (res << 10UL) + trail - ((0xd800 << 10UL) + 0xdc00 - 0x10000);
-										index += 4; //will add at the end anyway
+										index += 4;
 									} else {
 										r_err_str = "Invalid UTF-16 sequence in string, unpaired lead surrogate";
 										return ERR_PARSE_ERROR;
@@ -297,54 +508,83 @@ Error JSON::_get_token(const char32_t *p_str, int &index, int p_len, Token &r_to
 									r_err_str = "Invalid UTF-16 sequence in string, unpaired trail surrogate";
 									return ERR_PARSE_ERROR;
 								}
-
 							} break;
 							default: {
-								res = next;
+								// Keep the escaped character whole, it may span several bytes.
+								uint8_t lead = next;
+								int extra = lead >= 0xF0 ? 3 : (lead >= 0xE0 ? 2 : (lead >= 0xC0 ? 1 : 0));
+								res = extra ? (lead & (0x3F >> extra)) : lead;
+								for (int i = 0; i < extra && index + 1 < p_len && (p_str[index + 1] & 0xC0) == 0x80; i++) {
+									index++;
+									res = (res << 6) | (p_str[index] & 0x3F);
+								}
 							} break;
 						}
 
-						str += res;
+						_push_utf8(r_scratch, res);
 
 					} else {
 						if (p_str[index] == '\n') {
 							line++;
 						}
-						str += p_str[index];
+						if (escaped) {
+							r_scratch.push_back(p_str[index]);
+						}
 					}
 					index++;
 				}
 
 				r_token.type = TK_STRING;
-				r_token.value = str;
+				if (escaped) {
+					r_token.str = r_scratch.ptr();
+					r_token.len = r_scratch.size();
+				} else {
+					r_token.str = &p_str[start];
+					r_token.len = index - start;
+				}
+				index++;
 				return OK;
 
 			} break;
 			default: {
-				if (p_str[index] <= 32) {
+				if ((uint8_t)p_str[index] <= 32) {
 					index++;
 					break;
 				}
 
 				if (p_str[index] == '-' || (p_str[index] >= '0' && p_str[index] <= '9')) {
 					//a number
-					const char32_t *rptr;
-					double number = String::to_float(&p_str[index], &rptr);
-					index += (rptr - &p_str[index]);
+					int start = index;
+					if (!_scan_number(p_str, index, p_len)) {
+						r_err_str = "Malformed number.";
+						return ERR_PARSE_ERROR;
+					}
+
+					// The input isn't null-terminated, so the number is copied out to convert it.
+					int num_len = index - start;
+					char num_short[64];
+					LocalVector<char> num_long;
+					char *num = num_short;
+					if (num_len >= (int)sizeof(num_short)) {
+						num_long.resize(num_len + 1);
+						num = num_long.ptr();
+					}
+					memcpy(num, &p_str[start], num_len);
+					num[num_len] = 0;
+
 					r_token.type = TK_NUMBER;
-					r_token.value = number;
+					r_token.number = String::to_float(num);
 					return OK;
 
 				} else if ((p_str[index] >= 'A' && p_str[index] <= 'Z') || (p_str[index] >= 'a' && p_str[index] <= 'z')) {
-					String id;
-
-					while ((p_str[index] >= 'A' && p_str[index] <= 'Z') || (p_str[index] >= 'a' && p_str[index] <= 'z')) {
-						id += p_str[index];
+					int start = index;
+					while (index < p_len && ((p_str[index] >= 'A' && p_str[index] <= 'Z') || (p_str[index] >= 'a' && p_str[index] <= 'z'))) {
 						index++;
 					}
 
 					r_token.type = TK_IDENTIFIER;
-					r_token.value = id;
+					r_token.str = &p_str[start];
+					r_token.len = index - start;
 					return OK;
 				} else {
 					r_err_str = "Unexpected character.";
@@ -354,187 +594,252 @@ Error JSON::_get_token(const char32_t *p_str, int &index, int p_len, Token &r_to
 		}
 	}
 
-	return ERR_PARSE_ERROR;
+	r_token.type = TK_EOF;
+	return OK;
 }
 
-Error JSON::_parse_value(Variant &value, Token &token, const char32_t *p_str, int &index, int p_len, int &line, String &r_err_str) {
-	if (token.type == TK_CURLY_BRACKET_OPEN) {
-		Dictionary d;
-		Error err = _parse_object(d, p_str, index, p_len, line, r_err_str);
-		if (err) {
-			return err;
-		}
-		value = d;
-	} else if (token.type == TK_BRACKET_OPEN) {
-		Array a;
-		Error err = _parse_array(a, p_str, index, p_len, line, r_err_str);
-		if (err) {
-			return err;
-		}
-		value = a;
-	} else if (token.type == TK_IDENTIFIER) {
-		String id = token.value;
-		if (id == "true") {
-			value = true;
-		} else if (id == "false") {
-			value = false;
-		} else if (id == "null") {
-			value = Variant();
-		} else {
-			r_err_str = "Expected 'true','false' or 'null', got '" + id + "'.";
-			return ERR_PARSE_ERROR;
-		}
-	} else if (token.type == TK_NUMBER) {
-		value = token.value;
-	} else if (token.type == TK_STRING) {
-		value = token.value;
-	} else {
-		r_err_str = "Expected value, got " + String(tk_name[token.type]) + ".";
-		return ERR_PARSE_ERROR;
-	}
+Error JSON::parse_utf8(const char *p_data, int p_len, Handler *p_handler, String &r_err_str, int &r_err_line) {
+	ERR_FAIL_NULL_V(p_handler, ERR_INVALID_PARAMETER);
+	ERR_FAIL_COND_V(!p_data && p_len > 0, ERR_INVALID_PARAMETER);
 
-	return OK;
-}
+	// Nesting is kept in an explicit stack, so deep documents can't overflow the call stack.
+	struct Level {
+		bool object = false;
+		bool at_key = true;
+		bool need_comma = false;
+	};
 
-Error JSON::_parse_array(Array &array, const char32_t *p_str, int &index, int p_len, int &line, String &r_err_str) {
+	LocalVector<Level> levels;
+	LocalVector<char> scratch;
 	Token token;
-	bool need_comma = false;
+	int index = 0;
+	r_err_line = 0;
+	r_err_str = String();
 
-	while (index < p_len) {
-		Error err = _get_token(p_str, index, p_len, token, line, r_err_str);
+#define JSON_HANDLER_CALL(m_call)             \
+	if (!p_handler->m_call) {                 \
+		r_err_str = "Parsing was cancelled."; \
+		return ERR_SKIP;                      \
+	}
+
+	while (true) {
+		Error err = _get_token(p_data, index, p_len, token, r_err_line, r_err_str, scratch);
 		if (err != OK) {
 			return err;
 		}
 
-		if (token.type == TK_BRACKET_CLOSE) {
-			return OK;
-		}
+		bool closed = false;
+		if (levels.size()) {
+			Level &level = levels[levels.size() - 1];
 
-		if (need_comma) {
-			if (token.type != TK_COMMA) {
-				r_err_str = "Expected ','";
+			if (token.type == TK_EOF) {
+				r_err_str = level.object ? "Expected '}'" : "Expected ']'";
 				return ERR_PARSE_ERROR;
-			} else {
-				need_comma = false;
-				continue;
 			}
-		}
-
-		Variant v;
-		err = _parse_value(v, token, p_str, index, p_len, line, r_err_str);
-		if (err) {
-			return err;
-		}
-
-		array.push_back(v);
-		need_comma = true;
-	}
 
-	r_err_str = "Expected ']'";
-	return ERR_PARSE_ERROR;
-}
-
-Error JSON::_parse_object(Dictionary &object, const char32_t *p_str, int &index, int p_len, int &line, String &r_err_str) {
-	bool at_key = true;
-	String key;
-	Token token;
-	bool need_comma = false;
-
-	while (index < p_len) {
-		if (at_key) {
-			Error err = _get_token(p_str, index, p_len, token, line, r_err_str);
-			if (err != OK) {
-				return err;
-			}
-
-			if (token.type == TK_CURLY_BRACKET_CLOSE) {
-				return OK;
-			}
+			if (level.object && level.at_key) {
+				if (token.type == TK_CURLY_BRACKET_CLOSE) {
+					levels.resize(levels.size() - 1);
+					JSON_HANDLER_CALL(end_object());
+					closed = true;
+				} else if (level.need_comma) {
+					if (token.type != TK_COMMA) {
+						r_err_str = "Expected '}' or ','";
+						return ERR_PARSE_ERROR;
+					}
+					level.need_comma = false;
+					continue;
+				} else {
+					if (token.type != TK_STRING) {
+						r_err_str = "Expected key";
+						return ERR_PARSE_ERROR;
+					}
+					JSON_HANDLER_CALL(key(token.str, token.len));
 
-			if (need_comma) {
+					err = _get_token(p_data, index, p_len, token, r_err_line, r_err_str, scratch);
+					if (err != OK) {
+						return err;
+					}
+					if (token.type != TK_COLON) {
+						r_err_str = "Expected ':'";
+						return ERR_PARSE_ERROR;
+					}
+					level.at_key = false;
+					continue;
+				}
+			} else if (!level.object && token.type == TK_BRACKET_CLOSE) {
+				levels.resize(levels.size() - 1);
+				JSON_HANDLER_CALL(end_array());
+				closed = true;
+			} else if (!level.object && level.need_comma) {
 				if (token.type != TK_COMMA) {
-					r_err_str = "Expected '}' or ','";
+					r_err_str = "Expected ','";
 					return ERR_PARSE_ERROR;
-				} else {
-					need_comma = false;
-					continue;
 				}
+				level.need_comma = false;
+				continue;
 			}
+		}
 
-			if (token.type != TK_STRING) {
-				r_err_str = "Expected key";
-				return ERR_PARSE_ERROR;
-			}
-
-			key = token.value;
-			err = _get_token(p_str, index, p_len, token, line, r_err_str);
-			if (err != OK) {
-				return err;
-			}
-			if (token.type != TK_COLON) {
-				r_err_str = "Expected ':'";
-				return ERR_PARSE_ERROR;
-			}
-			at_key = false;
-		} else {
-			Error err = _get_token(p_str, index, p_len, token, line, r_err_str);
-			if (err != OK) {
-				return err;
+		if (!closed) {
+			switch (token.type) {
+				case TK_CURLY_BRACKET_OPEN: {
+					JSON_HANDLER_CALL(begin_object());
+					Level level;
+					level.object = true;
+					levels.push_back(level);
+					continue;
+				} break;
+				case TK_BRACKET_OPEN: {
+					JSON_HANDLER_CALL(begin_array());
+					levels.push_back(Level());
+					continue;
+				} break;
+				case TK_IDENTIFIER: {
+					if (token.len == 4 && memcmp(token.str, "true", 4) == 0) {
+						JSON_HANDLER_CALL(bool_value(true));
+					} else if (token.len == 5 && memcmp(token.str, "false", 5) == 0) {
+						JSON_HANDLER_CALL(bool_value(false));
+					} else if (token.len == 4 && memcmp(token.str, "null", 4) == 0) {
+						JSON_HANDLER_CALL(null_value());
+					} else {
+						String id;
+						id.parse_utf8(token.str, token.len);
+						r_err_str = "Expected 'true','false' or 'null', got '" + id + "'.";
+						return ERR_PARSE_ERROR;
+					}
+				} break;
+				case TK_NUMBER: {
+					JSON_HANDLER_CALL(number_value(token.number));
+				} break;
+				case TK_STRING: {
+					JSON_HANDLER_CALL(string_value(token.str, token.len));
+				} break;
+				default: {
+					r_err_str = "Expected value, got " + String(tk_name[token.type]) + ".";
+					return ERR_PARSE_ERROR;
+				}
 			}
+		}
 
-			Variant v;
-			err = _parse_value(v, token, p_str, index, p_len, line, r_err_str);
-			if (err) {
-				return err;
-			}
-			object[key] = v;
-			need_comma = true;
-			at_key = true;
+		// A value was completed.
+		if (levels.is_empty()) {
+			break;
 		}
+		levels[levels.size() - 1].need_comma = true;
+		levels[levels.size() - 1].at_key = true;
+	}
+
+#undef JSON_HANDLER_CALL
+
+	// Only whitespace may follow the value.
+	Error err = _get_token(p_data, index, p_len, token, r_err_line, r_err_str, scratch);
+	if (err || token.type != TK_EOF) {
+		r_err_str = "Expected 'EOF'";
+		return ERR_PARSE_ERROR;
 	}
 
-	r_err_str = "Expected '}'";
-	return ERR_PARSE_ERROR;
+	return OK;
 }
 
-Error JSON::_parse_string(const String &p_json, Variant &r_ret, String &r_err_str, int &r_err_line) {
-	const char32_t *str = p_json.ptr();
-	int idx = 0;
-	int len = p_json.length();
-	Token token;
-	r_err_line = 0;
-	String aux_key;
+// Builds the Variant for parse() and parse_buffer().
+class JSONVariantBuilder : public JSON::Handler {
+	LocalVector<Variant> containers;
+	String current_key;
 
-	Error err = _get_token(str, idx, len, token, r_err_line, r_err_str);
-	if (err) {
-		return err;
+	void _add(const Variant &p_value) {
+		if (containers.is_empty()) {
+			result = p_value;
+			return;
+		}
+
+		Variant &container = containers[containers.size() - 1];
+		if (container.get_type() == Variant::ARRAY) {
+			Array array = container;
+			array.push_back(p_value);
+		} else {
+			Dictionary object = container;
+			object[current_key] = p_value;
+		}
 	}
 
-	err = _parse_value(r_ret, token, str, idx, len, r_err_line, r_err_str);
+	static String _to_string(const char *p_utf8, int p_len) {
+		String str;
+		if (p_len) {
+			str.parse_utf8(p_utf8, p_len);
+		}
+		return str;
+	}
 
-	// Check if EOF is reached
-	// or it's a type of the next token.
-	if (err == OK && idx < len) {
-		err = _get_token(str, idx, len, token, r_err_line, r_err_str);
+public:
+	Variant result;
 
-		if (err || token.type != TK_EOF) {
-			r_err_str = "Expected 'EOF'";
-			// Reset return value to empty `Variant`
-			r_ret = Variant();
-			return ERR_PARSE_ERROR;
-		}
+	virtual bool begin_object() {
+		Dictionary object;
+		_add(object);
+		containers.push_back(object);
+		return true;
+	}
+	virtual bool key(const char *p_utf8, int p_len) {
+		current_key = _to_string(p_utf8, p_len);
+		return true;
+	}
+	virtual bool end_object() {
+		containers.resize(containers.size() - 1);
+		return true;
+	}
+	virtual bool begin_array() {
+		Array array;
+		_add(array);
+		containers.push_back(array);
+		return true;
 	}
+	virtual bool end_array() {
+		containers.resize(containers.size() - 1);
+		return true;
+	}
+	virtual bool string_value(const char *p_utf8, int p_len) {
+		_add(_to_string(p_utf8, p_len));
+		return true;
+	}
+	virtual bool number_value(double p_value) {
+		_add(p_value);
+		return true;
+	}
+	virtual bool bool_value(bool p_value) {
+		_add(p_value);
+		return true;
+	}
+	virtual bool null_value() {
+		_add(Variant());
+		return true;
+	}
+};
 
+Error JSON::_parse_data(const char *p_data, int p_len, Variant &r_ret, String &r_err_str, int &r_err_line) {
+	JSONVariantBuilder builder;
+	Error err = parse_utf8(p_data, p_len, &builder, r_err_str, r_err_line);
+	r_ret = err == OK ? builder.result : Variant();
 	return err;
 }
 
 String JSON::stringify(const Variant &p_var, const String &p_indent, bool p_sort_keys, bool p_full_precision) {
-	Set<const void *> markers;
-	return _stringify(p_var, p_indent, 0, p_sort_keys, markers, p_full_precision);
+	Writer writer(p_indent, p_sort_keys, p_full_precision);
+	writer.write(p_var);
+	return writer.get_string();
 }
 
 Error JSON::parse(const String &p_json_string) {
-	Error err = _parse_string(p_json_string, data, err_str, err_line);
+	CharString utf8 = p_json_string.utf8();
+	Error err = _parse_data(utf8.get_data(), utf8.length(), data, err_str, err_line);
+	if (err == Error::OK) {
+		err_line = 0;
+	}
+	return err;
+}
+
+Error JSON::parse_buffer(const PackedByteArray &p_json_buffer) {
+	Error err = _parse_data((const char *)p_json_buffer.ptr(), p_json_buffer.size(), data, err_str, err_line);
 	if (err == Error::OK) {
 		err_line = 0;
 	}
@@ -544,6 +849,7 @@ Error JSON::parse(const String &p_json_string) {
 void JSON::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("stringify", "data", "indent", "sort_keys", "full_precision"), &JSON::stringify, DEFVAL(""), DEFVAL(true), DEFVAL(false));
 	ClassDB::bind_method(D_METHOD("parse", "json_string"), &JSON::parse);
+	ClassDB::bind_method(D_METHOD("parse_buffer", "json_buffer"), &JSON::parse_buffer);
 
 	ClassDB::bind_method(D_METHOD("get_data"), &JSON::get_data);
 	ClassDB::bind_method(D_METHOD("get_error_line"), &JSON::get_error_line);
@@ -32,11 +32,70 @@
 #define JSON_H
 
 #include "core/object/ref_counted.h"
+#include "core/templates/local_vector.h"
 #include "core/variant/variant.h"
 
 class JSON : public RefCounted {
 	GDCLASS(JSON, RefCounted);
 
+public:
+	// Receives the contents of a document as parse_utf8() goes through it.
+	// Strings are UTF-8 views into the parsed data when they contain no escape
+	// sequences, or into a scratch buffer otherwise, and are only valid during
+	// the call. Returning false stops parsing with ERR_SKIP.
+	class Handler {
+	public:
+		virtual bool begin_object() = 0;
+		virtual bool key(const char *p_utf8, int p_len) = 0;
+		virtual bool end_object() = 0;
+		virtual bool begin_array() = 0;
+		virtual bool end_array() = 0;
+		virtual bool string_value(const char *p_utf8, int p_len) = 0;
+		virtual bool number_value(double p_value) = 0;
+		virtual bool bool_value(bool p_value) = 0;
+		virtual bool null_value() = 0;
+
+		virtual ~Handler() {}
+	};
+
+	// Appends JSON text as UTF-8 to a buffer that keeps its memory when cleared,
+	// so it can be reused for many documents. Containers can be written piece
+	// by piece, or whole from a Variant.
+	class Writer {
+		struct Level {
+			bool first = true;
+		};
+
+		LocalVector<char> buffer;
+		LocalVector<Level> levels;
+		CharString indent;
+		bool sort_keys = true;
+		bool full_precision = false;
+		bool after_key = false;
+
+		void _append(const char *p_data, int p_len);
+		void _append_escaped(const String &p_string);
+		void _begin_element();
+		void _end_container(char p_close);
+		void _write(const Variant &p_var, Set<const void *> &p_markers);
+
+	public:
+		void begin_object();
+		void key(const String &p_key);
+		void end_object();
+		void begin_array();
+		void end_array();
+		void write(const Variant &p_var); // Any value, including whole arrays and dictionaries.
+
+		void clear();
+		_FORCE_INLINE_ const char *get_data() const { return buffer.ptr(); }
+		_FORCE_INLINE_ int get_length() const { return buffer.size(); }
+		String get_string() const;
+
+		Writer(const String &p_indent = "", bool p_sort_keys = true, bool p_full_precision = false);
+	};
+
+private:
 	enum TokenType {
 		TK_CURLY_BRACKET_OPEN,
 		TK_CURLY_BRACKET_CLOSE,
@@ -60,7 +119,9 @@ class JSON : public RefCounted {
 
 	struct Token {
 		TokenType type;
-		Variant value;
+		const char *str = nullptr; // Set for strings and identifiers.
+		int len = 0;
+		double number = 0;
 	};
 
 	Variant data;
@@ -69,20 +130,18 @@ class JSON : public RefCounted {
 
 	static const char *tk_name[];
 
-	static String _make_indent(const String &p_indent, int p_size);
-	static String _stringify(const Variant &p_var, const String &p_indent, int p_cur_indent, bool p_sort_keys, Set<const void *> &p_markers, bool p_full_precision = false);
-	static Error _get_token(const char32_t *p_str, int &index, int p_len, Token &r_token, int &line, String &r_err_str);
-	static Error _parse_value(Variant &value, Token &token, const char32_t *p_str, int &index, int p_len, int &line, String &r_err_str);
-	static Error _parse_array(Array &array, const char32_t *p_str, int &index, int p_len, int &line, String &r_err_str);
-	static Error _parse_object(Dictionary &object, const char32_t *p_str, int &index, int p_len, int &line, String &r_err_str);
-	static Error _parse_string(const String &p_json, Variant &r_ret, String &r_err_str, int &r_err_line);
+	static Error _get_token(const char *p_str, int &index, int p_len, Token &r_token, int &line, String &r_err_str, LocalVector<char> &r_scratch);
+	static Error _parse_data(const char *p_data, int p_len, Variant &r_ret, String &r_err_str, int &r_err_line);
 
 protected:
 	static void _bind_methods();
 
 public:
+	static Error parse_utf8(const char *p_data, int p_len, Handler *p_handler, String &r_err_str, int &r_err_line);
+
 	String stringify(const Variant &p_var, const String &p_indent = "", bool p_sort_keys = true, bool p_full_precision = false);
 	Error parse(const String &p_json_string);
+	Error parse_buffer(const PackedByteArray &p_json_buffer);
 
 	inline Variant get_data() const { return data; }
 	inline int get_error_line() const { return err_line; }
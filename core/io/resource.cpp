@@ -438,12 +438,23 @@ Resource::~Resource() {
 		ResourceCache::resources.erase(path_cache);
 		ResourceCache::lock.write_unlock();
 	}
+	if (content_hash) {
+		ResourceCache::lock.write_lock();
+		Resource **r = ResourceCache::content_hashes.getptr(content_hash);
+		if (r && *r == this) {
+			ResourceCache::content_hashes.erase(content_hash);
+		}
+		ResourceCache::lock.write_unlock();
+	}
 	if (owners.size()) {
 		WARN_PRINT("Resource is still owned.");
 	}
 }
 
 HashMap<String, Resource *> ResourceCache::resources;
+HashMap<uint64_t, Resource *> ResourceCache::content_hashes;
+SafeNumeric<uint64_t> ResourceCache::deduplicated_count;
+SafeNumeric<uint64_t> ResourceCache::deduplicated_bytes;
 #ifdef TOOLS_ENABLED
 HashMap<String, HashMap<String, String>> ResourceCache::resource_path_cache;
 #endif
@@ -466,6 +477,7 @@ void ResourceCache::clear() {
 	}
 
 	resources.clear();
+	content_hashes.clear();
 }
 
 void ResourceCache::reload_externals() {
@@ -511,6 +523,44 @@ int ResourceCache::get_cached_resource_count() {
 	return rc;
 }
 
+void ResourceCache::set_content_hash(Resource *p_resource, uint64_t p_hash) {
+	ERR_FAIL_NULL(p_resource);
+	ERR_FAIL_COND(p_hash == 0);
+
+	lock.write_lock();
+	if (!p_resource->content_hash && !content_hashes.has(p_hash)) {
+		p_resource->content_hash = p_hash;
+		content_hashes[p_hash] = p_resource;
+	}
+	lock.write_unlock();
+}
+
+RES ResourceCache::get_by_content_hash(uint64_t p_hash) {
+	lock.read_lock();
+
+	// Reference it while locked, another thread may be releasing it. The reference
+	// fails (and the Ref stays null) if its count already dropped to zero.
+	RES res;
+	Resource **r = content_hashes.getptr(p_hash);
+	if (r) {
+		res = RES(*r);
+	}
+
+	lock.read_unlock();
+
+	return res;
+}
+
+void ResourceCache::add_deduplicated(uint64_t p_bytes) {
+	deduplicated_count.increment();
+	deduplicated_bytes.add(p_bytes);
+}
+
+void ResourceCache::get_deduplication_stats(uint64_t *r_count, uint64_t *r_bytes) {
+	*r_count = deduplicated_count.get();
+	*r_bytes = deduplicated_bytes.get();
+}
+
 void ResourceCache::dump(const char *p_file, bool p_short) {
 #ifdef DEBUG_ENABLED
 	lock.read_lock();
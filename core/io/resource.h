@@ -69,6 +69,7 @@ private:
 #endif
 
 	bool local_to_scene = false;
+	uint64_t content_hash = 0; // Set when registered for deduplication in ResourceCache.
 	friend class SceneState;
 	Node *local_scene = nullptr;
 
@@ -155,6 +156,9 @@ class ResourceCache {
 	friend class ResourceLoader; //need the lock
 	static RWLock lock;
 	static HashMap<String, Resource *> resources;
+	static HashMap<uint64_t, Resource *> content_hashes;
+	static SafeNumeric<uint64_t> deduplicated_count;
+	static SafeNumeric<uint64_t> deduplicated_bytes;
 #ifdef TOOLS_ENABLED
 	static HashMap<String, HashMap<String, String>> resource_path_cache; // Each tscn has a set of resource paths and IDs.
 	static RWLock path_cache_lock;
@@ -170,6 +174,12 @@ public:
 	static void dump(const char *p_file = nullptr, bool p_short = false);
 	static void get_cached_resources(List<Ref<Resource>> *p_resources);
 	static int get_cached_resource_count();
+
+	// Built-in resources with identical contents can be shared between the files including them.
+	static void set_content_hash(Resource *p_resource, uint64_t p_hash);
+	static RES get_by_content_hash(uint64_t p_hash);
+	static void add_deduplicated(uint64_t p_bytes);
+	static void get_deduplication_stats(uint64_t *r_count, uint64_t *r_bytes);
 };
 
 #endif // RESOURCE_H
@@ -30,7 +30,10 @@
 
 #include "resource_format_binary.h"
 
+#include "core/config/engine.h"
 #include "core/config/project_settings.h"
+#include "core/crypto/crypto_core.h"
+#include "core/io/compression.h"
 #include "core/io/dir_access.h"
 #include "core/io/file_access_compressed.h"
 #include "core/io/image.h"
@@ -87,11 +90,44 @@ enum {
 	// Version 2: added 64 bits support for float and int.
 	// Version 3: changed nodepath encoding.
 	// Version 4: new string ID for ext/subresources, breaks forward compat.
-	FORMAT_VERSION = 4,
+	// Version 5: packed arrays stored as aligned, optionally compressed blocks.
+	FORMAT_VERSION = 5,
 	FORMAT_VERSION_CAN_RENAME_DEPS = 1,
 	FORMAT_VERSION_NO_NODEPATH_PROPERTY = 3,
+	FORMAT_VERSION_PACKED_BLOCKS = 5,
+	PACKED_BLOCK_FLAG_COMPRESSED = 1,
+	PACKED_BLOCK_ALIGNMENT = 16,
+	PACKED_BLOCK_COMPRESS_MIN_SIZE = 4096,
 };
 
+// Blocks are stored with the endianness of the file, swap them if it's not the native one.
+static void _swap_packed_block(uint8_t *p_data, uint64_t p_size, uint32_t p_component_size) {
+	switch (p_component_size) {
+		case 4: {
+			uint32_t *ptr = (uint32_t *)p_data;
+			for (uint64_t i = 0; i < p_size / 4; i++) {
+				ptr[i] = BSWAP32(ptr[i]);
+			}
+		} break;
+		case 8: {
+			uint64_t *ptr = (uint64_t *)p_data;
+			for (uint64_t i = 0; i < p_size / 8; i++) {
+				ptr[i] = BSWAP64(ptr[i]);
+			}
+		} break;
+		default: {
+		}
+	}
+}
+
+static bool _is_packed_block_swapped(const FileAccess *p_f) {
+#ifdef BIG_ENDIAN_ENABLED
+	return !p_f->is_big_endian();
+#else
+	return p_f->is_big_endian();
+#endif
+}
+
 void ResourceLoaderBinary::_advance_padding(uint32_t p_len) {
 	uint32_t extra = 4 - (p_len % 4);
 	if (extra < 4) {
@@ -101,6 +137,44 @@ void ResourceLoaderBinary::_advance_padding(uint32_t p_len) {
 	}
 }
 
+Error ResourceLoaderBinary::_parse_packed_block(uint8_t *p_dst, uint64_t p_size, uint32_t p_component_size) {
+	uint32_t block_flags = f->get_32();
+	uint64_t stored_size = p_size;
+	if (block_flags & PACKED_BLOCK_FLAG_COMPRESSED) {
+		stored_size = f->get_32();
+	}
+
+	uint32_t padding = f->get_32();
+	ERR_FAIL_COND_V(padding >= PACKED_BLOCK_ALIGNMENT, ERR_FILE_CORRUPT);
+	f->seek(f->get_position() + padding);
+
+	// Blocks are aligned when saved, so they can be used in place if the file is in memory.
+	const uint8_t *view = f->get_buffer_view(stored_size);
+
+	if (block_flags & PACKED_BLOCK_FLAG_COMPRESSED) {
+		Vector<uint8_t> compressed;
+		if (!view) {
+			compressed.resize(stored_size);
+			ERR_FAIL_COND_V(f->get_buffer(compressed.ptrw(), stored_size) != stored_size, ERR_FILE_CORRUPT);
+			view = compressed.ptr();
+		}
+		int decompressed = Compression::decompress(p_dst, p_size, view, stored_size, Compression::MODE_ZSTD);
+		ERR_FAIL_COND_V(decompressed != (int)p_size, ERR_FILE_CORRUPT);
+	} else if (view) {
+		memcpy(p_dst, view, p_size);
+	} else {
+		ERR_FAIL_COND_V(f->get_buffer(p_dst, p_size) != p_size, ERR_FILE_CORRUPT);
+	}
+
+	_advance_padding(stored_size);
+
+	if (_is_packed_block_swapped(f)) {
+		_swap_packed_block(p_dst, p_size, p_component_size);
+	}
+
+	return OK;
+}
+
 StringName ResourceLoaderBinary::_get_string() {
 	uint32_t id = f->get_32();
 	if (id & 0x80000000) {
@@ -316,6 +390,17 @@ Error ResourceLoaderBinary::parse_variant(Variant &r_v) {
 
 					if (using_named_scene_ids) { // New format.
 						ERR_FAIL_INDEX_V((int)index, internal_resources.size(), ERR_PARSE_ERROR);
+						if (internal_resources[index].loading) {
+							// Cyclic reference, the resource is still being decoded further up.
+							WARN_PRINT(String("Cyclic reference to internal resource, setting it to null: " + internal_resources[index].path).utf8().get_data());
+							r_v = Variant();
+							break;
+						}
+						// Decoded on first use.
+						Error err = _load_internal_resource(index);
+						if (err != OK) {
+							return err;
+						}
 						path = internal_resources[index].path;
 					} else {
 						path += res_path + "::" + itos(index);
@@ -361,19 +446,10 @@ Error ResourceLoaderBinary::parse_variant(Variant &r_v) {
 						r_v = Variant();
 					} else {
 						if (external_resources[erindex].cache.is_null()) {
-							//cache not here yet, wait for it?
-							if (use_sub_threads) {
-								Error err;
-								external_resources.write[erindex].cache = ResourceLoader::load_threaded_get(external_resources[erindex].path, &err);
-
-								if (err != OK || external_resources[erindex].cache.is_null()) {
-									if (!ResourceLoader::get_abort_on_missing_resources()) {
-										ResourceLoader::notify_dependency_error(local_path, external_resources[erindex].path, external_resources[erindex].type);
-									} else {
-										error = ERR_FILE_MISSING_DEPENDENCIES;
-										ERR_FAIL_V_MSG(error, "Can't load dependency: " + external_resources[erindex].path + ".");
-									}
-								}
+							//cache not here yet, wait for it
+							Error err = _join_external_resource(erindex);
+							if (err != OK) {
+								return err;
 							}
 						}
 
@@ -428,8 +504,13 @@ Error ResourceLoaderBinary::parse_variant(Variant &r_v) {
 			Vector<uint8_t> array;
 			array.resize(len);
 			uint8_t *w = array.ptrw();
-			f->get_buffer(w, len);
-			_advance_padding(len);
+			if (ver_format >= FORMAT_VERSION_PACKED_BLOCKS) {
+				Error err = _parse_packed_block(w, len, 1);
+				ERR_FAIL_COND_V(err != OK, err);
+			} else {
+				f->get_buffer(w, len);
+				_advance_padding(len);
+			}
 
 			r_v = array;
 
@@ -440,16 +521,21 @@ Error ResourceLoaderBinary::parse_variant(Variant &r_v) {
 			Vector<int32_t> array;
 			array.resize(len);
 			int32_t *w = array.ptrw();
-			f->get_buffer((uint8_t *)w, len * sizeof(int32_t));
+			if (ver_format >= FORMAT_VERSION_PACKED_BLOCKS) {
+				Error err = _parse_packed_block((uint8_t *)w, len * sizeof(int32_t), sizeof(int32_t));
+				ERR_FAIL_COND_V(err != OK, err);
+			} else {
+				f->get_buffer((uint8_t *)w, len * sizeof(int32_t));
 #ifdef BIG_ENDIAN_ENABLED
-			{
-				uint32_t *ptr = (uint32_t *)w.ptr();
-				for (int i = 0; i < len; i++) {
-					ptr[i] = BSWAP32(ptr[i]);
+				{
+					uint32_t *ptr = (uint32_t *)w.ptr();
+					for (int i = 0; i < len; i++) {
+						ptr[i] = BSWAP32(ptr[i]);
+					}
 				}
-			}
 
 #endif
+			}
 
 			r_v = array;
 		} break;
@@ -459,16 +545,21 @@ Error ResourceLoaderBinary::parse_variant(Variant &r_v) {
 			Vector<int64_t> array;
 			array.resize(len);
 			int64_t *w = array.ptrw();
-			f->get_buffer((uint8_t *)w, len * sizeof(int64_t));
+			if (ver_format >= FORMAT_VERSION_PACKED_BLOCKS) {
+				Error err = _parse_packed_block((uint8_t *)w, len * sizeof(int64_t), sizeof(int64_t));
+				ERR_FAIL_COND_V(err != OK, err);
+			} else {
+				f->get_buffer((uint8_t *)w, len * sizeof(int64_t));
 #ifdef BIG_ENDIAN_ENABLED
-			{
-				uint64_t *ptr = (uint64_t *)w.ptr();
-				for (int i = 0; i < len; i++) {
-					ptr[i] = BSWAP64(ptr[i]);
+				{
+					uint64_t *ptr = (uint64_t *)w.ptr();
+					for (int i = 0; i < len; i++) {
+						ptr[i] = BSWAP64(ptr[i]);
+					}
 				}
-			}
 
 #endif
+			}
 
 			r_v = array;
 		} break;
@@ -478,16 +569,21 @@ Error ResourceLoaderBinary::parse_variant(Variant &r_v) {
 			Vector<float> array;
 			array.resize(len);
 			float *w = array.ptrw();
-			f->get_buffer((uint8_t *)w, len * sizeof(float));
+			if (ver_format >= FORMAT_VERSION_PACKED_BLOCKS) {
+				Error err = _parse_packed_block((uint8_t *)w, len * sizeof(float), sizeof(float));
+				ERR_FAIL_COND_V(err != OK, err);
+			} else {
+				f->get_buffer((uint8_t *)w, len * sizeof(float));
 #ifdef BIG_ENDIAN_ENABLED
-			{
-				uint32_t *ptr = (uint32_t *)w.ptr();
-				for (int i = 0; i < len; i++) {
-					ptr[i] = BSWAP32(ptr[i]);
+				{
+					uint32_t *ptr = (uint32_t *)w.ptr();
+					for (int i = 0; i < len; i++) {
+						ptr[i] = BSWAP32(ptr[i]);
+					}
 				}
-			}
 
 #endif
+			}
 
 			r_v = array;
 		} break;
@@ -497,16 +593,21 @@ Error ResourceLoaderBinary::parse_variant(Variant &r_v) {
 			Vector<double> array;
 			array.resize(len);
 			double *w = array.ptrw();
-			f->get_buffer((uint8_t *)w, len * sizeof(double));
+			if (ver_format >= FORMAT_VERSION_PACKED_BLOCKS) {
+				Error err = _parse_packed_block((uint8_t *)w, len * sizeof(double), sizeof(double));
+				ERR_FAIL_COND_V(err != OK, err);
+			} else {
+				f->get_buffer((uint8_t *)w, len * sizeof(double));
 #ifdef BIG_ENDIAN_ENABLED
-			{
-				uint64_t *ptr = (uint64_t *)w.ptr();
-				for (int i = 0; i < len; i++) {
-					ptr[i] = BSWAP64(ptr[i]);
+				{
+					uint64_t *ptr = (uint64_t *)w.ptr();
+					for (int i = 0; i < len; i++) {
+						ptr[i] = BSWAP64(ptr[i]);
+					}
 				}
-			}
 
 #endif
+			}
 
 			r_v = array;
 		} break;
@@ -528,7 +629,10 @@ Error ResourceLoaderBinary::parse_variant(Variant &r_v) {
 			Vector<Vector2> array;
 			array.resize(len);
 			Vector2 *w = array.ptrw();
-			if (sizeof(Vector2) == 8) {
+			if (ver_format >= FORMAT_VERSION_PACKED_BLOCKS) {
+				Error err = _parse_packed_block((uint8_t *)w, len * sizeof(Vector2), sizeof(real_t));
+				ERR_FAIL_COND_V(err != OK, err);
+			} else if (sizeof(Vector2) == 8) {
 				f->get_buffer((uint8_t *)w, len * sizeof(real_t) * 2);
 #ifdef BIG_ENDIAN_ENABLED
 				{
@@ -553,7 +657,10 @@ Error ResourceLoaderBinary::parse_variant(Variant &r_v) {
 			Vector<Vector3> array;
 			array.resize(len);
 			Vector3 *w = array.ptrw();
-			if (sizeof(Vector3) == 12) {
+			if (ver_format >= FORMAT_VERSION_PACKED_BLOCKS) {
+				Error err = _parse_packed_block((uint8_t *)w, len * sizeof(Vector3), sizeof(real_t));
+				ERR_FAIL_COND_V(err != OK, err);
+			} else if (sizeof(Vector3) == 12) {
 				f->get_buffer((uint8_t *)w, len * sizeof(real_t) * 3);
 #ifdef BIG_ENDIAN_ENABLED
 				{
@@ -578,7 +685,10 @@ Error ResourceLoaderBinary::parse_variant(Variant &r_v) {
 			Vector<Color> array;
 			array.resize(len);
 			Color *w = array.ptrw();
-			if (sizeof(Color) == 16) {
+			if (ver_format >= FORMAT_VERSION_PACKED_BLOCKS) {
+				Error err = _parse_packed_block((uint8_t *)w, len * sizeof(Color), sizeof(float));
+				ERR_FAIL_COND_V(err != OK, err);
+			} else if (sizeof(Color) == 16) {
 				f->get_buffer((uint8_t *)w, len * sizeof(real_t) * 4);
 #ifdef BIG_ENDIAN_ENABLED
 				{
@@ -612,6 +722,47 @@ Ref<Resource> ResourceLoaderBinary::get_resource() {
 	return resource;
 }
 
+Error ResourceLoaderBinary::_join_external_resource(int p_index) {
+	int shared_index = external_resources[p_index].shared_index;
+	if (shared_index != -1) {
+		Error err = _join_external_resource(shared_index);
+		external_resources.write[p_index].cache = external_resources[shared_index].cache;
+		return err;
+	}
+
+	ExtResource &er = external_resources.write[p_index];
+	if (!er.requested) {
+		return OK;
+	}
+
+	er.requested = false;
+
+	Error err;
+	er.cache = ResourceLoader::load_threaded_get(er.path, &err);
+
+	if (err != OK || er.cache.is_null()) {
+		if (!ResourceLoader::get_abort_on_missing_resources()) {
+			ResourceLoader::notify_dependency_error(local_path, er.path, er.type);
+		} else {
+			error = ERR_FILE_MISSING_DEPENDENCIES;
+			ERR_FAIL_V_MSG(error, "Can't load dependency: " + er.path + ".");
+		}
+	}
+
+	return OK;
+}
+
+void ResourceLoaderBinary::_release_external_resources() {
+	// Threaded loads that were never referenced still have to be joined,
+	// otherwise their load tasks are never released.
+	for (int i = 0; i < external_resources.size(); i++) {
+		if (external_resources[i].requested) {
+			external_resources.write[i].requested = false;
+			ResourceLoader::load_threaded_get(external_resources[i].path);
+		}
+	}
+}
+
 Error ResourceLoaderBinary::load() {
 	if (error != OK) {
 		return error;
@@ -619,6 +770,10 @@ Error ResourceLoaderBinary::load() {
 
 	int stage = 0;
 
+	// The same path may be listed more than once (e.g. by UID and by path),
+	// only the first entry loads it.
+	Map<String, int> external_paths;
+
 	for (int i = 0; i < external_resources.size(); i++) {
 		String path = external_resources[i].path;
 
@@ -633,6 +788,17 @@ Error ResourceLoaderBinary::load() {
 
 		external_resources.write[i].path = path; //remap happens here, not on load because on load it can actually be used for filesystem dock resource remap
 
+		Map<String, int>::Element *E = external_paths.find(path);
+		if (E) {
+			external_resources.write[i].shared_index = E->get();
+			if (!use_sub_threads) {
+				external_resources.write[i].cache = external_resources[E->get()].cache;
+			}
+			stage++;
+			continue;
+		}
+		external_paths[path] = i;
+
 		if (!use_sub_threads) {
 			external_resources.write[i].cache = ResourceLoader::load(path, external_resources[i].type);
 
@@ -647,7 +813,9 @@ Error ResourceLoaderBinary::load() {
 
 		} else {
 			Error err = ResourceLoader::load_threaded_request(path, external_resources[i].type, use_sub_threads, ResourceFormatLoader::CACHE_MODE_REUSE, local_path);
-			if (err != OK) {
+			if (err == OK) {
+				external_resources.write[i].requested = true;
+			} else {
 				if (!ResourceLoader::get_abort_on_missing_resources()) {
 					ResourceLoader::notify_dependency_error(local_path, path, external_resources[i].type);
 				} else {
@@ -660,125 +828,193 @@ Error ResourceLoaderBinary::load() {
 		stage++;
 	}
 
-	for (int i = 0; i < internal_resources.size(); i++) {
-		bool main = i == (internal_resources.size() - 1);
+	if (internal_resources.is_empty()) {
+		return ERR_FILE_EOF;
+	}
 
-		//maybe it is loaded already
-		String path;
-		String id;
+	int main_index = internal_resources.size() - 1;
 
-		if (!main) {
-			path = internal_resources[i].path;
+	// Resources refer to each other by path, so all are needed before decoding any.
+	for (int i = 0; i < main_index; i++) {
+		String path = internal_resources[i].path;
 
-			if (path.begins_with("local://")) {
-				path = path.replace_first("local://", "");
-				id = path;
-				path = res_path + "::" + path;
+		if (path.begins_with("local://")) {
+			path = path.replace_first("local://", "");
+			internal_resources.write[i].id = path;
+			internal_resources.write[i].path = res_path + "::" + path; // Update path.
+		}
+	}
 
-				internal_resources.write[i].path = path; // Update path.
+	if (!using_named_scene_ids) {
+		// Old files refer to sub-resources through the cache only, so all must be loaded in order.
+		for (int i = 0; i < main_index; i++) {
+			Error err = _load_internal_resource(i);
+			if (err != OK) {
+				return err;
 			}
+		}
+	}
 
-			if (cache_mode == ResourceFormatLoader::CACHE_MODE_REUSE) {
-				if (ResourceCache::has(path)) {
-					//already loaded, don't do anything
-					stage++;
-					error = OK;
-					continue;
-				}
-			}
-		} else {
-			if (cache_mode != ResourceFormatLoader::CACHE_MODE_IGNORE && !ResourceCache::has(res_path)) {
-				path = res_path;
+	// Sub-resources are decoded as they are found while decoding the main one,
+	// so the ones nothing refers to are never loaded.
+	Error err = _load_internal_resource(main_index);
+	if (err != OK) {
+		return err;
+	}
+
+	_release_external_resources();
+	f->close();
+	resource = internal_resources[main_index].cache;
+	resource->set_as_translation_remapped(translation_remapped);
+	error = OK;
+	return OK;
+}
+
+Error ResourceLoaderBinary::_load_internal_resource(int p_index) {
+	if (internal_resources[p_index].loaded) {
+		return OK;
+	}
+
+	bool main = p_index == (internal_resources.size() - 1);
+
+	//maybe it is loaded already
+	String path;
+	String id = internal_resources[p_index].id;
+
+	if (!main) {
+		path = internal_resources[p_index].path;
+
+		if (cache_mode == ResourceFormatLoader::CACHE_MODE_REUSE) {
+			if (ResourceCache::has(path)) {
+				//already loaded, don't do anything
+				RES cached = RES(ResourceCache::get(path));
+				internal_index_cache[path] = cached;
+				internal_resources.write[p_index].cache = cached;
+				internal_resources.write[p_index].loaded = true;
+				loaded_internal_count++;
+				return OK;
 			}
 		}
+	} else {
+		if (cache_mode != ResourceFormatLoader::CACHE_MODE_IGNORE && !ResourceCache::has(res_path)) {
+			path = res_path;
+		}
+	}
 
-		uint64_t offset = internal_resources[i].offset;
+	internal_resources.write[p_index].loading = true;
 
-		f->seek(offset);
+	// This may be called while in the middle of decoding another resource.
+	uint64_t prev_offset = f->get_position();
+	uint64_t offset = internal_resources[p_index].offset;
 
-		String t = get_unicode_string();
+	f->seek(offset);
 
-		RES res;
+	String t = get_unicode_string();
 
-		if (cache_mode == ResourceFormatLoader::CACHE_MODE_REPLACE && ResourceCache::has(path)) {
-			//use the existing one
-			Resource *r = ResourceCache::get(path);
-			if (r->get_class() == t) {
-				r->reset_state();
-				res = Ref<Resource>(r);
-			}
+	RES res;
+
+	bool shareable = !main && deduplicate && cache_mode == ResourceFormatLoader::CACHE_MODE_REUSE && internal_resources[p_index].content_hash;
+	if (shareable) {
+		// Identical contents were already loaded from another file, reuse them.
+		RES shared = ResourceCache::get_by_content_hash(internal_resources[p_index].content_hash);
+		if (shared.is_valid() && shared->get_class() == t) {
+			res = shared;
+			internal_index_cache[path] = res;
+			f->seek(prev_offset);
+
+			internal_resources.write[p_index].cache = res;
+			internal_resources.write[p_index].loading = false;
+			internal_resources.write[p_index].loaded = true;
+			loaded_internal_count++;
+			resource_cache.push_back(res);
+
+			// Resources are stored in the order of the table, the main one being last.
+			ResourceCache::add_deduplicated(internal_resources[p_index + 1].offset - offset);
+			return OK;
 		}
+	}
 
-		if (res.is_null()) {
-			//did not replace
+	if (cache_mode == ResourceFormatLoader::CACHE_MODE_REPLACE && ResourceCache::has(path)) {
+		//use the existing one
+		Resource *r = ResourceCache::get(path);
+		if (r->get_class() == t) {
+			r->reset_state();
+			res = Ref<Resource>(r);
+		}
+	}
 
-			Object *obj = ClassDB::instantiate(t);
-			if (!obj) {
-				error = ERR_FILE_CORRUPT;
-				ERR_FAIL_V_MSG(ERR_FILE_CORRUPT, local_path + ":Resource of unrecognized type in file: " + t + ".");
-			}
+	if (res.is_null()) {
+		//did not replace
 
-			Resource *r = Object::cast_to<Resource>(obj);
-			if (!r) {
-				String obj_class = obj->get_class();
-				error = ERR_FILE_CORRUPT;
-				memdelete(obj); //bye
-				ERR_FAIL_V_MSG(ERR_FILE_CORRUPT, local_path + ":Resource type in resource field not a resource, type is: " + obj_class + ".");
-			}
+		Object *obj = ClassDB::instantiate(t);
+		if (!obj) {
+			error = ERR_FILE_CORRUPT;
+			ERR_FAIL_V_MSG(ERR_FILE_CORRUPT, local_path + ":Resource of unrecognized type in file: " + t + ".");
+		}
 
-			res = RES(r);
-			if (path != String() && cache_mode != ResourceFormatLoader::CACHE_MODE_IGNORE) {
-				r->set_path(path, cache_mode == ResourceFormatLoader::CACHE_MODE_REPLACE); //if got here because the resource with same path has different type, replace it
-			}
-			r->set_scene_unique_id(id);
+		Resource *r = Object::cast_to<Resource>(obj);
+		if (!r) {
+			String obj_class = obj->get_class();
+			error = ERR_FILE_CORRUPT;
+			memdelete(obj); //bye
+			ERR_FAIL_V_MSG(ERR_FILE_CORRUPT, local_path + ":Resource type in resource field not a resource, type is: " + obj_class + ".");
 		}
 
-		if (!main) {
-			internal_index_cache[path] = res;
+		res = RES(r);
+		if (path != String() && cache_mode != ResourceFormatLoader::CACHE_MODE_IGNORE) {
+			r->set_path(path, cache_mode == ResourceFormatLoader::CACHE_MODE_REPLACE); //if got here because the resource with same path has different type, replace it
 		}
+		r->set_scene_unique_id(id);
+	}
 
-		int pc = f->get_32();
+	if (!main) {
+		internal_index_cache[path] = res;
+	}
 
-		//set properties
+	int pc = f->get_32();
 
-		for (int j = 0; j < pc; j++) {
-			StringName name = _get_string();
+	//set properties
 
-			if (name == StringName()) {
-				error = ERR_FILE_CORRUPT;
-				ERR_FAIL_V(ERR_FILE_CORRUPT);
-			}
+	for (int j = 0; j < pc; j++) {
+		StringName name = _get_string();
 
-			Variant value;
+		if (name == StringName()) {
+			error = ERR_FILE_CORRUPT;
+			ERR_FAIL_V(ERR_FILE_CORRUPT);
+		}
 
-			error = parse_variant(value);
-			if (error) {
-				return error;
-			}
+		Variant value;
 
-			res->set(name, value);
+		error = parse_variant(value);
+		if (error) {
+			return error;
 		}
+
+		res->set(name, value);
+	}
 #ifdef TOOLS_ENABLED
-		res->set_edited(false);
+	res->set_edited(false);
 #endif
-		stage++;
 
-		if (progress) {
-			*progress = (i + 1) / float(internal_resources.size());
-		}
+	if (shareable && !res->is_local_to_scene()) {
+		ResourceCache::set_content_hash(res.ptr(), internal_resources[p_index].content_hash);
+	}
 
-		resource_cache.push_back(res);
+	f->seek(prev_offset);
 
-		if (main) {
-			f->close();
-			resource = res;
-			resource->set_as_translation_remapped(translation_remapped);
-			error = OK;
-			return OK;
-		}
+	internal_resources.write[p_index].cache = res;
+	internal_resources.write[p_index].loading = false;
+	internal_resources.write[p_index].loaded = true;
+
+	// Decoded lazily and out of order, so report how many are done rather than the index.
+	loaded_internal_count++;
+	if (progress) {
+		*progress = loaded_internal_count / float(internal_resources.size());
 	}
 
-	return ERR_FILE_EOF;
+	resource_cache.push_back(res);
+
+	return OK;
 }
 
 void ResourceLoaderBinary::set_translation_remapped(bool p_remapped) {
@@ -899,6 +1135,11 @@ void ResourceLoaderBinary::open(FileAccess *p_f, bool p_no_resources, bool p_kee
 	if (flags & ResourceFormatSaverBinaryInstance::FORMAT_FLAG_UIDS) {
 		using_uids = true;
 	}
+	if (flags & ResourceFormatSaverBinaryInstance::FORMAT_FLAG_CONTENT_HASHES) {
+		using_content_hashes = true;
+		// Sharing built-in resources between scenes would make editing one affect the others.
+		deduplicate = !Engine::get_singleton()->is_editor_hint() && bool(GLOBAL_GET("resource_loader/deduplicate_built_in_resources"));
+	}
 
 	if (using_uids) {
 		uid = f->get_64();
@@ -951,6 +1192,9 @@ void ResourceLoaderBinary::open(FileAccess *p_f, bool p_no_resources, bool p_kee
 		IntResource ir;
 		ir.path = get_unicode_string();
 		ir.offset = f->get_64();
+		if (using_content_hashes) {
+			ir.content_hash = f->get_64();
+		}
 		internal_resources.push_back(ir);
 	}
 
@@ -1007,6 +1251,7 @@ String ResourceLoaderBinary::recognize(FileAccess *p_f) {
 }
 
 ResourceLoaderBinary::~ResourceLoaderBinary() {
+	_release_external_resources();
 	if (f) {
 		memdelete(f);
 	}
@@ -1280,6 +1525,9 @@ Error ResourceFormatLoaderBinary::rename_dependencies(const String &p_path, cons
 		uint64_t offset = f->get_64();
 		save_ustring(fw, path);
 		fw->store_64(offset + size_diff);
+		if (flags & ResourceFormatSaverBinaryInstance::FORMAT_FLAG_CONTENT_HASHES) {
+			fw->store_64(f->get_64());
+		}
 	}
 
 	//rest of file
@@ -1357,7 +1605,47 @@ void ResourceFormatSaverBinaryInstance::_pad_buffer(FileAccess *f, int p_bytes)
 	}
 }
 
-void ResourceFormatSaverBinaryInstance::write_variant(FileAccess *f, const Variant &p_property, Map<RES, int> &resource_map, Map<RES, int> &external_resources, Map<StringName, int> &string_map, const PropertyInfo &p_hint) {
+void ResourceFormatSaverBinaryInstance::_store_packed_block(FileAccess *f, const uint8_t *p_data, uint64_t p_size, uint32_t p_component_size, PackedArrayMode p_mode) {
+	Vector<uint8_t> swapped;
+	if (_is_packed_block_swapped(f) && p_component_size > 1) {
+		swapped.resize(p_size);
+		memcpy(swapped.ptrw(), p_data, p_size);
+		_swap_packed_block(swapped.ptrw(), p_size, p_component_size);
+		p_data = swapped.ptr();
+	}
+
+	uint32_t block_flags = 0;
+	Vector<uint8_t> compressed;
+	if (p_mode == PACKED_ARRAY_BLOCKS_COMPRESSED && p_size >= PACKED_BLOCK_COMPRESS_MIN_SIZE) {
+		compressed.resize(Compression::get_max_compressed_buffer_size(p_size, Compression::MODE_ZSTD));
+		int compressed_size = Compression::compress(compressed.ptrw(), p_data, p_size, Compression::MODE_ZSTD);
+		// Not worth decompressing if it barely saves anything.
+		if (compressed_size > 0 && uint64_t(compressed_size) < p_size - p_size / 8) {
+			compressed.resize(compressed_size);
+			block_flags |= PACKED_BLOCK_FLAG_COMPRESSED;
+		}
+	}
+
+	f->store_32(block_flags);
+	if (block_flags & PACKED_BLOCK_FLAG_COMPRESSED) {
+		f->store_32(compressed.size());
+		p_data = compressed.ptr();
+		p_size = compressed.size();
+	}
+
+	// Padding is stored rather than implied by the position, so blocks are still
+	// readable if the file contents are moved around (e.g. when renaming dependencies).
+	uint32_t padding = (PACKED_BLOCK_ALIGNMENT - ((f->get_position() + 4) % PACKED_BLOCK_ALIGNMENT)) % PACKED_BLOCK_ALIGNMENT;
+	f->store_32(padding);
+	for (uint32_t i = 0; i < padding; i++) {
+		f->store_8(0);
+	}
+
+	f->store_buffer(p_data, p_size);
+	_pad_buffer(f, p_size);
+}
+
+void ResourceFormatSaverBinaryInstance::write_variant(FileAccess *f, const Variant &p_property, Map<RES, int> &resource_map, Map<RES, int> &external_resources, Map<StringName, int> &string_map, const PropertyInfo &p_hint, PackedArrayMode p_packed_array_mode) {
 	switch (p_property.get_type()) {
 		case Variant::NIL: {
 			f->store_32(VARIANT_NIL);
@@ -1610,8 +1898,8 @@ void ResourceFormatSaverBinaryInstance::write_variant(FileAccess *f, const Varia
 					continue;
 				*/
 
-				write_variant(f, E, resource_map, external_resources, string_map);
-				write_variant(f, d[E], resource_map, external_resources, string_map);
+				write_variant(f, E, resource_map, external_resources, string_map, PropertyInfo(), p_packed_array_mode);
+				write_variant(f, d[E], resource_map, external_resources, string_map, PropertyInfo(), p_packed_array_mode);
 			}
 
 		} break;
@@ -1620,7 +1908,7 @@ void ResourceFormatSaverBinaryInstance::write_variant(FileAccess *f, const Varia
 			Array a = p_property;
 			f->store_32(uint32_t(a.size()));
 			for (int i = 0; i < a.size(); i++) {
-				write_variant(f, a[i], resource_map, external_resources, string_map);
+				write_variant(f, a[i], resource_map, external_resources, string_map, PropertyInfo(), p_packed_array_mode);
 			}
 
 		} break;
@@ -1630,8 +1918,12 @@ void ResourceFormatSaverBinaryInstance::write_variant(FileAccess *f, const Varia
 			int len = arr.size();
 			f->store_32(len);
 			const uint8_t *r = arr.ptr();
-			f->store_buffer(r, len);
-			_pad_buffer(f, len);
+			if (p_packed_array_mode != PACKED_ARRAY_INLINE) {
+				_store_packed_block(f, r, len, 1, p_packed_array_mode);
+			} else {
+				f->store_buffer(r, len);
+				_pad_buffer(f, len);
+			}
 
 		} break;
 		case Variant::PACKED_INT32_ARRAY: {
@@ -1640,8 +1932,12 @@ void ResourceFormatSaverBinaryInstance::write_variant(FileAccess *f, const Varia
 			int len = arr.size();
 			f->store_32(len);
 			const int32_t *r = arr.ptr();
-			for (int i = 0; i < len; i++) {
-				f->store_32(r[i]);
+			if (p_packed_array_mode != PACKED_ARRAY_INLINE) {
+				_store_packed_block(f, (const uint8_t *)r, len * sizeof(int32_t), sizeof(int32_t), p_packed_array_mode);
+			} else {
+				for (int i = 0; i < len; i++) {
+					f->store_32(r[i]);
+				}
 			}
 
 		} break;
@@ -1651,8 +1947,12 @@ void ResourceFormatSaverBinaryInstance::write_variant(FileAccess *f, const Varia
 			int len = arr.size();
 			f->store_32(len);
 			const int64_t *r = arr.ptr();
-			for (int i = 0; i < len; i++) {
-				f->store_64(r[i]);
+			if (p_packed_array_mode != PACKED_ARRAY_INLINE) {
+				_store_packed_block(f, (const uint8_t *)r, len * sizeof(int64_t), sizeof(int64_t), p_packed_array_mode);
+			} else {
+				for (int i = 0; i < len; i++) {
+					f->store_64(r[i]);
+				}
 			}
 
 		} break;
@@ -1662,8 +1962,12 @@ void ResourceFormatSaverBinaryInstance::write_variant(FileAccess *f, const Varia
 			int len = arr.size();
 			f->store_32(len);
 			const float *r = arr.ptr();
-			for (int i = 0; i < len; i++) {
-				f->store_real(r[i]);
+			if (p_packed_array_mode != PACKED_ARRAY_INLINE) {
+				_store_packed_block(f, (const uint8_t *)r, len * sizeof(float), sizeof(float), p_packed_array_mode);
+			} else {
+				for (int i = 0; i < len; i++) {
+					f->store_real(r[i]);
+				}
 			}
 
 		} break;
@@ -1673,8 +1977,12 @@ void ResourceFormatSaverBinaryInstance::write_variant(FileAccess *f, const Varia
 			int len = arr.size();
 			f->store_32(len);
 			const double *r = arr.ptr();
-			for (int i = 0; i < len; i++) {
-				f->store_double(r[i]);
+			if (p_packed_array_mode != PACKED_ARRAY_INLINE) {
+				_store_packed_block(f, (const uint8_t *)r, len * sizeof(double), sizeof(double), p_packed_array_mode);
+			} else {
+				for (int i = 0; i < len; i++) {
+					f->store_double(r[i]);
+				}
 			}
 
 		} break;
@@ -1695,10 +2003,14 @@ void ResourceFormatSaverBinaryInstance::write_variant(FileAccess *f, const Varia
 			int len = arr.size();
 			f->store_32(len);
 			const Vector3 *r = arr.ptr();
-			for (int i = 0; i < len; i++) {
-				f->store_real(r[i].x);
-				f->store_real(r[i].y);
-				f->store_real(r[i].z);
+			if (p_packed_array_mode != PACKED_ARRAY_INLINE) {
+				_store_packed_block(f, (const uint8_t *)r, len * sizeof(Vector3), sizeof(real_t), p_packed_array_mode);
+			} else {
+				for (int i = 0; i < len; i++) {
+					f->store_real(r[i].x);
+					f->store_real(r[i].y);
+					f->store_real(r[i].z);
+				}
 			}
 
 		} break;
@@ -1708,9 +2020,13 @@ void ResourceFormatSaverBinaryInstance::write_variant(FileAccess *f, const Varia
 			int len = arr.size();
 			f->store_32(len);
 			const Vector2 *r = arr.ptr();
-			for (int i = 0; i < len; i++) {
-				f->store_real(r[i].x);
-				f->store_real(r[i].y);
+			if (p_packed_array_mode != PACKED_ARRAY_INLINE) {
+				_store_packed_block(f, (const uint8_t *)r, len * sizeof(Vector2), sizeof(real_t), p_packed_array_mode);
+			} else {
+				for (int i = 0; i < len; i++) {
+					f->store_real(r[i].x);
+					f->store_real(r[i].y);
+				}
 			}
 
 		} break;
@@ -1720,11 +2036,15 @@ void ResourceFormatSaverBinaryInstance::write_variant(FileAccess *f, const Varia
 			int len = arr.size();
 			f->store_32(len);
 			const Color *r = arr.ptr();
-			for (int i = 0; i < len; i++) {
-				f->store_real(r[i].r);
-				f->store_real(r[i].g);
-				f->store_real(r[i].b);
-				f->store_real(r[i].a);
+			if (p_packed_array_mode != PACKED_ARRAY_INLINE) {
+				_store_packed_block(f, (const uint8_t *)r, len * sizeof(Color), sizeof(float), p_packed_array_mode);
+			} else {
+				for (int i = 0; i < len; i++) {
+					f->store_real(r[i].r);
+					f->store_real(r[i].g);
+					f->store_real(r[i].b);
+					f->store_real(r[i].a);
+				}
 			}
 
 		} break;
@@ -1821,6 +2141,96 @@ void ResourceFormatSaverBinaryInstance::_find_resources(const Variant &p_variant
 	}
 }
 
+static bool _hash_variant(CryptoCore::MD5Context &p_ctx, const Variant &p_variant, const Map<RES, int> &p_external_resources, const Map<RES, uint64_t> &p_hashes) {
+	uint8_t type = p_variant.get_type();
+	p_ctx.update(&type, 1);
+
+	switch (p_variant.get_type()) {
+		case Variant::OBJECT: {
+			RES res = p_variant;
+			if (res.is_null()) {
+				return true;
+			}
+
+			if (p_external_resources.has(res)) {
+				CharString path = res->get_path().utf8();
+				p_ctx.update((const uint8_t *)path.get_data(), path.length() + 1);
+				return true;
+			}
+
+			// Built-in resources are hashed before the ones referring to them.
+			const Map<RES, uint64_t>::Element *E = p_hashes.find(res);
+			if (!E || E->get() == 0) {
+				return false;
+			}
+			uint64_t hash = E->get();
+			p_ctx.update((const uint8_t *)&hash, sizeof(hash));
+		} break;
+		case Variant::ARRAY: {
+			Array array = p_variant;
+			uint32_t size = array.size();
+			p_ctx.update((const uint8_t *)&size, sizeof(size));
+			for (uint32_t i = 0; i < size; i++) {
+				if (!_hash_variant(p_ctx, array[i], p_external_resources, p_hashes)) {
+					return false;
+				}
+			}
+		} break;
+		case Variant::DICTIONARY: {
+			Dictionary d = p_variant;
+			List<Variant> keys;
+			d.get_key_list(&keys);
+			uint32_t size = keys.size();
+			p_ctx.update((const uint8_t *)&size, sizeof(size));
+			for (const Variant &E : keys) {
+				if (!_hash_variant(p_ctx, E, p_external_resources, p_hashes) || !_hash_variant(p_ctx, d[E], p_external_resources, p_hashes)) {
+					return false;
+				}
+			}
+		} break;
+		default: {
+			int len = 0;
+			Error err = encode_variant(p_variant, nullptr, len, false);
+			ERR_FAIL_COND_V(err != OK, false);
+			Vector<uint8_t> buf;
+			buf.resize(len);
+			encode_variant(p_variant, buf.ptrw(), len, false);
+			p_ctx.update(buf.ptr(), len);
+		} break;
+	}
+
+	return true;
+}
+
+uint64_t ResourceFormatSaverBinaryInstance::_get_content_hash(const RES &p_resource, const ResourceData &p_data, const Map<RES, uint64_t> &p_hashes) const {
+	if (p_resource->is_local_to_scene()) {
+		return 0; // Must be duplicated for each scene anyway.
+	}
+
+	CryptoCore::MD5Context ctx;
+	ctx.start();
+
+	CharString type = p_data.type.utf8();
+	ctx.update((const uint8_t *)type.get_data(), type.length() + 1);
+
+	for (const Property &p : p_data.properties) {
+		CharString name = String(strings[p.name_idx]).utf8();
+		ctx.update((const uint8_t *)name.get_data(), name.length() + 1);
+		if (!_hash_variant(ctx, p.value, external_resources, p_hashes)) {
+			return 0;
+		}
+	}
+
+	unsigned char md5[16];
+	ctx.finish(md5);
+
+	uint64_t hash = 0;
+	for (int i = 0; i < 8; i++) {
+		hash = (hash << 8) | md5[i];
+	}
+	return hash == 0 ? 1 : hash; // Zero means no hash.
+}
+
 void ResourceFormatSaverBinaryInstance::save_unicode_string(FileAccess *f, const String &p_string, bool p_bit_on_len) {
 	CharString utf8 = p_string.utf8();
 	if (p_bit_on_len) {
@@ -1863,6 +2273,7 @@ Error ResourceFormatSaverBinaryInstance::save(const String &p_path, const RES &p
 	skip_editor = p_flags & ResourceSaver::FLAG_OMIT_EDITOR_PROPERTIES;
 	bundle_resources = p_flags & ResourceSaver::FLAG_BUNDLE_RESOURCES;
 	big_endian = p_flags & ResourceSaver::FLAG_SAVE_BIG_ENDIAN;
+	compress_packed_arrays = p_flags & ResourceSaver::FLAG_COMPRESS_PACKED_ARRAYS;
 	takeover_paths = p_flags & ResourceSaver::FLAG_REPLACE_SUBRESOURCE_PATHS;
 
 	if (!p_path.begins_with("res://")) {
@@ -1900,7 +2311,7 @@ Error ResourceFormatSaverBinaryInstance::save(const String &p_path, const RES &p
 
 	save_unicode_string(f, p_resource->get_class());
 	f->store_64(0); //offset to import metadata
-	f->store_32(FORMAT_FLAG_NAMED_SCENE_IDS | FORMAT_FLAG_UIDS);
+	f->store_32(FORMAT_FLAG_NAMED_SCENE_IDS | FORMAT_FLAG_UIDS | FORMAT_FLAG_CONTENT_HASHES);
 	ResourceUID::ID uid = ResourceSaver::get_resource_id_for_path(p_path, true);
 	f->store_64(uid);
 	for (int i = 0; i < ResourceFormatSaverBinaryInstance::RESERVED_FIELDS; i++) {
@@ -1908,6 +2319,7 @@ Error ResourceFormatSaverBinaryInstance::save(const String &p_path, const RES &p
 	}
 
 	List<ResourceData> resources;
+	Map<RES, uint64_t> content_hashes;
 
 	{
 		for (const RES &E : saved_resources) {
@@ -1947,6 +2359,12 @@ Error ResourceFormatSaverBinaryInstance::save(const String &p_path, const RES &p
 					rd.properties.push_back(p);
 				}
 			}
+
+			// Lets loaders share identical built-in resources between files.
+			if (E != p_resource && (E->get_path() == "" || E->get_path().find("::") != -1)) {
+				rd.content_hash = _get_content_hash(E, rd, content_hashes);
+				content_hashes[E] = rd.content_hash;
+			}
 		}
 	}
 
@@ -1991,6 +2409,7 @@ Error ResourceFormatSaverBinaryInstance::save(const String &p_path, const RES &p
 
 	Map<RES, int> resource_map;
 	int res_index = 0;
+	const List<ResourceData>::Element *rd_element = resources.front();
 	for (RES &r : saved_resources) {
 		if (r->get_path() == "" || r->get_path().find("::") != -1) {
 			if (r->get_scene_unique_id() == "") {
@@ -2019,6 +2438,8 @@ Error ResourceFormatSaverBinaryInstance::save(const String &p_path, const RES &p
 		}
 		ofs_pos.push_back(f->get_position());
 		f->store_64(0); //offset in 64 bits
+		f->store_64(rd_element->get().content_hash);
+		rd_element = rd_element->next();
 		resource_map[r] = res_index++;
 	}
 
@@ -2032,7 +2453,7 @@ Error ResourceFormatSaverBinaryInstance::save(const String &p_path, const RES &p
 
 		for (const Property &p : rd.properties) {
 			f->store_32(p.name_idx);
-			write_variant(f, p.value, resource_map, external_resources, string_map, p.pi);
+			write_variant(f, p.value, resource_map, external_resources, string_map, p.pi, compress_packed_arrays ? PACKED_ARRAY_BLOCKS_COMPRESSED : PACKED_ARRAY_BLOCKS);
 		}
 	}
 
@@ -61,24 +61,35 @@ class ResourceLoaderBinary {
 		String type;
 		ResourceUID::ID uid = ResourceUID::INVALID_ID;
 		RES cache;
+		int shared_index = -1; // Earlier entry loading the same path.
+		bool requested = false; // Loading in a thread, must be joined.
 	};
 
 	bool using_named_scene_ids = false;
 	bool using_uids = false;
+	bool using_content_hashes = false;
+	bool deduplicate = false;
 	bool use_sub_threads = false;
 	float *progress = nullptr;
 	Vector<ExtResource> external_resources;
 
 	struct IntResource {
 		String path;
+		String id;
 		uint64_t offset;
+		uint64_t content_hash = 0; // Zero if the resource can't be shared between files.
+		RES cache;
+		bool loading = false;
+		bool loaded = false;
 	};
 
 	Vector<IntResource> internal_resources;
+	int loaded_internal_count = 0;
 	Map<String, RES> internal_index_cache;
 
 	String get_unicode_string();
 	void _advance_padding(uint32_t p_len);
+	Error _parse_packed_block(uint8_t *p_dst, uint64_t p_size, uint32_t p_component_size);
 
 	Map<String, String> remaps;
 	Error error = OK;
@@ -88,6 +99,10 @@ class ResourceLoaderBinary {
 	friend class ResourceFormatLoaderBinary;
 
 	Error parse_variant(Variant &r_v);
+	Error _load_internal_resource(int p_index);
+
+	Error _join_external_resource(int p_index);
+	void _release_external_resources();
 
 	Map<String, RES> dependency_cache;
 
@@ -119,6 +134,14 @@ public:
 };
 
 class ResourceFormatSaverBinaryInstance {
+public:
+	enum PackedArrayMode {
+		PACKED_ARRAY_INLINE, // Element by element, as in format version 4 and older.
+		PACKED_ARRAY_BLOCKS, // Aligned raw blocks.
+		PACKED_ARRAY_BLOCKS_COMPRESSED, // Aligned raw blocks, large ones compressed with Zstandard.
+	};
+
+private:
 	String local_path;
 	String path;
 
@@ -127,6 +150,7 @@ class ResourceFormatSaverBinaryInstance {
 	bool skip_editor;
 	bool big_endian;
 	bool takeover_paths;
+	bool compress_packed_arrays;
 	FileAccess *f;
 	String magic;
 	Set<RES> resource_set;
@@ -153,10 +177,13 @@ class ResourceFormatSaverBinaryInstance {
 	struct ResourceData {
 		String type;
 		List<Property> properties;
+		uint64_t content_hash = 0;
 	};
 
 	static void _pad_buffer(FileAccess *f, int p_bytes);
+	static void _store_packed_block(FileAccess *f, const uint8_t *p_data, uint64_t p_size, uint32_t p_component_size, PackedArrayMode p_mode);
 	void _find_resources(const Variant &p_variant, bool p_main = false);
+	uint64_t _get_content_hash(const RES &p_resource, const ResourceData &p_data, const Map<RES, uint64_t> &p_hashes) const;
 	static void save_unicode_string(FileAccess *f, const String &p_string, bool p_bit_on_len = false);
 	int get_string_index(const String &p_string);
 
@@ -164,11 +191,13 @@ public:
 	enum {
 		FORMAT_FLAG_NAMED_SCENE_IDS = 1,
 		FORMAT_FLAG_UIDS = 2,
+		FORMAT_FLAG_CONTENT_HASHES = 4,
 		// Amount of reserved 32-bit fields in resource header
 		RESERVED_FIELDS = 11
 	};
+
 	Error save(const String &p_path, const RES &p_resource, uint32_t p_flags = 0);
-	static void write_variant(FileAccess *f, const Variant &p_property, Map<RES, int> &resource_map, Map<RES, int> &external_resources, Map<StringName, int> &string_map, const PropertyInfo &p_hint = PropertyInfo());
+	static void write_variant(FileAccess *f, const Variant &p_property, Map<RES, int> &resource_map, Map<RES, int> &external_resources, Map<StringName, int> &string_map, const PropertyInfo &p_hint = PropertyInfo(), PackedArrayMode p_packed_array_mode = PACKED_ARRAY_INLINE);
 };
 
 class ResourceFormatSaverBinary : public ResourceFormatSaver {
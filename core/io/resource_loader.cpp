@@ -217,10 +217,6 @@ void ResourceLoader::_thread_load_function(void *p_userdata) {
 	ThreadLoadTask &load_task = *(ThreadLoadTask *)p_userdata;
 	load_task.loader_id = Thread::get_caller_id();
 
-	if (load_task.semaphore) {
-		//this is an actual thread, so wait for Ok from semaphore
-		thread_load_semaphore->wait(); //wait until its ok to start loading
-	}
 	load_task.resource = _load(load_task.remapped_path, load_task.remapped_path != load_task.local_path ? load_task.local_path : String(), load_task.type_hint, load_task.cache_mode, &load_task.error, load_task.use_sub_threads, &load_task.progress);
 
 	load_task.progress = 1.0; //it was fully loaded at this point, so force progress to 1.0
@@ -231,22 +227,22 @@ void ResourceLoader::_thread_load_function(void *p_userdata) {
 	} else {
 		load_task.status = THREAD_LOAD_LOADED;
 	}
+	load_task.end_usec = OS::get_singleton()->get_ticks_usec();
+
 	if (load_task.semaphore) {
-		if (load_task.start_next && thread_waiting_count > 0) {
-			thread_waiting_count--;
-			//thread loading count remains constant, this ends but another one begins
-			thread_load_semaphore->post();
-		} else {
-			thread_loading_count--; //no threads waiting, just reduce loading count
-		}
+		//this is an actual thread, give its slot to the next queued load
+		thread_loading_count--;
+		thread_load_bytes_in_flight -= load_task.size_estimate;
 
-		print_lt("END: load count: " + itos(thread_loading_count) + " / wait count: " + itos(thread_waiting_count) + " / suspended count: " + itos(thread_suspended_count) + " / active: " + itos(thread_loading_count - thread_suspended_count));
+		print_lt("END: load count: " + itos(thread_loading_count) + " / suspended count: " + itos(thread_suspended_count) + " / active: " + itos(thread_loading_count - thread_suspended_count));
 
 		for (int i = 0; i < load_task.poll_requests; i++) {
 			load_task.semaphore->post();
 		}
 		memdelete(load_task.semaphore);
 		load_task.semaphore = nullptr;
+
+		_thread_load_start_queued();
 	}
 
 	if (load_task.resource.is_valid()) {
@@ -271,9 +267,70 @@ void ResourceLoader::_thread_load_function(void *p_userdata) {
 		}
 	}
 
+	if (load_task.cancelled) {
+		//nobody wants the result anymore, this thread can't join itself so it's left for the next caller
+		thread_load_finished.push_back(load_task.thread);
+		String local_path = load_task.local_path;
+		thread_load_tasks.erase(local_path);
+	}
+
 	thread_load_mutex->unlock();
 }
 
+void ResourceLoader::_thread_load_start_queued() {
+	for (int i = 0; i < LOAD_PRIORITY_MAX; i++) {
+		while (thread_load_queue[i].size()) {
+			if (thread_loading_count - thread_suspended_count >= thread_load_max) {
+				return; //no free threads
+			}
+
+			String path = thread_load_queue[i].front()->get();
+			ThreadLoadTask &load_task = thread_load_tasks[path];
+
+			//something is waiting for this one, or nothing is loading at all, so it can't be held back
+			bool must_start = load_task.priority == LOAD_PRIORITY_CRITICAL || load_task.poll_requests > 0 || thread_load_bytes_in_flight == 0;
+			if (!must_start && thread_load_max_bytes_in_flight > 0 && thread_load_bytes_in_flight + load_task.size_estimate > thread_load_max_bytes_in_flight) {
+				return; //wait for memory to be freed, don't let lower priorities go first
+			}
+
+			thread_load_queue[i].pop_front();
+
+			load_task.queued = false;
+			load_task.start_usec = OS::get_singleton()->get_ticks_usec();
+			thread_loading_count++;
+			thread_load_bytes_in_flight += load_task.size_estimate;
+
+			print_lt("START: load count: " + itos(thread_loading_count) + " / suspended count: " + itos(thread_suspended_count) + " / active: " + itos(thread_loading_count - thread_suspended_count));
+
+			load_task.thread = memnew(Thread);
+			load_task.thread->start(_thread_load_function, &load_task);
+			load_task.loader_id = load_task.thread->get_id();
+		}
+	}
+}
+
+void ResourceLoader::_thread_load_join_finished() {
+	for (int i = 0; i < thread_load_finished.size(); i++) {
+		thread_load_finished[i]->wait_to_finish();
+		memdelete(thread_load_finished[i]);
+	}
+	thread_load_finished.clear();
+}
+
+uint64_t ResourceLoader::_thread_load_estimate_size(const String &p_local_path) {
+	//imported resources are loaded from their imported data, not from the source file
+	FileAccess *f = FileAccess::open(import_remap(_path_remap(p_local_path)), FileAccess::READ);
+	if (!f) {
+		return 0;
+	}
+	//file size is used as estimate of the memory needed to load it
+	uint64_t size = f->get_length();
+	//start fetching the file while the task waits in the queue
+	f->read_ahead(0, size);
+	memdelete(f);
+	return size;
+}
+
 static String _validate_local_path(const String &p_path) {
 	ResourceUID::ID uid = ResourceUID::get_singleton()->text_to_id(p_path);
 	if (uid != ResourceUID::INVALID_ID) {
@@ -284,11 +341,30 @@ static String _validate_local_path(const String &p_path) {
 		return ProjectSettings::get_singleton()->localize_path(p_path);
 	}
 }
-Error ResourceLoader::load_threaded_request(const String &p_path, const String &p_type_hint, bool p_use_sub_threads, ResourceFormatLoader::CacheMode p_cache_mode, const String &p_source_resource) {
+Error ResourceLoader::load_threaded_request(const String &p_path, const String &p_type_hint, bool p_use_sub_threads, ResourceFormatLoader::CacheMode p_cache_mode, const String &p_source_resource, LoadPriority p_priority) {
+	ERR_FAIL_INDEX_V(p_priority, LOAD_PRIORITY_MAX, ERR_INVALID_PARAMETER);
+
 	String local_path = _validate_local_path(p_path);
 
+	//opening the file may block, so resources that need loading are estimated before locking
+	thread_load_mutex->lock();
+	bool requested = thread_load_tasks.has(local_path);
+	thread_load_mutex->unlock();
+
+	uint64_t size_estimate = (requested || ResourceCache::has(local_path)) ? 0 : _thread_load_estimate_size(local_path);
+	uint64_t max_bytes_in_flight = 0;
+	if (ProjectSettings::get_singleton()) {
+		max_bytes_in_flight = uint64_t(int(GLOBAL_GET("resource_loader/threaded_load/max_in_flight_mb"))) * 1024 * 1024;
+	}
+
 	thread_load_mutex->lock();
 
+	thread_load_max_bytes_in_flight = max_bytes_in_flight;
+
+	_thread_load_join_finished();
+
+	LoadPriority priority = p_priority;
+
 	if (p_source_resource != String()) {
 		//must be loading from this resource
 		if (!thread_load_tasks.has(p_source_resource)) {
@@ -306,13 +382,25 @@ Error ResourceLoader::load_threaded_request(const String &p_path, const String &
 			thread_load_mutex->unlock();
 			ERR_FAIL_V_MSG(ERR_INVALID_PARAMETER, "Thread loading source resource '" + p_source_resource + "' already is loading '" + local_path + "'.");
 		}
+
+		//dependencies are as urgent as what needs them
+		priority = thread_load_tasks[p_source_resource].priority;
 	}
 
 	if (thread_load_tasks.has(local_path)) {
-		thread_load_tasks[local_path].requests++;
+		ThreadLoadTask &load_task = thread_load_tasks[local_path];
+		load_task.requests++;
+		load_task.cancelled = false;
 		if (p_source_resource != String()) {
 			thread_load_tasks[p_source_resource].sub_tasks.insert(local_path);
 		}
+		if (load_task.queued && priority < load_task.priority) {
+			//requested again with more urgency, move it up
+			thread_load_queue[load_task.priority].erase(local_path);
+			thread_load_queue[priority].push_back(local_path);
+			load_task.priority = priority;
+			_thread_load_start_queued();
+		}
 		thread_load_mutex->unlock();
 		return OK;
 	}
@@ -328,6 +416,8 @@ Error ResourceLoader::load_threaded_request(const String &p_path, const String &
 		load_task.type_hint = p_type_hint;
 		load_task.cache_mode = p_cache_mode;
 		load_task.use_sub_threads = p_use_sub_threads;
+		load_task.priority = priority;
+		load_task.request_usec = OS::get_singleton()->get_ticks_usec();
 
 		{ //must check if resource is already loaded before attempting to load it in a thread
 
@@ -366,18 +456,14 @@ Error ResourceLoader::load_threaded_request(const String &p_path, const String &
 	if (load_task.resource.is_null()) { //needs to be loaded in thread
 
 		load_task.semaphore = memnew(Semaphore);
-		if (thread_loading_count < thread_load_max) {
-			thread_loading_count++;
-			thread_load_semaphore->post(); //we have free threads, so allow one
-		} else {
-			thread_waiting_count++;
-		}
+		load_task.queued = true;
+		load_task.size_estimate = size_estimate;
 
-		print_lt("REQUEST: load count: " + itos(thread_loading_count) + " / wait count: " + itos(thread_waiting_count) + " / suspended count: " + itos(thread_suspended_count) + " / active: " + itos(thread_loading_count - thread_suspended_count));
+		thread_load_queue[load_task.priority].push_back(local_path);
 
-		load_task.thread = memnew(Thread);
-		load_task.thread->start(_thread_load_function, &thread_load_tasks[local_path]);
-		load_task.loader_id = load_task.thread->get_id();
+		print_lt("REQUEST: load count: " + itos(thread_loading_count) + " / suspended count: " + itos(thread_suspended_count) + " / active: " + itos(thread_loading_count - thread_suspended_count));
+
+		_thread_load_start_queued();
 	}
 
 	thread_load_mutex->unlock();
@@ -427,6 +513,37 @@ ResourceLoader::ThreadLoadStatus ResourceLoader::load_threaded_get_status(const
 	return status;
 }
 
+bool ResourceLoader::load_threaded_get_stats(const String &p_path, ThreadLoadStats *r_stats) {
+	ERR_FAIL_NULL_V(r_stats, false);
+
+	String local_path = _validate_local_path(p_path);
+
+	thread_load_mutex->lock();
+	if (!thread_load_tasks.has(local_path)) {
+		thread_load_mutex->unlock();
+		return false;
+	}
+
+	const ThreadLoadTask &load_task = thread_load_tasks[local_path];
+	uint64_t now = OS::get_singleton()->get_ticks_usec();
+
+	r_stats->priority = load_task.priority;
+	r_stats->progress = _dependency_get_progress(local_path);
+	r_stats->queued_usec = 0;
+	r_stats->loading_usec = 0;
+
+	if (load_task.queued) {
+		r_stats->queued_usec = now - load_task.request_usec;
+	} else if (load_task.start_usec) {
+		r_stats->queued_usec = load_task.start_usec - load_task.request_usec;
+		r_stats->loading_usec = (load_task.end_usec ? load_task.end_usec : now) - load_task.start_usec;
+	}
+
+	thread_load_mutex->unlock();
+
+	return true;
+}
+
 RES ResourceLoader::load_threaded_get(const String &p_path, Error *r_error) {
 	String local_path = _validate_local_path(p_path);
 
@@ -446,28 +563,20 @@ RES ResourceLoader::load_threaded_get(const String &p_path, Error *r_error) {
 	if (semaphore) {
 		load_task.poll_requests++;
 
-		{
-			// As we got a semaphore, this means we are going to have to wait
-			// until the sub-resource is done loading
-			//
-			// As this thread will become 'blocked' we should "exchange" its
-			// active status with a waiting one, to ensure load continues.
-			//
-			// This ensures loading is never blocked and that is also within
-			// the maximum number of active threads.
-
-			if (thread_waiting_count > 0) {
-				thread_waiting_count--;
-				thread_loading_count++;
-				thread_load_semaphore->post();
-
-				load_task.start_next = false; //do not start next since we are doing it here
-			}
+		if (load_task.queued && load_task.priority != LOAD_PRIORITY_CRITICAL) {
+			//waiting for it, so it can't stay behind anything else
+			thread_load_queue[load_task.priority].erase(local_path);
+			thread_load_queue[LOAD_PRIORITY_CRITICAL].push_front(local_path);
+			load_task.priority = LOAD_PRIORITY_CRITICAL;
+		}
 
-			thread_suspended_count++;
+		// As this thread will become 'blocked', let a queued load take its
+		// place, to ensure load continues within the maximum number of
+		// active threads.
+		thread_suspended_count++;
+		_thread_load_start_queued();
 
-			print_lt("GET: load count: " + itos(thread_loading_count) + " / wait count: " + itos(thread_waiting_count) + " / suspended count: " + itos(thread_suspended_count) + " / active: " + itos(thread_loading_count - thread_suspended_count));
-		}
+		print_lt("GET: load count: " + itos(thread_loading_count) + " / suspended count: " + itos(thread_suspended_count) + " / active: " + itos(thread_loading_count - thread_suspended_count));
 
 		thread_load_mutex->unlock();
 		semaphore->wait();
@@ -504,6 +613,44 @@ RES ResourceLoader::load_threaded_get(const String &p_path, Error *r_error) {
 	return resource;
 }
 
+bool ResourceLoader::load_threaded_cancel(const String &p_path) {
+	String local_path = _validate_local_path(p_path);
+
+	thread_load_mutex->lock();
+
+	_thread_load_join_finished();
+
+	if (!thread_load_tasks.has(local_path)) {
+		thread_load_mutex->unlock();
+		return false;
+	}
+
+	ThreadLoadTask &load_task = thread_load_tasks[local_path];
+	load_task.requests--;
+
+	if (load_task.requests == 0) {
+		if (load_task.queued) {
+			//never started, just drop it
+			thread_load_queue[load_task.priority].erase(local_path);
+			memdelete(load_task.semaphore);
+			thread_load_tasks.erase(local_path);
+		} else if (load_task.semaphore) {
+			//loading, it will be discarded once done
+			load_task.cancelled = true;
+		} else {
+			if (load_task.thread) {
+				load_task.thread->wait_to_finish();
+				memdelete(load_task.thread);
+			}
+			thread_load_tasks.erase(local_path);
+		}
+	}
+
+	thread_load_mutex->unlock();
+
+	return true;
+}
+
 RES ResourceLoader::load(const String &p_path, const String &p_type_hint, ResourceFormatLoader::CacheMode p_cache_mode, Error *r_error) {
 	if (r_error) {
 		*r_error = ERR_CANT_OPEN;
@@ -1053,14 +1200,14 @@ void ResourceLoader::initialize() {
 	thread_load_mutex = memnew(Mutex);
 	thread_load_max = OS::get_singleton()->get_processor_count();
 	thread_loading_count = 0;
-	thread_waiting_count = 0;
 	thread_suspended_count = 0;
-	thread_load_semaphore = memnew(Semaphore);
+	thread_load_bytes_in_flight = 0;
+	thread_load_max_bytes_in_flight = 0;
 }
 
 void ResourceLoader::finalize() {
+	_thread_load_join_finished();
 	memdelete(thread_load_mutex);
-	memdelete(thread_load_semaphore);
 }
 
 ResourceLoadErrorNotify ResourceLoader::err_notify = nullptr;
@@ -1074,12 +1221,14 @@ bool ResourceLoader::timestamp_on_load = false;
 
 Mutex *ResourceLoader::thread_load_mutex = nullptr;
 HashMap<String, ResourceLoader::ThreadLoadTask> ResourceLoader::thread_load_tasks;
-Semaphore *ResourceLoader::thread_load_semaphore = nullptr;
+List<String> ResourceLoader::thread_load_queue[ResourceLoader::LOAD_PRIORITY_MAX];
+Vector<Thread *> ResourceLoader::thread_load_finished;
 
 int ResourceLoader::thread_loading_count = 0;
-int ResourceLoader::thread_waiting_count = 0;
 int ResourceLoader::thread_suspended_count = 0;
 int ResourceLoader::thread_load_max = 0;
+uint64_t ResourceLoader::thread_load_bytes_in_flight = 0;
+uint64_t ResourceLoader::thread_load_max_bytes_in_flight = 0;
 
 SelfList<Resource>::List ResourceLoader::remapped_list;
 HashMap<String, Vector<String>> ResourceLoader::translation_remaps;
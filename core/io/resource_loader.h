@@ -100,6 +100,21 @@ public:
 		THREAD_LOAD_LOADED
 	};
 
+	// Queued threaded loads are started in priority order.
+	enum LoadPriority {
+		LOAD_PRIORITY_CRITICAL, // Needed right away, ignores the in-flight memory limit.
+		LOAD_PRIORITY_VISIBLE,
+		LOAD_PRIORITY_PREFETCH,
+		LOAD_PRIORITY_MAX
+	};
+
+	struct ThreadLoadStats {
+		LoadPriority priority = LOAD_PRIORITY_VISIBLE;
+		float progress = 0.0;
+		uint64_t queued_usec = 0; // Time between the request and the start of the load.
+		uint64_t loading_usec = 0; // Time spent loading so far, or in total once loaded.
+	};
+
 private:
 	static Ref<ResourceFormatLoader> loader[MAX_LOADERS];
 	static int loader_count;
@@ -141,27 +156,40 @@ private:
 		RES resource;
 		bool xl_remapped = false;
 		bool use_sub_threads = false;
-		bool start_next = true;
+		bool queued = false;
+		bool cancelled = false;
+		LoadPriority priority = LOAD_PRIORITY_VISIBLE;
+		uint64_t size_estimate = 0;
+		uint64_t request_usec = 0;
+		uint64_t start_usec = 0;
+		uint64_t end_usec = 0;
 		int requests = 0;
 		int poll_requests = 0;
 		Set<String> sub_tasks;
 	};
 
 	static void _thread_load_function(void *p_userdata);
+	static void _thread_load_start_queued();
+	static void _thread_load_join_finished();
+	static uint64_t _thread_load_estimate_size(const String &p_local_path);
 	static Mutex *thread_load_mutex;
 	static HashMap<String, ThreadLoadTask> thread_load_tasks;
-	static Semaphore *thread_load_semaphore;
-	static int thread_waiting_count;
+	static List<String> thread_load_queue[LOAD_PRIORITY_MAX];
+	static Vector<Thread *> thread_load_finished;
 	static int thread_loading_count;
 	static int thread_suspended_count;
 	static int thread_load_max;
+	static uint64_t thread_load_bytes_in_flight;
+	static uint64_t thread_load_max_bytes_in_flight;
 
 	static float _dependency_get_progress(const String &p_path);
 
 public:
-	static Error load_threaded_request(const String &p_path, const String &p_type_hint = "", bool p_use_sub_threads = false, ResourceFormatLoader::CacheMode p_cache_mode = ResourceFormatLoader::CACHE_MODE_REUSE, const String &p_source_resource = String());
+	static Error load_threaded_request(const String &p_path, const String &p_type_hint = "", bool p_use_sub_threads = false, ResourceFormatLoader::CacheMode p_cache_mode = ResourceFormatLoader::CACHE_MODE_REUSE, const String &p_source_resource = String(), LoadPriority p_priority = LOAD_PRIORITY_VISIBLE);
 	static ThreadLoadStatus load_threaded_get_status(const String &p_path, float *r_progress = nullptr);
+	static bool load_threaded_get_stats(const String &p_path, ThreadLoadStats *r_stats);
 	static RES load_threaded_get(const String &p_path, Error *r_error = nullptr);
+	static bool load_threaded_cancel(const String &p_path);
 
 	static RES load(const String &p_path, const String &p_type_hint = "", ResourceFormatLoader::CacheMode p_cache_mode = ResourceFormatLoader::CACHE_MODE_REUSE, Error *r_error = nullptr);
 	static bool exists(const String &p_path, const String &p_type_hint = "");
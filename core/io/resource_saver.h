@@ -78,6 +78,7 @@ public:
 		FLAG_SAVE_BIG_ENDIAN = 16,
 		FLAG_COMPRESS = 32,
 		FLAG_REPLACE_SUBRESOURCE_PATHS = 64,
+		FLAG_COMPRESS_PACKED_ARRAYS = 128,
 	};
 
 	static Error save(const String &p_path, const RES &p_resource, uint32_t p_flags = 0);
@@ -32,12 +32,46 @@
 
 #include "core/math/geometry_3d.h"
 #include "core/object/script_language.h"
+#include "core/os/os.h"
 #include "scene/scene_string_names.h"
 
+ThreadWorkPool AStar::batch_pool;
+BinaryMutex AStar::batch_pool_mutex;
+bool AStar::batch_pool_initialized = false;
+
+bool AStar::_lock_batch_pool() {
+#ifdef NO_THREADS
+	return false;
+#else
+	if (batch_pool_mutex.try_lock() != OK) {
+		return false; // Another batch is using it, solve on the calling thread instead.
+	}
+
+	if (!batch_pool_initialized) {
+		if (OS::get_singleton()->get_processor_count() < 2) {
+			batch_pool_mutex.unlock();
+			return false;
+		}
+		batch_pool.init();
+		batch_pool_initialized = true;
+	}
+
+	return true;
+#endif
+}
+
+void AStar::finish_batch_pool() {
+	MutexLock lock(batch_pool_mutex);
+	if (batch_pool_initialized) {
+		batch_pool.finish();
+		batch_pool_initialized = false;
+	}
+}
+
 int AStar::get_available_point_id() const {
-	if (points.has(last_free_id)) {
+	if (point_indices.has(last_free_id)) {
 		int cur_new_id = last_free_id + 1;
-		while (points.has(cur_new_id)) {
+		while (point_indices.has(cur_new_id)) {
 			cur_new_id++;
 		}
 		const_cast<int &>(last_free_id) = cur_new_id;
@@ -46,222 +80,264 @@ int AStar::get_available_point_id() const {
 	return last_free_id;
 }
 
+uint32_t AStar::_find_link(uint32_t p_point, uint32_t p_linked, uint32_t *r_prev) const {
+	uint32_t prev = UINT32_MAX;
+	uint32_t link = points[p_point].first_link;
+	while (link != UINT32_MAX && links[link].point != p_linked) {
+		prev = link;
+		link = links[link].next;
+	}
+	if (r_prev) {
+		*r_prev = prev;
+	}
+	return link;
+}
+
+void AStar::_add_link(uint32_t p_point, uint32_t p_linked, uint32_t p_direction) {
+	uint32_t link = _find_link(p_point, p_linked);
+	if (link != UINT32_MAX) {
+		links[link].direction |= p_direction;
+		return;
+	}
+
+	if (first_free_link != UINT32_MAX) {
+		link = first_free_link;
+		first_free_link = links[link].next;
+	} else {
+		link = links.size();
+		links.push_back(Link());
+	}
+
+	Link &l = links[link];
+	l.point = p_linked;
+	l.direction = p_direction;
+	l.next = points[p_point].first_link;
+	points[p_point].first_link = link;
+}
+
+void AStar::_remove_link(uint32_t p_point, uint32_t p_linked) {
+	uint32_t prev;
+	const uint32_t link = _find_link(p_point, p_linked, &prev);
+	ERR_FAIL_COND(link == UINT32_MAX);
+
+	if (prev == UINT32_MAX) {
+		points[p_point].first_link = links[link].next;
+	} else {
+		links[prev].next = links[link].next;
+	}
+
+	links[link].direction = Link::NONE;
+	links[link].next = first_free_link;
+	first_free_link = link;
+}
+
 void AStar::add_point(int p_id, const Vector3 &p_pos, real_t p_weight_scale) {
 	ERR_FAIL_COND_MSG(p_id < 0, vformat("Can't add a point with negative id: %d.", p_id));
 	ERR_FAIL_COND_MSG(p_weight_scale < 1, vformat("Can't add a point with weight scale less than one: %f.", p_weight_scale));
 
-	Point *found_pt;
-	bool p_exists = points.lookup(p_id, found_pt);
+	uint32_t index;
+	bool p_exists = point_indices.lookup(p_id, index);
 
 	if (!p_exists) {
-		Point *pt = memnew(Point);
-		pt->id = p_id;
-		pt->pos = p_pos;
-		pt->weight_scale = p_weight_scale;
-		pt->prev_point = nullptr;
-		pt->open_pass = 0;
-		pt->closed_pass = 0;
-		pt->enabled = true;
-		points.set(p_id, pt);
+		Point pt;
+		pt.id = p_id;
+		pt.pos = p_pos;
+		pt.weight_scale = p_weight_scale;
+		pt.enabled = true;
+		point_indices.set(p_id, points.size());
+		points.push_back(pt);
+		adjacency_dirty = true;
 	} else {
-		found_pt->pos = p_pos;
-		found_pt->weight_scale = p_weight_scale;
+		points[index].pos = p_pos;
+		points[index].weight_scale = p_weight_scale;
 	}
+	version++;
 }
 
 Vector3 AStar::get_point_position(int p_id) const {
-	Point *p;
-	bool p_exists = points.lookup(p_id, p);
+	uint32_t index;
+	bool p_exists = point_indices.lookup(p_id, index);
 	ERR_FAIL_COND_V_MSG(!p_exists, Vector3(), vformat("Can't get point's position. Point with id: %d doesn't exist.", p_id));
 
-	return p->pos;
+	return points[index].pos;
 }
 
 void AStar::set_point_position(int p_id, const Vector3 &p_pos) {
-	Point *p;
-	bool p_exists = points.lookup(p_id, p);
+	uint32_t index;
+	bool p_exists = point_indices.lookup(p_id, index);
 	ERR_FAIL_COND_MSG(!p_exists, vformat("Can't set point's position. Point with id: %d doesn't exist.", p_id));
 
-	p->pos = p_pos;
+	points[index].pos = p_pos;
+	version++;
 }
 
 real_t AStar::get_point_weight_scale(int p_id) const {
-	Point *p;
-	bool p_exists = points.lookup(p_id, p);
+	uint32_t index;
+	bool p_exists = point_indices.lookup(p_id, index);
 	ERR_FAIL_COND_V_MSG(!p_exists, 0, vformat("Can't get point's weight scale. Point with id: %d doesn't exist.", p_id));
 
-	return p->weight_scale;
+	return points[index].weight_scale;
 }
 
 void AStar::set_point_weight_scale(int p_id, real_t p_weight_scale) {
-	Point *p;
-	bool p_exists = points.lookup(p_id, p);
+	uint32_t index;
+	bool p_exists = point_indices.lookup(p_id, index);
 	ERR_FAIL_COND_MSG(!p_exists, vformat("Can't set point's weight scale. Point with id: %d doesn't exist.", p_id));
 	ERR_FAIL_COND_MSG(p_weight_scale < 1, vformat("Can't set point's weight scale less than one: %f.", p_weight_scale));
 
-	p->weight_scale = p_weight_scale;
+	points[index].weight_scale = p_weight_scale;
+	version++;
 }
 
 void AStar::remove_point(int p_id) {
-	Point *p;
-	bool p_exists = points.lookup(p_id, p);
+	uint32_t index;
+	bool p_exists = point_indices.lookup(p_id, index);
 	ERR_FAIL_COND_MSG(!p_exists, vformat("Can't remove point. Point with id: %d doesn't exist.", p_id));
 
-	for (OAHashMap<int, Point *>::Iterator it = p->neighbours.iter(); it.valid; it = p->neighbours.next_iter(it)) {
-		Segment s(p_id, (*it.key));
-		segments.erase(s);
-
-		(*it.value)->neighbours.remove(p->id);
-		(*it.value)->unlinked_neighbours.remove(p->id);
+	// Drop the connections from both sides.
+	uint32_t link = points[index].first_link;
+	while (link != UINT32_MAX) {
+		const uint32_t next = links[link].next;
+		_remove_link(links[link].point, index);
+		links[link].direction = Link::NONE;
+		links[link].next = first_free_link;
+		first_free_link = link;
+		link = next;
 	}
-
-	for (OAHashMap<int, Point *>::Iterator it = p->unlinked_neighbours.iter(); it.valid; it = p->unlinked_neighbours.next_iter(it)) {
-		Segment s(p_id, (*it.key));
-		segments.erase(s);
-
-		(*it.value)->neighbours.remove(p->id);
-		(*it.value)->unlinked_neighbours.remove(p->id);
+	points[index].first_link = UINT32_MAX;
+
+	// Move the last point into the freed place, and point its links back to it.
+	const uint32_t last = points.size() - 1;
+	if (index != last) {
+		points[index] = points[last];
+		point_indices.set(points[index].id, index);
+		for (link = points[index].first_link; link != UINT32_MAX; link = links[link].next) {
+			links[_find_link(links[link].point, last)].point = index;
+		}
 	}
+	points.resize(last);
 
-	memdelete(p);
-	points.remove(p_id);
+	point_indices.remove(p_id);
 	last_free_id = p_id;
+	adjacency_dirty = true;
+	version++;
 }
 
 void AStar::connect_points(int p_id, int p_with_id, bool bidirectional) {
 	ERR_FAIL_COND_MSG(p_id == p_with_id, vformat("Can't connect point with id: %d to itself.", p_id));
 
-	Point *a;
-	bool from_exists = points.lookup(p_id, a);
+	uint32_t a;
+	bool from_exists = point_indices.lookup(p_id, a);
 	ERR_FAIL_COND_MSG(!from_exists, vformat("Can't connect points. Point with id: %d doesn't exist.", p_id));
 
-	Point *b;
-	bool to_exists = points.lookup(p_with_id, b);
+	uint32_t b;
+	bool to_exists = point_indices.lookup(p_with_id, b);
 	ERR_FAIL_COND_MSG(!to_exists, vformat("Can't connect points. Point with id: %d doesn't exist.", p_with_id));
 
-	a->neighbours.set(b->id, b);
-
-	if (bidirectional) {
-		b->neighbours.set(a->id, a);
-	} else {
-		b->unlinked_neighbours.set(a->id, a);
-	}
-
-	Segment s(p_id, p_with_id);
-	if (bidirectional) {
-		s.direction = Segment::BIDIRECTIONAL;
-	}
-
-	Set<Segment>::Element *element = segments.find(s);
-	if (element != nullptr) {
-		s.direction |= element->get().direction;
-		if (s.direction == Segment::BIDIRECTIONAL) {
-			// Both are neighbours of each other now
-			a->unlinked_neighbours.remove(b->id);
-			b->unlinked_neighbours.remove(a->id);
-		}
-		segments.erase(element);
-	}
-
-	segments.insert(s);
+	const uint32_t direction = bidirectional ? (uint32_t)Link::BIDIRECTIONAL : (uint32_t)Link::FORWARD;
+	_add_link(a, b, direction);
+	_add_link(b, a, Link::get_mirrored(direction));
+	adjacency_dirty = true;
+	version++;
 }
 
 void AStar::disconnect_points(int p_id, int p_with_id, bool bidirectional) {
-	Point *a;
-	bool a_exists = points.lookup(p_id, a);
+	uint32_t a;
+	bool a_exists = point_indices.lookup(p_id, a);
 	ERR_FAIL_COND_MSG(!a_exists, vformat("Can't disconnect points. Point with id: %d doesn't exist.", p_id));
 
-	Point *b;
-	bool b_exists = points.lookup(p_with_id, b);
+	uint32_t b;
+	bool b_exists = point_indices.lookup(p_with_id, b);
 	ERR_FAIL_COND_MSG(!b_exists, vformat("Can't disconnect points. Point with id: %d doesn't exist.", p_with_id));
 
-	Segment s(p_id, p_with_id);
-	int remove_direction = bidirectional ? (int)Segment::BIDIRECTIONAL : s.direction;
-
-	Set<Segment>::Element *element = segments.find(s);
-	if (element != nullptr) {
-		// s is the new segment
-		// Erase the directions to be removed
-		s.direction = (element->get().direction & ~remove_direction);
-
-		a->neighbours.remove(b->id);
-		if (bidirectional) {
-			b->neighbours.remove(a->id);
-			if (element->get().direction != Segment::BIDIRECTIONAL) {
-				a->unlinked_neighbours.remove(b->id);
-				b->unlinked_neighbours.remove(a->id);
-			}
-		} else {
-			if (s.direction == Segment::NONE) {
-				b->unlinked_neighbours.remove(a->id);
-			} else {
-				a->unlinked_neighbours.set(b->id, b);
-			}
-		}
+	const uint32_t link = _find_link(a, b);
+	if (link == UINT32_MAX) {
+		return;
+	}
 
-		segments.erase(element);
-		if (s.direction != Segment::NONE) {
-			segments.insert(s);
-		}
+	const uint32_t remove_direction = bidirectional ? (uint32_t)Link::BIDIRECTIONAL : (uint32_t)Link::FORWARD;
+	const uint32_t direction = links[link].direction & ~remove_direction;
+	if (direction == Link::NONE) {
+		_remove_link(a, b);
+		_remove_link(b, a);
+	} else {
+		links[link].direction = direction;
+		links[_find_link(b, a)].direction = Link::get_mirrored(direction);
 	}
+	adjacency_dirty = true;
+	version++;
 }
 
 bool AStar::has_point(int p_id) const {
-	return points.has(p_id);
+	return point_indices.has(p_id);
 }
 
 Array AStar::get_points() {
 	Array point_list;
 
-	for (OAHashMap<int, Point *>::Iterator it = points.iter(); it.valid; it = points.next_iter(it)) {
-		point_list.push_back(*(it.key));
+	for (uint32_t i = 0; i < points.size(); i++) {
+		point_list.push_back(points[i].id);
 	}
 
 	return point_list;
 }
 
 Vector<int> AStar::get_point_connections(int p_id) {
-	Point *p;
-	bool p_exists = points.lookup(p_id, p);
+	uint32_t index;
+	bool p_exists = point_indices.lookup(p_id, index);
 	ERR_FAIL_COND_V_MSG(!p_exists, Vector<int>(), vformat("Can't get point's connections. Point with id: %d doesn't exist.", p_id));
 
 	Vector<int> point_list;
 
-	for (OAHashMap<int, Point *>::Iterator it = p->neighbours.iter(); it.valid; it = p->neighbours.next_iter(it)) {
-		point_list.push_back((*it.key));
+	for (uint32_t link = points[index].first_link; link != UINT32_MAX; link = links[link].next) {
+		if (links[link].direction & Link::FORWARD) {
+			point_list.push_back(points[links[link].point].id);
+		}
 	}
 
 	return point_list;
 }
 
 bool AStar::are_points_connected(int p_id, int p_with_id, bool bidirectional) const {
-	Segment s(p_id, p_with_id);
-	const Set<Segment>::Element *element = segments.find(s);
+	uint32_t a;
+	uint32_t b;
+	if (!point_indices.lookup(p_id, a) || !point_indices.lookup(p_with_id, b)) {
+		return false;
+	}
 
-	return element != nullptr &&
-		   (bidirectional || (element->get().direction & s.direction) == s.direction);
+	const uint32_t link = _find_link(a, b);
+	return link != UINT32_MAX &&
+		   (bidirectional || (links[link].direction & Link::FORWARD));
 }
 
 void AStar::clear() {
 	last_free_id = 0;
-	for (OAHashMap<int, Point *>::Iterator it = points.iter(); it.valid; it = points.next_iter(it)) {
-		memdelete(*(it.value));
-	}
-	segments.clear();
+	point_indices.clear();
 	points.clear();
+	links.clear();
+	first_free_link = UINT32_MAX;
+	adjacency_offsets.clear();
+	adjacency.clear();
+	reverse_adjacency_offsets.clear();
+	reverse_adjacency.clear();
+	flow_fields.clear();
+	adjacency_dirty = true;
+	reverse_adjacency_dirty = true;
+	version++;
 }
 
 int AStar::get_point_count() const {
-	return points.get_num_elements();
+	return points.size();
 }
 
 int AStar::get_point_capacity() const {
-	return points.get_capacity();
+	return point_indices.get_capacity();
 }
 
 void AStar::reserve_space(int p_num_nodes) {
 	ERR_FAIL_COND_MSG(p_num_nodes <= 0, vformat("New capacity must be greater than 0, new was: %d.", p_num_nodes));
-	ERR_FAIL_COND_MSG((uint32_t)p_num_nodes < points.get_capacity(), vformat("New capacity must be greater than current capacity: %d, new was: %d.", points.get_capacity(), p_num_nodes));
+	ERR_FAIL_COND_MSG((uint32_t)p_num_nodes < point_indices.get_capacity(), vformat("New capacity must be greater than current capacity: %d, new was: %d.", point_indices.get_capacity(), p_num_nodes));
+	point_indices.reserve(p_num_nodes);
 	points.reserve(p_num_nodes);
 }
 
@@ -269,15 +345,15 @@ int AStar::get_closest_point(const Vector3 &p_point, bool p_include_disabled) co
 	int closest_id = -1;
 	real_t closest_dist = 1e20;
 
-	for (OAHashMap<int, Point *>::Iterator it = points.iter(); it.valid; it = points.next_iter(it)) {
-		if (!p_include_disabled && !(*it.value)->enabled) {
+	for (uint32_t i = 0; i < points.size(); i++) {
+		if (!p_include_disabled && !points[i].enabled) {
 			continue; // Disabled points should not be considered.
 		}
 
 		// Keep the closest point's ID, and in case of multiple closest IDs,
 		// the smallest one (makes it deterministic).
-		real_t d = p_point.distance_squared_to((*it.value)->pos);
-		int id = *(it.key);
+		real_t d = p_point.distance_squared_to(points[i].pos);
+		int id = points[i].id;
 		if (d <= closest_dist) {
 			if (d == closest_dist && id > closest_id) { // Keep lowest ID.
 				continue;
@@ -294,91 +370,421 @@ Vector3 AStar::get_closest_position_in_segment(const Vector3 &p_point) const {
 	real_t closest_dist = 1e20;
 	Vector3 closest_point;
 
-	for (const Set<Segment>::Element *E = segments.front(); E; E = E->next()) {
-		Point *from_point = nullptr, *to_point = nullptr;
-		points.lookup(E->get().u, from_point);
-		points.lookup(E->get().v, to_point);
-
-		if (!(from_point->enabled && to_point->enabled)) {
+	for (uint32_t i = 0; i < points.size(); i++) {
+		const Point &from_point = points[i];
+		if (!from_point.enabled) {
 			continue;
 		}
 
-		Vector3 segment[2] = {
-			from_point->pos,
-			to_point->pos,
-		};
+		for (uint32_t link = from_point.first_link; link != UINT32_MAX; link = links[link].next) {
+			const uint32_t to = links[link].point;
+			if (to < i || !points[to].enabled) {
+				continue; // Each segment is visited from its first point.
+			}
+
+			Vector3 segment[2] = {
+				from_point.pos,
+				points[to].pos,
+			};
 
-		Vector3 p = Geometry3D::get_closest_point_to_segment(p_point, segment);
-		real_t d = p_point.distance_squared_to(p);
-		if (d < closest_dist) {
-			closest_point = p;
-			closest_dist = d;
+			Vector3 p = Geometry3D::get_closest_point_to_segment(p_point, segment);
+			real_t d = p_point.distance_squared_to(p);
+			if (d < closest_dist) {
+				closest_point = p;
+				closest_dist = d;
+			}
 		}
 	}
 
 	return closest_point;
 }
 
-bool AStar::_solve(Point *begin_point, Point *end_point) {
+void AStar::_update_adjacency() {
+	if (!adjacency_dirty) {
+		return;
+	}
+
+	const uint32_t point_count = points.size();
+	adjacency_offsets.resize(point_count + 1);
+	adjacency.clear();
+
+	for (uint32_t i = 0; i < point_count; i++) {
+		adjacency_offsets[i] = adjacency.size();
+		for (uint32_t link = points[i].first_link; link != UINT32_MAX; link = links[link].next) {
+			if (links[link].direction & Link::FORWARD) {
+				adjacency.push_back(links[link].point);
+			}
+		}
+	}
+	adjacency_offsets[point_count] = adjacency.size();
+
+	adjacency_dirty = false;
+	reverse_adjacency_dirty = true;
+}
+
+void AStar::_update_reverse_adjacency() {
+	if (!reverse_adjacency_dirty) {
+		return;
+	}
+
+	const uint32_t point_count = points.size();
+	reverse_adjacency_offsets.resize(point_count + 1);
+	reverse_adjacency.clear();
+
+	for (uint32_t i = 0; i < point_count; i++) {
+		reverse_adjacency_offsets[i] = reverse_adjacency.size();
+		for (uint32_t link = points[i].first_link; link != UINT32_MAX; link = links[link].next) {
+			if (links[link].direction & Link::BACKWARD) {
+				reverse_adjacency.push_back(links[link].point);
+			}
+		}
+	}
+	reverse_adjacency_offsets[point_count] = reverse_adjacency.size();
+
+	reverse_adjacency_dirty = false;
+}
+
+void AStar::SearchState::prepare(uint32_t p_point_count) {
+	if (open_pass.size() != p_point_count) {
+		prev_point.resize(p_point_count);
+		g_score.resize(p_point_count);
+		f_score.resize(p_point_count);
+		open_pass.resize(p_point_count);
+		closed_pass.resize(p_point_count);
+		open_index.resize(p_point_count);
+		for (uint32_t i = 0; i < p_point_count; i++) {
+			open_pass[i] = 0;
+			closed_pass[i] = 0;
+		}
+		pass = 0;
+	}
+
 	pass++;
+	open_list.clear();
+}
 
-	if (!end_point->enabled) {
+void AStar::SearchState::open_list_sift_up(uint32_t p_point) {
+	uint32_t index = open_index[p_point];
+	while (index > 0) {
+		const uint32_t parent_index = (index - 1) / 2;
+		const uint32_t parent = open_list[parent_index];
+		if (!is_worse(parent, p_point)) {
+			break;
+		}
+		open_list[index] = parent;
+		open_index[parent] = index;
+		index = parent_index;
+	}
+	open_list[index] = p_point;
+	open_index[p_point] = index;
+}
+
+void AStar::SearchState::open_list_push(uint32_t p_point) {
+	open_index[p_point] = open_list.size();
+	open_list.push_back(p_point);
+	open_list_sift_up(p_point);
+}
+
+uint32_t AStar::SearchState::open_list_pop() {
+	const uint32_t top = open_list[0];
+	const uint32_t last = open_list[open_list.size() - 1];
+	open_list.resize(open_list.size() - 1);
+
+	const uint32_t size = open_list.size();
+	if (size == 0) {
+		return top;
+	}
+
+	// Sift the last point down from the root.
+	uint32_t index = 0;
+	while (true) {
+		uint32_t child_index = index * 2 + 1;
+		if (child_index >= size) {
+			break;
+		}
+		if (child_index + 1 < size && is_worse(open_list[child_index], open_list[child_index + 1])) {
+			child_index++;
+		}
+		const uint32_t child = open_list[child_index];
+		if (!is_worse(last, child)) {
+			break;
+		}
+		open_list[index] = child;
+		open_index[child] = index;
+		index = child_index;
+	}
+	open_list[index] = last;
+	open_index[last] = index;
+
+	return top;
+}
+
+template <class T>
+bool AStar::_can_solve_in_threads(T *p_owner) const {
+	// Scripts can't be called from the worker threads. Costs overridden in C++ must be thread safe.
+	return !p_owner->get_script_instance() && !GDVIRTUAL_IS_OVERRIDDEN_PTR(p_owner, _estimate_cost) && !GDVIRTUAL_IS_OVERRIDDEN_PTR(p_owner, _compute_cost);
+}
+
+template <class T>
+bool AStar::_solve(T *p_owner, SearchState &r_state, uint32_t p_begin, uint32_t p_end) {
+	if (!points[p_end].enabled) {
 		return false;
 	}
 
-	bool found_route = false;
+	// Points are read by index, the cost callbacks may add points and move them.
+	const int end_id = points[p_end].id;
+	r_state.prepare(points.size());
+	const uint64_t pass = r_state.pass;
+
+	r_state.g_score[p_begin] = 0;
+	r_state.f_score[p_begin] = p_owner->_estimate_cost(points[p_begin].id, end_id);
+	r_state.open_pass[p_begin] = pass;
+	r_state.open_list_push(p_begin);
 
-	Vector<Point *> open_list;
-	SortArray<Point *, SortPoints> sorter;
+	while (!r_state.open_list.is_empty()) {
+		const uint32_t p = r_state.open_list[0]; // The currently processed point
 
-	begin_point->g_score = 0;
-	begin_point->f_score = _estimate_cost(begin_point->id, end_point->id);
-	open_list.push_back(begin_point);
+		if (p == p_end) {
+			return true;
+		}
 
-	while (!open_list.is_empty()) {
-		Point *p = open_list[0]; // The currently processed point
+		r_state.open_list_pop(); // Remove the current point from the open list
+		r_state.closed_pass[p] = pass; // Mark the point as closed
 
-		if (p == end_point) {
-			found_route = true;
-			break;
+		const int point_id = points[p].id;
+		for (uint32_t i = adjacency_offsets[p]; i < adjacency_offsets[p + 1]; i++) {
+			const uint32_t e = adjacency[i]; // The neighbour point
+
+			if (!points[e].enabled || r_state.closed_pass[e] == pass) {
+				continue;
+			}
+
+			const int neighbour_id = points[e].id;
+			const real_t weight_scale = points[e].weight_scale;
+			real_t tentative_g_score = r_state.g_score[p] + p_owner->_compute_cost(point_id, neighbour_id) * weight_scale;
+
+			bool new_point = false;
+
+			if (r_state.open_pass[e] != pass) { // The point wasn't inside the open list.
+				r_state.open_pass[e] = pass;
+				new_point = true;
+			} else if (tentative_g_score >= r_state.g_score[e]) { // The new path is worse than the previous.
+				continue;
+			}
+
+			r_state.prev_point[e] = p;
+			r_state.g_score[e] = tentative_g_score;
+			r_state.f_score[e] = tentative_g_score + p_owner->_estimate_cost(neighbour_id, end_id);
+
+			if (new_point) {
+				r_state.open_list_push(e);
+			} else { // Only got cheaper, move it up from where it is.
+				r_state.open_list_sift_up(e);
+			}
 		}
+	}
+
+	return false;
+}
+
+template <class T>
+bool AStar::_find_path(T *p_owner, SearchState &r_state, uint32_t p_begin, uint32_t p_end) {
+	r_state.path.clear();
+
+	if (p_begin == p_end) {
+		r_state.path.push_back(p_begin);
+		return true;
+	}
+
+	if (!_solve(p_owner, r_state, p_begin, p_end)) {
+		return false;
+	}
 
-		sorter.pop_heap(0, open_list.size(), open_list.ptrw()); // Remove the current point from the open list
-		open_list.remove(open_list.size() - 1);
-		p->closed_pass = pass; // Mark the point as closed
+	uint32_t p = p_end;
+	uint32_t pc = 1; // Begin point
+	while (p != p_begin) {
+		pc++;
+		p = r_state.prev_point[p];
+	}
 
-		for (OAHashMap<int, Point *>::Iterator it = p->neighbours.iter(); it.valid; it = p->neighbours.next_iter(it)) {
-			Point *e = *(it.value); // The neighbour point
+	r_state.path.resize(pc);
+	p = p_end;
+	for (uint32_t idx = pc - 1; idx > 0; idx--) {
+		r_state.path[idx] = p;
+		p = r_state.prev_point[p];
+	}
+	r_state.path[0] = p; // Assign first
 
-			if (!e->enabled || e->closed_pass == pass) {
+	return true;
+}
+
+template <class T>
+void AStar::_find_paths_chunk(uint32_t p_chunk, PathBatch<T> *p_batch) {
+	SearchState &state = batch_states[p_chunk];
+	for (uint32_t i = p_chunk; i < p_batch->count; i += p_batch->stride) {
+		uint32_t from_point = 0;
+		uint32_t to_point = 0;
+		point_indices.lookup(p_batch->from_ids[i], from_point);
+		point_indices.lookup(p_batch->to_ids[i], to_point);
+
+		if (_find_path(p_batch->owner, state, from_point, to_point)) {
+			p_batch->paths[i] = state.path;
+		}
+	}
+}
+
+template <class T>
+bool AStar::_find_paths(T *p_owner, const Vector<int> &p_from_ids, const Vector<int> &p_to_ids, LocalVector<LocalVector<uint32_t>> &r_paths) {
+	ERR_FAIL_COND_V_MSG(p_from_ids.size() != p_to_ids.size(), false, vformat("Can't get paths. Got %d start points for %d end points.", p_from_ids.size(), p_to_ids.size()));
+	for (int i = 0; i < p_from_ids.size(); i++) {
+		ERR_FAIL_COND_V_MSG(!point_indices.has(p_from_ids[i]), false, vformat("Can't get paths. Point with id: %d doesn't exist.", p_from_ids[i]));
+		ERR_FAIL_COND_V_MSG(!point_indices.has(p_to_ids[i]), false, vformat("Can't get paths. Point with id: %d doesn't exist.", p_to_ids[i]));
+	}
+
+	_update_adjacency();
+
+	r_paths.resize(p_from_ids.size());
+
+	PathBatch<T> batch;
+	batch.owner = p_owner;
+	batch.from_ids = p_from_ids.ptr();
+	batch.to_ids = p_to_ids.ptr();
+	batch.count = p_from_ids.size();
+	batch.paths = r_paths.ptr();
+
+	const bool use_pool = batch.count > 1 && _can_solve_in_threads(p_owner) && _lock_batch_pool();
+	if (use_pool) {
+		batch.stride = MIN(batch.count, batch_pool.get_thread_count());
+	}
+
+	if (batch_states.size() < batch.stride) {
+		batch_states.resize(batch.stride);
+	}
+
+	if (batch.stride > 1) {
+		batch_pool.do_work(batch.stride, this, &AStar::_find_paths_chunk<T>, &batch);
+	} else {
+		_find_paths_chunk(0, &batch);
+	}
+	if (use_pool) {
+		batch_pool_mutex.unlock();
+	}
+
+	return true;
+}
+
+template <class T>
+void AStar::_build_flow_field(T *p_owner, uint32_t p_to, LocalVector<uint32_t> &r_next_point) {
+	_update_reverse_adjacency();
+
+	const uint32_t point_count = points.size();
+	r_next_point.resize(point_count);
+	for (uint32_t i = 0; i < point_count; i++) {
+		r_next_point[i] = UINT32_MAX;
+	}
+
+	if (!points[p_to].enabled) {
+		return;
+	}
+
+	// Dijkstra from the goal over the reversed connections, each point is settled with the
+	// first point of its cheapest path to the goal.
+	SearchState &state = search_state;
+	state.prepare(point_count);
+	const uint64_t pass = state.pass;
+
+	state.g_score[p_to] = 0;
+	state.f_score[p_to] = 0;
+	state.open_pass[p_to] = pass;
+	state.open_list_push(p_to);
+	r_next_point[p_to] = p_to;
+
+	while (!state.open_list.is_empty()) {
+		const uint32_t p = state.open_list_pop();
+		state.closed_pass[p] = pass;
+		if (p != p_to) {
+			r_next_point[p] = state.prev_point[p];
+		}
+
+		if (!points[p].enabled) {
+			continue; // Paths can start at disabled points, but not go through them.
+		}
+		const int point_id = points[p].id;
+		const real_t weight_scale = points[p].weight_scale;
+
+		for (uint32_t i = reverse_adjacency_offsets[p]; i < reverse_adjacency_offsets[p + 1]; i++) {
+			const uint32_t e = reverse_adjacency[i]; // A point connected to this one.
+			if (state.closed_pass[e] == pass) {
 				continue;
 			}
 
-			real_t tentative_g_score = p->g_score + _compute_cost(p->id, e->id) * e->weight_scale;
+			real_t tentative_g_score = state.g_score[p] + p_owner->_compute_cost(points[e].id, point_id) * weight_scale;
 
 			bool new_point = false;
 
-			if (e->open_pass != pass) { // The point wasn't inside the open list.
-				e->open_pass = pass;
-				open_list.push_back(e);
+			if (state.open_pass[e] != pass) {
+				state.open_pass[e] = pass;
 				new_point = true;
-			} else if (tentative_g_score >= e->g_score) { // The new path is worse than the previous.
+			} else if (tentative_g_score >= state.g_score[e]) {
 				continue;
 			}
 
-			e->prev_point = p;
-			e->g_score = tentative_g_score;
-			e->f_score = e->g_score + _estimate_cost(e->id, end_point->id);
+			state.prev_point[e] = p;
+			state.g_score[e] = tentative_g_score;
+			state.f_score[e] = tentative_g_score;
 
-			if (new_point) { // The position of the new points is already known.
-				sorter.push_heap(0, open_list.size() - 1, 0, e, open_list.ptrw());
+			if (new_point) {
+				state.open_list_push(e);
 			} else {
-				sorter.push_heap(0, open_list.find(e), 0, e, open_list.ptrw());
+				state.open_list_sift_up(e);
 			}
 		}
 	}
+}
+
+template <class T>
+int AStar::_get_flow_field_next_id(T *p_owner, int p_from_id, int p_to_id) {
+	uint32_t a;
+	bool from_exists = point_indices.lookup(p_from_id, a);
+	ERR_FAIL_COND_V_MSG(!from_exists, -1, vformat("Can't get flow field. Point with id: %d doesn't exist.", p_from_id));
+
+	uint32_t b;
+	bool to_exists = point_indices.lookup(p_to_id, b);
+	ERR_FAIL_COND_V_MSG(!to_exists, -1, vformat("Can't get flow field. Point with id: %d doesn't exist.", p_to_id));
+
+	_update_adjacency();
 
-	return found_route;
+	FlowField *field = nullptr;
+	for (uint32_t i = 0; i < flow_fields.size(); i++) {
+		if (flow_fields[i].to_id == p_to_id && flow_fields[i].version == version) {
+			field = &flow_fields[i];
+			break;
+		}
+	}
+
+	if (!field) {
+		// Replace an outdated field or the least recently used one.
+		if (flow_fields.size() < FLOW_FIELD_CACHE_SIZE) {
+			flow_fields.push_back(FlowField());
+			field = &flow_fields[flow_fields.size() - 1];
+		} else {
+			field = &flow_fields[0];
+			for (uint32_t i = 1; i < flow_fields.size() && field->version == version; i++) {
+				if (flow_fields[i].version != version || flow_fields[i].last_used < field->last_used) {
+					field = &flow_fields[i];
+				}
+			}
+		}
+
+		field->to_id = p_to_id;
+		field->version = version;
+		_build_flow_field(p_owner, b, field->next_point);
+	}
+
+	field->last_used = ++flow_field_uses;
+
+	const uint32_t next = field->next_point[a];
+	return next == UINT32_MAX ? -1 : points[next].id;
 }
 
 real_t AStar::_estimate_cost(int p_from_id, int p_to_id) {
@@ -387,15 +793,15 @@ real_t AStar::_estimate_cost(int p_from_id, int p_to_id) {
 		return scost;
 	}
 
-	Point *from_point;
-	bool from_exists = points.lookup(p_from_id, from_point);
+	uint32_t from_point;
+	bool from_exists = point_indices.lookup(p_from_id, from_point);
 	ERR_FAIL_COND_V_MSG(!from_exists, 0, vformat("Can't estimate cost. Point with id: %d doesn't exist.", p_from_id));
 
-	Point *to_point;
-	bool to_exists = points.lookup(p_to_id, to_point);
+	uint32_t to_point;
+	bool to_exists = point_indices.lookup(p_to_id, to_point);
 	ERR_FAIL_COND_V_MSG(!to_exists, 0, vformat("Can't estimate cost. Point with id: %d doesn't exist.", p_to_id));
 
-	return from_point->pos.distance_to(to_point->pos);
+	return points[from_point].pos.distance_to(points[to_point].pos);
 }
 
 real_t AStar::_compute_cost(int p_from_id, int p_to_id) {
@@ -404,129 +810,130 @@ real_t AStar::_compute_cost(int p_from_id, int p_to_id) {
 		return scost;
 	}
 
-	Point *from_point;
-	bool from_exists = points.lookup(p_from_id, from_point);
+	uint32_t from_point;
+	bool from_exists = point_indices.lookup(p_from_id, from_point);
 	ERR_FAIL_COND_V_MSG(!from_exists, 0, vformat("Can't compute cost. Point with id: %d doesn't exist.", p_from_id));
 
-	Point *to_point;
-	bool to_exists = points.lookup(p_to_id, to_point);
+	uint32_t to_point;
+	bool to_exists = point_indices.lookup(p_to_id, to_point);
 	ERR_FAIL_COND_V_MSG(!to_exists, 0, vformat("Can't compute cost. Point with id: %d doesn't exist.", p_to_id));
 
-	return from_point->pos.distance_to(to_point->pos);
+	return points[from_point].pos.distance_to(points[to_point].pos);
 }
 
 Vector<Vector3> AStar::get_point_path(int p_from_id, int p_to_id) {
-	Point *a;
-	bool from_exists = points.lookup(p_from_id, a);
+	uint32_t a;
+	bool from_exists = point_indices.lookup(p_from_id, a);
 	ERR_FAIL_COND_V_MSG(!from_exists, Vector<Vector3>(), vformat("Can't get point path. Point with id: %d doesn't exist.", p_from_id));
 
-	Point *b;
-	bool to_exists = points.lookup(p_to_id, b);
+	uint32_t b;
+	bool to_exists = point_indices.lookup(p_to_id, b);
 	ERR_FAIL_COND_V_MSG(!to_exists, Vector<Vector3>(), vformat("Can't get point path. Point with id: %d doesn't exist.", p_to_id));
 
-	if (a == b) {
-		Vector<Vector3> ret;
-		ret.push_back(a->pos);
-		return ret;
-	}
-
-	Point *begin_point = a;
-	Point *end_point = b;
+	_update_adjacency();
 
-	bool found_route = _solve(begin_point, end_point);
+	bool found_route = _find_path(this, search_state, a, b);
 	if (!found_route) {
 		return Vector<Vector3>();
 	}
 
-	Point *p = end_point;
-	int pc = 1; // Begin point
-	while (p != begin_point) {
-		pc++;
-		p = p->prev_point;
-	}
-
 	Vector<Vector3> path;
-	path.resize(pc);
-
-	{
-		Vector3 *w = path.ptrw();
-
-		Point *p2 = end_point;
-		int idx = pc - 1;
-		while (p2 != begin_point) {
-			w[idx--] = p2->pos;
-			p2 = p2->prev_point;
-		}
-
-		w[0] = p2->pos; // Assign first
+	path.resize(search_state.path.size());
+	Vector3 *w = path.ptrw();
+	for (uint32_t i = 0; i < search_state.path.size(); i++) {
+		w[i] = points[search_state.path[i]].pos;
 	}
 
 	return path;
 }
 
 Vector<int> AStar::get_id_path(int p_from_id, int p_to_id) {
-	Point *a;
-	bool from_exists = points.lookup(p_from_id, a);
+	uint32_t a;
+	bool from_exists = point_indices.lookup(p_from_id, a);
 	ERR_FAIL_COND_V_MSG(!from_exists, Vector<int>(), vformat("Can't get id path. Point with id: %d doesn't exist.", p_from_id));
 
-	Point *b;
-	bool to_exists = points.lookup(p_to_id, b);
+	uint32_t b;
+	bool to_exists = point_indices.lookup(p_to_id, b);
 	ERR_FAIL_COND_V_MSG(!to_exists, Vector<int>(), vformat("Can't get id path. Point with id: %d doesn't exist.", p_to_id));
 
-	if (a == b) {
-		Vector<int> ret;
-		ret.push_back(a->id);
-		return ret;
-	}
-
-	Point *begin_point = a;
-	Point *end_point = b;
+	_update_adjacency();
 
-	bool found_route = _solve(begin_point, end_point);
+	bool found_route = _find_path(this, search_state, a, b);
 	if (!found_route) {
 		return Vector<int>();
 	}
 
-	Point *p = end_point;
-	int pc = 1; // Begin point
-	while (p != begin_point) {
-		pc++;
-		p = p->prev_point;
+	Vector<int> path;
+	path.resize(search_state.path.size());
+	int *w = path.ptrw();
+	for (uint32_t i = 0; i < search_state.path.size(); i++) {
+		w[i] = points[search_state.path[i]].id;
 	}
 
-	Vector<int> path;
-	path.resize(pc);
+	return path;
+}
 
-	{
-		int *w = path.ptrw();
+Array AStar::get_point_paths_batch(const Vector<int> &p_from_ids, const Vector<int> &p_to_ids) {
+	LocalVector<LocalVector<uint32_t>> paths;
+	Array ret;
+	if (!_find_paths(this, p_from_ids, p_to_ids, paths)) {
+		return ret;
+	}
 
-		p = end_point;
-		int idx = pc - 1;
-		while (p != begin_point) {
-			w[idx--] = p->id;
-			p = p->prev_point;
+	ret.resize(paths.size());
+	for (uint32_t i = 0; i < paths.size(); i++) {
+		Vector<Vector3> path;
+		path.resize(paths[i].size());
+		Vector3 *w = path.ptrw();
+		for (uint32_t j = 0; j < paths[i].size(); j++) {
+			w[j] = points[paths[i][j]].pos;
 		}
+		ret[i] = path;
+	}
+
+	return ret;
+}
 
-		w[0] = p->id; // Assign first
+Array AStar::get_id_paths_batch(const Vector<int> &p_from_ids, const Vector<int> &p_to_ids) {
+	LocalVector<LocalVector<uint32_t>> paths;
+	Array ret;
+	if (!_find_paths(this, p_from_ids, p_to_ids, paths)) {
+		return ret;
 	}
 
-	return path;
+	ret.resize(paths.size());
+	for (uint32_t i = 0; i < paths.size(); i++) {
+		Vector<int> path;
+		path.resize(paths[i].size());
+		int *w = path.ptrw();
+		for (uint32_t j = 0; j < paths[i].size(); j++) {
+			w[j] = points[paths[i][j]].id;
+		}
+		ret[i] = path;
+	}
+
+	return ret;
+}
+
+int AStar::get_flow_field_next_id(int p_from_id, int p_to_id) {
+	return _get_flow_field_next_id(this, p_from_id, p_to_id);
 }
 
 void AStar::set_point_disabled(int p_id, bool p_disabled) {
-	Point *p;
-	bool p_exists = points.lookup(p_id, p);
+	uint32_t index;
+	bool p_exists = point_indices.lookup(p_id, index);
 	ERR_FAIL_COND_MSG(!p_exists, vformat("Can't set if point is disabled. Point with id: %d doesn't exist.", p_id));
 
-	p->enabled = !p_disabled;
+	points[index].enabled = !p_disabled;
+	version++;
 }
 
 bool AStar::is_point_disabled(int p_id) const {
-	Point *p;
-	bool p_exists = points.lookup(p_id, p);
+	uint32_t index;
+	bool p_exists = point_indices.lookup(p_id, index);
 	ERR_FAIL_COND_V_MSG(!p_exists, false, vformat("Can't get if point is disabled. Point with id: %d doesn't exist.", p_id));
 
-	return !p->enabled;
+	return !points[index].enabled;
 }
 
 void AStar::_bind_methods() {
@@ -558,6 +965,9 @@ void AStar::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("get_point_path", "from_id", "to_id"), &AStar::get_point_path);
 	ClassDB::bind_method(D_METHOD("get_id_path", "from_id", "to_id"), &AStar::get_id_path);
+	ClassDB::bind_method(D_METHOD("get_point_paths_batch", "from_ids", "to_ids"), &AStar::get_point_paths_batch);
+	ClassDB::bind_method(D_METHOD("get_id_paths_batch", "from_ids", "to_ids"), &AStar::get_id_paths_batch);
+	ClassDB::bind_method(D_METHOD("get_flow_field_next_id", "from_id", "to_id"), &AStar::get_flow_field_next_id);
 
 	GDVIRTUAL_BIND(_estimate_cost, "from_id", "to_id")
 	GDVIRTUAL_BIND(_compute_cost, "from_id", "to_id")
@@ -661,15 +1071,15 @@ real_t AStar2D::_estimate_cost(int p_from_id, int p_to_id) {
 		return scost;
 	}
 
-	AStar::Point *from_point;
-	bool from_exists = astar.points.lookup(p_from_id, from_point);
+	uint32_t from_point;
+	bool from_exists = astar.point_indices.lookup(p_from_id, from_point);
 	ERR_FAIL_COND_V_MSG(!from_exists, 0, vformat("Can't estimate cost. Point with id: %d doesn't exist.", p_from_id));
 
-	AStar::Point *to_point;
-	bool to_exists = astar.points.lookup(p_to_id, to_point);
+	uint32_t to_point;
+	bool to_exists = astar.point_indices.lookup(p_to_id, to_point);
 	ERR_FAIL_COND_V_MSG(!to_exists, 0, vformat("Can't estimate cost. Point with id: %d doesn't exist.", p_to_id));
 
-	return from_point->pos.distance_to(to_point->pos);
+	return astar.points[from_point].pos.distance_to(astar.points[to_point].pos);
 }
 
 real_t AStar2D::_compute_cost(int p_from_id, int p_to_id) {
@@ -678,175 +1088,117 @@ real_t AStar2D::_compute_cost(int p_from_id, int p_to_id) {
 		return scost;
 	}
 
-	AStar::Point *from_point;
-	bool from_exists = astar.points.lookup(p_from_id, from_point);
+	uint32_t from_point;
+	bool from_exists = astar.point_indices.lookup(p_from_id, from_point);
 	ERR_FAIL_COND_V_MSG(!from_exists, 0, vformat("Can't compute cost. Point with id: %d doesn't exist.", p_from_id));
 
-	AStar::Point *to_point;
-	bool to_exists = astar.points.lookup(p_to_id, to_point);
+	uint32_t to_point;
+	bool to_exists = astar.point_indices.lookup(p_to_id, to_point);
 	ERR_FAIL_COND_V_MSG(!to_exists, 0, vformat("Can't compute cost. Point with id: %d doesn't exist.", p_to_id));
 
-	return from_point->pos.distance_to(to_point->pos);
+	return astar.points[from_point].pos.distance_to(astar.points[to_point].pos);
 }
 
 Vector<Vector2> AStar2D::get_point_path(int p_from_id, int p_to_id) {
-	AStar::Point *a;
-	bool from_exists = astar.points.lookup(p_from_id, a);
+	uint32_t a;
+	bool from_exists = astar.point_indices.lookup(p_from_id, a);
 	ERR_FAIL_COND_V_MSG(!from_exists, Vector<Vector2>(), vformat("Can't get point path. Point with id: %d doesn't exist.", p_from_id));
 
-	AStar::Point *b;
-	bool to_exists = astar.points.lookup(p_to_id, b);
+	uint32_t b;
+	bool to_exists = astar.point_indices.lookup(p_to_id, b);
 	ERR_FAIL_COND_V_MSG(!to_exists, Vector<Vector2>(), vformat("Can't get point path. Point with id: %d doesn't exist.", p_to_id));
 
-	if (a == b) {
-		Vector<Vector2> ret;
-		ret.push_back(Vector2(a->pos.x, a->pos.y));
-		return ret;
-	}
-
-	AStar::Point *begin_point = a;
-	AStar::Point *end_point = b;
+	astar._update_adjacency();
 
-	bool found_route = _solve(begin_point, end_point);
+	bool found_route = astar._find_path(this, astar.search_state, a, b);
 	if (!found_route) {
 		return Vector<Vector2>();
 	}
 
-	AStar::Point *p = end_point;
-	int pc = 1; // Begin point
-	while (p != begin_point) {
-		pc++;
-		p = p->prev_point;
-	}
-
+	const LocalVector<uint32_t> &route = astar.search_state.path;
 	Vector<Vector2> path;
-	path.resize(pc);
-
-	{
-		Vector2 *w = path.ptrw();
-
-		AStar::Point *p2 = end_point;
-		int idx = pc - 1;
-		while (p2 != begin_point) {
-			w[idx--] = Vector2(p2->pos.x, p2->pos.y);
-			p2 = p2->prev_point;
-		}
-
-		w[0] = Vector2(p2->pos.x, p2->pos.y); // Assign first
+	path.resize(route.size());
+	Vector2 *w = path.ptrw();
+	for (uint32_t i = 0; i < route.size(); i++) {
+		const Vector3 &pos = astar.points[route[i]].pos;
+		w[i] = Vector2(pos.x, pos.y);
 	}
 
 	return path;
 }
 
 Vector<int> AStar2D::get_id_path(int p_from_id, int p_to_id) {
-	AStar::Point *a;
-	bool from_exists = astar.points.lookup(p_from_id, a);
+	uint32_t a;
+	bool from_exists = astar.point_indices.lookup(p_from_id, a);
 	ERR_FAIL_COND_V_MSG(!from_exists, Vector<int>(), vformat("Can't get id path. Point with id: %d doesn't exist.", p_from_id));
 
-	AStar::Point *b;
-	bool to_exists = astar.points.lookup(p_to_id, b);
+	uint32_t b;
+	bool to_exists = astar.point_indices.lookup(p_to_id, b);
 	ERR_FAIL_COND_V_MSG(!to_exists, Vector<int>(), vformat("Can't get id path. Point with id: %d doesn't exist.", p_to_id));
 
-	if (a == b) {
-		Vector<int> ret;
-		ret.push_back(a->id);
-		return ret;
-	}
+	astar._update_adjacency();
 
-	AStar::Point *begin_point = a;
-	AStar::Point *end_point = b;
-
-	bool found_route = _solve(begin_point, end_point);
+	bool found_route = astar._find_path(this, astar.search_state, a, b);
 	if (!found_route) {
 		return Vector<int>();
 	}
 
-	AStar::Point *p = end_point;
-	int pc = 1; // Begin point
-	while (p != begin_point) {
-		pc++;
-		p = p->prev_point;
-	}
-
+	const LocalVector<uint32_t> &route = astar.search_state.path;
 	Vector<int> path;
-	path.resize(pc);
-
-	{
-		int *w = path.ptrw();
-
-		p = end_point;
-		int idx = pc - 1;
-		while (p != begin_point) {
-			w[idx--] = p->id;
-			p = p->prev_point;
-		}
-
-		w[0] = p->id; // Assign first
+	path.resize(route.size());
+	int *w = path.ptrw();
+	for (uint32_t i = 0; i < route.size(); i++) {
+		w[i] = astar.points[route[i]].id;
 	}
 
 	return path;
 }
 
-bool AStar2D::_solve(AStar::Point *begin_point, AStar::Point *end_point) {
-	astar.pass++;
-
-	if (!end_point->enabled) {
-		return false;
+Array AStar2D::get_point_paths_batch(const Vector<int> &p_from_ids, const Vector<int> &p_to_ids) {
+	LocalVector<LocalVector<uint32_t>> paths;
+	Array ret;
+	if (!astar._find_paths(this, p_from_ids, p_to_ids, paths)) {
+		return ret;
 	}
 
-	bool found_route = false;
-
-	Vector<AStar::Point *> open_list;
-	SortArray<AStar::Point *, AStar::SortPoints> sorter;
-
-	begin_point->g_score = 0;
-	begin_point->f_score = _estimate_cost(begin_point->id, end_point->id);
-	open_list.push_back(begin_point);
-
-	while (!open_list.is_empty()) {
-		AStar::Point *p = open_list[0]; // The currently processed point
-
-		if (p == end_point) {
-			found_route = true;
-			break;
+	ret.resize(paths.size());
+	for (uint32_t i = 0; i < paths.size(); i++) {
+		Vector<Vector2> path;
+		path.resize(paths[i].size());
+		Vector2 *w = path.ptrw();
+		for (uint32_t j = 0; j < paths[i].size(); j++) {
+			const Vector3 &pos = astar.points[paths[i][j]].pos;
+			w[j] = Vector2(pos.x, pos.y);
 		}
+		ret[i] = path;
+	}
 
-		sorter.pop_heap(0, open_list.size(), open_list.ptrw()); // Remove the current point from the open list
-		open_list.remove(open_list.size() - 1);
-		p->closed_pass = astar.pass; // Mark the point as closed
-
-		for (OAHashMap<int, AStar::Point *>::Iterator it = p->neighbours.iter(); it.valid; it = p->neighbours.next_iter(it)) {
-			AStar::Point *e = *(it.value); // The neighbour point
-
-			if (!e->enabled || e->closed_pass == astar.pass) {
-				continue;
-			}
-
-			real_t tentative_g_score = p->g_score + _compute_cost(p->id, e->id) * e->weight_scale;
-
-			bool new_point = false;
-
-			if (e->open_pass != astar.pass) { // The point wasn't inside the open list.
-				e->open_pass = astar.pass;
-				open_list.push_back(e);
-				new_point = true;
-			} else if (tentative_g_score >= e->g_score) { // The new path is worse than the previous.
-				continue;
-			}
+	return ret;
+}
 
-			e->prev_point = p;
-			e->g_score = tentative_g_score;
-			e->f_score = e->g_score + _estimate_cost(e->id, end_point->id);
+Array AStar2D::get_id_paths_batch(const Vector<int> &p_from_ids, const Vector<int> &p_to_ids) {
+	LocalVector<LocalVector<uint32_t>> paths;
+	Array ret;
+	if (!astar._find_paths(this, p_from_ids, p_to_ids, paths)) {
+		return ret;
+	}
 
-			if (new_point) { // The position of the new points is already known.
-				sorter.push_heap(0, open_list.size() - 1, 0, e, open_list.ptrw());
-			} else {
-				sorter.push_heap(0, open_list.find(e), 0, e, open_list.ptrw());
-			}
+	ret.resize(paths.size());
+	for (uint32_t i = 0; i < paths.size(); i++) {
+		Vector<int> path;
+		path.resize(paths[i].size());
+		int *w = path.ptrw();
+		for (uint32_t j = 0; j < paths[i].size(); j++) {
+			w[j] = astar.points[paths[i][j]].id;
 		}
+		ret[i] = path;
 	}
 
-	return found_route;
+	return ret;
+}
+
+int AStar2D::get_flow_field_next_id(int p_from_id, int p_to_id) {
+	return astar._get_flow_field_next_id(this, p_from_id, p_to_id);
 }
 
 void AStar2D::_bind_methods() {
@@ -878,6 +1230,9 @@ void AStar2D::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("get_point_path", "from_id", "to_id"), &AStar2D::get_point_path);
 	ClassDB::bind_method(D_METHOD("get_id_path", "from_id", "to_id"), &AStar2D::get_id_path);
+	ClassDB::bind_method(D_METHOD("get_point_paths_batch", "from_ids", "to_ids"), &AStar2D::get_point_paths_batch);
+	ClassDB::bind_method(D_METHOD("get_id_paths_batch", "from_ids", "to_ids"), &AStar2D::get_id_paths_batch);
+	ClassDB::bind_method(D_METHOD("get_flow_field_next_id", "from_id", "to_id"), &AStar2D::get_flow_field_next_id);
 
 	GDVIRTUAL_BIND(_estimate_cost, "from_id", "to_id")
 	GDVIRTUAL_BIND(_compute_cost, "from_id", "to_id")
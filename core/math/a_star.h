@@ -34,7 +34,10 @@
 #include "core/object/gdvirtual.gen.inc"
 #include "core/object/ref_counted.h"
 #include "core/object/script_language.h"
+#include "core/os/mutex.h"
+#include "core/templates/local_vector.h"
 #include "core/templates/oa_hash_map.h"
+#include "core/templates/thread_work_pool.h"
 
 /**
 	A* pathfinding algorithm
@@ -54,69 +57,136 @@ class AStar : public RefCounted {
 		real_t weight_scale = 0;
 		bool enabled = false;
 
-		OAHashMap<int, Point *> neighbours = 4u;
-		OAHashMap<int, Point *> unlinked_neighbours = 4u;
-
-		// Used for pathfinding.
-		Point *prev_point = nullptr;
-		real_t g_score = 0;
-		real_t f_score = 0;
-		uint64_t open_pass = 0;
-		uint64_t closed_pass = 0;
-	};
-
-	struct SortPoints {
-		_FORCE_INLINE_ bool operator()(const Point *A, const Point *B) const { // Returns true when the Point A is worse than Point B.
-			if (A->f_score > B->f_score) {
-				return true;
-			} else if (A->f_score < B->f_score) {
-				return false;
-			} else {
-				return A->g_score < B->g_score; // If the f_costs are the same then prioritize the points that are further away from the start.
-			}
-		}
+		uint32_t first_link = UINT32_MAX; // Head of the list of this point's links in `AStar::links`.
 	};
 
-	struct Segment {
-		union {
-			struct {
-				int32_t u;
-				int32_t v;
-			};
-			uint64_t key = 0;
-		};
-
+	// One connection as seen from one of its two points, each connection has a link in both.
+	// The links of all the points share one array, chained by `next`.
+	struct Link {
 		enum {
 			NONE = 0,
-			FORWARD = 1,
-			BACKWARD = 2,
+			FORWARD = 1, // The linked point can be reached from this one.
+			BACKWARD = 2, // This point can be reached from the linked one.
 			BIDIRECTIONAL = FORWARD | BACKWARD
 		};
-		unsigned char direction = NONE;
 
-		bool operator<(const Segment &p_s) const { return key < p_s.key; }
+		uint32_t point = 0; // Index of the linked point.
+		uint32_t next = UINT32_MAX; // Next link of the same point, or next free link.
+		uint32_t direction = NONE;
+
+		static _FORCE_INLINE_ uint32_t get_mirrored(uint32_t p_direction) {
+			return ((p_direction & FORWARD) ? BACKWARD : NONE) | ((p_direction & BACKWARD) ? FORWARD : NONE);
+		}
+	};
+
+	// Pathfinding state of one search, indexed by point index. Kept apart from the points
+	// so that several searches can run at once, each with its own state.
+	struct SearchState {
+		uint64_t pass = 0;
+		LocalVector<uint32_t> prev_point;
+		LocalVector<real_t> g_score;
+		LocalVector<real_t> f_score;
+		LocalVector<uint64_t> open_pass;
+		LocalVector<uint64_t> closed_pass;
+		LocalVector<uint32_t> open_index; // Position in `open_list` while in it.
+
+		LocalVector<uint32_t> open_list; // Binary heap of the points to visit.
+		LocalVector<uint32_t> path; // Points of the last path found, from begin to end.
 
-		Segment() {}
-		Segment(int p_from, int p_to) {
-			if (p_from < p_to) {
-				u = p_from;
-				v = p_to;
-				direction = FORWARD;
+		void prepare(uint32_t p_point_count);
+
+		_FORCE_INLINE_ bool is_worse(uint32_t p_a, uint32_t p_b) const { // Returns true when the point A is worse than point B.
+			if (f_score[p_a] > f_score[p_b]) {
+				return true;
+			} else if (f_score[p_a] < f_score[p_b]) {
+				return false;
 			} else {
-				u = p_to;
-				v = p_from;
-				direction = BACKWARD;
+				return g_score[p_a] < g_score[p_b]; // If the f_costs are the same then prioritize the points that are further away from the start.
 			}
 		}
+
+		void open_list_sift_up(uint32_t p_point);
+		void open_list_push(uint32_t p_point);
+		uint32_t open_list_pop();
 	};
 
-	int last_free_id = 0;
-	uint64_t pass = 1;
+	// Next point towards one goal for every point, see `get_flow_field_next_id`.
+	struct FlowField {
+		int to_id = -1;
+		uint64_t version = 0;
+		uint64_t last_used = 0;
+		LocalVector<uint32_t> next_point; // UINT32_MAX where the goal can't be reached from.
+	};
+
+	template <class T>
+	struct PathBatch {
+		T *owner = nullptr;
+		const int *from_ids = nullptr;
+		const int *to_ids = nullptr;
+		uint32_t count = 0;
+		uint32_t stride = 1; // Each chunk solves every `stride`-th query.
+		LocalVector<uint32_t> *paths = nullptr;
+	};
 
-	OAHashMap<int, Point *> points;
-	Set<Segment> segments;
+	enum {
+		FLOW_FIELD_CACHE_SIZE = 4,
+	};
 
-	bool _solve(Point *begin_point, Point *end_point);
+	int last_free_id = 0;
+	// Bumped by every change that can alter a path, cached flow fields are only valid for one version.
+	uint64_t version = 1;
+
+	// Points are stored densely, removing one moves the last point into its place.
+	OAHashMap<int, uint32_t> point_indices; // Point id to index in `points`.
+	LocalVector<Point> points;
+	LocalVector<Link> links;
+	uint32_t first_free_link = UINT32_MAX;
+
+	// The neighbours of every point by point index, derived from the links so searches read them
+	// contiguously. Rebuilt before a search when points or connections changed. The neighbours of
+	// point `i` are `adjacency[adjacency_offsets[i]]` up to `adjacency[adjacency_offsets[i + 1]]`.
+	LocalVector<uint32_t> adjacency_offsets;
+	LocalVector<uint32_t> adjacency;
+	bool adjacency_dirty = true;
+	// The same for the points each point can be reached from, only built for flow fields.
+	LocalVector<uint32_t> reverse_adjacency_offsets;
+	LocalVector<uint32_t> reverse_adjacency;
+	bool reverse_adjacency_dirty = true;
+
+	SearchState search_state;
+	LocalVector<SearchState> batch_states;
+
+	// Shared by all the AStar instances, used by one batch at a time.
+	static ThreadWorkPool batch_pool;
+	static BinaryMutex batch_pool_mutex;
+	static bool batch_pool_initialized;
+
+	static bool _lock_batch_pool();
+
+	LocalVector<FlowField> flow_fields;
+	uint64_t flow_field_uses = 0;
+
+	uint32_t _find_link(uint32_t p_point, uint32_t p_linked, uint32_t *r_prev = nullptr) const;
+	void _add_link(uint32_t p_point, uint32_t p_linked, uint32_t p_direction);
+	void _remove_link(uint32_t p_point, uint32_t p_linked);
+
+	void _update_adjacency();
+	void _update_reverse_adjacency();
+
+	template <class T>
+	bool _can_solve_in_threads(T *p_owner) const;
+	template <class T>
+	bool _solve(T *p_owner, SearchState &r_state, uint32_t p_begin, uint32_t p_end);
+	template <class T>
+	bool _find_path(T *p_owner, SearchState &r_state, uint32_t p_begin, uint32_t p_end);
+	template <class T>
+	void _find_paths_chunk(uint32_t p_chunk, PathBatch<T> *p_batch);
+	template <class T>
+	bool _find_paths(T *p_owner, const Vector<int> &p_from_ids, const Vector<int> &p_to_ids, LocalVector<LocalVector<uint32_t>> &r_paths);
+	template <class T>
+	void _build_flow_field(T *p_owner, uint32_t p_to, LocalVector<uint32_t> &r_next_point);
+	template <class T>
+	int _get_flow_field_next_id(T *p_owner, int p_from_id, int p_to_id);
 
 protected:
 	static void _bind_methods();
@@ -158,16 +228,21 @@ public:
 	Vector<Vector3> get_point_path(int p_from_id, int p_to_id);
 	Vector<int> get_id_path(int p_from_id, int p_to_id);
 
+	Array get_point_paths_batch(const Vector<int> &p_from_ids, const Vector<int> &p_to_ids);
+	Array get_id_paths_batch(const Vector<int> &p_from_ids, const Vector<int> &p_to_ids);
+	int get_flow_field_next_id(int p_from_id, int p_to_id);
+
+	static void finish_batch_pool();
+
 	AStar() {}
 	~AStar();
 };
 
 class AStar2D : public RefCounted {
 	GDCLASS(AStar2D, RefCounted);
+	friend class AStar;
 	AStar astar;
 
-	bool _solve(AStar::Point *begin_point, AStar::Point *end_point);
-
 protected:
 	static void _bind_methods();
 
@@ -208,6 +283,10 @@ public:
 	Vector<Vector2> get_point_path(int p_from_id, int p_to_id);
 	Vector<int> get_id_path(int p_from_id, int p_to_id);
 
+	Array get_point_paths_batch(const Vector<int> &p_from_ids, const Vector<int> &p_to_ids);
+	Array get_id_paths_batch(const Vector<int> &p_from_ids, const Vector<int> &p_to_ids);
+	int get_flow_field_next_id(int p_from_id, int p_to_id);
+
 	AStar2D() {}
 	~AStar2D() {}
 };
@@ -44,6 +44,7 @@
 #include "core/input/shortcut.h"
 #include "core/io/config_file.h"
 #include "core/io/dtls_server.h"
+#include "core/io/file_access_compressed.h"
 #include "core/io/http_client.h"
 #include "core/io/image_loader.h"
 #include "core/io/json.h"
@@ -76,6 +77,7 @@
 #include "core/os/time.h"
 #include "core/string/optimized_translation.h"
 #include "core/string/translation.h"
+#include "core/variant/variant_parser.h"
 
 static Ref<ResourceFormatSaverBinary> resource_saver_binary;
 static Ref<ResourceFormatLoaderBinary> resource_loader_binary;
@@ -266,6 +268,10 @@ void register_core_settings() {
 
 	GLOBAL_DEF("network/ssl/certificate_bundle_override", "");
 	ProjectSettings::get_singleton()->set_custom_property_info("network/ssl/certificate_bundle_override", PropertyInfo(Variant::STRING, "network/ssl/certificate_bundle_override", PROPERTY_HINT_FILE, "*.crt"));
+
+	GLOBAL_DEF("resource_loader/deduplicate_built_in_resources", false);
+	GLOBAL_DEF("resource_loader/threaded_load/max_in_flight_mb", 0);
+	ProjectSettings::get_singleton()->set_custom_property_info("resource_loader/threaded_load/max_in_flight_mb", PropertyInfo(Variant::INT, "resource_loader/threaded_load/max_in_flight_mb", PROPERTY_HINT_RANGE, "0,4096,1,or_greater"));
 }
 
 void register_core_singletons() {
@@ -357,6 +363,9 @@ void unregister_core_types() {
 	resource_loader_native_extension.unref();
 
 	ResourceLoader::finalize();
+	FileAccessCompressed::finish_thread_pool();
+	VariantParser::finish_thread_pool();
+	AStar::finish_batch_pool();
 
 	ClassDB::cleanup_defaults();
 	ObjectDB::cleanup();
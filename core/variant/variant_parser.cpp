@@ -33,38 +33,96 @@
 #include "core/input/input_event.h"
 #include "core/io/resource_loader.h"
 #include "core/os/keyboard.h"
+#include "core/os/mutex.h"
+#include "core/os/os.h"
 #include "core/string/string_buffer.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/thread_work_pool.h"
+
+char32_t VariantParser::Stream::get_char() {
+	// Fill the buffer only when it has been exhausted.
+	if (readahead_pointer == readahead_filled) {
+		if (eof) {
+			return 0;
+		}
+		if (readahead_enabled) {
+			readahead_filled = _read_buffer(readahead_buffer, READAHEAD_SIZE);
+		} else {
+			readahead_filled = _read_buffer(readahead_buffer, 1);
+		}
+		readahead_pointer = 0;
+		if (readahead_filled == 0) {
+			// Report EOF only once a read past the end was attempted, like FileAccess does.
+			eof = true;
+			return 0;
+		}
+	}
 
-char32_t VariantParser::StreamFile::get_char() {
-	return f->get_8();
+	return readahead_buffer[readahead_pointer++];
+}
+
+bool VariantParser::Stream::is_eof() const {
+	if (readahead_enabled) {
+		return eof;
+	}
+	return _is_eof();
+}
+
+uint32_t VariantParser::StreamFile::_read_buffer(char32_t *p_buffer, uint32_t p_num_chars) {
+	ERR_FAIL_COND_V(!p_num_chars, 0);
+
+	// Read raw bytes into the tail end of the buffer and widen them in place, front to back.
+	uint8_t *temp = (uint8_t *)(p_buffer + p_num_chars) - p_num_chars;
+	uint64_t num_read = f->get_buffer(temp, p_num_chars);
+	ERR_FAIL_COND_V(num_read == UINT64_MAX, 0);
+
+	for (uint64_t i = 0; i < num_read; i++) {
+		p_buffer[i] = temp[i];
+	}
+
+	return num_read;
 }
 
 bool VariantParser::StreamFile::is_utf8() const {
 	return true;
 }
 
-bool VariantParser::StreamFile::is_eof() const {
+bool VariantParser::StreamFile::_is_eof() const {
 	return f->eof_reached();
 }
 
-char32_t VariantParser::StreamString::get_char() {
-	if (pos > s.length()) {
-		return 0;
-	} else if (pos == s.length()) {
-		// You need to try to read again when you have reached the end for EOF to be reported,
-		// so this works the same as files (like StreamFile does)
-		pos++;
-		return 0;
-	} else {
-		return s[pos++];
+uint32_t VariantParser::StreamString::_read_buffer(char32_t *p_buffer, uint32_t p_num_chars) {
+	ERR_FAIL_COND_V(!p_num_chars, 0);
+
+	int available = MAX(s.length() - pos, 0);
+	if (available >= (int)p_num_chars) {
+		const char32_t *src = s.ptr();
+		src += pos;
+		memcpy(p_buffer, src, p_num_chars * sizeof(char32_t));
+		pos += p_num_chars;
+
+		return p_num_chars;
+	}
+
+	// Going to reach EOF.
+	if (available) {
+		const char32_t *src = s.ptr();
+		src += pos;
+		memcpy(p_buffer, src, available * sizeof(char32_t));
+		pos += available;
 	}
+
+	// Flag the end of the string, reported once a read past it was attempted.
+	pos++;
+
+	return available;
 }
 
 bool VariantParser::StreamString::is_utf8() const {
 	return false;
 }
 
-bool VariantParser::StreamString::is_eof() const {
+bool VariantParser::StreamString::_is_eof() const {
 	return pos > s.length();
 }
 
@@ -442,6 +500,206 @@ Error VariantParser::_parse_enginecfg(Stream *p_stream, Vector<String> &strings,
 	}
 }
 
+// Packed array literals (meshes, curves, tile data) can hold millions of numbers, so they skip
+// the generic tokenizer: literals are scanned straight off the stream into a flat buffer and
+// converted afterwards, on several threads when the array is large enough to make it worth it.
+
+enum {
+	PACKED_CONVERT_CHUNK_SIZE = 4096,
+	PACKED_CONVERT_PARALLEL_MIN = 32768, // Smaller arrays are converted on the calling thread.
+	PACKED_CONVERT_MAX_THREADS = 8,
+};
+
+static ThreadWorkPool packed_convert_pool;
+static BinaryMutex packed_convert_pool_mutex;
+static bool packed_convert_pool_initialized = false;
+
+static bool _lock_packed_convert_pool() {
+#ifdef NO_THREADS
+	return false;
+#else
+	if (packed_convert_pool_mutex.try_lock() != OK) {
+		return false; // Another parse is using it, work on the calling thread instead.
+	}
+
+	if (!packed_convert_pool_initialized) {
+		int thread_count = MIN(OS::get_singleton()->get_processor_count(), (int)PACKED_CONVERT_MAX_THREADS);
+		if (thread_count < 2) {
+			packed_convert_pool_mutex.unlock();
+			return false;
+		}
+		packed_convert_pool.init(thread_count);
+		packed_convert_pool_initialized = true;
+	}
+
+	return true;
+#endif
+}
+
+void VariantParser::finish_thread_pool() {
+	MutexLock lock(packed_convert_pool_mutex);
+	if (packed_convert_pool_initialized) {
+		packed_convert_pool.finish();
+		packed_convert_pool_initialized = false;
+	}
+}
+
+struct VariantParserPackedNumbers {
+	LocalVector<char32_t> text; // Number literals, each followed by a null terminator.
+	LocalVector<uint32_t> offsets;
+	LocalVector<uint8_t> is_float;
+
+	// Same conversions get_token() and Variant apply, so results match the generic path exactly.
+	template <class T>
+	void convert(uint32_t p_chunk, T *p_dst) {
+		uint32_t from = p_chunk * PACKED_CONVERT_CHUNK_SIZE;
+		uint32_t to = MIN(from + PACKED_CONVERT_CHUNK_SIZE, offsets.size());
+		for (uint32_t i = from; i < to; i++) {
+			const char32_t *num = &text[offsets[i]];
+			if (is_float[i]) {
+				p_dst[i] = String::to_float(num);
+			} else {
+				p_dst[i] = String::to_int(num);
+			}
+		}
+	}
+};
+
+static _FORCE_INLINE_ char32_t _skip_packed_whitespace(VariantParser::Stream *p_stream, char32_t p_char, int &line) {
+	while (p_char != 0 && p_char <= 32) {
+		if (p_char == '\n') {
+			line++;
+		}
+		p_char = p_stream->get_char();
+	}
+	return p_char;
+}
+
+// Accepts exactly what _parse_construct() accepts through get_token(), with the same errors.
+static Error _scan_packed_numbers(VariantParser::Stream *p_stream, VariantParserPackedNumbers &r_numbers, int &line, String &r_err_str) {
+	char32_t c;
+	if (p_stream->saved) {
+		c = p_stream->saved;
+		p_stream->saved = 0;
+	} else {
+		c = p_stream->get_char();
+	}
+
+	c = _skip_packed_whitespace(p_stream, c, line);
+	if (c != '(') {
+		r_err_str = "Expected '(' in constructor";
+		return ERR_PARSE_ERROR;
+	}
+
+	c = _skip_packed_whitespace(p_stream, p_stream->get_char(), line);
+	if (c == ')') {
+		return OK;
+	}
+
+	while (true) {
+		if (c != '-' && (c < '0' || c > '9')) {
+			r_err_str = "Expected float in constructor";
+			return ERR_PARSE_ERROR;
+		}
+
+		r_numbers.offsets.push_back(r_numbers.text.size());
+
+		if (c == '-') {
+			r_numbers.text.push_back('-');
+			c = p_stream->get_char();
+		}
+
+		int reading = READING_INT;
+		bool exp_sign = false;
+		bool exp_beg = false;
+		bool is_float = false;
+
+		while (true) {
+			switch (reading) {
+				case READING_INT: {
+					if (c >= '0' && c <= '9') {
+						//pass
+					} else if (c == '.') {
+						reading = READING_DEC;
+						is_float = true;
+					} else if (c == 'e') {
+						reading = READING_EXP;
+						is_float = true;
+					} else {
+						reading = READING_DONE;
+					}
+				} break;
+				case READING_DEC: {
+					if (c >= '0' && c <= '9') {
+					} else if (c == 'e') {
+						reading = READING_EXP;
+					} else {
+						reading = READING_DONE;
+					}
+				} break;
+				case READING_EXP: {
+					if (c >= '0' && c <= '9') {
+						exp_beg = true;
+					} else if ((c == '-' || c == '+') && !exp_sign && !exp_beg) {
+						exp_sign = true;
+					} else {
+						reading = READING_DONE;
+					}
+				} break;
+			}
+
+			if (reading == READING_DONE) {
+				break;
+			}
+			r_numbers.text.push_back(c);
+			c = p_stream->get_char();
+		}
+
+		r_numbers.text.push_back(0);
+		r_numbers.is_float.push_back(is_float);
+
+		c = _skip_packed_whitespace(p_stream, c, line);
+		if (c == ')') {
+			break;
+		} else if (c != ',') {
+			r_err_str = "Expected ',' or ')' in constructor";
+			return ERR_PARSE_ERROR;
+		}
+
+		c = _skip_packed_whitespace(p_stream, p_stream->get_char(), line);
+	}
+
+	return OK;
+}
+
+template <class T>
+static Error _parse_packed_construct(VariantParser::Stream *p_stream, Vector<T> &r_construct, int &line, String &r_err_str) {
+	VariantParserPackedNumbers numbers;
+	Error err = _scan_packed_numbers(p_stream, numbers, line, r_err_str);
+	if (err) {
+		return err;
+	}
+
+	uint32_t count = numbers.offsets.size();
+	r_construct.resize(count);
+	if (count == 0) {
+		return OK;
+	}
+
+	T *w = r_construct.ptrw();
+	uint32_t chunks = (count + PACKED_CONVERT_CHUNK_SIZE - 1) / PACKED_CONVERT_CHUNK_SIZE;
+	if (count >= PACKED_CONVERT_PARALLEL_MIN && _lock_packed_convert_pool()) {
+		packed_convert_pool.do_work(chunks, &numbers, &VariantParserPackedNumbers::convert<T>, w);
+		packed_convert_pool_mutex.unlock();
+	} else {
+		for (uint32_t i = 0; i < chunks; i++) {
+			numbers.convert<T>(i, w);
+		}
+	}
+
+	return OK;
+}
+
 template <class T>
 Error VariantParser::_parse_construct(Stream *p_stream, Vector<T> &r_construct, int &line, String &r_err_str) {
 	Token token;
@@ -872,94 +1130,44 @@ Error VariantParser::parse_value(Token &token, Variant &value, Stream *p_stream,
 				}
 			}
 		} else if (id == "PackedByteArray" || id == "PoolByteArray" || id == "ByteArray") {
-			Vector<uint8_t> args;
-			Error err = _parse_construct<uint8_t>(p_stream, args, line, r_err_str);
+			Vector<uint8_t> arr;
+			Error err = _parse_packed_construct<uint8_t>(p_stream, arr, line, r_err_str);
 			if (err) {
 				return err;
 			}
 
-			Vector<uint8_t> arr;
-			{
-				int len = args.size();
-				arr.resize(len);
-				uint8_t *w = arr.ptrw();
-				for (int i = 0; i < len; i++) {
-					w[i] = args[i];
-				}
-			}
-
 			value = arr;
 		} else if (id == "PackedInt32Array" || id == "PackedIntArray" || id == "PoolIntArray" || id == "IntArray") {
-			Vector<int32_t> args;
-			Error err = _parse_construct<int32_t>(p_stream, args, line, r_err_str);
+			Vector<int32_t> arr;
+			Error err = _parse_packed_construct<int32_t>(p_stream, arr, line, r_err_str);
 			if (err) {
 				return err;
 			}
 
-			Vector<int32_t> arr;
-			{
-				int32_t len = args.size();
-				arr.resize(len);
-				int32_t *w = arr.ptrw();
-				for (int32_t i = 0; i < len; i++) {
-					w[i] = int32_t(args[i]);
-				}
-			}
-
 			value = arr;
 		} else if (id == "PackedInt64Array") {
-			Vector<int64_t> args;
-			Error err = _parse_construct<int64_t>(p_stream, args, line, r_err_str);
+			Vector<int64_t> arr;
+			Error err = _parse_packed_construct<int64_t>(p_stream, arr, line, r_err_str);
 			if (err) {
 				return err;
 			}
 
-			Vector<int64_t> arr;
-			{
-				int64_t len = args.size();
-				arr.resize(len);
-				int64_t *w = arr.ptrw();
-				for (int64_t i = 0; i < len; i++) {
-					w[i] = int64_t(args[i]);
-				}
-			}
-
 			value = arr;
 		} else if (id == "PackedFloat32Array" || id == "PackedRealArray" || id == "PoolRealArray" || id == "FloatArray") {
-			Vector<float> args;
-			Error err = _parse_construct<float>(p_stream, args, line, r_err_str);
+			Vector<float> arr;
+			Error err = _parse_packed_construct<float>(p_stream, arr, line, r_err_str);
 			if (err) {
 				return err;
 			}
 
-			Vector<float> arr;
-			{
-				int len = args.size();
-				arr.resize(len);
-				float *w = arr.ptrw();
-				for (int i = 0; i < len; i++) {
-					w[i] = args[i];
-				}
-			}
-
 			value = arr;
 		} else if (id == "PackedFloat64Array") {
-			Vector<double> args;
-			Error err = _parse_construct<double>(p_stream, args, line, r_err_str);
+			Vector<double> arr;
+			Error err = _parse_packed_construct<double>(p_stream, arr, line, r_err_str);
 			if (err) {
 				return err;
 			}
 
-			Vector<double> arr;
-			{
-				int len = args.size();
-				arr.resize(len);
-				double *w = arr.ptrw();
-				for (int i = 0; i < len; i++) {
-					w[i] = args[i];
-				}
-			}
-
 			value = arr;
 		} else if (id == "PackedStringArray" || id == "PoolStringArray" || id == "StringArray") {
 			get_token(p_stream, token, line, r_err_str);
@@ -1009,7 +1217,7 @@ Error VariantParser::parse_value(Token &token, Variant &value, Stream *p_stream,
 			value = arr;
 		} else if (id == "PackedVector2Array" || id == "PoolVector2Array" || id == "Vector2Array") {
 			Vector<real_t> args;
-			Error err = _parse_construct<real_t>(p_stream, args, line, r_err_str);
+			Error err = _parse_packed_construct<real_t>(p_stream, args, line, r_err_str);
 			if (err) {
 				return err;
 			}
@@ -1027,7 +1235,7 @@ Error VariantParser::parse_value(Token &token, Variant &value, Stream *p_stream,
 			value = arr;
 		} else if (id == "PackedVector3Array" || id == "PoolVector3Array" || id == "Vector3Array") {
 			Vector<real_t> args;
-			Error err = _parse_construct<real_t>(p_stream, args, line, r_err_str);
+			Error err = _parse_packed_construct<real_t>(p_stream, args, line, r_err_str);
 			if (err) {
 				return err;
 			}
@@ -1045,7 +1253,7 @@ Error VariantParser::parse_value(Token &token, Variant &value, Stream *p_stream,
 			value = arr;
 		} else if (id == "PackedColorArray" || id == "PoolColorArray" || id == "ColorArray") {
 			Vector<float> args;
-			Error err = _parse_construct<float>(p_stream, args, line, r_err_str);
+			Error err = _parse_packed_construct<float>(p_stream, args, line, r_err_str);
 			if (err) {
 				return err;
 			}
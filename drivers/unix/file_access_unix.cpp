@@ -41,6 +41,7 @@
 #include <errno.h>
 
 #if defined(UNIX_ENABLED)
+#include <sys/mman.h>
 #include <unistd.h>
 #endif
 
@@ -72,6 +73,7 @@ void FileAccessUnix::check_errors() const {
 
 Error FileAccessUnix::_open(const String &p_path, int p_mode_flags) {
 	if (f) {
+		wait_async();
 		fclose(f);
 	}
 	f = nullptr;
@@ -153,6 +155,7 @@ void FileAccessUnix::close() {
 		return;
 	}
 
+	wait_async();
 	fclose(f);
 	f = nullptr;
 
@@ -252,6 +255,156 @@ Error FileAccessUnix::get_error() const {
 	return last_error;
 }
 
+const uint8_t *FileAccessUnix::map_region(uint64_t p_offset, uint64_t p_length) {
+#if defined(UNIX_ENABLED)
+	ERR_FAIL_COND_V_MSG(!f, nullptr, "File must be opened before use.");
+	ERR_FAIL_COND_V(p_length == 0, nullptr);
+
+	if (flags != READ) {
+		return nullptr;
+	}
+
+	// mmap needs an offset aligned to the page size.
+	uint64_t page_size = sysconf(_SC_PAGESIZE);
+	uint64_t page_offset = p_offset % page_size;
+
+	void *region = mmap(nullptr, p_length + page_offset, PROT_READ, MAP_SHARED, fileno(f), p_offset - page_offset);
+	if (region == MAP_FAILED) {
+		return nullptr;
+	}
+	return (const uint8_t *)region + page_offset;
+#else
+	return nullptr;
+#endif
+}
+
+void FileAccessUnix::unmap_region(const uint8_t *p_region, uint64_t p_length) {
+#if defined(UNIX_ENABLED)
+	ERR_FAIL_COND(!p_region);
+
+	uint64_t page_size = sysconf(_SC_PAGESIZE);
+	uint64_t page_offset = uint64_t(p_region) % page_size;
+	munmap((void *)(p_region - page_offset), p_length + page_offset);
+#endif
+}
+
+#ifdef UNIX_ASYNC_IO_ENABLED
+Mutex FileAccessUnix::async_mutex;
+Semaphore FileAccessUnix::async_semaphore;
+List<FileAccessUnix::AsyncTask> FileAccessUnix::async_tasks;
+LocalVector<Thread *> FileAccessUnix::async_threads;
+bool FileAccessUnix::async_exit = false;
+
+void FileAccessUnix::_async_thread_func(void *p_userdata) {
+	while (true) {
+		async_semaphore.wait();
+
+		// Every task and every exit request posts once, so the queue is only found empty when
+		// exiting. Tasks posted before the exit request are still served, wait_async() needs them.
+		async_mutex.lock();
+		if (async_tasks.is_empty()) {
+			async_mutex.unlock();
+			return;
+		}
+		AsyncTask task = async_tasks.front()->get();
+		async_tasks.pop_front();
+		async_mutex.unlock();
+
+		const ReadRequest &request = task.request;
+		uint64_t read = 0;
+		while (read < request.length) {
+			ssize_t r = pread(task.fd, request.dst + read, request.length - read, request.offset + read);
+			if (r < 0 && errno == EINTR) {
+				continue;
+			}
+			if (r <= 0) {
+				break;
+			}
+			read += r;
+		}
+
+		if (request.callback) {
+			request.callback(request.userdata, read == request.length ? OK : ERR_FILE_EOF, read);
+		}
+
+		task.file->async_done.post();
+	}
+}
+#endif
+
+Error FileAccessUnix::read_async(const ReadRequest *p_requests, int p_count) {
+	ERR_FAIL_COND_V_MSG(!f, ERR_FILE_CANT_READ, "File must be opened before use.");
+	ERR_FAIL_COND_V(!p_requests && p_count > 0, ERR_INVALID_PARAMETER);
+
+#ifdef UNIX_ASYNC_IO_ENABLED
+	if (flags == READ) {
+		MutexLock lock(async_mutex);
+
+		if (!async_exit) {
+			if (async_threads.is_empty()) {
+				int thread_count = CLAMP(OS::get_singleton()->get_processor_count() / 2, 1, (int)ASYNC_IO_MAX_THREADS);
+				for (int i = 0; i < thread_count; i++) {
+					Thread *thread = memnew(Thread);
+					thread->start(_async_thread_func, nullptr);
+					async_threads.push_back(thread);
+				}
+			}
+
+			int fd = fileno(f);
+			for (int i = 0; i < p_count; i++) {
+				AsyncTask task;
+				task.fd = fd;
+				task.request = p_requests[i];
+				task.file = this;
+				async_tasks.push_back(task);
+				async_pending++;
+				async_semaphore.post();
+			}
+
+			return OK;
+		}
+	}
+#endif
+
+	// Not opened for reading only, or shutting down: read synchronously.
+	return FileAccess::read_async(p_requests, p_count);
+}
+
+void FileAccessUnix::wait_async() {
+#ifdef UNIX_ASYNC_IO_ENABLED
+	while (async_pending) {
+		async_done.wait();
+		async_pending--;
+	}
+#endif
+}
+
+void FileAccessUnix::read_ahead(uint64_t p_offset, uint64_t p_length) {
+	ERR_FAIL_COND_MSG(!f, "File must be opened before use.");
+
+#if defined(UNIX_ENABLED) && defined(POSIX_FADV_WILLNEED)
+	// Let the kernel start filling the page cache, reads will then not block on the disk.
+	posix_fadvise(fileno(f), p_offset, p_length, POSIX_FADV_WILLNEED);
+#endif
+}
+
+void FileAccessUnix::finish_async_io() {
+#ifdef UNIX_ASYNC_IO_ENABLED
+	async_mutex.lock();
+	async_exit = true;
+	async_mutex.unlock();
+
+	for (uint32_t i = 0; i < async_threads.size(); i++) {
+		async_semaphore.post();
+	}
+	for (uint32_t i = 0; i < async_threads.size(); i++) {
+		async_threads[i]->wait_to_finish();
+		memdelete(async_threads[i]);
+	}
+	async_threads.clear();
+#endif
+}
+
 void FileAccessUnix::flush() {
 	ERR_FAIL_COND_MSG(!f, "File must be opened before use.");
 	fflush(f);
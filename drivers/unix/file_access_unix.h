@@ -38,6 +38,15 @@
 
 #if defined(UNIX_ENABLED) || defined(LIBC_FILEIO_ENABLED)
 
+#if defined(UNIX_ENABLED) && !defined(NO_THREADS)
+#define UNIX_ASYNC_IO_ENABLED
+#include "core/os/mutex.h"
+#include "core/os/semaphore.h"
+#include "core/os/thread.h"
+#include "core/templates/list.h"
+#include "core/templates/local_vector.h"
+#endif
+
 typedef void (*CloseNotificationFunc)(const String &p_file, int p_flags);
 
 class FileAccessUnix : public FileAccess {
@@ -51,6 +60,31 @@ class FileAccessUnix : public FileAccess {
 
 	static FileAccess *create_libc();
 
+#ifdef UNIX_ASYNC_IO_ENABLED
+	// Reads started with read_async() are served by a small pool of threads
+	// shared by all files, using pread() so the stream position is untouched.
+	enum {
+		ASYNC_IO_MAX_THREADS = 4,
+	};
+
+	struct AsyncTask {
+		int fd = -1;
+		ReadRequest request;
+		FileAccessUnix *file = nullptr;
+	};
+
+	static Mutex async_mutex;
+	static Semaphore async_semaphore;
+	static List<AsyncTask> async_tasks;
+	static LocalVector<Thread *> async_threads;
+	static bool async_exit;
+
+	static void _async_thread_func(void *p_userdata);
+
+	Semaphore async_done;
+	uint32_t async_pending = 0;
+#endif
+
 public:
 	static CloseNotificationFunc close_notification_func;
 
@@ -73,6 +107,13 @@ public:
 
 	virtual Error get_error() const; ///< get last error
 
+	virtual const uint8_t *map_region(uint64_t p_offset, uint64_t p_length);
+	virtual void unmap_region(const uint8_t *p_region, uint64_t p_length);
+
+	virtual Error read_async(const ReadRequest *p_requests, int p_count);
+	virtual void wait_async();
+	virtual void read_ahead(uint64_t p_offset, uint64_t p_length);
+
 	virtual void flush();
 	virtual void store_8(uint8_t p_dest); ///< store a byte
 	virtual void store_buffer(const uint8_t *p_src, uint64_t p_length); ///< store an array of bytes
@@ -83,6 +124,8 @@ public:
 	virtual uint32_t _get_unix_permissions(const String &p_file);
 	virtual Error _set_unix_permissions(const String &p_file, uint32_t p_permissions);
 
+	static void finish_async_io(); ///< stop the threads serving read_async, called when the OS finalizes
+
 	FileAccessUnix() {}
 	virtual ~FileAccessUnix();
 };
@@ -136,6 +136,7 @@ void OS_Unix::initialize_core() {
 }
 
 void OS_Unix::finalize_core() {
+	FileAccessUnix::finish_async_io();
 	NetSocketPosix::cleanup();
 }
 
@@ -49,6 +49,7 @@ void Performance::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_custom_monitor", "id"), &Performance::get_custom_monitor);
 	ClassDB::bind_method(D_METHOD("get_monitor_modification_time"), &Performance::get_monitor_modification_time);
 	ClassDB::bind_method(D_METHOD("get_custom_monitor_names"), &Performance::get_custom_monitor_names);
+	ClassDB::bind_method(D_METHOD("get_process_thread_group_times"), &Performance::get_process_thread_group_times);
 
 	BIND_ENUM_CONSTANT(TIME_FPS);
 	BIND_ENUM_CONSTANT(TIME_PROCESS);
@@ -73,6 +74,8 @@ void Performance::_bind_methods() {
 	BIND_ENUM_CONSTANT(PHYSICS_3D_COLLISION_PAIRS);
 	BIND_ENUM_CONSTANT(PHYSICS_3D_ISLAND_COUNT);
 	BIND_ENUM_CONSTANT(AUDIO_OUTPUT_LATENCY);
+	BIND_ENUM_CONSTANT(TIME_PROCESS_THREAD_GROUPS);
+	BIND_ENUM_CONSTANT(TIME_PHYSICS_PROCESS_THREAD_GROUPS);
 
 	BIND_ENUM_CONSTANT(MONITOR_MAX);
 }
@@ -86,6 +89,24 @@ int Performance::_get_node_count() const {
 	return sml->get_node_count();
 }
 
+double Performance::_get_thread_groups_process_time() const {
+	MainLoop *ml = OS::get_singleton()->get_main_loop();
+	SceneTree *sml = Object::cast_to<SceneTree>(ml);
+	if (!sml) {
+		return 0;
+	}
+	return sml->get_thread_groups_process_time();
+}
+
+double Performance::_get_thread_groups_physics_process_time() const {
+	MainLoop *ml = OS::get_singleton()->get_main_loop();
+	SceneTree *sml = Object::cast_to<SceneTree>(ml);
+	if (!sml) {
+		return 0;
+	}
+	return sml->get_thread_groups_physics_process_time();
+}
+
 String Performance::get_monitor_name(Monitor p_monitor) const {
 	ERR_FAIL_INDEX_V(p_monitor, MONITOR_MAX, String());
 	static const char *names[MONITOR_MAX] = {
@@ -112,6 +133,8 @@ String Performance::get_monitor_name(Monitor p_monitor) const {
 		"physics_3d/collision_pairs",
 		"physics_3d/islands",
 		"audio/driver/output_latency",
+		"time/process_thread_groups",
+		"time/physics_process_thread_groups",
 
 	};
 
@@ -166,6 +189,10 @@ double Performance::get_monitor(Monitor p_monitor) const {
 			return PhysicsServer3D::get_singleton()->get_process_info(PhysicsServer3D::INFO_ISLAND_COUNT);
 		case AUDIO_OUTPUT_LATENCY:
 			return AudioServer::get_singleton()->get_output_latency();
+		case TIME_PROCESS_THREAD_GROUPS:
+			return _get_thread_groups_process_time();
+		case TIME_PHYSICS_PROCESS_THREAD_GROUPS:
+			return _get_thread_groups_physics_process_time();
 
 		default: {
 		}
@@ -201,12 +228,23 @@ Performance::MonitorType Performance::get_monitor_type(Monitor p_monitor) const
 		MONITOR_TYPE_QUANTITY,
 		MONITOR_TYPE_QUANTITY,
 		MONITOR_TYPE_TIME,
+		MONITOR_TYPE_TIME,
+		MONITOR_TYPE_TIME,
 
 	};
 
 	return types[p_monitor];
 }
 
+Dictionary Performance::get_process_thread_group_times() const {
+	MainLoop *ml = OS::get_singleton()->get_main_loop();
+	SceneTree *sml = Object::cast_to<SceneTree>(ml);
+	if (!sml) {
+		return Dictionary();
+	}
+	return sml->get_thread_group_process_times();
+}
+
 void Performance::set_process_time(double p_pt) {
 	_process_time = p_pt;
 }
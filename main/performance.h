@@ -44,6 +44,8 @@ class Performance : public Object {
 	static void _bind_methods();
 
 	int _get_node_count() const;
+	double _get_thread_groups_process_time() const;
+	double _get_thread_groups_physics_process_time() const;
 
 	double _process_time;
 	double _physics_process_time;
@@ -87,6 +89,8 @@ public:
 		PHYSICS_3D_ISLAND_COUNT,
 		//physics
 		AUDIO_OUTPUT_LATENCY,
+		TIME_PROCESS_THREAD_GROUPS,
+		TIME_PHYSICS_PROCESS_THREAD_GROUPS,
 		MONITOR_MAX
 	};
 
@@ -101,6 +105,8 @@ public:
 
 	MonitorType get_monitor_type(Monitor p_monitor) const;
 
+	Dictionary get_process_thread_group_times() const;
+
 	void set_process_time(double p_pt);
 	void set_physics_process_time(double p_pt);
 
@@ -30,7 +30,9 @@
 
 #include "godot_navigation_server.h"
 
+#include "core/config/project_settings.h"
 #include "core/os/mutex.h"
+#include "core/os/os.h"
 
 #ifndef _3D_DISABLED
 #include "navigation_mesh_generator.h"
@@ -115,10 +117,25 @@
 
 GodotNavigationServer::GodotNavigationServer() :
 		NavigationServer3D() {
+	path_query_time_budget_usec = uint64_t(double(GLOBAL_DEF("navigation/3d/path_query_time_budget_msec", 1.0)) * 1000.0);
 }
 
 GodotNavigationServer::~GodotNavigationServer() {
 	flush_queries();
+
+	for (const int64_t *key = path_queries.next(nullptr); key; key = path_queries.next(key)) {
+		memdelete(path_queries[*key]);
+	}
+	// Cancelled queries are no longer tracked by id but may still be queued.
+	for (List<PathQuery *>::Element *E = queued_path_queries.front(); E; E = E->next()) {
+		if (E->get()->cancelled) {
+			memdelete(E->get());
+		}
+	}
+
+	if (work_pool_initialized) {
+		work_pool.finish();
+	}
 }
 
 void GodotNavigationServer::add_command(SetCommand *command) const {
@@ -204,6 +221,26 @@ real_t GodotNavigationServer::map_get_edge_connection_margin(RID p_map) const {
 	return map->get_edge_connection_margin();
 }
 
+int64_t GodotNavigationServer::map_get_sync_info(RID p_map, MapSyncInfo p_info) const {
+	const NavMap *map = map_owner.getornull(p_map);
+	ERR_FAIL_COND_V(map == nullptr, 0);
+
+	switch (p_info) {
+		case MAP_SYNC_INFO_POLYGON_COUNT:
+			return map->get_polygon_count();
+		case MAP_SYNC_INFO_DIRTY_REGIONS:
+			return map->get_last_sync_dirty_regions();
+		case MAP_SYNC_INFO_RELINKED_POLYGONS:
+			return map->get_last_sync_relinked_polygons();
+		case MAP_SYNC_INFO_FULL_RELINK:
+			return map->is_last_sync_full_relink() ? 1 : 0;
+		case MAP_SYNC_INFO_TIME_USEC:
+			return map->get_last_sync_usec();
+	}
+
+	return 0;
+}
+
 Vector<Vector3> GodotNavigationServer::map_get_path(RID p_map, Vector3 p_origin, Vector3 p_destination, bool p_optimize, uint32_t p_layers) const {
 	const NavMap *map = map_owner.getornull(p_map);
 	ERR_FAIL_COND_V(map == nullptr, Vector<Vector3>());
@@ -211,6 +248,72 @@ Vector<Vector3> GodotNavigationServer::map_get_path(RID p_map, Vector3 p_origin,
 	return map->get_path(p_origin, p_destination, p_optimize, p_layers);
 }
 
+int64_t GodotNavigationServer::map_request_path(RID p_map, Vector3 p_origin, Vector3 p_destination, bool p_optimize, uint32_t p_layers, Object *p_receiver, StringName p_method, Variant p_udata) const {
+	ERR_FAIL_COND_V(!map_owner.owns(p_map), 0);
+
+	PathQuery *query = memnew(PathQuery);
+	query->map = p_map;
+	query->origin = p_origin;
+	query->destination = p_destination;
+	query->optimize = p_optimize;
+	query->layers = p_layers;
+	if (p_receiver) {
+		query->receiver = p_receiver->get_instance_id();
+		query->method = p_method;
+		query->udata = p_udata;
+	}
+
+	GodotNavigationServer *mut_this = const_cast<GodotNavigationServer *>(this);
+	MutexLock lock(path_queries_mutex);
+	query->id = ++mut_this->last_path_query_id;
+	mut_this->queued_path_queries.push_back(query);
+	mut_this->path_queries.set(query->id, query);
+	return query->id;
+}
+
+bool GodotNavigationServer::path_query_is_done(int64_t p_query) const {
+	MutexLock lock(path_queries_mutex);
+	PathQuery *const *query = path_queries.getptr(p_query);
+	ERR_FAIL_COND_V_MSG(!query, false, "Invalid path query.");
+
+	return (*query)->state == PathQuery::STATE_DONE;
+}
+
+Vector<Vector3> GodotNavigationServer::path_query_get_path(int64_t p_query) const {
+	GodotNavigationServer *mut_this = const_cast<GodotNavigationServer *>(this);
+	MutexLock lock(path_queries_mutex);
+	PathQuery *const *query_ptr = path_queries.getptr(p_query);
+	ERR_FAIL_COND_V_MSG(!query_ptr, Vector<Vector3>(), "Invalid path query.");
+	PathQuery *query = *query_ptr;
+	ERR_FAIL_COND_V_MSG(query->state != PathQuery::STATE_DONE, Vector<Vector3>(), "The path query is not done yet, check it with path_query_is_done().");
+
+	Vector<Vector3> path = query->path;
+	mut_this->path_queries.erase(p_query);
+	memdelete(query);
+	return path;
+}
+
+void GodotNavigationServer::path_query_cancel(int64_t p_query) const {
+	GodotNavigationServer *mut_this = const_cast<GodotNavigationServer *>(this);
+	MutexLock lock(path_queries_mutex);
+	PathQuery *const *query_ptr = path_queries.getptr(p_query);
+	ERR_FAIL_COND_MSG(!query_ptr, "Invalid path query.");
+	PathQuery *query = *query_ptr;
+
+	mut_this->path_queries.erase(p_query);
+	if (query->state == PathQuery::STATE_DONE) {
+		memdelete(query);
+	} else {
+		// Still owned by the queue or a batch being processed, which frees it.
+		query->cancelled = true;
+	}
+}
+
+int GodotNavigationServer::get_path_query_queue_depth() const {
+	MutexLock lock(path_queries_mutex);
+	return queued_path_queries.size();
+}
+
 Vector3 GodotNavigationServer::map_get_closest_point_to_segment(RID p_map, const Vector3 &p_from, const Vector3 &p_to, const bool p_use_collision) const {
 	const NavMap *map = map_owner.getornull(p_map);
 	ERR_FAIL_COND_V(map == nullptr, Vector3());
@@ -308,6 +411,16 @@ void GodotNavigationServer::region_bake_navmesh(Ref<NavigationMesh> r_mesh, Node
 #endif
 }
 
+void GodotNavigationServer::region_bake_navmesh_area(Ref<NavigationMesh> r_mesh, Node *p_node, const AABB &p_area) const {
+	ERR_FAIL_COND(r_mesh.is_null());
+	ERR_FAIL_COND(p_node == nullptr);
+
+#ifndef _3D_DISABLED
+	NavigationMeshGenerator::get_singleton()->clear(r_mesh);
+	NavigationMeshGenerator::get_singleton()->bake_area(r_mesh, p_node, p_area);
+#endif
+}
+
 int GodotNavigationServer::region_get_connections_count(RID p_region) const {
 	NavRegion *region = region_owner.getornull(p_region);
 	ERR_FAIL_COND_V(!region, 0);
@@ -518,6 +631,100 @@ void GodotNavigationServer::flush_queries() {
 	commands.clear();
 }
 
+void GodotNavigationServer::_process_path_query(uint32_t p_index, PathQuery **p_queries) {
+	PathQuery *query = p_queries[p_index];
+	const NavMap *map = map_owner.getornull(query->map);
+	if (map) {
+		query->path = map->get_path(query->origin, query->destination, query->optimize, query->layers);
+	}
+}
+
+ThreadWorkPool *GodotNavigationServer::_get_work_pool() {
+#ifndef NO_THREADS
+	if (!work_pool_initialized && OS::get_singleton()->get_processor_count() > 1) {
+		work_pool.init();
+		work_pool_initialized = true;
+	}
+#endif
+	return work_pool_initialized ? &work_pool : nullptr;
+}
+
+void GodotNavigationServer::_process_path_queries() {
+	// Maps are synced and can't change while the operations mutex is held, so the batches
+	// below all see the same snapshot. Batches are processed until the frame budget is used,
+	// at least one per frame so the queue always drains.
+	const uint64_t start = OS::get_singleton()->get_ticks_usec();
+	while (true) {
+		path_query_batch.clear();
+		{
+			MutexLock lock(path_queries_mutex);
+			if (queued_path_queries.is_empty()) {
+				break;
+			}
+
+			ThreadWorkPool *pool = queued_path_queries.size() > 1 ? _get_work_pool() : nullptr;
+			const uint32_t batch_size = MAX(1, pool ? pool->get_thread_count() : 1) * PATH_QUERY_BATCH_PER_THREAD;
+
+			while (!queued_path_queries.is_empty() && path_query_batch.size() < batch_size) {
+				PathQuery *query = queued_path_queries.front()->get();
+				queued_path_queries.pop_front();
+				if (query->cancelled) {
+					memdelete(query);
+					continue;
+				}
+				query->state = PathQuery::STATE_PROCESSING;
+				path_query_batch.push_back(query);
+			}
+		}
+
+		if (path_query_batch.size() > 1 && work_pool_initialized) {
+			work_pool.do_work(path_query_batch.size(), this, &GodotNavigationServer::_process_path_query, path_query_batch.ptr());
+		} else {
+			for (uint32_t i = 0; i < path_query_batch.size(); i++) {
+				_process_path_query(i, path_query_batch.ptr());
+			}
+		}
+
+		{
+			MutexLock lock(path_queries_mutex);
+			for (uint32_t i = 0; i < path_query_batch.size(); i++) {
+				PathQuery *query = path_query_batch[i];
+				if (query->cancelled) {
+					memdelete(query);
+					continue;
+				}
+				query->state = PathQuery::STATE_DONE;
+				if (query->receiver.is_valid()) {
+					// Delivered below and never polled.
+					path_queries.erase(query->id);
+					path_query_callbacks.push_back(query);
+				}
+			}
+		}
+
+		if (OS::get_singleton()->get_ticks_usec() - start >= path_query_time_budget_usec) {
+			break;
+		}
+	}
+}
+
+void GodotNavigationServer::_dispatch_path_query_callbacks() {
+	for (uint32_t i = 0; i < path_query_callbacks.size(); i++) {
+		PathQuery *query = path_query_callbacks[i];
+		Object *obj = ObjectDB::get_instance(query->receiver);
+		if (obj) {
+			Callable::CallError call_error;
+			const Variant id = query->id;
+			const Variant path = query->path;
+			const Variant *vp[3] = { &id, &path, &query->udata };
+			int argc = (query->udata.get_type() == Variant::NIL) ? 2 : 3;
+			obj->call(query->method, vp, argc, call_error);
+		}
+		memdelete(query);
+	}
+	path_query_callbacks.clear();
+}
+
 void GodotNavigationServer::process(real_t p_delta_time) {
 	flush_queries();
 
@@ -530,7 +737,13 @@ void GodotNavigationServer::process(real_t p_delta_time) {
 	MutexLock lock(operations_mutex);
 	for (uint32_t i(0); i < active_maps.size(); i++) {
 		active_maps[i]->sync();
-		active_maps[i]->step(p_delta_time);
+		active_maps[i]->step(p_delta_time, active_maps[i]->get_controlled_agent_count() > 1 ? _get_work_pool() : nullptr);
+	}
+
+	_process_path_queries();
+
+	// Agent and path query results are delivered together, once everything for this frame is computed.
+	for (uint32_t i(0); i < active_maps.size(); i++) {
 		active_maps[i]->dispatch_callbacks();
 
 		// Emit a signal if a map changed.
@@ -540,6 +753,8 @@ void GodotNavigationServer::process(real_t p_delta_time) {
 			active_maps_update_id[i] = new_map_update_id;
 		}
 	}
+
+	_dispatch_path_query_callbacks();
 }
 
 #undef COMMAND_1
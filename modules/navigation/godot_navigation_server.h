@@ -31,9 +31,12 @@
 #ifndef GODOT_NAVIGATION_SERVER_H
 #define GODOT_NAVIGATION_SERVER_H
 
+#include "core/templates/hash_map.h"
+#include "core/templates/list.h"
 #include "core/templates/local_vector.h"
 #include "core/templates/rid.h"
 #include "core/templates/rid_owner.h"
+#include "core/templates/thread_work_pool.h"
 #include "servers/navigation_server_3d.h"
 
 #include "nav_map.h"
@@ -83,6 +86,48 @@ class GodotNavigationServer : public NavigationServer3D {
 	LocalVector<NavMap *> active_maps;
 	LocalVector<uint32_t> active_maps_update_id;
 
+	struct PathQuery {
+		enum State {
+			STATE_QUEUED,
+			STATE_PROCESSING,
+			STATE_DONE,
+		};
+
+		int64_t id = 0;
+		State state = STATE_QUEUED;
+		bool cancelled = false;
+
+		RID map;
+		Vector3 origin;
+		Vector3 destination;
+		bool optimize = false;
+		uint32_t layers = 1;
+
+		ObjectID receiver;
+		StringName method;
+		Variant udata;
+
+		Vector<Vector3> path;
+	};
+
+	enum {
+		PATH_QUERY_BATCH_PER_THREAD = 8,
+	};
+
+	/// Guards the path queries, which can be requested and polled from any thread.
+	mutable Mutex path_queries_mutex;
+	int64_t last_path_query_id = 0;
+	List<PathQuery *> queued_path_queries;
+	/// Queries that can still be polled or cancelled.
+	HashMap<int64_t, PathQuery *> path_queries;
+
+	/// Shared by the path queries and the agent avoidance, both run from `process`.
+	ThreadWorkPool work_pool;
+	bool work_pool_initialized = false;
+	uint64_t path_query_time_budget_usec = 0;
+	LocalVector<PathQuery *> path_query_batch;
+	LocalVector<PathQuery *> path_query_callbacks;
+
 public:
 	GodotNavigationServer();
 	virtual ~GodotNavigationServer();
@@ -102,8 +147,16 @@ public:
 	COMMAND_2(map_set_edge_connection_margin, RID, p_map, real_t, p_connection_margin);
 	virtual real_t map_get_edge_connection_margin(RID p_map) const;
 
+	virtual int64_t map_get_sync_info(RID p_map, MapSyncInfo p_info) const;
+
 	virtual Vector<Vector3> map_get_path(RID p_map, Vector3 p_origin, Vector3 p_destination, bool p_optimize, uint32_t p_layers = 1) const;
 
+	virtual int64_t map_request_path(RID p_map, Vector3 p_origin, Vector3 p_destination, bool p_optimize, uint32_t p_layers = 1, Object *p_receiver = nullptr, StringName p_method = StringName(), Variant p_udata = Variant()) const;
+	virtual bool path_query_is_done(int64_t p_query) const;
+	virtual Vector<Vector3> path_query_get_path(int64_t p_query) const;
+	virtual void path_query_cancel(int64_t p_query) const;
+	virtual int get_path_query_queue_depth() const;
+
 	virtual Vector3 map_get_closest_point_to_segment(RID p_map, const Vector3 &p_from, const Vector3 &p_to, const bool p_use_collision = false) const;
 	virtual Vector3 map_get_closest_point(RID p_map, const Vector3 &p_point) const;
 	virtual Vector3 map_get_closest_point_normal(RID p_map, const Vector3 &p_point) const;
@@ -116,6 +169,7 @@ public:
 	COMMAND_2(region_set_transform, RID, p_region, Transform3D, p_transform);
 	COMMAND_2(region_set_navmesh, RID, p_region, Ref<NavigationMesh>, p_nav_mesh);
 	virtual void region_bake_navmesh(Ref<NavigationMesh> r_mesh, Node *p_node) const;
+	virtual void region_bake_navmesh_area(Ref<NavigationMesh> r_mesh, Node *p_node, const AABB &p_area) const;
 	virtual int region_get_connections_count(RID p_region) const;
 	virtual Vector3 region_get_connection_pathway_start(RID p_region, int p_connection_id) const;
 	virtual Vector3 region_get_connection_pathway_end(RID p_region, int p_connection_id) const;
@@ -140,6 +194,12 @@ public:
 
 	void flush_queries();
 	virtual void process(real_t p_delta_time);
+
+private:
+	ThreadWorkPool *_get_work_pool();
+	void _process_path_query(uint32_t p_index, PathQuery **p_queries);
+	void _process_path_queries();
+	void _dispatch_path_query_callbacks();
 };
 
 #undef COMMAND_1
@@ -30,7 +30,7 @@
 
 #include "nav_map.h"
 
-#include "core/os/threaded_array_processor.h"
+#include "core/os/os.h"
 #include "nav_region.h"
 #include "rvo_agent.h"
 
@@ -57,6 +57,12 @@ void NavMap::set_edge_connection_margin(float p_edge_connection_margin) {
 	regenerate_links = true;
 }
 
+NavMap::~NavMap() {
+	for (uint32_t i = 0; i < path_search_contexts.size(); i++) {
+		memdelete(path_search_contexts[i]);
+	}
+}
+
 gd::PointKey NavMap::get_point_key(const Vector3 &p_pos) const {
 	const int x = int(Math::floor(p_pos.x / cell_size));
 	const int y = int(Math::floor(p_pos.y / cell_size));
@@ -70,47 +76,246 @@ gd::PointKey NavMap::get_point_key(const Vector3 &p_pos) const {
 	return p;
 }
 
-Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p_optimize, uint32_t p_layers) const {
-	// Find the start poly and the end poly on this map.
-	const gd::Polygon *begin_poly = nullptr;
-	const gd::Polygon *end_poly = nullptr;
-	Vector3 begin_point;
-	Vector3 end_point;
-	float begin_d = 1e20;
-	float end_d = 1e20;
-	// Find the initial poly and the end poly on this map.
-	for (size_t i(0); i < polygons.size(); i++) {
-		const gd::Polygon &p = polygons[i];
-
-		// Only consider the polygon if it in a region with compatible layers.
-		if ((p_layers & p.owner->get_layers()) == 0) {
-			continue;
-		}
+static real_t _get_aabb_distance(const AABB &p_a, const AABB &p_b) {
+	const Vector3 a_end = p_a.position + p_a.size;
+	const Vector3 b_end = p_b.position + p_b.size;
+	Vector3 gap;
+	for (int i = 0; i < 3; i++) {
+		gap[i] = MAX(0.0, MAX(p_a.position[i] - b_end[i], p_b.position[i] - a_end[i]));
+	}
+	return gap.length();
+}
+
+// BVH queries: `get_lower_bound()` bounds the distance of everything inside an AABB, `measure()`
+// tests one polygon. Ties between polygons go to the lowest index, as with a linear scan.
 
-		// For each point cast a face and check the distance between the origin/destination
+struct NavMapPathEndpointQuery {
+	const LocalVector<gd::Polygon *> *polygons = nullptr;
+	Vector3 location;
+	AABB bounds;
+
+	real_t best_distance = 1e20;
+	uint32_t best_index = UINT32_MAX;
+	Vector3 best_point;
+
+	real_t get_lower_bound(const AABB &p_aabb) const {
+		return _get_aabb_distance(p_aabb, bounds);
+	}
+
+	void measure(uint32_t p_index) {
+		const gd::Polygon &p = *(*polygons)[p_index];
+
+		// For each point cast a face and check the distance to the location.
 		for (size_t point_id = 0; point_id < p.points.size(); point_id++) {
 			const Vector3 p1 = p.points[point_id].pos;
 			const Vector3 p2 = p.points[(point_id + 1) % p.points.size()].pos;
 			const Vector3 p3 = p.points[(point_id + 2) % p.points.size()].pos;
 			const Face3 face(p1, p2, p3);
 
-			Vector3 point = face.get_closest_point_to(p_origin);
-			float distance_to_point = point.distance_to(p_origin);
-			if (distance_to_point < begin_d) {
-				begin_d = distance_to_point;
-				begin_poly = &p;
-				begin_point = point;
+			const Vector3 point = face.get_closest_point_to(location);
+			const real_t d = point.distance_to(location);
+			if (d < best_distance || (d == best_distance && p_index < best_index)) {
+				best_distance = d;
+				best_index = p_index;
+				best_point = point;
+			}
+		}
+	}
+
+	NavMapPathEndpointQuery(const LocalVector<gd::Polygon *> *p_polygons, const Vector3 &p_location) :
+			polygons(p_polygons),
+			location(p_location),
+			bounds(p_location, Vector3()) {}
+};
+
+struct NavMapClosestPointQuery {
+	const LocalVector<gd::Polygon *> *polygons = nullptr;
+	Vector3 location;
+	AABB bounds;
+
+	real_t best_distance = 1e20;
+	uint32_t best_index = UINT32_MAX;
+	Vector3 best_point;
+	Vector3 best_normal;
+
+	real_t get_lower_bound(const AABB &p_aabb) const {
+		return _get_aabb_distance(p_aabb, bounds);
+	}
+
+	void measure(uint32_t p_index) {
+		const gd::Polygon &p = *(*polygons)[p_index];
+
+		// For each point cast a face and check the distance to the point
+		for (size_t point_id = 2; point_id < p.points.size(); point_id += 1) {
+			const Face3 f(p.points[point_id - 2].pos, p.points[point_id - 1].pos, p.points[point_id].pos);
+			const Vector3 inters = f.get_closest_point_to(location);
+			const real_t d = inters.distance_to(location);
+			if (d < best_distance || (d == best_distance && p_index < best_index)) {
+				best_distance = d;
+				best_index = p_index;
+				best_point = inters;
+				best_normal = f.get_plane().normal;
+			}
+		}
+	}
+
+	NavMapClosestPointQuery(const LocalVector<gd::Polygon *> *p_polygons, const Vector3 &p_location) :
+			polygons(p_polygons),
+			location(p_location),
+			bounds(p_location, Vector3()) {}
+};
+
+struct NavMapSegmentIntersectionQuery {
+	const LocalVector<gd::Polygon *> *polygons = nullptr;
+	Vector3 from;
+	Vector3 to;
+	AABB bounds;
+
+	real_t best_distance = 1e20;
+	uint32_t best_index = UINT32_MAX;
+	Vector3 best_point;
+
+	real_t get_lower_bound(const AABB &p_aabb) const {
+		if (!p_aabb.intersects_inclusive(bounds)) {
+			return 1e30; // Out of reach of any match.
+		}
+		return _get_aabb_distance(p_aabb, AABB(from, Vector3()));
+	}
+
+	void measure(uint32_t p_index) {
+		const gd::Polygon &p = *(*polygons)[p_index];
+
+		// For each point cast a face and check the distance to the segment start.
+		for (size_t point_id = 2; point_id < p.points.size(); point_id += 1) {
+			const Face3 f(p.points[point_id - 2].pos, p.points[point_id - 1].pos, p.points[point_id].pos);
+			Vector3 inters;
+			if (f.intersects_segment(from, to, &inters)) {
+				const real_t d = from.distance_to(inters);
+				if (d < best_distance || (d == best_distance && p_index < best_index)) {
+					best_distance = d;
+					best_index = p_index;
+					best_point = inters;
+				}
+			}
+		}
+	}
+
+	NavMapSegmentIntersectionQuery(const LocalVector<gd::Polygon *> *p_polygons, const Vector3 &p_from, const Vector3 &p_to) :
+			polygons(p_polygons),
+			from(p_from),
+			to(p_to),
+			bounds(p_from, Vector3()) {
+		bounds.expand_to(p_to);
+	}
+};
+
+struct NavMapSegmentClosestEdgeQuery {
+	const LocalVector<gd::Polygon *> *polygons = nullptr;
+	Vector3 from;
+	Vector3 to;
+	AABB bounds;
+
+	real_t best_distance = 1e20;
+	uint32_t best_index = UINT32_MAX;
+	Vector3 best_point;
+
+	real_t get_lower_bound(const AABB &p_aabb) const {
+		return _get_aabb_distance(p_aabb, bounds);
+	}
+
+	void measure(uint32_t p_index) {
+		const gd::Polygon &p = *(*polygons)[p_index];
+
+		for (size_t point_id = 0; point_id < p.points.size(); point_id += 1) {
+			Vector3 a, b;
+
+			Geometry3D::get_closest_points_between_segments(
+					from,
+					to,
+					p.points[point_id].pos,
+					p.points[(point_id + 1) % p.points.size()].pos,
+					a,
+					b);
+
+			const real_t d = a.distance_to(b);
+			if (d < best_distance || (d == best_distance && p_index < best_index)) {
+				best_distance = d;
+				best_index = p_index;
+				best_point = b;
 			}
+		}
+	}
+
+	NavMapSegmentClosestEdgeQuery(const LocalVector<gd::Polygon *> *p_polygons, const Vector3 &p_from, const Vector3 &p_to) :
+			polygons(p_polygons),
+			from(p_from),
+			to(p_to),
+			bounds(p_from, Vector3()) {
+		bounds.expand_to(p_to);
+	}
+};
+
+template <class Q>
+void NavMap::_query_polygon_bvh(bool p_filter_layers, uint32_t p_layers, Q &r_query) const {
+	if (polygon_bvh.is_empty()) {
+		return;
+	}
 
-			point = face.get_closest_point_to(p_destination);
-			distance_to_point = point.distance_to(p_destination);
-			if (distance_to_point < end_d) {
-				end_d = distance_to_point;
-				end_poly = &p;
-				end_point = point;
+	// Depth first, nearest child first, skipping nodes that can't hold anything closer than the best match.
+	struct StackEntry {
+		uint32_t node;
+		real_t lower_bound;
+	};
+	StackEntry stack[POLYGON_BVH_STACK_SIZE];
+	uint32_t stack_size = 0;
+	stack[stack_size++] = { 0, r_query.get_lower_bound(polygon_bvh[0].aabb) };
+
+	while (stack_size) {
+		const StackEntry entry = stack[--stack_size];
+		if (entry.lower_bound > r_query.best_distance) {
+			continue;
+		}
+
+		const PolygonBVHNode &node = polygon_bvh[entry.node];
+		if (p_filter_layers && (node.layers & p_layers) == 0) {
+			continue;
+		}
+
+		if (node.count) {
+			for (uint32_t i = node.index; i < node.index + node.count; i++) {
+				const uint32_t polygon_index = polygon_bvh_items[i];
+				// Only consider the polygon if it in a region with compatible layers.
+				if (p_filter_layers && (p_layers & polygons[polygon_index]->owner->get_layers()) == 0) {
+					continue;
+				}
+				r_query.measure(polygon_index);
 			}
+			continue;
 		}
+
+		StackEntry near = { entry.node + 1, r_query.get_lower_bound(polygon_bvh[entry.node + 1].aabb) };
+		StackEntry far = { node.index, r_query.get_lower_bound(polygon_bvh[node.index].aabb) };
+		if (far.lower_bound < near.lower_bound) {
+			SWAP(near, far);
+		}
+		ERR_FAIL_COND(stack_size + 2 > POLYGON_BVH_STACK_SIZE);
+		stack[stack_size++] = far;
+		stack[stack_size++] = near;
 	}
+}
+
+Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p_optimize, uint32_t p_layers) const {
+	// Find the start poly and the end poly on this map.
+	NavMapPathEndpointQuery begin_query(&polygons, p_origin);
+	_query_polygon_bvh(true, p_layers, begin_query);
+	NavMapPathEndpointQuery end_query(&polygons, p_destination);
+	_query_polygon_bvh(true, p_layers, end_query);
+
+	const gd::Polygon *begin_poly = begin_query.best_index != UINT32_MAX ? polygons[begin_query.best_index] : nullptr;
+	const gd::Polygon *end_poly = end_query.best_index != UINT32_MAX ? polygons[end_query.best_index] : nullptr;
+	const Vector3 begin_point = begin_query.best_point;
+	Vector3 end_point = end_query.best_point;
+	float end_d = end_query.best_distance;
 
 	// Check for trivial cases
 	if (!begin_poly || !end_poly) {
@@ -124,24 +329,19 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 		return path;
 	}
 
-	// List of all reachable navigation polys.
-	std::vector<gd::NavigationPoly> navigation_polys;
-	navigation_polys.reserve(polygons.size() * 0.75);
+	// Reachable navigation polys, indexed by polygon id.
+	gd::PathSearchContext *context = _acquire_path_search_context();
+	context->begin(polygons.size());
+	LocalVector<gd::NavigationPoly> &navigation_polys = context->navigation_polys;
 
 	// Add the start polygon to the reachable navigation polygons.
-	gd::NavigationPoly begin_navigation_poly = gd::NavigationPoly(begin_poly);
-	begin_navigation_poly.self_id = 0;
+	gd::NavigationPoly &begin_navigation_poly = context->visit(begin_poly->id, begin_poly);
 	begin_navigation_poly.entry = begin_point;
 	begin_navigation_poly.back_navigation_edge_pathway_start = begin_point;
 	begin_navigation_poly.back_navigation_edge_pathway_end = begin_point;
-	navigation_polys.push_back(begin_navigation_poly);
-
-	// List of polygon IDs to visit.
-	List<uint32_t> to_visit;
-	to_visit.push_back(0);
 
 	// This is an implementation of the A* algorithm.
-	int least_cost_id = 0;
+	uint32_t least_cost_id = begin_poly->id;
 	bool found_route = false;
 
 	const gd::Polygon *reachable_end = nullptr;
@@ -168,44 +368,41 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 				const Vector3 new_entry = Geometry3D::get_closest_point_to_segment(least_cost_poly->entry, pathway);
 				const float new_distance = least_cost_poly->entry.distance_to(new_entry) + least_cost_poly->traveled_distance;
 
-				const std::vector<gd::NavigationPoly>::iterator it = std::find(
-						navigation_polys.begin(),
-						navigation_polys.end(),
-						gd::NavigationPoly(connection.polygon));
-
-				if (it != navigation_polys.end()) {
+				const uint32_t neighbor_id = connection.polygon->id;
+				if (context->is_visited(neighbor_id)) {
 					// Polygon already visited, check if we can reduce the travel cost.
-					if (new_distance < it->traveled_distance) {
-						it->back_navigation_poly_id = least_cost_id;
-						it->back_navigation_edge = connection.edge;
-						it->back_navigation_edge_pathway_start = connection.pathway_start;
-						it->back_navigation_edge_pathway_end = connection.pathway_end;
-						it->traveled_distance = new_distance;
-						it->entry = new_entry;
+					gd::NavigationPoly &neighbor = navigation_polys[neighbor_id];
+					if (new_distance < neighbor.traveled_distance) {
+						neighbor.back_navigation_poly_id = least_cost_id;
+						neighbor.back_navigation_edge = connection.edge;
+						neighbor.back_navigation_edge_pathway_start = connection.pathway_start;
+						neighbor.back_navigation_edge_pathway_end = connection.pathway_end;
+						neighbor.traveled_distance = new_distance;
+						neighbor.entry = new_entry;
+						if (neighbor.heap_index != UINT32_MAX) {
+							neighbor.cost = new_distance + new_entry.distance_to(end_point);
+							context->update_open(neighbor_id);
+						}
 					}
 				} else {
 					// Add the neighbour polygon to the reachable ones.
-					gd::NavigationPoly new_navigation_poly = gd::NavigationPoly(connection.polygon);
-					new_navigation_poly.self_id = navigation_polys.size();
+					gd::NavigationPoly &new_navigation_poly = context->visit(neighbor_id, connection.polygon);
 					new_navigation_poly.back_navigation_poly_id = least_cost_id;
 					new_navigation_poly.back_navigation_edge = connection.edge;
 					new_navigation_poly.back_navigation_edge_pathway_start = connection.pathway_start;
 					new_navigation_poly.back_navigation_edge_pathway_end = connection.pathway_end;
 					new_navigation_poly.traveled_distance = new_distance;
 					new_navigation_poly.entry = new_entry;
-					navigation_polys.push_back(new_navigation_poly);
+					new_navigation_poly.cost = new_distance + new_entry.distance_to(end_point);
 
 					// Add the neighbour polygon to the polygons to visit.
-					to_visit.push_back(navigation_polys.size() - 1);
+					context->push_open(neighbor_id);
 				}
 			}
 		}
 
-		// Removes the least cost polygon from the list of polygons to visit so we can advance.
-		to_visit.erase(least_cost_id);
-
 		// When the list of polygons to visit is empty at this point it means the End Polygon is not reachable
-		if (to_visit.size() == 0) {
+		if (context->open.is_empty()) {
 			// Thus use the further reachable polygon
 			ERR_BREAK_MSG(is_reachable == false, "It's not expect to not find the most reachable polygons");
 			is_reachable = false;
@@ -228,29 +425,18 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 			}
 
 			// Reset open and navigation_polys
-			gd::NavigationPoly np = navigation_polys[0];
-			navigation_polys.clear();
-			navigation_polys.push_back(np);
-			to_visit.clear();
-			to_visit.push_back(0);
+			gd::NavigationPoly np = navigation_polys[begin_poly->id];
+			context->begin(polygons.size());
+			context->visit(begin_poly->id, begin_poly) = np;
+			least_cost_id = begin_poly->id;
 
 			reachable_end = nullptr;
 
 			continue;
 		}
 
-		// Find the polygon with the minimum cost from the list of polygons to visit.
-		least_cost_id = -1;
-		float least_cost = 1e30;
-		for (List<uint32_t>::Element *element = to_visit.front(); element != nullptr; element = element->next()) {
-			gd::NavigationPoly *np = &navigation_polys[element->get()];
-			float cost = np->traveled_distance;
-			cost += np->entry.distance_to(end_point);
-			if (cost < least_cost) {
-				least_cost_id = np->self_id;
-				least_cost = cost;
-			}
-		}
+		// Take the polygon with the minimum cost from the list of polygons to visit.
+		least_cost_id = context->pop_open();
 
 		// Stores the further reachable end polygon, in case our goal is not reachable.
 		if (is_reachable) {
@@ -261,8 +447,6 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 			}
 		}
 
-		ERR_BREAK(least_cost_id == -1);
-
 		// Check if we reached the end
 		if (navigation_polys[least_cost_id].poly == end_poly) {
 			found_route = true;
@@ -272,6 +456,7 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 
 	// If we did not find a route, return an empty path.
 	if (!found_route) {
+		_release_path_search_context(context);
 		return Vector<Vector3>();
 	}
 
@@ -366,149 +551,121 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 		path.reverse();
 	}
 
+	_release_path_search_context(context);
 	return path;
 }
 
 Vector3 NavMap::get_closest_point_to_segment(const Vector3 &p_from, const Vector3 &p_to, const bool p_use_collision) const {
-	bool use_collision = p_use_collision;
-	Vector3 closest_point;
-	real_t closest_point_d = 1e20;
-
-	// Find the initial poly and the end poly on this map.
-	for (size_t i(0); i < polygons.size(); i++) {
-		const gd::Polygon &p = polygons[i];
-
-		// For each point cast a face and check the distance to the segment
-		for (size_t point_id = 2; point_id < p.points.size(); point_id += 1) {
-			const Face3 f(p.points[point_id - 2].pos, p.points[point_id - 1].pos, p.points[point_id].pos);
-			Vector3 inters;
-			if (f.intersects_segment(p_from, p_to, &inters)) {
-				const real_t d = closest_point_d = p_from.distance_to(inters);
-				if (use_collision == false) {
-					closest_point = inters;
-					use_collision = true;
-					closest_point_d = d;
-				} else if (closest_point_d > d) {
-					closest_point = inters;
-					closest_point_d = d;
-				}
-			}
-		}
-
-		if (use_collision == false) {
-			for (size_t point_id = 0; point_id < p.points.size(); point_id += 1) {
-				Vector3 a, b;
-
-				Geometry3D::get_closest_points_between_segments(
-						p_from,
-						p_to,
-						p.points[point_id].pos,
-						p.points[(point_id + 1) % p.points.size()].pos,
-						a,
-						b);
+	// Prefer the intersection closest to the segment start.
+	NavMapSegmentIntersectionQuery intersection_query(&polygons, p_from, p_to);
+	_query_polygon_bvh(false, 0, intersection_query);
+	if (intersection_query.best_index != UINT32_MAX) {
+		return intersection_query.best_point;
+	}
 
-				const real_t d = a.distance_to(b);
-				if (d < closest_point_d) {
-					closest_point_d = d;
-					closest_point = b;
-				}
-			}
-		}
+	if (p_use_collision) {
+		return Vector3();
 	}
 
-	return closest_point;
+	// Otherwise the closest point on the polygon edges.
+	NavMapSegmentClosestEdgeQuery edge_query(&polygons, p_from, p_to);
+	_query_polygon_bvh(false, 0, edge_query);
+	return edge_query.best_point;
 }
 
 Vector3 NavMap::get_closest_point(const Vector3 &p_point) const {
-	// TODO this is really not optimal, please redesign the API to directly return all this data
-
-	Vector3 closest_point;
-	real_t closest_point_d = 1e20;
-
-	// Find the initial poly and the end poly on this map.
-	for (size_t i(0); i < polygons.size(); i++) {
-		const gd::Polygon &p = polygons[i];
-
-		// For each point cast a face and check the distance to the point
-		for (size_t point_id = 2; point_id < p.points.size(); point_id += 1) {
-			const Face3 f(p.points[point_id - 2].pos, p.points[point_id - 1].pos, p.points[point_id].pos);
-			const Vector3 inters = f.get_closest_point_to(p_point);
-			const real_t d = inters.distance_to(p_point);
-			if (d < closest_point_d) {
-				closest_point = inters;
-				closest_point_d = d;
-			}
-		}
-	}
-
-	return closest_point;
+	NavMapClosestPointQuery query(&polygons, p_point);
+	_query_polygon_bvh(false, 0, query);
+	return query.best_point;
 }
 
 Vector3 NavMap::get_closest_point_normal(const Vector3 &p_point) const {
-	// TODO this is really not optimal, please redesign the API to directly return all this data
-
-	Vector3 closest_point;
-	Vector3 closest_point_normal;
-	real_t closest_point_d = 1e20;
-
-	// Find the initial poly and the end poly on this map.
-	for (size_t i(0); i < polygons.size(); i++) {
-		const gd::Polygon &p = polygons[i];
-
-		// For each point cast a face and check the distance to the point
-		for (size_t point_id = 2; point_id < p.points.size(); point_id += 1) {
-			const Face3 f(p.points[point_id - 2].pos, p.points[point_id - 1].pos, p.points[point_id].pos);
-			const Vector3 inters = f.get_closest_point_to(p_point);
-			const real_t d = inters.distance_to(p_point);
-			if (d < closest_point_d) {
-				closest_point = inters;
-				closest_point_normal = f.get_plane().normal;
-				closest_point_d = d;
-			}
-		}
-	}
-
-	return closest_point_normal;
+	NavMapClosestPointQuery query(&polygons, p_point);
+	_query_polygon_bvh(false, 0, query);
+	return query.best_normal;
 }
 
 RID NavMap::get_closest_point_owner(const Vector3 &p_point) const {
-	// TODO this is really not optimal, please redesign the API to directly return all this data
-
-	Vector3 closest_point;
-	RID closest_point_owner;
-	real_t closest_point_d = 1e20;
-
-	// Find the initial poly and the end poly on this map.
-	for (size_t i(0); i < polygons.size(); i++) {
-		const gd::Polygon &p = polygons[i];
+	NavMapClosestPointQuery query(&polygons, p_point);
+	_query_polygon_bvh(false, 0, query);
+	if (query.best_index == UINT32_MAX) {
+		return RID();
+	}
+	return polygons[query.best_index]->owner->get_self();
+}
 
-		// For each point cast a face and check the distance to the point
-		for (size_t point_id = 2; point_id < p.points.size(); point_id += 1) {
-			const Face3 f(p.points[point_id - 2].pos, p.points[point_id - 1].pos, p.points[point_id].pos);
-			const Vector3 inters = f.get_closest_point_to(p_point);
-			const real_t d = inters.distance_to(p_point);
-			if (d < closest_point_d) {
-				closest_point = inters;
-				closest_point_owner = p.owner->get_self();
-				closest_point_d = d;
-			}
-		}
+gd::PathSearchContext *NavMap::_acquire_path_search_context() const {
+	MutexLock lock(path_search_contexts_mutex);
+	if (path_search_contexts.is_empty()) {
+		return memnew(gd::PathSearchContext);
 	}
+	gd::PathSearchContext *context = path_search_contexts[path_search_contexts.size() - 1];
+	path_search_contexts.resize(path_search_contexts.size() - 1);
+	return context;
+}
 
-	return closest_point_owner;
+void NavMap::_release_path_search_context(gd::PathSearchContext *p_context) const {
+	MutexLock lock(path_search_contexts_mutex);
+	path_search_contexts.push_back(p_context);
 }
 
 void NavMap::add_region(NavRegion *p_region) {
+	// The region is dirty until its first sync, which connects it.
 	regions.push_back(p_region);
-	regenerate_links = true;
 }
 
 void NavMap::remove_region(NavRegion *p_region) {
 	const std::vector<NavRegion *>::iterator it = std::find(regions.begin(), regions.end(), p_region);
 	if (it != regions.end()) {
 		regions.erase(it);
-		regenerate_links = true;
+		if (!p_region->get_polygons().empty()) {
+			affected_bounds.push_back(p_region->get_bounds());
+		}
+		polygons_changed = true;
+		_remove_region_polygons(p_region);
+	}
+}
+
+void NavMap::_remove_region_polygons(NavRegion *p_region) {
+	// The region can be freed before the next sync, so its polygons and the connections to them
+	// are dropped now. The edges left free are connected again by the next sync.
+	const std::vector<gd::Polygon> &region_polygons = p_region->get_polygons();
+	if (region_polygons.empty()) {
+		return;
+	}
+	const gd::Polygon *region_begin = &region_polygons[0];
+	const gd::Polygon *region_end = region_begin + region_polygons.size();
+
+	uint32_t count = 0;
+	for (uint32_t i = 0; i < polygons.size(); i++) {
+		gd::Polygon *p = polygons[i];
+		if (p >= region_begin && p < region_end) {
+			continue;
+		}
+		for (size_t e(0); e < p->edges.size(); e++) {
+			Vector<gd::Edge::Connection> &connections = p->edges[e].connections;
+			for (int c = connections.size() - 1; c >= 0; c--) {
+				if (connections[c].polygon >= region_begin && connections[c].polygon < region_end) {
+					connections.remove(c);
+				}
+			}
+		}
+		p->id = count;
+		polygons[count] = p;
+		polygon_aabbs[count] = polygon_aabbs[i];
+		count++;
+	}
+	if (count == polygons.size()) {
+		return;
+	}
+
+	polygons.resize(count);
+	polygon_aabbs.resize(count);
+	_build_polygon_bvh();
+	if (!polygon_bvh.is_empty()) {
+		_update_polygon_bvh_layers(0);
 	}
+	map_update_id = (map_update_id + 1) % 9999999;
 }
 
 bool NavMap::has_agent(RvoAgent *agent) const {
@@ -547,6 +704,8 @@ void NavMap::remove_agent_as_controlled(RvoAgent *agent) {
 }
 
 void NavMap::sync() {
+	const uint64_t sync_begin = OS::get_singleton()->get_ticks_usec();
+
 	// Check if we need to update the links.
 	if (regenerate_polygons) {
 		for (size_t r(0); r < regions.size(); r++) {
@@ -555,173 +714,542 @@ void NavMap::sync() {
 		regenerate_links = true;
 	}
 
+	uint32_t dirty_regions = 0;
 	for (size_t r(0); r < regions.size(); r++) {
-		if (regions[r]->sync()) {
-			regenerate_links = true;
+		NavRegion *region = regions[r];
+		const bool had_polygons = region->is_dirty() && !region->get_polygons().empty();
+		const AABB old_bounds = region->get_bounds();
+		if (region->sync()) {
+			// Both the area left by the region and the one it now covers have to be reconnected.
+			if (had_polygons) {
+				affected_bounds.push_back(old_bounds);
+			}
+			if (!region->get_polygons().empty()) {
+				affected_bounds.push_back(region->get_bounds());
+			}
+			region->get_connections().clear();
+			polygons_changed = true;
+			dirty_regions++;
 		}
 	}
 
-	if (regenerate_links) {
-		// Remove regions connections.
-		for (size_t r(0); r < regions.size(); r++) {
-			regions[r]->get_connections().clear();
-		}
-
-		// Resize the polygon count.
-		int count = 0;
+	const bool map_changed = regenerate_links || polygons_changed;
+	if (map_changed) {
+		// Collect the polygons of all the regions, the unchanged ones keep their connections.
+		uint32_t count = 0;
 		for (size_t r(0); r < regions.size(); r++) {
 			count += regions[r]->get_polygons().size();
 		}
 		polygons.resize(count);
+		polygon_aabbs.resize(count);
 
-		// Copy all region polygons in the map.
 		count = 0;
 		for (size_t r(0); r < regions.size(); r++) {
-			std::copy(
-					regions[r]->get_polygons().data(),
-					regions[r]->get_polygons().data() + regions[r]->get_polygons().size(),
-					polygons.begin() + count);
-			count += regions[r]->get_polygons().size();
+			std::vector<gd::Polygon> &region_polygons = regions[r]->get_polygons();
+			for (size_t i(0); i < region_polygons.size(); i++) {
+				gd::Polygon &p = region_polygons[i];
+				AABB aabb(p.points.empty() ? p.center : p.points[0].pos, Vector3());
+				for (size_t point_id = 1; point_id < p.points.size(); point_id++) {
+					aabb.expand_to(p.points[point_id].pos);
+				}
+				p.id = count;
+				polygons[count] = &p;
+				polygon_aabbs[count] = aabb;
+				count++;
+			}
 		}
 
-		// Group all edges per key.
-		Map<gd::EdgeKey, Vector<gd::Edge::Connection>> connections;
-		for (size_t poly_id(0); poly_id < polygons.size(); poly_id++) {
-			gd::Polygon &poly(polygons[poly_id]);
+		_build_polygon_bvh();
 
-			for (size_t p(0); p < poly.points.size(); p++) {
-				int next_point = (p + 1) % poly.points.size();
-				gd::EdgeKey ek(poly.points[p].key, poly.points[next_point].key);
+		last_sync_relinked_polygons = _update_connections(regenerate_links);
+		last_sync_dirty_regions = dirty_regions;
+		last_sync_full_relink = regenerate_links;
+		last_sync_usec = OS::get_singleton()->get_ticks_usec() - sync_begin;
 
-				Map<gd::EdgeKey, Vector<gd::Edge::Connection>>::Element *connection = connections.find(ek);
-				if (!connection) {
-					connections[ek] = Vector<gd::Edge::Connection>();
-				}
-				if (connections[ek].size() <= 1) {
-					// Add the polygon/edge tuple to this key.
-					gd::Edge::Connection new_connection;
-					new_connection.polygon = &poly;
-					new_connection.edge = p;
-					new_connection.pathway_start = poly.points[p].pos;
-					new_connection.pathway_end = poly.points[next_point].pos;
-					connections[ek].push_back(new_connection);
-				} else {
-					// The edge is already connected with another edge, skip.
-					ERR_PRINT("Attempted to merge a navigation mesh triangle edge with another already-merged edge. This happens when the current `cell_size` is different from the one used to generate the navigation mesh. This will cause navigation problem.");
+		// Update the update ID.
+		map_update_id = (map_update_id + 1) % 9999999;
+	}
+	affected_bounds.clear();
+
+	// Region layers can change without the polygons changing, keep the BVH masks current.
+	bool bvh_layers_dirty = map_changed;
+	if (polygon_bvh_region_layers.size() != regions.size()) {
+		polygon_bvh_region_layers.resize(regions.size());
+		bvh_layers_dirty = true;
+	}
+	for (size_t r(0); r < regions.size(); r++) {
+		if (polygon_bvh_region_layers[r] != regions[r]->get_layers()) {
+			polygon_bvh_region_layers[r] = regions[r]->get_layers();
+			bvh_layers_dirty = true;
+		}
+	}
+	if (bvh_layers_dirty && !polygon_bvh.is_empty()) {
+		_update_polygon_bvh_layers(0);
+	}
+
+	regenerate_polygons = false;
+	regenerate_links = false;
+	polygons_changed = false;
+}
+
+enum {
+	NAV_MAP_POLYGON_UNTOUCHED,
+	/// The polygon connections are rebuilt.
+	NAV_MAP_POLYGON_RELINK,
+	/// The polygon is only a connection target for the relinked ones.
+	NAV_MAP_POLYGON_NEIGHBOR,
+};
+
+struct NavMapFreeEdge {
+	gd::Edge::Connection connection;
+	Vector3 p1;
+	Vector3 p2;
+	/// Bounds of the edge grown by half the connection margin, edges close enough to connect overlap.
+	AABB aabb;
+	bool relink = false;
+};
+
+struct NavMapFreeEdgeCompare {
+	bool operator()(const NavMapFreeEdge &p_a, const NavMapFreeEdge &p_b) const {
+		return p_a.aabb.position.x < p_b.aabb.position.x;
+	}
+};
+
+static void _connect_free_edges(const NavMapFreeEdge &p_edge, const NavMapFreeEdge &p_other, real_t p_margin) {
+	const Vector3 &edge_p1 = p_edge.p1;
+	const Vector3 &edge_p2 = p_edge.p2;
+	const Vector3 &other_edge_p1 = p_other.p1;
+	const Vector3 &other_edge_p2 = p_other.p2;
+
+	// Compute the projection of the opposite edge on the current one
+	Vector3 edge_vector = edge_p2 - edge_p1;
+	float projected_p1_ratio = edge_vector.dot(other_edge_p1 - edge_p1) / (edge_vector.length_squared());
+	float projected_p2_ratio = edge_vector.dot(other_edge_p2 - edge_p1) / (edge_vector.length_squared());
+	if ((projected_p1_ratio < 0.0 && projected_p2_ratio < 0.0) || (projected_p1_ratio > 1.0 && projected_p2_ratio > 1.0)) {
+		return;
+	}
+
+	// Check if the two edges are close to each other enough and compute a pathway between the two regions.
+	Vector3 self1 = edge_vector * CLAMP(projected_p1_ratio, 0.0, 1.0) + edge_p1;
+	Vector3 other1;
+	if (projected_p1_ratio >= 0.0 && projected_p1_ratio <= 1.0) {
+		other1 = other_edge_p1;
+	} else {
+		other1 = other_edge_p1.lerp(other_edge_p2, (1.0 - projected_p1_ratio) / (projected_p2_ratio - projected_p1_ratio));
+	}
+	if ((self1 - other1).length() > p_margin) {
+		return;
+	}
+
+	Vector3 self2 = edge_vector * CLAMP(projected_p2_ratio, 0.0, 1.0) + edge_p1;
+	Vector3 other2;
+	if (projected_p2_ratio >= 0.0 && projected_p2_ratio <= 1.0) {
+		other2 = other_edge_p2;
+	} else {
+		other2 = other_edge_p1.lerp(other_edge_p2, (0.0 - projected_p1_ratio) / (projected_p2_ratio - projected_p1_ratio));
+	}
+	if ((self2 - other2).length() > p_margin) {
+		return;
+	}
+
+	// The edges can now be connected.
+	const gd::Edge::Connection &free_edge = p_edge.connection;
+	gd::Edge::Connection new_connection = p_other.connection;
+	new_connection.pathway_start = (self1 + other1) / 2.0;
+	new_connection.pathway_end = (self2 + other2) / 2.0;
+	free_edge.polygon->edges[free_edge.edge].connections.push_back(new_connection);
+
+	// Add the connection to the region connections, keyed by the edge it starts from.
+	gd::Edge::Connection region_connection = new_connection;
+	region_connection.polygon = free_edge.polygon;
+	region_connection.edge = free_edge.edge;
+	free_edge.polygon->owner->get_connections().push_back(region_connection);
+}
+
+struct NavMapPolygonOverlapQuery {
+	const LocalVector<AABB> *aabbs = nullptr;
+	AABB bounds;
+
+	real_t best_distance = 1e20;
+	LocalVector<uint32_t> found;
+
+	real_t get_lower_bound(const AABB &p_aabb) const {
+		return p_aabb.intersects_inclusive(bounds) ? 0.0 : 1e30;
+	}
+
+	void measure(uint32_t p_index) {
+		if ((*aabbs)[p_index].intersects_inclusive(bounds)) {
+			found.push_back(p_index);
+		}
+	}
+
+	NavMapPolygonOverlapQuery(const LocalVector<AABB> *p_aabbs, const AABB &p_bounds) :
+			aabbs(p_aabbs),
+			bounds(p_bounds) {}
+};
+
+uint32_t NavMap::_update_connections(bool p_full) {
+	LocalVector<uint8_t> polygon_states;
+	polygon_states.resize(polygons.size());
+	for (uint32_t i = 0; i < polygons.size(); i++) {
+		polygon_states[i] = p_full ? NAV_MAP_POLYGON_RELINK : NAV_MAP_POLYGON_UNTOUCHED;
+	}
+
+	if (!p_full) {
+		// Relink the polygons close enough to a changed area to be connected with it, and use
+		// the polygons around them as connection targets.
+		for (uint32_t i = 0; i < affected_bounds.size(); i++) {
+			NavMapPolygonOverlapQuery relink_query(&polygon_aabbs, affected_bounds[i].grow(edge_connection_margin));
+			_query_polygon_bvh(false, 0, relink_query);
+			if (relink_query.found.is_empty()) {
+				continue;
+			}
+
+			AABB relink_bounds = polygon_aabbs[relink_query.found[0]];
+			for (uint32_t j = 0; j < relink_query.found.size(); j++) {
+				polygon_states[relink_query.found[j]] = NAV_MAP_POLYGON_RELINK;
+				relink_bounds.merge_with(polygon_aabbs[relink_query.found[j]]);
+			}
+
+			NavMapPolygonOverlapQuery neighbor_query(&polygon_aabbs, relink_bounds.grow(edge_connection_margin));
+			_query_polygon_bvh(false, 0, neighbor_query);
+			for (uint32_t j = 0; j < neighbor_query.found.size(); j++) {
+				if (polygon_states[neighbor_query.found[j]] == NAV_MAP_POLYGON_UNTOUCHED) {
+					polygon_states[neighbor_query.found[j]] = NAV_MAP_POLYGON_NEIGHBOR;
 				}
 			}
 		}
+	}
+
+	// Remove the connections that are rebuilt.
+	uint32_t relinked_count = 0;
+	for (uint32_t i = 0; i < polygons.size(); i++) {
+		if (polygon_states[i] == NAV_MAP_POLYGON_RELINK) {
+			// The connected polygons may be gone, never read these connections.
+			for (size_t e(0); e < polygons[i]->edges.size(); e++) {
+				polygons[i]->edges[e].connections.clear();
+			}
+			relinked_count++;
+		}
+	}
+	for (size_t r(0); r < regions.size(); r++) {
+		Vector<gd::Edge::Connection> &region_connections = regions[r]->get_connections();
+		if (p_full) {
+			region_connections.clear();
+			continue;
+		}
+		// Changed regions were cleared during the sync, the others only start from valid polygons.
+		Vector<gd::Edge::Connection> kept_connections;
+		for (int i = 0; i < region_connections.size(); i++) {
+			if (polygon_states[region_connections[i].polygon->id] != NAV_MAP_POLYGON_RELINK) {
+				kept_connections.push_back(region_connections[i]);
+			}
+		}
+		if (kept_connections.size() != region_connections.size()) {
+			region_connections = kept_connections;
+		}
+	}
+
+	if (relinked_count == 0) {
+		return 0;
+	}
+
+	// Group all edges per key.
+	Map<gd::EdgeKey, Vector<gd::Edge::Connection>> connections;
+	for (uint32_t poly_id = 0; poly_id < polygons.size(); poly_id++) {
+		if (polygon_states[poly_id] == NAV_MAP_POLYGON_UNTOUCHED) {
+			continue;
+		}
+		gd::Polygon &poly(*polygons[poly_id]);
+
+		for (size_t p(0); p < poly.points.size(); p++) {
+			int next_point = (p + 1) % poly.points.size();
+			gd::EdgeKey ek(poly.points[p].key, poly.points[next_point].key);
+
+			Map<gd::EdgeKey, Vector<gd::Edge::Connection>>::Element *connection = connections.find(ek);
+			if (!connection) {
+				connection = connections.insert(ek, Vector<gd::Edge::Connection>());
+			}
+			if (connection->get().size() <= 1) {
+				// Add the polygon/edge tuple to this key.
+				gd::Edge::Connection new_connection;
+				new_connection.polygon = &poly;
+				new_connection.edge = p;
+				new_connection.pathway_start = poly.points[p].pos;
+				new_connection.pathway_end = poly.points[next_point].pos;
+				connection->get().push_back(new_connection);
+			} else {
+				// The edge is already connected with another edge, skip.
+				ERR_PRINT("Attempted to merge a navigation mesh triangle edge with another already-merged edge. This happens when the current `cell_size` is different from the one used to generate the navigation mesh. This will cause navigation problem.");
+			}
+		}
+	}
 
-		Vector<gd::Edge::Connection> free_edges;
-		for (Map<gd::EdgeKey, Vector<gd::Edge::Connection>>::Element *E = connections.front(); E; E = E->next()) {
-			if (E->get().size() == 2) {
-				// Connect edge that are shared in different polygons.
-				gd::Edge::Connection &c1 = E->get().write[0];
-				gd::Edge::Connection &c2 = E->get().write[1];
+	LocalVector<NavMapFreeEdge> free_edges;
+	for (Map<gd::EdgeKey, Vector<gd::Edge::Connection>>::Element *E = connections.front(); E; E = E->next()) {
+		if (E->get().size() == 2) {
+			// Connect edge that are shared in different polygons.
+			gd::Edge::Connection &c1 = E->get().write[0];
+			gd::Edge::Connection &c2 = E->get().write[1];
+			if (polygon_states[c1.polygon->id] == NAV_MAP_POLYGON_RELINK) {
 				c1.polygon->edges[c1.edge].connections.push_back(c2);
+			}
+			if (polygon_states[c2.polygon->id] == NAV_MAP_POLYGON_RELINK) {
 				c2.polygon->edges[c2.edge].connections.push_back(c1);
-				// Note: The pathway_start/end are full for those connection and do not need to be modified.
-			} else {
-				CRASH_COND_MSG(E->get().size() != 1, vformat("Number of connection != 1. Found: %d", E->get().size()));
-				free_edges.push_back(E->get()[0]);
-			}
-		}
-
-		// Find the compatible near edges.
-		//
-		// Note:
-		// Considering that the edges must be compatible (for obvious reasons)
-		// to be connected, create new polygons to remove that small gap is
-		// not really useful and would result in wasteful computation during
-		// connection, integration and path finding.
-		for (int i = 0; i < free_edges.size(); i++) {
-			const gd::Edge::Connection &free_edge = free_edges[i];
-			Vector3 edge_p1 = free_edge.polygon->points[free_edge.edge].pos;
-			Vector3 edge_p2 = free_edge.polygon->points[(free_edge.edge + 1) % free_edge.polygon->points.size()].pos;
-
-			for (int j = 0; j < free_edges.size(); j++) {
-				const gd::Edge::Connection &other_edge = free_edges[j];
-				if (i == j || free_edge.polygon->owner == other_edge.polygon->owner) {
-					continue;
-				}
+			}
+			// Note: The pathway_start/end are full for those connection and do not need to be modified.
+		} else {
+			CRASH_COND_MSG(E->get().size() != 1, vformat("Number of connection != 1. Found: %d", E->get().size()));
+			const gd::Edge::Connection &connection = E->get()[0];
+			NavMapFreeEdge free_edge;
+			free_edge.connection = connection;
+			free_edge.p1 = connection.polygon->points[connection.edge].pos;
+			free_edge.p2 = connection.polygon->points[(connection.edge + 1) % connection.polygon->points.size()].pos;
+			free_edge.aabb = AABB(free_edge.p1, Vector3());
+			free_edge.aabb.expand_to(free_edge.p2);
+			free_edge.aabb.grow_by(edge_connection_margin * 0.5);
+			free_edge.relink = polygon_states[connection.polygon->id] == NAV_MAP_POLYGON_RELINK;
+			free_edges.push_back(free_edge);
+		}
+	}
 
-				Vector3 other_edge_p1 = other_edge.polygon->points[other_edge.edge].pos;
-				Vector3 other_edge_p2 = other_edge.polygon->points[(other_edge.edge + 1) % other_edge.polygon->points.size()].pos;
+	// Find the compatible near edges.
+	//
+	// Note:
+	// Considering that the edges must be compatible (for obvious reasons)
+	// to be connected, create new polygons to remove that small gap is
+	// not really useful and would result in wasteful computation during
+	// connection, integration and path finding.
+	//
+	// The edges are swept along the X axis, so only the ones whose bounds overlap are compared.
+	std::sort(free_edges.ptr(), free_edges.ptr() + free_edges.size(), NavMapFreeEdgeCompare());
+	for (uint32_t i = 0; i < free_edges.size(); i++) {
+		const NavMapFreeEdge &free_edge = free_edges[i];
+		const real_t end_x = free_edge.aabb.position.x + free_edge.aabb.size.x;
+
+		for (uint32_t j = i + 1; j < free_edges.size() && free_edges[j].aabb.position.x <= end_x; j++) {
+			const NavMapFreeEdge &other_edge = free_edges[j];
+			if (free_edge.connection.polygon->owner == other_edge.connection.polygon->owner) {
+				continue;
+			}
+			if (!free_edge.aabb.intersects_inclusive(other_edge.aabb)) {
+				continue;
+			}
 
-				// Compute the projection of the opposite edge on the current one
-				Vector3 edge_vector = edge_p2 - edge_p1;
-				float projected_p1_ratio = edge_vector.dot(other_edge_p1 - edge_p1) / (edge_vector.length_squared());
-				float projected_p2_ratio = edge_vector.dot(other_edge_p2 - edge_p1) / (edge_vector.length_squared());
-				if ((projected_p1_ratio < 0.0 && projected_p2_ratio < 0.0) || (projected_p1_ratio > 1.0 && projected_p2_ratio > 1.0)) {
-					continue;
-				}
+			if (free_edge.relink) {
+				_connect_free_edges(free_edge, other_edge, edge_connection_margin);
+			}
+			if (other_edge.relink) {
+				_connect_free_edges(other_edge, free_edge, edge_connection_margin);
+			}
+		}
+	}
 
-				// Check if the two edges are close to each other enough and compute a pathway between the two regions.
-				Vector3 self1 = edge_vector * CLAMP(projected_p1_ratio, 0.0, 1.0) + edge_p1;
-				Vector3 other1;
-				if (projected_p1_ratio >= 0.0 && projected_p1_ratio <= 1.0) {
-					other1 = other_edge_p1;
-				} else {
-					other1 = other_edge_p1.lerp(other_edge_p2, (1.0 - projected_p1_ratio) / (projected_p2_ratio - projected_p1_ratio));
-				}
-				if ((self1 - other1).length() > edge_connection_margin) {
-					continue;
-				}
+	return relinked_count;
+}
 
-				Vector3 self2 = edge_vector * CLAMP(projected_p2_ratio, 0.0, 1.0) + edge_p1;
-				Vector3 other2;
-				if (projected_p2_ratio >= 0.0 && projected_p2_ratio <= 1.0) {
-					other2 = other_edge_p2;
-				} else {
-					other2 = other_edge_p1.lerp(other_edge_p2, (0.0 - projected_p1_ratio) / (projected_p2_ratio - projected_p1_ratio));
-				}
-				if ((self2 - other2).length() > edge_connection_margin) {
-					continue;
-				}
+struct NavMapPolygonCenterCompare {
+	const LocalVector<AABB> *aabbs = nullptr;
+	int axis = 0;
 
-				// The edges can now be connected.
-				gd::Edge::Connection new_connection = other_edge;
-				new_connection.pathway_start = (self1 + other1) / 2.0;
-				new_connection.pathway_end = (self2 + other2) / 2.0;
-				free_edge.polygon->edges[free_edge.edge].connections.push_back(new_connection);
+	bool operator()(uint32_t p_a, uint32_t p_b) const {
+		return (*aabbs)[p_a].get_center()[axis] < (*aabbs)[p_b].get_center()[axis];
+	}
+};
 
-				// Add the connection to the region_connection map.
-				free_edge.polygon->owner->get_connections().push_back(new_connection);
-			}
+void NavMap::_build_polygon_bvh() {
+	polygon_bvh.clear();
+	polygon_bvh_items.resize(polygons.size());
+	if (polygons.is_empty()) {
+		return;
+	}
+
+	for (uint32_t i = 0; i < polygons.size(); i++) {
+		polygon_bvh_items[i] = i;
+	}
+
+	polygon_bvh.reserve(2 * (polygons.size() / POLYGON_BVH_LEAF_SIZE) + 1);
+	_build_polygon_bvh_node(polygon_aabbs, 0, polygons.size());
+}
+
+uint32_t NavMap::_build_polygon_bvh_node(const LocalVector<AABB> &p_aabbs, uint32_t p_from, uint32_t p_to) {
+	const uint32_t node_index = polygon_bvh.size();
+	polygon_bvh.push_back(PolygonBVHNode());
+
+	AABB aabb = p_aabbs[polygon_bvh_items[p_from]];
+	for (uint32_t i = p_from + 1; i < p_to; i++) {
+		aabb.merge_with(p_aabbs[polygon_bvh_items[i]]);
+	}
+
+	if (p_to - p_from <= POLYGON_BVH_LEAF_SIZE) {
+		PolygonBVHNode &node = polygon_bvh[node_index];
+		node.aabb = aabb;
+		node.index = p_from;
+		node.count = p_to - p_from;
+		return node_index;
+	}
+
+	// Split at the median along the longest axis, which keeps the tree balanced.
+	NavMapPolygonCenterCompare compare;
+	compare.aabbs = &p_aabbs;
+	compare.axis = aabb.get_longest_axis_index();
+	const uint32_t middle = (p_from + p_to) / 2;
+	std::nth_element(polygon_bvh_items.ptr() + p_from, polygon_bvh_items.ptr() + middle, polygon_bvh_items.ptr() + p_to, compare);
+
+	_build_polygon_bvh_node(p_aabbs, p_from, middle);
+	const uint32_t second = _build_polygon_bvh_node(p_aabbs, middle, p_to);
+
+	PolygonBVHNode &node = polygon_bvh[node_index];
+	node.aabb = aabb;
+	node.index = second;
+	node.count = 0;
+	return node_index;
+}
+
+uint32_t NavMap::_update_polygon_bvh_layers(uint32_t p_node) {
+	uint32_t layers = 0;
+	const PolygonBVHNode &node = polygon_bvh[p_node];
+	if (node.count) {
+		for (uint32_t i = node.index; i < node.index + node.count; i++) {
+			layers |= polygons[polygon_bvh_items[i]]->owner->get_layers();
 		}
+	} else {
+		layers = _update_polygon_bvh_layers(p_node + 1) | _update_polygon_bvh_layers(node.index);
+	}
+	polygon_bvh[p_node].layers = layers;
+	return layers;
+}
 
-		// Update the update ID.
-		map_update_id = (map_update_id + 1) % 9999999;
+uint64_t NavMap::_get_agent_cell_key(const Vector3 &p_position) const {
+	const int32_t x = int32_t(Math::floor(p_position.x / agent_cell_size));
+	const int32_t z = int32_t(Math::floor(p_position.z / agent_cell_size));
+	return (uint64_t(uint32_t(x)) << 32) | uint64_t(uint32_t(z));
+}
+
+void NavMap::_update_agent_cells() {
+	if (!agents_dirty) {
+		// The cells are sized from the neighbor distances, resize them when one changed.
+		real_t neighbor_dist_sum = 0.0;
+		for (uint32_t i = 0; i < rvo_agents.size(); i++) {
+			neighbor_dist_sum += rvo_agents[i]->neighborDist_;
+		}
+		agents_dirty = neighbor_dist_sum != agent_neighbor_dist_sum;
 	}
 
-	// Update agents tree.
 	if (agents_dirty) {
-		std::vector<RVO::Agent *> raw_agents;
-		raw_agents.reserve(agents.size());
-		for (size_t i(0); i < agents.size(); i++) {
-			raw_agents.push_back(agents[i]->get_agent());
+		rvo_agents.resize(agents.size());
+		agent_positions.resize(agents.size());
+		agent_cell_keys.resize(agents.size());
+
+		// Cells about the size of the neighborhoods keep each search within a few cells.
+		agent_neighbor_dist_sum = 0.0;
+		for (uint32_t i = 0; i < rvo_agents.size(); i++) {
+			rvo_agents[i] = agents[i]->get_agent();
+			agent_neighbor_dist_sum += rvo_agents[i]->neighborDist_;
+		}
+		agent_cell_size = rvo_agents.is_empty() ? 1.0 : MAX(agent_neighbor_dist_sum / rvo_agents.size(), AGENT_MIN_CELL_SIZE_CM * 0.01);
+
+		agent_cells.clear();
+		for (uint32_t i = 0; i < rvo_agents.size(); i++) {
+			const RVO::Vector3 &position = rvo_agents[i]->position_;
+			agent_positions[i] = Vector3(position.x(), position.y(), position.z());
+			agent_cell_keys[i] = _get_agent_cell_key(agent_positions[i]);
+			agent_cells[agent_cell_keys[i]].push_back(i);
 		}
-		rvo.buildAgentTree(raw_agents);
+
+		agents_dirty = false;
+		return;
 	}
 
-	regenerate_polygons = false;
-	regenerate_links = false;
-	agents_dirty = false;
+	for (uint32_t i = 0; i < rvo_agents.size(); i++) {
+		const RVO::Vector3 &position = rvo_agents[i]->position_;
+		agent_positions[i] = Vector3(position.x(), position.y(), position.z());
+
+		const uint64_t key = _get_agent_cell_key(agent_positions[i]);
+		if (key == agent_cell_keys[i]) {
+			continue;
+		}
+
+		LocalVector<uint32_t> *old_cell = agent_cells.getptr(agent_cell_keys[i]);
+		if (old_cell) {
+			const int64_t index = old_cell->find(i);
+			if (index >= 0) {
+				old_cell->remove_unordered(index);
+			}
+			if (old_cell->is_empty()) {
+				agent_cells.erase(agent_cell_keys[i]);
+			}
+		}
+		agent_cells[key].push_back(i);
+		agent_cell_keys[i] = key;
+	}
 }
 
-void NavMap::compute_single_step(uint32_t index, RvoAgent **agent) {
-	(*(agent + index))->get_agent()->computeNeighbors(&rvo);
-	(*(agent + index))->get_agent()->computeNewVelocity(deltatime);
+void NavMap::_compute_agent_neighbors(RVO::Agent *p_agent) const {
+	p_agent->agentNeighbors_.clear();
+	if (p_agent->maxNeighbors_ == 0) {
+		return;
+	}
+
+	// Shrinks once the agent has all its neighbors, see `RVO::Agent::insertAgentNeighbor`.
+	float range_sq = p_agent->neighborDist_ * p_agent->neighborDist_;
+	const Vector3 position(p_agent->position_.x(), p_agent->position_.y(), p_agent->position_.z());
+
+	// An agent seeing much further than the others would go through more cells than there are agents.
+	const real_t cell_reach = Math::ceil(p_agent->neighborDist_ / agent_cell_size);
+	const real_t cells_side = cell_reach * 2 + 1;
+	if (cells_side * cells_side >= real_t(rvo_agents.size())) {
+		for (uint32_t i = 0; i < rvo_agents.size(); i++) {
+			if (position.distance_squared_to(agent_positions[i]) < range_sq) {
+				p_agent->insertAgentNeighbor(rvo_agents[i], range_sq);
+			}
+		}
+		return;
+	}
+
+	const int reach = int(cell_reach);
+	const int cell_x = int(Math::floor(position.x / agent_cell_size));
+	const int cell_z = int(Math::floor(position.z / agent_cell_size));
+
+	for (int x = cell_x - reach; x <= cell_x + reach; x++) {
+		for (int z = cell_z - reach; z <= cell_z + reach; z++) {
+			const LocalVector<uint32_t> *cell = agent_cells.getptr((uint64_t(uint32_t(x)) << 32) | uint64_t(uint32_t(z)));
+			if (!cell) {
+				continue;
+			}
+			for (uint32_t i = 0; i < cell->size(); i++) {
+				const uint32_t other = (*cell)[i];
+				if (position.distance_squared_to(agent_positions[other]) < range_sq) {
+					p_agent->insertAgentNeighbor(rvo_agents[other], range_sq);
+				}
+			}
+		}
+	}
+}
+
+void NavMap::compute_single_step(uint32_t index, RVO::Agent **agent) {
+	_compute_agent_neighbors(agent[index]);
+	agent[index]->computeNewVelocity(deltatime);
 }
 
-void NavMap::step(real_t p_deltatime) {
+void NavMap::step(real_t p_deltatime, ThreadWorkPool *p_work_pool) {
 	deltatime = p_deltatime;
+
+	_update_agent_cells();
+
 	if (controlled_agents.size() > 0) {
-		thread_process_array(
-				controlled_agents.size(),
-				this,
-				&NavMap::compute_single_step,
-				controlled_agents.data());
+		controlled_rvo_agents.resize(controlled_agents.size());
+		for (uint32_t i = 0; i < controlled_rvo_agents.size(); i++) {
+			controlled_rvo_agents[i] = controlled_agents[i]->get_agent();
+		}
+
+		if (p_work_pool && controlled_rvo_agents.size() > 1) {
+			p_work_pool->do_work(controlled_rvo_agents.size(), this, &NavMap::compute_single_step, controlled_rvo_agents.ptr());
+		} else {
+			for (uint32_t i = 0; i < controlled_rvo_agents.size(); i++) {
+				compute_single_step(i, controlled_rvo_agents.ptr());
+			}
+		}
 	}
 }
 
@@ -731,7 +1259,7 @@ void NavMap::dispatch_callbacks() {
 	}
 }
 
-void NavMap::clip_path(const std::vector<gd::NavigationPoly> &p_navigation_polys, Vector<Vector3> &path, const gd::NavigationPoly *from_poly, const Vector3 &p_to_point, const gd::NavigationPoly *p_to_poly) const {
+void NavMap::clip_path(const LocalVector<gd::NavigationPoly> &p_navigation_polys, Vector<Vector3> &path, const gd::NavigationPoly *from_poly, const Vector3 &p_to_point, const gd::NavigationPoly *p_to_poly) const {
 	Vector3 from = path[path.size() - 1];
 
 	if (from.is_equal_approx(p_to_point)) {
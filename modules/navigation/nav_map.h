@@ -33,10 +33,15 @@
 
 #include "nav_rid.h"
 
+#include "core/math/aabb.h"
 #include "core/math/math_defs.h"
+#include "core/os/mutex.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
 #include "core/templates/map.h"
+#include "core/templates/thread_work_pool.h"
 #include "nav_utils.h"
-#include <KdTree.h>
+#include <Agent.h>
 
 /**
 	@author AndreaCatania
@@ -58,19 +63,64 @@ class NavMap : public NavRid {
 	real_t edge_connection_margin = 5.0;
 
 	bool regenerate_polygons = true;
+	/// Forces the next sync to reconnect all the polygons, not only the changed ones.
 	bool regenerate_links = true;
+	/// A region was removed since the last sync.
+	bool polygons_changed = false;
 
 	std::vector<NavRegion *> regions;
 
-	/// Map polygons
-	std::vector<gd::Polygon> polygons;
-
-	/// Rvo world
-	RVO::KdTree rvo;
+	/// Map polygons, owned by the regions. The index is the polygon id.
+	/// The polygons of a region are dropped as soon as it's removed, as it may be freed before the next sync.
+	LocalVector<gd::Polygon *> polygons;
+	LocalVector<AABB> polygon_aabbs;
+
+	/// Areas whose polygons changed since the last sync, the edges around them are reconnected.
+	LocalVector<AABB> affected_bounds;
+
+	enum {
+		POLYGON_BVH_LEAF_SIZE = 4,
+		POLYGON_BVH_STACK_SIZE = 64,
+	};
+
+	struct PolygonBVHNode {
+		AABB aabb;
+		/// Union of the layers of the regions owning the polygons below this node.
+		uint32_t layers = 0;
+		/// Leaves: first entry in `polygon_bvh_items`. Branches: index of the second child, the first one follows this node.
+		uint32_t index = 0;
+		/// Polygons in a leaf, zero for branches.
+		uint32_t count = 0;
+	};
+
+	/// Bounding volume hierarchy over `polygons`, rebuilt with them and used by all point queries.
+	LocalVector<PolygonBVHNode> polygon_bvh;
+	LocalVector<uint32_t> polygon_bvh_items;
+	/// Region layers the BVH layer masks were computed with.
+	LocalVector<uint32_t> polygon_bvh_region_layers;
+
+	enum {
+		AGENT_MIN_CELL_SIZE_CM = 10,
+	};
 
 	/// Is agent array modified?
 	bool agents_dirty = false;
 
+	/// Uniform grid over the agents on the XZ plane, used to find their neighbors. The agents
+	/// move between cells as they move, the grid is only rebuilt when the agent array changes.
+	real_t agent_cell_size = 1.0;
+	real_t agent_neighbor_dist_sum = 0.0;
+	HashMap<uint64_t, LocalVector<uint32_t>> agent_cells;
+
+	/// Per agent, in the order of `agents`: the RVO agent, its position and its cell in the grid.
+	/// The positions are scanned by the neighbor searches, so they are kept together.
+	LocalVector<RVO::Agent *> rvo_agents;
+	LocalVector<Vector3> agent_positions;
+	LocalVector<uint64_t> agent_cell_keys;
+
+	/// RVO agents of the controlled agents, stepped in parallel.
+	LocalVector<RVO::Agent *> controlled_rvo_agents;
+
 	/// All the Agents (even the controlled one)
 	std::vector<RvoAgent *> agents;
 
@@ -83,8 +133,19 @@ class NavMap : public NavRid {
 	/// Change the id each time the map is updated.
 	uint32_t map_update_id = 0;
 
+	/// Statistics of the last sync that updated the map.
+	uint32_t last_sync_dirty_regions = 0;
+	uint32_t last_sync_relinked_polygons = 0;
+	bool last_sync_full_relink = false;
+	uint64_t last_sync_usec = 0;
+
+	/// Idle path search states, one is taken by each concurrent `get_path` call.
+	mutable Mutex path_search_contexts_mutex;
+	mutable LocalVector<gd::PathSearchContext *> path_search_contexts;
+
 public:
 	NavMap() {}
+	~NavMap();
 
 	void set_up(Vector3 p_up);
 	Vector3 get_up() const {
@@ -124,18 +185,54 @@ public:
 
 	void set_agent_as_controlled(RvoAgent *agent);
 	void remove_agent_as_controlled(RvoAgent *agent);
+	uint32_t get_controlled_agent_count() const {
+		return controlled_agents.size();
+	}
 
 	uint32_t get_map_update_id() const {
 		return map_update_id;
 	}
 
+	uint32_t get_last_sync_dirty_regions() const {
+		return last_sync_dirty_regions;
+	}
+	uint32_t get_last_sync_relinked_polygons() const {
+		return last_sync_relinked_polygons;
+	}
+	bool is_last_sync_full_relink() const {
+		return last_sync_full_relink;
+	}
+	uint64_t get_last_sync_usec() const {
+		return last_sync_usec;
+	}
+	uint32_t get_polygon_count() const {
+		return polygons.size();
+	}
+	real_t get_agent_cell_size() const {
+		return agent_cell_size;
+	}
+
 	void sync();
-	void step(real_t p_deltatime);
+	void step(real_t p_deltatime, ThreadWorkPool *p_work_pool = nullptr);
 	void dispatch_callbacks();
 
 private:
-	void compute_single_step(uint32_t index, RvoAgent **agent);
-	void clip_path(const std::vector<gd::NavigationPoly> &p_navigation_polys, Vector<Vector3> &path, const gd::NavigationPoly *from_poly, const Vector3 &p_to_point, const gd::NavigationPoly *p_to_poly) const;
+	void _remove_region_polygons(NavRegion *p_region);
+	uint32_t _update_connections(bool p_full);
+	void _build_polygon_bvh();
+	uint32_t _build_polygon_bvh_node(const LocalVector<AABB> &p_aabbs, uint32_t p_from, uint32_t p_to);
+	uint32_t _update_polygon_bvh_layers(uint32_t p_node);
+	template <class Q>
+	void _query_polygon_bvh(bool p_filter_layers, uint32_t p_layers, Q &r_query) const;
+
+	gd::PathSearchContext *_acquire_path_search_context() const;
+	void _release_path_search_context(gd::PathSearchContext *p_context) const;
+
+	uint64_t _get_agent_cell_key(const Vector3 &p_position) const;
+	void _update_agent_cells();
+	void _compute_agent_neighbors(RVO::Agent *p_agent) const;
+	void compute_single_step(uint32_t index, RVO::Agent **agent);
+	void clip_path(const LocalVector<gd::NavigationPoly> &p_navigation_polys, Vector<Vector3> &path, const gd::NavigationPoly *from_poly, const Vector3 &p_to_point, const gd::NavigationPoly *p_to_poly) const;
 };
 
 #endif // RVO_SPACE_H
@@ -94,6 +94,7 @@ void NavRegion::update_polygons() {
 		return;
 	}
 	polygons.clear();
+	bounds = AABB();
 	polygons_dirty = false;
 
 	if (map == nullptr) {
@@ -139,6 +140,12 @@ void NavRegion::update_polygons() {
 			p.points[j].pos = point_position;
 			p.points[j].key = map->get_point_key(point_position);
 
+			if (i == 0 && j == 0) {
+				bounds.position = point_position;
+			} else {
+				bounds.expand_to(point_position);
+			}
+
 			center += point_position; // Composing the center of the polygon
 
 			if (j >= 2) {
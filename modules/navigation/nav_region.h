@@ -49,12 +49,15 @@ class NavRegion : public NavRid {
 	Transform3D transform;
 	Ref<NavigationMesh> mesh;
 	uint32_t layers = 1;
+	/// Pathways of the margin connections starting from this region, kept for debugging.
 	Vector<gd::Edge::Connection> connections;
 
 	bool polygons_dirty = true;
 
 	/// Cache
 	std::vector<gd::Polygon> polygons;
+	/// Bounds of the cached polygons.
+	AABB bounds;
 
 public:
 	NavRegion() {}
@@ -63,6 +66,10 @@ public:
 		polygons_dirty = true;
 	}
 
+	bool is_dirty() const {
+		return polygons_dirty;
+	}
+
 	void set_map(NavMap *p_map);
 	NavMap *get_map() const {
 		return map;
@@ -91,6 +98,13 @@ public:
 	std::vector<gd::Polygon> const &get_polygons() const {
 		return polygons;
 	}
+	std::vector<gd::Polygon> &get_polygons() {
+		return polygons;
+	}
+
+	const AABB &get_bounds() const {
+		return bounds;
+	}
 
 	bool sync();
 
@@ -32,6 +32,7 @@
 #define NAV_UTILS_H
 
 #include "core/math/vector3.h"
+#include "core/templates/local_vector.h"
 
 #include <vector>
 
@@ -94,6 +95,9 @@ struct Edge {
 struct Polygon {
 	NavRegion *owner;
 
+	/// Index of this `Polygon` in its map.
+	uint32_t id = 0;
+
 	/// The points of this `Polygon`
 	std::vector<Point> points;
 
@@ -110,7 +114,7 @@ struct Polygon {
 struct NavigationPoly {
 	uint32_t self_id = 0;
 	/// This poly.
-	const Polygon *poly;
+	const Polygon *poly = nullptr;
 
 	/// Those 4 variables are used to travel the path backwards.
 	int back_navigation_poly_id = -1;
@@ -122,7 +126,12 @@ struct NavigationPoly {
 	Vector3 entry;
 	/// The distance to the destination.
 	float traveled_distance = 0.0;
+	/// The traveled distance plus the estimate to the end point, used to order the open list.
+	float cost = 0.0;
+	/// Position in the open list, or UINT32_MAX when not in it.
+	uint32_t heap_index = UINT32_MAX;
 
+	NavigationPoly() {}
 	NavigationPoly(const Polygon *p_poly) :
 			poly(p_poly) {}
 
@@ -135,6 +144,115 @@ struct NavigationPoly {
 	}
 };
 
+/// Path search state reused across searches, indexed by polygon id.
+/// Entries are only meaningful when stamped with the current search generation,
+/// so starting a new search doesn't need to clear anything.
+struct PathSearchContext {
+	LocalVector<NavigationPoly> navigation_polys;
+	LocalVector<uint32_t> generations;
+	uint32_t generation = 0;
+
+	/// Polygons to visit, a binary min-heap on `NavigationPoly::cost`.
+	LocalVector<uint32_t> open;
+
+	void begin(uint32_t p_polygon_count) {
+		if (generations.size() < p_polygon_count) {
+			uint32_t from = generations.size();
+			navigation_polys.resize(p_polygon_count);
+			generations.resize(p_polygon_count);
+			for (uint32_t i = from; i < p_polygon_count; i++) {
+				generations[i] = 0;
+			}
+		}
+
+		generation++;
+		if (generation == 0) {
+			// Wrapped around, forget all the old stamps.
+			for (uint32_t i = 0; i < generations.size(); i++) {
+				generations[i] = 0;
+			}
+			generation = 1;
+		}
+		open.clear();
+	}
+
+	bool is_visited(uint32_t p_id) const {
+		return generations[p_id] == generation;
+	}
+
+	NavigationPoly &visit(uint32_t p_id, const Polygon *p_poly) {
+		generations[p_id] = generation;
+		NavigationPoly &np = navigation_polys[p_id];
+		np = NavigationPoly(p_poly);
+		np.self_id = p_id;
+		return np;
+	}
+
+	void push_open(uint32_t p_id) {
+		navigation_polys[p_id].heap_index = open.size();
+		open.push_back(p_id);
+		_sift_up(open.size() - 1);
+	}
+
+	/// To be called after the cost of an open polygon decreased.
+	void update_open(uint32_t p_id) {
+		_sift_up(navigation_polys[p_id].heap_index);
+	}
+
+	uint32_t pop_open() {
+		const uint32_t top = open[0];
+		navigation_polys[top].heap_index = UINT32_MAX;
+		const uint32_t last = open[open.size() - 1];
+		open.resize(open.size() - 1);
+		if (!open.is_empty()) {
+			open[0] = last;
+			navigation_polys[last].heap_index = 0;
+			_sift_down(0);
+		}
+		return top;
+	}
+
+private:
+	void _sift_up(uint32_t p_index) {
+		const uint32_t id = open[p_index];
+		const float cost = navigation_polys[id].cost;
+		while (p_index > 0) {
+			const uint32_t parent = (p_index - 1) / 2;
+			if (navigation_polys[open[parent]].cost <= cost) {
+				break;
+			}
+			open[p_index] = open[parent];
+			navigation_polys[open[p_index]].heap_index = p_index;
+			p_index = parent;
+		}
+		open[p_index] = id;
+		navigation_polys[id].heap_index = p_index;
+	}
+
+	void _sift_down(uint32_t p_index) {
+		const uint32_t id = open[p_index];
+		const float cost = navigation_polys[id].cost;
+		const uint32_t size = open.size();
+		while (true) {
+			uint32_t child = p_index * 2 + 1;
+			if (child >= size) {
+				break;
+			}
+			if (child + 1 < size && navigation_polys[open[child + 1]].cost < navigation_polys[open[child]].cost) {
+				child++;
+			}
+			if (cost <= navigation_polys[open[child]].cost) {
+				break;
+			}
+			open[p_index] = open[child];
+			navigation_polys[open[p_index]].heap_index = p_index;
+			p_index = child;
+		}
+		open[p_index] = id;
+		navigation_polys[id].heap_index = p_index;
+	}
+};
+
 } // namespace gd
 
 #endif // NAV_UTILS_H
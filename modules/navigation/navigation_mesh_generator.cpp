@@ -33,6 +33,7 @@
 #include "navigation_mesh_generator.h"
 
 #include "core/math/convex_hull.h"
+#include "core/os/os.h"
 #include "core/os/thread.h"
 #include "scene/3d/collision_shape_3d.h"
 #include "scene/3d/mesh_instance_3d.h"
@@ -60,6 +61,8 @@
 #include "modules/gridmap/grid_map.h"
 #endif
 
+#include <algorithm>
+
 NavigationMeshGenerator *NavigationMeshGenerator::singleton = nullptr;
 
 void NavigationMeshGenerator::_add_vertex(const Vector3 &p_vec3, Vector<float> &p_verticies) {
@@ -300,6 +303,24 @@ void NavigationMeshGenerator::_convert_detail_mesh_to_native_navigation_mesh(con
 	}
 }
 
+void NavigationMeshGenerator::_fill_recast_config(Ref<NavigationMesh> p_nav_mesh, rcConfig &r_cfg) {
+	memset(&r_cfg, 0, sizeof(r_cfg));
+
+	r_cfg.cs = p_nav_mesh->get_cell_size();
+	r_cfg.ch = p_nav_mesh->get_cell_height();
+	r_cfg.walkableSlopeAngle = p_nav_mesh->get_agent_max_slope();
+	r_cfg.walkableHeight = (int)Math::ceil(p_nav_mesh->get_agent_height() / r_cfg.ch);
+	r_cfg.walkableClimb = (int)Math::floor(p_nav_mesh->get_agent_max_climb() / r_cfg.ch);
+	r_cfg.walkableRadius = (int)Math::ceil(p_nav_mesh->get_agent_radius() / r_cfg.cs);
+	r_cfg.maxEdgeLen = (int)(p_nav_mesh->get_edge_max_length() / p_nav_mesh->get_cell_size());
+	r_cfg.maxSimplificationError = p_nav_mesh->get_edge_max_error();
+	r_cfg.minRegionArea = (int)(p_nav_mesh->get_region_min_size() * p_nav_mesh->get_region_min_size());
+	r_cfg.mergeRegionArea = (int)(p_nav_mesh->get_region_merge_size() * p_nav_mesh->get_region_merge_size());
+	r_cfg.maxVertsPerPoly = (int)p_nav_mesh->get_verts_per_poly();
+	r_cfg.detailSampleDist = p_nav_mesh->get_detail_sample_distance() < 0.9f ? 0 : p_nav_mesh->get_cell_size() * p_nav_mesh->get_detail_sample_distance();
+	r_cfg.detailSampleMaxError = p_nav_mesh->get_cell_height() * p_nav_mesh->get_detail_sample_max_error();
+}
+
 void NavigationMeshGenerator::_build_recast_navigation_mesh(
 		Ref<NavigationMesh> p_nav_mesh,
 #ifdef TOOLS_ENABLED
@@ -329,21 +350,7 @@ void NavigationMeshGenerator::_build_recast_navigation_mesh(
 	rcCalcBounds(verts, nverts, bmin, bmax);
 
 	rcConfig cfg;
-	memset(&cfg, 0, sizeof(cfg));
-
-	cfg.cs = p_nav_mesh->get_cell_size();
-	cfg.ch = p_nav_mesh->get_cell_height();
-	cfg.walkableSlopeAngle = p_nav_mesh->get_agent_max_slope();
-	cfg.walkableHeight = (int)Math::ceil(p_nav_mesh->get_agent_height() / cfg.ch);
-	cfg.walkableClimb = (int)Math::floor(p_nav_mesh->get_agent_max_climb() / cfg.ch);
-	cfg.walkableRadius = (int)Math::ceil(p_nav_mesh->get_agent_radius() / cfg.cs);
-	cfg.maxEdgeLen = (int)(p_nav_mesh->get_edge_max_length() / p_nav_mesh->get_cell_size());
-	cfg.maxSimplificationError = p_nav_mesh->get_edge_max_error();
-	cfg.minRegionArea = (int)(p_nav_mesh->get_region_min_size() * p_nav_mesh->get_region_min_size());
-	cfg.mergeRegionArea = (int)(p_nav_mesh->get_region_merge_size() * p_nav_mesh->get_region_merge_size());
-	cfg.maxVertsPerPoly = (int)p_nav_mesh->get_verts_per_poly();
-	cfg.detailSampleDist = p_nav_mesh->get_detail_sample_distance() < 0.9f ? 0 : p_nav_mesh->get_cell_size() * p_nav_mesh->get_detail_sample_distance();
-	cfg.detailSampleMaxError = p_nav_mesh->get_cell_height() * p_nav_mesh->get_detail_sample_max_error();
+	_fill_recast_config(p_nav_mesh, cfg);
 
 	cfg.bmin[0] = bmin[0];
 	cfg.bmin[1] = bmin[1];
@@ -477,6 +484,424 @@ void NavigationMeshGenerator::_build_recast_navigation_mesh(
 	detail_mesh = nullptr;
 }
 
+void NavigationMeshGenerator::_build_recast_tile(
+		const TileBakeSettings &p_settings,
+		rcConfig &p_cfg,
+		rcHeightfield *&hf,
+		rcCompactHeightfield *&chf,
+		rcContourSet *&cset,
+		rcPolyMesh *&poly_mesh,
+		rcPolyMeshDetail *&detail_mesh,
+		const float *p_vertices,
+		int p_vertex_count,
+		const LocalVector<int> &p_indices,
+		BakedTile &r_tile) {
+	rcContext ctx;
+
+	const int *tris = p_indices.ptr();
+	const int ntris = p_indices.size() / 3;
+
+	hf = rcAllocHeightfield();
+	ERR_FAIL_COND(!hf);
+	ERR_FAIL_COND(!rcCreateHeightfield(&ctx, *hf, p_cfg.width, p_cfg.height, p_cfg.bmin, p_cfg.bmax, p_cfg.cs, p_cfg.ch));
+
+	{
+		LocalVector<unsigned char> tri_areas;
+		tri_areas.resize(ntris);
+		memset(tri_areas.ptr(), 0, ntris * sizeof(unsigned char));
+		rcMarkWalkableTriangles(&ctx, p_cfg.walkableSlopeAngle, p_vertices, p_vertex_count, tris, ntris, tri_areas.ptr());
+
+		ERR_FAIL_COND(!rcRasterizeTriangles(&ctx, p_vertices, p_vertex_count, tris, tri_areas.ptr(), ntris, *hf, p_cfg.walkableClimb));
+	}
+
+	if (p_settings.filter_low_hanging_obstacles) {
+		rcFilterLowHangingWalkableObstacles(&ctx, p_cfg.walkableClimb, *hf);
+	}
+	if (p_settings.filter_ledge_spans) {
+		rcFilterLedgeSpans(&ctx, p_cfg.walkableHeight, p_cfg.walkableClimb, *hf);
+	}
+	if (p_settings.filter_walkable_low_height_spans) {
+		rcFilterWalkableLowHeightSpans(&ctx, p_cfg.walkableHeight, *hf);
+	}
+
+	chf = rcAllocCompactHeightfield();
+	ERR_FAIL_COND(!chf);
+	ERR_FAIL_COND(!rcBuildCompactHeightfield(&ctx, p_cfg.walkableHeight, p_cfg.walkableClimb, *hf, *chf));
+
+	rcFreeHeightField(hf);
+	hf = nullptr;
+
+	ERR_FAIL_COND(!rcErodeWalkableArea(&ctx, p_cfg.walkableRadius, *chf));
+
+	// The border cells only give the tile the context of its neighbors, they are cut from the result.
+	if (p_settings.partition_type == NavigationMesh::SAMPLE_PARTITION_WATERSHED) {
+		ERR_FAIL_COND(!rcBuildDistanceField(&ctx, *chf));
+		ERR_FAIL_COND(!rcBuildRegions(&ctx, *chf, p_cfg.borderSize, p_cfg.minRegionArea, p_cfg.mergeRegionArea));
+	} else if (p_settings.partition_type == NavigationMesh::SAMPLE_PARTITION_MONOTONE) {
+		ERR_FAIL_COND(!rcBuildRegionsMonotone(&ctx, *chf, p_cfg.borderSize, p_cfg.minRegionArea, p_cfg.mergeRegionArea));
+	} else {
+		ERR_FAIL_COND(!rcBuildLayerRegions(&ctx, *chf, p_cfg.borderSize, p_cfg.minRegionArea));
+	}
+
+	cset = rcAllocContourSet();
+	ERR_FAIL_COND(!cset);
+	ERR_FAIL_COND(!rcBuildContours(&ctx, *chf, p_cfg.maxSimplificationError, p_cfg.maxEdgeLen, *cset));
+
+	poly_mesh = rcAllocPolyMesh();
+	ERR_FAIL_COND(!poly_mesh);
+	ERR_FAIL_COND(!rcBuildPolyMesh(&ctx, *cset, p_cfg.maxVertsPerPoly, *poly_mesh));
+
+	detail_mesh = rcAllocPolyMeshDetail();
+	ERR_FAIL_COND(!detail_mesh);
+	ERR_FAIL_COND(!rcBuildPolyMeshDetail(&ctx, *poly_mesh, *chf, p_cfg.detailSampleDist, p_cfg.detailSampleMaxError, *detail_mesh));
+
+	r_tile.vertices.resize(detail_mesh->nverts);
+	Vector3 *vertices_w = r_tile.vertices.ptrw();
+	for (int i = 0; i < detail_mesh->nverts; i++) {
+		const float *v = &detail_mesh->verts[i * 3];
+		vertices_w[i] = Vector3(v[0], v[1], v[2]);
+	}
+
+	for (int i = 0; i < detail_mesh->nmeshes; i++) {
+		const unsigned int *m = &detail_mesh->meshes[i * 4];
+		const unsigned int bverts = m[0];
+		const unsigned int btris = m[2];
+		const unsigned int ntris_detail = m[3];
+		const unsigned char *detail_tris = &detail_mesh->tris[btris * 4];
+		for (unsigned int j = 0; j < ntris_detail; j++) {
+			// Polygon order in recast is opposite than godot's
+			r_tile.indices.push_back((int)(bverts + detail_tris[j * 4 + 0]));
+			r_tile.indices.push_back((int)(bverts + detail_tris[j * 4 + 2]));
+			r_tile.indices.push_back((int)(bverts + detail_tris[j * 4 + 1]));
+		}
+	}
+}
+
+void NavigationMeshGenerator::_bake_tile(uint32_t p_index, TiledBake *p_bake) {
+	const uint64_t begin_usec = OS::get_singleton()->get_ticks_usec();
+
+	TileBakeItem &item = p_bake->items[p_index];
+	const TileBakeSettings &settings = p_bake->settings;
+	const float *vertices = p_bake->vertices->ptr();
+
+	rcConfig cfg = settings.cfg;
+	const float border = cfg.borderSize * cfg.cs;
+	cfg.width = cfg.tileSize + cfg.borderSize * 2;
+	cfg.height = cfg.tileSize + cfg.borderSize * 2;
+	cfg.bmin[0] = item.tile.x * settings.tile_world_size - border;
+	cfg.bmin[2] = item.tile.y * settings.tile_world_size - border;
+	cfg.bmax[0] = (item.tile.x + 1) * settings.tile_world_size + border;
+	cfg.bmax[2] = (item.tile.y + 1) * settings.tile_world_size + border;
+	cfg.bmin[1] = vertices[item.indices[0] * 3 + 1];
+	cfg.bmax[1] = cfg.bmin[1];
+	for (uint32_t i = 1; i < item.indices.size(); i++) {
+		const float y = vertices[item.indices[i] * 3 + 1];
+		cfg.bmin[1] = MIN(cfg.bmin[1], y);
+		cfg.bmax[1] = MAX(cfg.bmax[1], y);
+	}
+
+	rcHeightfield *hf = nullptr;
+	rcCompactHeightfield *chf = nullptr;
+	rcContourSet *cset = nullptr;
+	rcPolyMesh *poly_mesh = nullptr;
+	rcPolyMeshDetail *detail_mesh = nullptr;
+
+	_build_recast_tile(settings, cfg, hf, chf, cset, poly_mesh, detail_mesh, vertices, p_bake->vertices->size() / 3, item.indices, item.result);
+
+	rcFreeHeightField(hf);
+	rcFreeCompactHeightfield(chf);
+	rcFreeContourSet(cset);
+	rcFreePolyMesh(poly_mesh);
+	rcFreePolyMeshDetail(detail_mesh);
+
+	item.bake_usec = OS::get_singleton()->get_ticks_usec() - begin_usec;
+}
+
+// Tile borders, in tile units, along X (axis 0) or Z (axis 1).
+static bool _get_tile_border_line(const Vector3 &p_point, int p_axis, float p_tile_size, float p_epsilon, int &r_line) {
+	const float coord = p_axis == 0 ? p_point.x : p_point.z;
+	const float line = Math::round(coord / p_tile_size);
+	if (Math::abs(coord - line * p_tile_size) > p_epsilon) {
+		return false;
+	}
+	r_line = (int)line;
+	return true;
+}
+
+struct NavigationMeshTileBorderCompare {
+	const Vector<Vector3> *vertices = nullptr;
+	int axis = 0;
+
+	bool operator()(int p_a, int p_b) const {
+		// Sort along the border, which runs along the other axis.
+		return axis == 0 ? (*vertices)[p_a].z < (*vertices)[p_b].z : (*vertices)[p_a].x < (*vertices)[p_b].x;
+	}
+};
+
+void NavigationMeshGenerator::_merge_tiles(const TileCache &p_cache, const TileBakeSettings &p_settings, Ref<NavigationMesh> p_nav_mesh) {
+	const float tile_size = p_settings.tile_world_size;
+	const float cell_size = p_settings.cfg.cs;
+	const float epsilon = cell_size * 0.1;
+	// Border vertices closer than a climbable step are on the same surface.
+	const float max_height_difference = MAX(p_settings.cfg.walkableClimb, 1) * p_settings.cfg.ch;
+
+	Vector<Vector3> nav_vertices;
+	// Border vertices per cell, to weld the ones baked by both neighboring tiles.
+	Map<Vector2i, LocalVector<int>> border_cells;
+	// Border vertices per tile border line, keyed by axis and line.
+	Map<Vector2i, LocalVector<int>> border_lines;
+	LocalVector<LocalVector<int>> tile_remaps;
+	tile_remaps.resize(p_cache.tiles.size());
+
+	uint32_t tile_index = 0;
+	for (const Map<Vector2i, BakedTile>::Element *E = p_cache.tiles.front(); E; E = E->next(), tile_index++) {
+		const BakedTile &tile = E->get();
+		LocalVector<int> &remap = tile_remaps[tile_index];
+		remap.resize(tile.vertices.size());
+
+		for (int i = 0; i < tile.vertices.size(); i++) {
+			const Vector3 &point = tile.vertices[i];
+			int line_x = 0;
+			int line_z = 0;
+			const bool on_x = _get_tile_border_line(point, 0, tile_size, epsilon, line_x);
+			const bool on_z = _get_tile_border_line(point, 1, tile_size, epsilon, line_z);
+			if (!on_x && !on_z) {
+				remap[i] = nav_vertices.size();
+				nav_vertices.push_back(point);
+				continue;
+			}
+
+			LocalVector<int> &cell = border_cells[Vector2i((int)Math::round(point.x / cell_size), (int)Math::round(point.z / cell_size))];
+			int welded = -1;
+			for (uint32_t j = 0; j < cell.size(); j++) {
+				if (Math::abs(nav_vertices[cell[j]].y - point.y) <= max_height_difference) {
+					welded = cell[j];
+					break;
+				}
+			}
+			if (welded == -1) {
+				welded = nav_vertices.size();
+				nav_vertices.push_back(point);
+				cell.push_back(welded);
+				if (on_x) {
+					border_lines[Vector2i(0, line_x)].push_back(welded);
+				}
+				if (on_z) {
+					border_lines[Vector2i(1, line_z)].push_back(welded);
+				}
+			}
+			remap[i] = welded;
+		}
+	}
+
+	for (Map<Vector2i, LocalVector<int>>::Element *E = border_lines.front(); E; E = E->next()) {
+		NavigationMeshTileBorderCompare compare;
+		compare.vertices = &nav_vertices;
+		compare.axis = E->key().x;
+		std::sort(E->get().ptr(), E->get().ptr() + E->get().size(), compare);
+	}
+
+	p_nav_mesh->set_vertices(nav_vertices);
+
+	tile_index = 0;
+	for (const Map<Vector2i, BakedTile>::Element *E = p_cache.tiles.front(); E; E = E->next(), tile_index++) {
+		const BakedTile &tile = E->get();
+		const LocalVector<int> &remap = tile_remaps[tile_index];
+
+		for (int i = 0; i < tile.indices.size(); i += 3) {
+			const int triangle[3] = { remap[tile.indices[i]], remap[tile.indices[i + 1]], remap[tile.indices[i + 2]] };
+			if (triangle[0] == triangle[1] || triangle[1] == triangle[2] || triangle[2] == triangle[0]) {
+				continue; // Collapsed by the welding.
+			}
+
+			Vector<int> polygon;
+			for (int j = 0; j < 3; j++) {
+				const int a = triangle[j];
+				const int b = triangle[(j + 1) % 3];
+				polygon.push_back(a);
+
+				// The neighboring tile may split this border edge differently, add its vertices to the edge
+				// so the polygons on both sides share them.
+				const Vector3 &point_a = nav_vertices[a];
+				const Vector3 &point_b = nav_vertices[b];
+				for (int axis = 0; axis < 2; axis++) {
+					int line_a = 0;
+					int line_b = 0;
+					if (!_get_tile_border_line(point_a, axis, tile_size, epsilon, line_a) || !_get_tile_border_line(point_b, axis, tile_size, epsilon, line_b) || line_a != line_b) {
+						continue;
+					}
+					const Map<Vector2i, LocalVector<int>>::Element *line_element = border_lines.find(Vector2i(axis, line_a));
+					if (!line_element) {
+						break;
+					}
+					const LocalVector<int> *line = &line_element->get();
+
+					const float from = axis == 0 ? point_a.z : point_a.x;
+					const float to = axis == 0 ? point_b.z : point_b.x;
+					const float length = to - from;
+					if (Math::abs(length) <= epsilon) {
+						break;
+					}
+
+					const int count = line->size();
+					for (int k = 0; k < count; k++) {
+						// Walk the sorted line in the direction of the edge.
+						const int vertex = (*line)[length > 0 ? k : count - 1 - k];
+						if (vertex == a || vertex == b) {
+							continue;
+						}
+						const Vector3 &point = nav_vertices[vertex];
+						const float weight = ((axis == 0 ? point.z : point.x) - from) / length;
+						if (weight * Math::abs(length) <= epsilon || (1.0 - weight) * Math::abs(length) <= epsilon) {
+							continue;
+						}
+						if (Math::abs(point.y - Math::lerp(point_a.y, point_b.y, weight)) <= max_height_difference) {
+							polygon.push_back(vertex);
+						}
+					}
+					break;
+				}
+			}
+			p_nav_mesh->add_polygon(polygon);
+		}
+	}
+}
+
+void NavigationMeshGenerator::_bake_tiles(Ref<NavigationMesh> p_nav_mesh, Node *p_node, const Vector<float> &p_vertices, const Vector<int> &p_indices, bool p_partial, const AABB &p_area) {
+	TiledBake bake;
+	bake.vertices = &p_vertices;
+
+	// Cleared first so the padding doesn't change the hash.
+	memset(&bake.settings, 0, sizeof(TileBakeSettings));
+	_fill_recast_config(p_nav_mesh, bake.settings.cfg);
+	rcConfig &cfg = bake.settings.cfg;
+	cfg.tileSize = MAX(1, (int)Math::round(p_nav_mesh->get_tile_size() / cfg.cs));
+	cfg.borderSize = cfg.walkableRadius + 3;
+	bake.settings.tile_world_size = cfg.tileSize * cfg.cs;
+	bake.settings.partition_type = p_nav_mesh->get_sample_partition_type();
+	bake.settings.filter_low_hanging_obstacles = p_nav_mesh->get_filter_low_hanging_obstacles();
+	bake.settings.filter_ledge_spans = p_nav_mesh->get_filter_ledge_spans();
+	bake.settings.filter_walkable_low_height_spans = p_nav_mesh->get_filter_walkable_low_height_spans();
+	const uint32_t settings_hash = hash_djb2_buffer((const uint8_t *)&bake.settings, sizeof(TileBakeSettings));
+
+	const float tile_size = bake.settings.tile_world_size;
+	const float border = cfg.borderSize * cfg.cs;
+	const Transform3D root_transform = Object::cast_to<Node3D>(p_node)->get_global_transform();
+
+	// Take the tiles of the previous bake of this node, only one bake per node runs at a time.
+	TileCache *cache = nullptr;
+	{
+		MutexLock lock(tile_caches_mutex);
+
+		List<ObjectID> freed_nodes;
+		for (const ObjectID *key = tile_caches.next(nullptr); key; key = tile_caches.next(key)) {
+			if (!ObjectDB::get_instance(*key)) {
+				freed_nodes.push_back(*key);
+			}
+		}
+		for (const ObjectID &id : freed_nodes) {
+			memdelete(tile_caches[id]);
+			tile_caches.erase(id);
+		}
+
+		TileCache **cached = tile_caches.getptr(p_node->get_instance_id());
+		if (cached) {
+			cache = *cached;
+			tile_caches.erase(p_node->get_instance_id());
+		}
+	}
+	if (!cache) {
+		cache = memnew(TileCache);
+	}
+
+	bool rebake_all = !p_partial || cache->settings_hash != settings_hash || !cache->root_transform.is_equal_approx(root_transform);
+	if (rebake_all) {
+		cache->tiles.clear();
+		cache->settings_hash = settings_hash;
+		cache->root_transform = root_transform;
+	}
+
+	// The tiles whose border reaches the changed area, in the navigation mesh space.
+	Rect2i rebake_tiles;
+	if (!rebake_all) {
+		const AABB area = root_transform.affine_inverse().xform(p_area);
+		const Vector2i from((int)Math::floor((area.position.x - border) / tile_size), (int)Math::floor((area.position.z - border) / tile_size));
+		const Vector2i to((int)Math::floor((area.position.x + area.size.x + border) / tile_size), (int)Math::floor((area.position.z + area.size.z + border) / tile_size));
+		rebake_tiles = Rect2i(from, to - from + Vector2i(1, 1));
+
+		for (int x = from.x; x <= to.x; x++) {
+			for (int y = from.y; y <= to.y; y++) {
+				cache->tiles.erase(Vector2i(x, y));
+			}
+		}
+	}
+
+	// Give each tile the triangles overlapping it, border included.
+	Map<Vector2i, uint32_t> tile_items;
+	const float *vertices = p_vertices.ptr();
+	const int *indices = p_indices.ptr();
+	for (int i = 0; i + 2 < p_indices.size(); i += 3) {
+		Vector2 min(vertices[indices[i] * 3], vertices[indices[i] * 3 + 2]);
+		Vector2 max = min;
+		for (int j = 1; j < 3; j++) {
+			const Vector2 point(vertices[indices[i + j] * 3], vertices[indices[i + j] * 3 + 2]);
+			min = min.min(point);
+			max = max.max(point);
+		}
+
+		Vector2i from((int)Math::floor((min.x - border) / tile_size), (int)Math::floor((min.y - border) / tile_size));
+		Vector2i to((int)Math::floor((max.x + border) / tile_size), (int)Math::floor((max.y + border) / tile_size));
+		if (!rebake_all) {
+			from = from.max(rebake_tiles.position);
+			to = to.min(rebake_tiles.position + rebake_tiles.size - Vector2i(1, 1));
+		}
+
+		for (int x = from.x; x <= to.x; x++) {
+			for (int y = from.y; y <= to.y; y++) {
+				const Vector2i tile(x, y);
+				Map<Vector2i, uint32_t>::Element *E = tile_items.find(tile);
+				if (!E) {
+					E = tile_items.insert(tile, bake.items.size());
+					bake.items.push_back(TileBakeItem());
+					bake.items[bake.items.size() - 1].tile = tile;
+				}
+				LocalVector<int> &tile_indices = bake.items[E->get()].indices;
+				tile_indices.push_back(indices[i]);
+				tile_indices.push_back(indices[i + 1]);
+				tile_indices.push_back(indices[i + 2]);
+			}
+		}
+	}
+
+	// Bake the tiles on the worker threads, or here if another bake is using them.
+	if (bake.items.size() > 1 && OS::get_singleton()->get_processor_count() > 1 && tile_bake_pool_mutex.try_lock() == OK) {
+		if (!tile_bake_pool_initialized) {
+			tile_bake_pool.init();
+			tile_bake_pool_initialized = true;
+		}
+		tile_bake_pool.do_work(bake.items.size(), this, &NavigationMeshGenerator::_bake_tile, &bake);
+		tile_bake_pool_mutex.unlock();
+	} else {
+		for (uint32_t i = 0; i < bake.items.size(); i++) {
+			_bake_tile(i, &bake);
+		}
+	}
+
+	cache->last_bake_usec.clear();
+	for (uint32_t i = 0; i < bake.items.size(); i++) {
+		const TileBakeItem &item = bake.items[i];
+		cache->last_bake_usec[item.tile] = item.bake_usec;
+		if (!item.result.indices.is_empty()) {
+			cache->tiles[item.tile] = item.result;
+		}
+	}
+
+	_merge_tiles(*cache, bake.settings, p_nav_mesh);
+
+	MutexLock lock(tile_caches_mutex);
+	tile_caches.set(p_node->get_instance_id(), cache);
+}
+
 NavigationMeshGenerator *NavigationMeshGenerator::get_singleton() {
 	return singleton;
 }
@@ -486,11 +911,44 @@ NavigationMeshGenerator::NavigationMeshGenerator() {
 }
 
 NavigationMeshGenerator::~NavigationMeshGenerator() {
+	if (tile_bake_pool_initialized) {
+		tile_bake_pool.finish();
+	}
+	for (const ObjectID *key = tile_caches.next(nullptr); key; key = tile_caches.next(key)) {
+		memdelete(tile_caches[*key]);
+	}
 }
 
 void NavigationMeshGenerator::bake(Ref<NavigationMesh> p_nav_mesh, Node *p_node) {
 	ERR_FAIL_COND(!p_nav_mesh.is_valid());
 
+	_bake(p_nav_mesh, p_node, false, AABB());
+}
+
+void NavigationMeshGenerator::bake_area(Ref<NavigationMesh> p_nav_mesh, Node *p_node, const AABB &p_area) {
+	ERR_FAIL_COND(!p_nav_mesh.is_valid());
+
+	// Without tiles the whole mesh is baked again.
+	_bake(p_nav_mesh, p_node, p_nav_mesh->get_tile_size() > 0, p_area);
+}
+
+Dictionary NavigationMeshGenerator::get_tile_bake_times(Node *p_node) {
+	ERR_FAIL_COND_V(p_node == nullptr, Dictionary());
+
+	Dictionary times;
+	MutexLock lock(tile_caches_mutex);
+	TileCache **cache = tile_caches.getptr(p_node->get_instance_id());
+	if (cache) {
+		for (const Map<Vector2i, uint64_t>::Element *E = (*cache)->last_bake_usec.front(); E; E = E->next()) {
+			times[E->key()] = E->get();
+		}
+	}
+	return times;
+}
+
+void NavigationMeshGenerator::_bake(Ref<NavigationMesh> p_nav_mesh, Node *p_node, bool p_partial, const AABB &p_area) {
+	ERR_FAIL_COND(p_node == nullptr);
+
 #ifdef TOOLS_ENABLED
 	EditorProgress *ep(nullptr);
 	if (Engine::get_singleton()->is_editor_hint()) {
@@ -521,7 +979,14 @@ void NavigationMeshGenerator::bake(Ref<NavigationMesh> p_nav_mesh, Node *p_node)
 		_parse_geometry(navmesh_xform, E, vertices, indices, geometry_type, collision_mask, recurse_children);
 	}
 
-	if (vertices.size() > 0 && indices.size() > 0) {
+	if (p_nav_mesh->get_tile_size() > 0) {
+#ifdef TOOLS_ENABLED
+		if (ep) {
+			ep->step(TTR("Baking tiles..."), 1);
+		}
+#endif
+		_bake_tiles(p_nav_mesh, p_node, vertices, indices, p_partial, p_area);
+	} else if (vertices.size() > 0 && indices.size() > 0) {
 		rcHeightfield *hf = nullptr;
 		rcCompactHeightfield *chf = nullptr;
 		rcContourSet *cset = nullptr;
@@ -577,6 +1042,8 @@ void NavigationMeshGenerator::clear(Ref<NavigationMesh> p_nav_mesh) {
 
 void NavigationMeshGenerator::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("bake", "nav_mesh", "root_node"), &NavigationMeshGenerator::bake);
+	ClassDB::bind_method(D_METHOD("bake_area", "nav_mesh", "root_node", "area"), &NavigationMeshGenerator::bake_area);
+	ClassDB::bind_method(D_METHOD("get_tile_bake_times", "root_node"), &NavigationMeshGenerator::get_tile_bake_times);
 	ClassDB::bind_method(D_METHOD("clear", "nav_mesh"), &NavigationMeshGenerator::clear);
 }
 
@@ -33,6 +33,11 @@
 
 #ifndef _3D_DISABLED
 
+#include "core/os/mutex.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/map.h"
+#include "core/templates/thread_work_pool.h"
 #include "scene/3d/navigation_region_3d.h"
 
 #include <Recast.h>
@@ -46,6 +51,55 @@ class NavigationMeshGenerator : public Object {
 
 	static NavigationMeshGenerator *singleton;
 
+	struct TileBakeSettings {
+		rcConfig cfg;
+		float tile_world_size;
+		int partition_type;
+		bool filter_low_hanging_obstacles;
+		bool filter_ledge_spans;
+		bool filter_walkable_low_height_spans;
+	};
+
+	struct BakedTile {
+		Vector<Vector3> vertices;
+		/// Triangles, in Godot's winding order.
+		Vector<int> indices;
+	};
+
+	/// The tiles of the last bake of a root node, reused by the next partial bake.
+	struct TileCache {
+		uint32_t settings_hash = 0;
+		Transform3D root_transform;
+		Map<Vector2i, BakedTile> tiles;
+		/// Bake time of the tiles baked by the last bake, in microseconds.
+		Map<Vector2i, uint64_t> last_bake_usec;
+	};
+
+	struct TileBakeItem {
+		Vector2i tile;
+		/// The source triangles overlapping the tile and its border.
+		LocalVector<int> indices;
+		BakedTile result;
+		uint64_t bake_usec = 0;
+	};
+
+	struct TiledBake {
+		TileBakeSettings settings;
+		const Vector<float> *vertices = nullptr;
+		LocalVector<TileBakeItem> items;
+	};
+
+	Mutex tile_caches_mutex;
+	HashMap<ObjectID, TileCache *> tile_caches;
+
+	BinaryMutex tile_bake_pool_mutex;
+	ThreadWorkPool tile_bake_pool;
+	bool tile_bake_pool_initialized = false;
+
+	void _bake(Ref<NavigationMesh> p_nav_mesh, Node *p_node, bool p_partial, const AABB &p_area);
+	void _bake_tiles(Ref<NavigationMesh> p_nav_mesh, Node *p_node, const Vector<float> &p_vertices, const Vector<int> &p_indices, bool p_partial, const AABB &p_area);
+	void _bake_tile(uint32_t p_index, TiledBake *p_bake);
+
 protected:
 	static void _bind_methods();
 
@@ -55,6 +109,20 @@ protected:
 	static void _parse_geometry(Transform3D p_accumulated_transform, Node *p_node, Vector<float> &p_verticies, Vector<int> &p_indices, NavigationMesh::ParsedGeometryType p_generate_from, uint32_t p_collision_mask, bool p_recurse_children);
 
 	static void _convert_detail_mesh_to_native_navigation_mesh(const rcPolyMeshDetail *p_detail_mesh, Ref<NavigationMesh> p_nav_mesh);
+	static void _fill_recast_config(Ref<NavigationMesh> p_nav_mesh, rcConfig &r_cfg);
+	static void _build_recast_tile(
+			const TileBakeSettings &p_settings,
+			rcConfig &p_cfg,
+			rcHeightfield *&hf,
+			rcCompactHeightfield *&chf,
+			rcContourSet *&cset,
+			rcPolyMesh *&poly_mesh,
+			rcPolyMeshDetail *&detail_mesh,
+			const float *p_vertices,
+			int p_vertex_count,
+			const LocalVector<int> &p_indices,
+			BakedTile &r_tile);
+	static void _merge_tiles(const TileCache &p_cache, const TileBakeSettings &p_settings, Ref<NavigationMesh> p_nav_mesh);
 	static void _build_recast_navigation_mesh(
 			Ref<NavigationMesh> p_nav_mesh,
 #ifdef TOOLS_ENABLED
@@ -75,7 +143,10 @@ public:
 	~NavigationMeshGenerator();
 
 	void bake(Ref<NavigationMesh> p_nav_mesh, Node *p_node);
+	void bake_area(Ref<NavigationMesh> p_nav_mesh, Node *p_node, const AABB &p_area);
 	void clear(Ref<NavigationMesh> p_nav_mesh);
+
+	Dictionary get_tile_bake_times(Node *p_node);
 };
 
 #endif
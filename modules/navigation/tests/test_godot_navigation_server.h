@@ -0,0 +1,183 @@
+/*************************************************************************/
+/*  test_godot_navigation_server.h                                       */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+
+#ifndef TEST_GODOT_NAVIGATION_SERVER_H
+#define TEST_GODOT_NAVIGATION_SERVER_H
+
+#include "modules/navigation/godot_navigation_server.h"
+#include "modules/navigation/tests/test_nav_map.h"
+
+#include "tests/test_macros.h"
+
+namespace TestGodotNavigationServer {
+
+// Records the path query results it receives.
+class _TestPathReceiver : public Object {
+public:
+	int calls = 0;
+	int64_t query = 0;
+	Vector<Vector3> path;
+	Variant udata;
+
+	virtual Variant call(const StringName &p_method, const Variant **p_args, int p_argcount, Callable::CallError &r_error) override {
+		if (p_method != StringName("_path_ready")) {
+			return Object::call(p_method, p_args, p_argcount, r_error);
+		}
+		calls++;
+		query = *p_args[0];
+		path = *p_args[1];
+		udata = p_argcount > 2 ? *p_args[2] : Variant();
+		r_error.error = Callable::CallError::CALL_OK;
+		return Variant();
+	}
+};
+
+struct TestNavigationWorld {
+	GodotNavigationServer server;
+	RID map;
+	RID region;
+
+	TestNavigationWorld() {
+		map = server.map_create();
+		server.map_set_active(map, true);
+		region = server.region_create();
+		server.region_set_map(region, map);
+		server.region_set_navmesh(region, TestNavMap::create_square_mesh(4));
+		server.process(0.1);
+	}
+
+	~TestNavigationWorld() {
+		server.free(region);
+		if (map.is_valid()) {
+			server.free(map);
+		}
+		server.flush_queries();
+	}
+};
+
+TEST_CASE("[Navigation] Asynchronous path queries complete on process") {
+	TestNavigationWorld world;
+	GodotNavigationServer &server = world.server;
+	const Vector3 from(0.5, 0, 0.5);
+	const Vector3 to(3.5, 0, 3.5);
+	const Vector<Vector3> expected = server.map_get_path(world.map, from, to, true);
+	REQUIRE(expected.size() >= 2);
+
+	_TestPathReceiver receiver;
+	const int64_t polled = server.map_request_path(world.map, from, to, true);
+	const int64_t delivered = server.map_request_path(world.map, from, to, true, 1, &receiver, "_path_ready", 42);
+	CHECK(polled != delivered);
+	CHECK(server.get_path_query_queue_depth() == 2);
+	CHECK_FALSE(server.path_query_is_done(polled));
+
+	server.process(0.1);
+	CHECK(server.get_path_query_queue_depth() == 0);
+
+	CHECK(server.path_query_is_done(polled));
+	CHECK(server.path_query_get_path(polled) == expected);
+	ERR_PRINT_OFF;
+	CHECK_MESSAGE(!server.path_query_is_done(polled), "A query is released once its path is taken.");
+	ERR_PRINT_ON;
+
+	CHECK(receiver.calls == 1);
+	CHECK(receiver.query == delivered);
+	CHECK(receiver.path == expected);
+	CHECK(receiver.udata == Variant(42));
+
+	// Enough queries for several batches, processed in parallel when there are threads.
+	LocalVector<int64_t> queries;
+	for (int i = 0; i < 100; i++) {
+		const Vector3 destination(0.5 + (i % 4), 0, 0.5 + (i / 25));
+		queries.push_back(server.map_request_path(world.map, from, destination, i % 2 == 0));
+	}
+	while (server.get_path_query_queue_depth() > 0) {
+		server.process(0.1);
+	}
+	for (int i = 0; i < 100; i++) {
+		const Vector3 destination(0.5 + (i % 4), 0, 0.5 + (i / 25));
+		REQUIRE(server.path_query_is_done(queries[i]));
+		CHECK(server.path_query_get_path(queries[i]) == server.map_get_path(world.map, from, destination, i % 2 == 0));
+	}
+}
+
+TEST_CASE("[Navigation] Cancelled asynchronous path queries are discarded") {
+	TestNavigationWorld world;
+	GodotNavigationServer &server = world.server;
+	const Vector3 from(0.5, 0, 0.5);
+	const Vector3 to(3.5, 0, 3.5);
+
+	_TestPathReceiver receiver;
+	const int64_t queued = server.map_request_path(world.map, from, to, true, 1, &receiver, "_path_ready");
+	const int64_t finished = server.map_request_path(world.map, from, to, true);
+	server.path_query_cancel(queued);
+
+	server.process(0.1);
+	CHECK(server.get_path_query_queue_depth() == 0);
+	CHECK_MESSAGE(receiver.calls == 0, "Cancelled queries are never delivered.");
+
+	REQUIRE(server.path_query_is_done(finished));
+	server.path_query_cancel(finished);
+
+	ERR_PRINT_OFF;
+	CHECK(!server.path_query_is_done(queued));
+	CHECK(!server.path_query_is_done(finished));
+	CHECK(server.path_query_get_path(finished).is_empty());
+	ERR_PRINT_ON;
+}
+
+TEST_CASE("[Navigation] Asynchronous path queries on a freed map") {
+	TestNavigationWorld world;
+	GodotNavigationServer &server = world.server;
+	const Vector3 from(0.5, 0, 0.5);
+	const Vector3 to(3.5, 0, 3.5);
+
+	_TestPathReceiver receiver;
+	const int64_t polled = server.map_request_path(world.map, from, to, true);
+	server.map_request_path(world.map, from, to, true, 1, &receiver, "_path_ready");
+
+	// Freed before the queries run, they still finish with an empty path.
+	server.free(world.map);
+	world.map = RID();
+	server.process(0.1);
+
+	REQUIRE(server.path_query_is_done(polled));
+	CHECK(server.path_query_get_path(polled).is_empty());
+	CHECK(receiver.calls == 1);
+	CHECK(receiver.path.is_empty());
+
+	ERR_PRINT_OFF;
+	CHECK_MESSAGE(server.map_request_path(world.map, from, to, true) == 0, "Paths can't be requested on a freed map.");
+	ERR_PRINT_ON;
+}
+
+} // namespace TestGodotNavigationServer
+
+#endif // TEST_GODOT_NAVIGATION_SERVER_H
@@ -0,0 +1,583 @@
+/*************************************************************************/
+/*  test_nav_map.h                                                       */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_NAV_MAP_H
+#define TEST_NAV_MAP_H
+
+#include "core/math/face3.h"
+#include "core/math/geometry_3d.h"
+#include "core/math/random_pcg.h"
+#include "core/os/thread.h"
+#include "modules/navigation/nav_map.h"
+#include "modules/navigation/nav_region.h"
+#include "modules/navigation/rvo_agent.h"
+
+#include "tests/test_macros.h"
+
+#include <algorithm>
+
+namespace TestNavMap {
+
+// A flat square of one unit wide quads on the XZ plane.
+static Ref<NavigationMesh> create_square_mesh(int p_size) {
+	Vector<Vector3> vertices;
+	for (int x = 0; x <= p_size; x++) {
+		for (int z = 0; z <= p_size; z++) {
+			vertices.push_back(Vector3(x, 0, z));
+		}
+	}
+
+	Ref<NavigationMesh> mesh;
+	mesh.instantiate();
+	mesh->set_vertices(vertices);
+	for (int x = 0; x < p_size; x++) {
+		for (int z = 0; z < p_size; z++) {
+			Vector<int> polygon;
+			polygon.push_back(x * (p_size + 1) + z);
+			polygon.push_back(x * (p_size + 1) + z + 1);
+			polygon.push_back((x + 1) * (p_size + 1) + z + 1);
+			polygon.push_back((x + 1) * (p_size + 1) + z);
+			mesh->add_polygon(polygon);
+		}
+	}
+	return mesh;
+}
+
+static NavRegion *add_region(NavMap &p_map, const Ref<NavigationMesh> &p_mesh, const Vector3 &p_origin, const Basis &p_basis = Basis()) {
+	NavRegion *region = memnew(NavRegion);
+	region->set_mesh(p_mesh);
+	region->set_transform(Transform3D(p_basis, p_origin));
+	p_map.add_region(region);
+	region->set_map(&p_map);
+	return region;
+}
+
+static void remove_region(NavMap &p_map, NavRegion *p_region) {
+	p_map.remove_region(p_region);
+	p_region->set_map(nullptr);
+	memdelete(p_region);
+}
+
+// Lists the connections of all the polygons by region, polygon and edge index, checking
+// that they only point to polygons currently in the map.
+static Vector<String> describe_connections(const NavMap &p_map) {
+	const std::vector<NavRegion *> &regions = p_map.get_regions();
+	Vector<String> result;
+	for (size_t r = 0; r < regions.size(); r++) {
+		const std::vector<gd::Polygon> &polygons = regions[r]->get_polygons();
+		for (size_t p = 0; p < polygons.size(); p++) {
+			for (size_t e = 0; e < polygons[p].edges.size(); e++) {
+				const Vector<gd::Edge::Connection> &connections = polygons[p].edges[e].connections;
+				for (int c = 0; c < connections.size(); c++) {
+					const gd::Edge::Connection &connection = connections[c];
+					int target_region = -1;
+					int target_polygon = -1;
+					for (size_t t = 0; t < regions.size(); t++) {
+						const std::vector<gd::Polygon> &targets = regions[t]->get_polygons();
+						for (size_t i = 0; i < targets.size(); i++) {
+							if (&targets[i] == connection.polygon) {
+								target_region = t;
+								target_polygon = i;
+							}
+						}
+					}
+					CHECK_MESSAGE(target_region != -1, "Connections should only point to polygons of the map.");
+					if (target_region == -1) {
+						continue;
+					}
+					CHECK(connection.edge >= 0);
+					CHECK(connection.edge < (int)connection.polygon->edges.size());
+					result.push_back(vformat("%d/%d/%d", (int)r, (int)p, (int)e) + vformat(" -> %d/%d/%d", target_region, target_polygon, connection.edge) + vformat(" %s %s", connection.pathway_start, connection.pathway_end));
+				}
+			}
+		}
+	}
+	result.sort();
+	return result;
+}
+
+// Builds the same map from scratch and checks that its connections and paths are the same.
+static void check_matches_rebuilt_map(const NavMap &p_map, const Vector<Vector3> &p_path_points) {
+	NavMap rebuilt;
+	rebuilt.set_edge_connection_margin(p_map.get_edge_connection_margin());
+	LocalVector<NavRegion *> regions;
+	for (size_t r = 0; r < p_map.get_regions().size(); r++) {
+		const NavRegion *region = p_map.get_regions()[r];
+		regions.push_back(add_region(rebuilt, region->get_mesh(), region->get_transform().origin, region->get_transform().basis));
+	}
+	rebuilt.sync();
+
+	CHECK(describe_connections(p_map) == describe_connections(rebuilt));
+	for (size_t r = 0; r < p_map.get_regions().size(); r++) {
+		CHECK(p_map.get_regions()[r]->get_connections_count() == regions[r]->get_connections_count());
+	}
+
+	for (int i = 0; i < p_path_points.size(); i++) {
+		for (int j = 0; j < p_path_points.size(); j++) {
+			for (int optimize = 0; optimize < 2; optimize++) {
+				const Vector<Vector3> path = p_map.get_path(p_path_points[i], p_path_points[j], optimize);
+				const Vector<Vector3> rebuilt_path = rebuilt.get_path(p_path_points[i], p_path_points[j], optimize);
+				REQUIRE(path.size() == rebuilt_path.size());
+				for (int k = 0; k < path.size(); k++) {
+					CHECK(path[k].is_equal_approx(rebuilt_path[k]));
+				}
+			}
+		}
+	}
+
+	for (uint32_t r = 0; r < regions.size(); r++) {
+		remove_region(rebuilt, regions[r]);
+	}
+}
+
+TEST_CASE("[Navigation] Incremental map sync matches a full rebuild") {
+	const Ref<NavigationMesh> mesh = create_square_mesh(4);
+	NavMap map;
+	map.set_edge_connection_margin(1.0);
+
+	// Connected through the edge connection margin.
+	NavRegion *first = add_region(map, mesh, Vector3());
+	NavRegion *moved = add_region(map, mesh, Vector3(4.5, 0, 0));
+	map.sync();
+	CHECK(map.is_last_sync_full_relink());
+	CHECK(map.get_polygon_count() == 32);
+	Vector<Vector3> points;
+	points.push_back(Vector3(0.5, 0, 0.5));
+	points.push_back(Vector3(8, 0, 3.5));
+	check_matches_rebuilt_map(map, points);
+
+	// Sharing its edge vertices with the first region.
+	NavRegion *shared = add_region(map, mesh, Vector3(0, 0, 4));
+	map.sync();
+	CHECK_FALSE(map.is_last_sync_full_relink());
+	CHECK(map.get_last_sync_dirty_regions() == 1);
+	CHECK(map.get_last_sync_relinked_polygons() < map.get_polygon_count());
+	points.push_back(Vector3(0.5, 0, 7.5));
+	check_matches_rebuilt_map(map, points);
+
+	moved->set_transform(Transform3D(Basis(), Vector3(4.5, 0, 2)));
+	map.sync();
+	CHECK_FALSE(map.is_last_sync_full_relink());
+	check_matches_rebuilt_map(map, points);
+
+	remove_region(map, first);
+	map.sync();
+	CHECK_FALSE(map.is_last_sync_full_relink());
+	CHECK(map.get_polygon_count() == 32);
+	points.remove(0);
+	check_matches_rebuilt_map(map, points);
+
+	NavRegion *added = add_region(map, mesh, Vector3(4.5, 0, -2.5));
+	map.sync();
+	CHECK_FALSE(map.is_last_sync_full_relink());
+	points.push_back(Vector3(8, 0, -2));
+	check_matches_rebuilt_map(map, points);
+
+	// From the shared region to the added one, through the moved one.
+	const Vector<Vector3> path = map.get_path(Vector3(0.5, 0, 7.5), Vector3(8, 0, -2), true);
+	REQUIRE(path.size() > 0);
+	CHECK(path[path.size() - 1].is_equal_approx(Vector3(8, 0, -2)));
+
+	remove_region(map, moved);
+	remove_region(map, shared);
+	remove_region(map, added);
+}
+
+TEST_CASE("[Navigation] Connections to replaced region polygons are updated") {
+	NavMap map;
+	map.set_edge_connection_margin(1.0);
+	NavRegion *kept = add_region(map, create_square_mesh(4), Vector3());
+	NavRegion *replaced = add_region(map, create_square_mesh(4), Vector3(4.5, 0, 0));
+	map.sync();
+	CHECK(kept->get_connections_count() > 0);
+
+	Vector<Vector3> points;
+	points.push_back(Vector3(0.5, 0, 0.5));
+	points.push_back(Vector3(5, 0, 1.5));
+
+	// Fewer polygons, so the region's polygon array is reallocated.
+	replaced->set_mesh(create_square_mesh(2));
+	map.sync();
+	CHECK(map.get_polygon_count() == 20);
+	const Vector<String> connections = describe_connections(map);
+	bool connected = false;
+	for (int i = 0; i < connections.size(); i++) {
+		connected = connected || (connections[i].begins_with("0/") && connections[i].find(" -> 1/") != -1);
+	}
+	CHECK_MESSAGE(connected, "The kept region should be connected to the new polygons.");
+	check_matches_rebuilt_map(map, points);
+
+	// Same polygon count, rebuilt in place.
+	replaced->set_mesh(create_square_mesh(2));
+	map.sync();
+	check_matches_rebuilt_map(map, points);
+
+	remove_region(map, kept);
+	remove_region(map, replaced);
+}
+
+TEST_CASE("[Navigation] Queries ignore regions freed before the next sync") {
+	NavMap map;
+	map.set_edge_connection_margin(1.0);
+	NavRegion *kept = add_region(map, create_square_mesh(4), Vector3());
+	NavRegion *freed = add_region(map, create_square_mesh(4), Vector3(4.5, 0, 0));
+	map.sync();
+	CHECK(map.get_polygon_count() == 32);
+	const uint32_t update_id = map.get_map_update_id();
+
+	// As when the server frees a region of an inactive map, no sync follows.
+	remove_region(map, freed);
+	CHECK(map.get_polygon_count() == 16);
+	CHECK(map.get_map_update_id() != update_id);
+	// Checks that the connections only point to the kept region.
+	describe_connections(map);
+
+	CHECK(map.get_closest_point(Vector3(7, 0, 2)).is_equal_approx(Vector3(4, 0, 2)));
+	const Vector<Vector3> path = map.get_path(Vector3(0.5, 0, 0.5), Vector3(7, 0, 2), false);
+	REQUIRE(path.size() > 0);
+	CHECK(path[path.size() - 1].is_equal_approx(Vector3(4, 0, 2)));
+
+	map.sync();
+	Vector<Vector3> points;
+	points.push_back(Vector3(0.5, 0, 0.5));
+	points.push_back(Vector3(3.5, 0, 3.5));
+	check_matches_rebuilt_map(map, points);
+
+	remove_region(map, kept);
+}
+
+// The closest point queries as they were before the polygon BVH, going through every face.
+struct LinearClosestPoint {
+	Vector3 point;
+	Vector3 normal;
+	RID owner;
+	real_t distance = 1e20;
+};
+
+static LinearClosestPoint get_linear_closest_point(const NavMap &p_map, const Vector3 &p_point) {
+	LinearClosestPoint closest;
+	const std::vector<NavRegion *> &regions = p_map.get_regions();
+	for (size_t r = 0; r < regions.size(); r++) {
+		const std::vector<gd::Polygon> &polygons = regions[r]->get_polygons();
+		for (size_t i = 0; i < polygons.size(); i++) {
+			const gd::Polygon &p = polygons[i];
+			for (size_t point_id = 2; point_id < p.points.size(); point_id++) {
+				const Face3 f(p.points[point_id - 2].pos, p.points[point_id - 1].pos, p.points[point_id].pos);
+				const Vector3 inters = f.get_closest_point_to(p_point);
+				const real_t d = inters.distance_to(p_point);
+				if (d < closest.distance) {
+					closest.point = inters;
+					closest.normal = f.get_plane().normal;
+					closest.owner = regions[r]->get_self();
+					closest.distance = d;
+				}
+			}
+		}
+	}
+	return closest;
+}
+
+static Vector3 get_linear_closest_point_to_segment(const NavMap &p_map, const Vector3 &p_from, const Vector3 &p_to, bool p_use_collision) {
+	const std::vector<NavRegion *> &regions = p_map.get_regions();
+
+	bool intersected = false;
+	Vector3 closest_point;
+	real_t closest_point_d = 1e20;
+	for (size_t r = 0; r < regions.size(); r++) {
+		const std::vector<gd::Polygon> &polygons = regions[r]->get_polygons();
+		for (size_t i = 0; i < polygons.size(); i++) {
+			const gd::Polygon &p = polygons[i];
+			for (size_t point_id = 2; point_id < p.points.size(); point_id++) {
+				const Face3 f(p.points[point_id - 2].pos, p.points[point_id - 1].pos, p.points[point_id].pos);
+				Vector3 inters;
+				if (f.intersects_segment(p_from, p_to, &inters) && p_from.distance_to(inters) < closest_point_d) {
+					intersected = true;
+					closest_point = inters;
+					closest_point_d = p_from.distance_to(inters);
+				}
+			}
+		}
+	}
+	if (intersected || p_use_collision) {
+		return closest_point;
+	}
+
+	for (size_t r = 0; r < regions.size(); r++) {
+		const std::vector<gd::Polygon> &polygons = regions[r]->get_polygons();
+		for (size_t i = 0; i < polygons.size(); i++) {
+			const gd::Polygon &p = polygons[i];
+			for (size_t point_id = 0; point_id < p.points.size(); point_id++) {
+				Vector3 a, b;
+				Geometry3D::get_closest_points_between_segments(p_from, p_to, p.points[point_id].pos, p.points[(point_id + 1) % p.points.size()].pos, a, b);
+				if (a.distance_to(b) < closest_point_d) {
+					closest_point = b;
+					closest_point_d = a.distance_to(b);
+				}
+			}
+		}
+	}
+	return closest_point;
+}
+
+TEST_CASE("[Navigation] Closest point queries match a linear search") {
+	NavMap map;
+	LocalVector<NavRegion *> regions;
+	regions.push_back(add_region(map, create_square_mesh(6), Vector3()));
+	regions.push_back(add_region(map, create_square_mesh(4), Vector3(8, 1, 2)));
+	regions.push_back(add_region(map, create_square_mesh(5), Vector3(-3, 3, -7), Basis(Vector3(1, 0, 0), 0.4)));
+	regions.push_back(add_region(map, create_square_mesh(3), Vector3(2, -2, 9), Basis(Vector3(0, 1, 0), 0.7) * Basis(Vector3(0, 0, 1), -0.3)));
+	for (uint32_t i = 0; i < regions.size(); i++) {
+		regions[i]->set_self(RID::from_uint64(i + 1));
+	}
+	map.sync();
+	// Enough polygons for the BVH to have several levels.
+	CHECK(map.get_polygon_count() == 36 + 16 + 25 + 9);
+
+	RandomPCG rng(1234);
+	for (int i = 0; i < 500; i++) {
+		const Vector3 point(rng.random(-10.0, 16.0), rng.random(-5.0, 6.0), rng.random(-12.0, 15.0));
+		const LinearClosestPoint expected = get_linear_closest_point(map, point);
+		CHECK(map.get_closest_point(point).is_equal_approx(expected.point));
+		CHECK(map.get_closest_point_normal(point).is_equal_approx(expected.normal));
+		CHECK(map.get_closest_point_owner(point) == expected.owner);
+
+		const Vector3 to(rng.random(-10.0, 16.0), rng.random(-5.0, 6.0), rng.random(-12.0, 15.0));
+		CHECK(map.get_closest_point_to_segment(point, to, false).is_equal_approx(get_linear_closest_point_to_segment(map, point, to, false)));
+		CHECK(map.get_closest_point_to_segment(point, to, true).is_equal_approx(get_linear_closest_point_to_segment(map, point, to, true)));
+	}
+
+	for (uint32_t i = 0; i < regions.size(); i++) {
+		remove_region(map, regions[i]);
+	}
+}
+
+TEST_CASE("[Navigation] Path search context open list") {
+	gd::PathSearchContext context;
+	context.begin(64);
+
+	RandomPCG rng(42);
+	for (uint32_t i = 0; i < 64; i++) {
+		gd::NavigationPoly &np = context.visit(i, nullptr);
+		CHECK(np.self_id == i);
+		np.cost = rng.random(0.0f, 100.0f);
+		context.push_open(i);
+	}
+	// Cheaper ways into some polygons.
+	for (uint32_t i = 0; i < 64; i += 3) {
+		context.navigation_polys[i].cost *= 0.5;
+		context.update_open(i);
+	}
+
+	LocalVector<bool> popped;
+	popped.resize(64);
+	for (uint32_t i = 0; i < 64; i++) {
+		popped[i] = false;
+	}
+	float previous_cost = -1.0;
+	for (uint32_t i = 0; i < 64; i++) {
+		REQUIRE(!context.open.is_empty());
+		const uint32_t id = context.pop_open();
+		CHECK_FALSE(popped[id]);
+		popped[id] = true;
+		CHECK(context.navigation_polys[id].heap_index == UINT32_MAX);
+		CHECK(context.navigation_polys[id].cost >= previous_cost);
+		previous_cost = context.navigation_polys[id].cost;
+		for (uint32_t j = 0; j < context.open.size(); j++) {
+			CHECK(context.navigation_polys[context.open[j]].heap_index == j);
+		}
+	}
+	CHECK(context.open.is_empty());
+}
+
+TEST_CASE("[Navigation] Path search context generations") {
+	gd::PathSearchContext context;
+	context.begin(4);
+	context.visit(1, nullptr);
+	context.visit(3, nullptr);
+	context.push_open(3);
+	CHECK(context.is_visited(1));
+	CHECK_FALSE(context.is_visited(2));
+
+	// A new search forgets the previous one without clearing anything.
+	context.begin(4);
+	CHECK_FALSE(context.is_visited(1));
+	CHECK_FALSE(context.is_visited(3));
+	CHECK(context.open.is_empty());
+
+	// Growing for a bigger map keeps the stamps of the existing polygons valid.
+	context.visit(1, nullptr);
+	context.begin(8);
+	for (uint32_t i = 0; i < 8; i++) {
+		CHECK_FALSE(context.is_visited(i));
+	}
+
+	// Stamps older than a wrap around of the generation are not mistaken for new ones.
+	gd::PathSearchContext wrapping;
+	wrapping.begin(8);
+	CHECK(wrapping.generation == 1);
+	wrapping.visit(5, nullptr);
+	wrapping.generation = UINT32_MAX;
+	wrapping.begin(8);
+	CHECK(wrapping.generation == 1);
+	CHECK_FALSE(wrapping.is_visited(5));
+}
+
+struct ConcurrentPathQueries {
+	const NavMap *map = nullptr;
+	Vector<Vector3> points;
+	Vector<Vector<Vector3>> paths;
+
+	static void run(void *p_userdata) {
+		ConcurrentPathQueries *queries = static_cast<ConcurrentPathQueries *>(p_userdata);
+		queries->paths.resize(queries->points.size() * queries->points.size());
+		for (int repeat = 0; repeat < 10; repeat++) {
+			for (int i = 0; i < queries->points.size(); i++) {
+				for (int j = 0; j < queries->points.size(); j++) {
+					queries->paths.write[i * queries->points.size() + j] = queries->map->get_path(queries->points[i], queries->points[j], (i + j) % 2 == 0);
+				}
+			}
+		}
+	}
+};
+
+TEST_CASE("[Navigation] Concurrent path queries match serial ones") {
+	NavMap map;
+	NavRegion *region = add_region(map, create_square_mesh(8), Vector3());
+	map.sync();
+
+	ConcurrentPathQueries serial;
+	serial.map = &map;
+	RandomPCG rng(7);
+	for (int i = 0; i < 6; i++) {
+		serial.points.push_back(Vector3(rng.random(0.0f, 8.0f), 0, rng.random(0.0f, 8.0f)));
+	}
+	ConcurrentPathQueries::run(&serial);
+
+	ConcurrentPathQueries concurrent[4];
+	Thread threads[4];
+	for (int i = 0; i < 4; i++) {
+		concurrent[i].map = &map;
+		concurrent[i].points = serial.points;
+		threads[i].start(&ConcurrentPathQueries::run, &concurrent[i]);
+	}
+	for (int i = 0; i < 4; i++) {
+		threads[i].wait_to_finish();
+		REQUIRE(concurrent[i].paths.size() == serial.paths.size());
+		for (int j = 0; j < serial.paths.size(); j++) {
+			CHECK(concurrent[i].paths[j] == serial.paths[j]);
+		}
+	}
+
+	remove_region(map, region);
+}
+
+// The neighbors RVO's kd-tree would find: the closest agents within the neighbor distance.
+static std::vector<const RVO::Agent *> get_linear_agent_neighbors(const NavMap &p_map, const RVO::Agent *p_agent) {
+	std::vector<std::pair<float, const RVO::Agent *>> in_range;
+	for (size_t i = 0; i < p_map.get_agents().size(); i++) {
+		const RVO::Agent *other = p_map.get_agents()[i]->get_agent();
+		const float dist_sq = RVO::absSq(p_agent->position_ - other->position_);
+		if (other != p_agent && dist_sq < p_agent->neighborDist_ * p_agent->neighborDist_) {
+			in_range.push_back(std::make_pair(dist_sq, other));
+		}
+	}
+	std::sort(in_range.begin(), in_range.end());
+
+	std::vector<const RVO::Agent *> neighbors;
+	for (size_t i = 0; i < in_range.size() && i < p_agent->maxNeighbors_; i++) {
+		neighbors.push_back(in_range[i].second);
+	}
+	return neighbors;
+}
+
+static void check_agent_neighbors(const NavMap &p_map) {
+	for (size_t i = 0; i < p_map.get_agents().size(); i++) {
+		const RVO::Agent *agent = p_map.get_agents()[i]->get_agent();
+		const std::vector<const RVO::Agent *> expected = get_linear_agent_neighbors(p_map, agent);
+		REQUIRE_MESSAGE(agent->agentNeighbors_.size() == expected.size(), vformat("Agent %d has the wrong number of neighbors.", (int)i));
+		for (size_t j = 0; j < expected.size(); j++) {
+			CHECK(agent->agentNeighbors_[j].second == expected[j]);
+		}
+	}
+}
+
+TEST_CASE("[Navigation] Agent neighbors match a linear search") {
+	NavMap map;
+	RandomPCG rng(11);
+	LocalVector<RvoAgent *> agents;
+	for (int i = 0; i < 300; i++) {
+		RvoAgent *agent = memnew(RvoAgent);
+		RVO::Agent *rvo_agent = agent->get_agent();
+		rvo_agent->position_ = RVO::Vector3(rng.random(-25.0f, 25.0f), rng.random(0.0f, 2.0f), rng.random(-25.0f, 25.0f));
+		rvo_agent->neighborDist_ = rng.random(2.0f, 4.0f);
+		rvo_agent->maxNeighbors_ = 10;
+		rvo_agent->radius_ = 0.5;
+		rvo_agent->timeHorizon_ = 1.0;
+		rvo_agent->maxSpeed_ = 1.0;
+		map.add_agent(agent);
+		agent->set_map(&map);
+		map.set_agent_as_controlled(agent);
+		agents.push_back(agent);
+	}
+	// Sees the whole crowd, searched without the grid.
+	agents[0]->get_agent()->neighborDist_ = 1000.0;
+	agents[1]->get_agent()->maxNeighbors_ = 0;
+
+	map.step(0.1);
+	check_agent_neighbors(map);
+
+	// Agents moving to other cells.
+	for (uint32_t i = 0; i < agents.size(); i++) {
+		RVO::Agent *rvo_agent = agents[i]->get_agent();
+		rvo_agent->position_ = rvo_agent->position_ + RVO::Vector3(rng.random(-3.0f, 3.0f), 0, rng.random(-3.0f, 3.0f));
+	}
+	map.step(0.1);
+	check_agent_neighbors(map);
+
+	// The cells follow the neighbor distances.
+	const real_t cell_size = map.get_agent_cell_size();
+	for (uint32_t i = 1; i < agents.size(); i++) {
+		agents[i]->get_agent()->neighborDist_ = 8.0;
+	}
+	map.step(0.1);
+	CHECK(map.get_agent_cell_size() > cell_size);
+	CHECK(map.get_agent_cell_size() == doctest::Approx((1000.0 + 8.0 * 299) / 300));
+	check_agent_neighbors(map);
+
+	for (uint32_t i = 0; i < agents.size(); i++) {
+		map.remove_agent(agents[i]);
+		agents[i]->set_map(nullptr);
+		memdelete(agents[i]);
+	}
+}
+
+} // namespace TestNavMap
+
+#endif // TEST_NAV_MAP_H
@@ -0,0 +1,201 @@
+/*************************************************************************/
+/*  test_navigation_mesh_generator.h                                     */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+
+#ifndef TEST_NAVIGATION_MESH_GENERATOR_H
+#define TEST_NAVIGATION_MESH_GENERATOR_H
+
+#ifndef _3D_DISABLED
+
+#include "modules/navigation/navigation_mesh_generator.h"
+#include "modules/navigation/tests/test_nav_map.h"
+#include "scene/3d/collision_shape_3d.h"
+#include "scene/3d/physics_body_3d.h"
+#include "scene/main/window.h"
+#include "scene/resources/concave_polygon_shape_3d.h"
+
+#include "tests/test_macros.h"
+
+namespace TestNavigationMeshGenerator {
+
+static const float TILE_SIZE = 5.0;
+
+static void add_quad(Vector<Vector3> &r_faces, const Vector3 &p_from, const Vector3 &p_to, float p_height) {
+	const Vector3 a(p_from.x, p_height, p_from.z);
+	const Vector3 b(p_to.x, p_height, p_from.z);
+	const Vector3 c(p_to.x, p_height, p_to.z);
+	const Vector3 d(p_from.x, p_height, p_to.z);
+	r_faces.push_back(a);
+	r_faces.push_back(b);
+	r_faces.push_back(c);
+	r_faces.push_back(a);
+	r_faces.push_back(c);
+	r_faces.push_back(d);
+}
+
+// A 20x20 ground with a low slab across the tile border at x = 10, too low to walk under.
+static Node3D *create_level() {
+	Vector<Vector3> faces;
+	add_quad(faces, Vector3(0, 0, 0), Vector3(20, 0, 20), 0);
+	add_quad(faces, Vector3(9.5, 0, 4), Vector3(10.5, 0, 16), 1);
+
+	Ref<ConcavePolygonShape3D> shape;
+	shape.instantiate();
+	shape->set_faces(faces);
+
+	Node3D *root = memnew(Node3D);
+	StaticBody3D *body = memnew(StaticBody3D);
+	CollisionShape3D *collision_shape = memnew(CollisionShape3D);
+	collision_shape->set_shape(shape);
+	body->add_child(collision_shape);
+	root->add_child(body);
+	SceneTree::get_singleton()->get_root()->add_child(root);
+	return root;
+}
+
+static Ref<NavigationMesh> bake(Node3D *p_root, float p_tile_size) {
+	Ref<NavigationMesh> mesh;
+	mesh.instantiate();
+	mesh->set_parsed_geometry_type(NavigationMesh::PARSED_GEOMETRY_STATIC_COLLIDERS);
+	mesh->set_cell_size(0.25);
+	mesh->set_tile_size(p_tile_size);
+	NavigationMeshGenerator::get_singleton()->bake(mesh, p_root);
+	return mesh;
+}
+
+static bool is_on_tile_border(real_t p_coord) {
+	return Math::abs(p_coord - Math::round(p_coord / TILE_SIZE) * TILE_SIZE) < 0.01;
+}
+
+static real_t get_path_length(const Vector<Vector3> &p_path) {
+	real_t length = 0;
+	for (int i = 1; i < p_path.size(); i++) {
+		length += p_path[i - 1].distance_to(p_path[i]);
+	}
+	return length;
+}
+
+TEST_CASE("[SceneTree][Navigation] Tiled bakes connect across tile borders like untiled bakes") {
+	Node3D *root = create_level();
+	Ref<NavigationMesh> untiled = bake(root, 0);
+	Ref<NavigationMesh> tiled = bake(root, TILE_SIZE);
+	REQUIRE(untiled->get_polygon_count() > 0);
+	REQUIRE(tiled->get_polygon_count() > 0);
+
+	const Vector<Vector3> vertices = tiled->get_vertices();
+
+	SUBCASE("Vertices on tile borders are welded") {
+		for (int i = 0; i < vertices.size(); i++) {
+			if (!is_on_tile_border(vertices[i].x) && !is_on_tile_border(vertices[i].z)) {
+				continue;
+			}
+			for (int j = i + 1; j < vertices.size(); j++) {
+				CHECK_MESSAGE(vertices[i].distance_to(vertices[j]) > 0.01, vformat("Border vertices %d and %d are at the same position %s.", i, j, vertices[i]));
+			}
+		}
+	}
+
+	SUBCASE("Edges on tile borders have no T-junctions") {
+		for (int i = 0; i < tiled->get_polygon_count(); i++) {
+			const Vector<int> polygon = tiled->get_polygon(i);
+			for (int j = 0; j < polygon.size(); j++) {
+				const Vector3 &a = vertices[polygon[j]];
+				const Vector3 &b = vertices[polygon[(j + 1) % polygon.size()]];
+				const bool along_x_border = is_on_tile_border(a.x) && Math::is_equal_approx(a.x, b.x);
+				const bool along_z_border = is_on_tile_border(a.z) && Math::is_equal_approx(a.z, b.z);
+				if (!along_x_border && !along_z_border) {
+					continue;
+				}
+				for (int k = 0; k < vertices.size(); k++) {
+					if (k == polygon[j] || k == polygon[(j + 1) % polygon.size()]) {
+						continue;
+					}
+					const Vector3 segment[2] = { a, b };
+					const Vector3 point = Geometry3D::get_closest_point_to_segment(vertices[k], segment);
+					const bool inside = point.distance_to(vertices[k]) < 0.01 && point.distance_to(a) > 0.01 && point.distance_to(b) > 0.01;
+					CHECK_MESSAGE(!inside, vformat("Vertex %s splits the border edge %s - %s.", vertices[k], a, b));
+				}
+			}
+		}
+	}
+
+	SUBCASE("Polygons on both sides of a tile border are connected") {
+		NavMap map;
+		NavRegion *region = TestNavMap::add_region(map, tiled, Vector3());
+		map.sync();
+
+		for (size_t i = 0; i < region->get_polygons().size(); i++) {
+			const gd::Polygon &polygon = region->get_polygons()[i];
+			for (size_t j = 0; j < polygon.points.size(); j++) {
+				const Vector3 &a = polygon.points[j].pos;
+				const Vector3 &b = polygon.points[(j + 1) % polygon.points.size()].pos;
+				const bool along_x_border = is_on_tile_border(a.x) && Math::is_equal_approx(a.x, b.x);
+				const bool along_z_border = is_on_tile_border(a.z) && Math::is_equal_approx(a.z, b.z);
+				if (along_x_border || along_z_border) {
+					CHECK_MESSAGE(!polygon.edges[j].connections.is_empty(), vformat("The border edge %s - %s is not connected.", a, b));
+				}
+			}
+		}
+
+		TestNavMap::remove_region(map, region);
+	}
+
+	SUBCASE("Paths match the untiled bake") {
+		NavMap untiled_map;
+		NavRegion *untiled_region = TestNavMap::add_region(untiled_map, untiled, Vector3());
+		untiled_map.sync();
+		NavMap tiled_map;
+		NavRegion *tiled_region = TestNavMap::add_region(tiled_map, tiled, Vector3());
+		tiled_map.sync();
+
+		const Vector3 points[] = { Vector3(2, 0, 2), Vector3(18, 0, 18), Vector3(2, 0, 10), Vector3(18, 0, 10), Vector3(12, 0, 3), Vector3(7, 0, 17) };
+		for (const Vector3 &from : points) {
+			for (const Vector3 &to : points) {
+				const Vector<Vector3> untiled_path = untiled_map.get_path(from, to, true);
+				const Vector<Vector3> tiled_path = tiled_map.get_path(from, to, true);
+				REQUIRE(untiled_path.size() > 0);
+				REQUIRE(tiled_path.size() > 0);
+				CHECK_MESSAGE(tiled_path[tiled_path.size() - 1].distance_to(tiled_map.get_closest_point(to)) < 0.1, vformat("The tiled path from %s doesn't reach %s.", from, to));
+				CHECK(get_path_length(tiled_path) == doctest::Approx(get_path_length(untiled_path)).epsilon(0.1));
+			}
+		}
+
+		TestNavMap::remove_region(untiled_map, untiled_region);
+		TestNavMap::remove_region(tiled_map, tiled_region);
+	}
+
+	memdelete(root);
+}
+
+} // namespace TestNavigationMeshGenerator
+
+#endif // _3D_DISABLED
+
+#endif // TEST_NAVIGATION_MESH_GENERATOR_H
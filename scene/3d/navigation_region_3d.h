@@ -63,6 +63,9 @@ public:
 	/// Bakes the navigation mesh in a dedicated thread; once done, automatically
 	/// sets the new navigation mesh and emits a signal
 	void bake_navigation_mesh();
+	/// Same as `bake_navigation_mesh`, but only rebakes the tiles touched by the given global area
+	/// when the navigation mesh is tiled.
+	void bake_navigation_mesh_area(const AABB &p_area);
 	void _bake_finished(Ref<NavigationMesh> p_nav_mesh);
 
 	TypedArray<String> get_configuration_warnings() const override;
@@ -79,6 +79,7 @@ void Node3D::_notify_dirty() {
 	if (data.notify_transform && !data.ignore_notification && !xform_change.in_list()) {
 
 #endif
+		MutexLock lock(get_tree()->xform_change_list_mutex);
 		get_tree()->xform_change_list.add(&xform_change);
 	}
 }
@@ -112,6 +113,7 @@ void Node3D::_propagate_transform_changed(Node3D *p_origin) {
 #else
 	if (data.notify_transform && !data.ignore_notification && !xform_change.in_list()) {
 #endif
+		MutexLock lock(get_tree()->xform_change_list_mutex);
 		get_tree()->xform_change_list.add(&xform_change);
 	}
 	data.dirty |= DIRTY_GLOBAL;
@@ -715,11 +717,38 @@ void Node3D::force_update_transform() {
 	if (!xform_change.in_list()) {
 		return; //nothing to update
 	}
-	get_tree()->xform_change_list.remove(&xform_change);
+	{
+		MutexLock lock(get_tree()->xform_change_list_mutex);
+		get_tree()->xform_change_list.remove(&xform_change);
+	}
 
 	notification(NOTIFICATION_TRANSFORM_CHANGED);
 }
 
+void Node3D::_update_global_transform_task(uint32_t p_index, Node3D *const *p_nodes) {
+	p_nodes[p_index]->get_global_transform();
+}
+
+// Updates nodes sharing the same tree depth, with their parents already up to date.
+void Node3D::_update_global_transforms(Node3D *const *p_nodes, uint32_t p_count, ThreadWorkPool *p_work_pool) {
+	// Parents that weren't part of the batch may still be dirty. Update them here,
+	// so every node only writes to itself below.
+	for (uint32_t i = 0; i < p_count; i++) {
+		const Node3D *node = p_nodes[i];
+		if (node->data.parent && !node->data.top_level_active && (node->data.parent->data.dirty & DIRTY_GLOBAL)) {
+			node->data.parent->get_global_transform();
+		}
+	}
+
+	if (p_work_pool && p_count >= 64) {
+		p_work_pool->do_work(p_count, p_nodes[0], &Node3D::_update_global_transform_task, p_nodes);
+	} else {
+		for (uint32_t i = 0; i < p_count; i++) {
+			p_nodes[i]->get_global_transform();
+		}
+	}
+}
+
 void Node3D::_update_visibility_parent(bool p_update_root) {
 	RID new_parent;
 
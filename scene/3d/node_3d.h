@@ -101,6 +101,7 @@ class Node3D : public Node {
 	void _update_gizmos();
 	void _notify_dirty();
 	void _propagate_transform_changed(Node3D *p_origin);
+	void _update_global_transform_task(uint32_t p_index, Node3D *const *p_nodes);
 
 	void _propagate_visibility_changed();
 
@@ -203,6 +204,7 @@ public:
 	bool is_visible_in_tree() const;
 
 	void force_update_transform();
+	static void _update_global_transforms(Node3D *const *p_nodes, uint32_t p_count, ThreadWorkPool *p_work_pool);
 
 	void set_visibility_parent(const NodePath &p_path);
 	NodePath get_visibility_parent() const;
@@ -198,6 +198,9 @@ void AnimationPlayer::_notification(int p_what) {
 			}
 			//_set_process(false);
 			clear_caches();
+			if (parallel_evaluation) {
+				parallel_players.push_back(this);
+			}
 		} break;
 		case NOTIFICATION_READY: {
 			if (!Engine::get_singleton()->is_editor_hint() && animation_set.has(autoplay)) {
@@ -210,7 +213,7 @@ void AnimationPlayer::_notification(int p_what) {
 				break;
 			}
 
-			if (processing) {
+			if (processing && !(parallel_evaluation && _process_parallel(false))) {
 				_animation_process(get_process_delta_time());
 			}
 		} break;
@@ -219,11 +222,14 @@ void AnimationPlayer::_notification(int p_what) {
 				break;
 			}
 
-			if (processing) {
+			if (processing && !(parallel_evaluation && _process_parallel(true))) {
 				_animation_process(get_physics_process_delta_time());
 			}
 		} break;
 		case NOTIFICATION_EXIT_TREE: {
+			if (parallel_evaluation) {
+				_parallel_unregister();
+			}
 			clear_caches();
 		} break;
 	}
@@ -341,8 +347,25 @@ void AnimationPlayer::_ensure_node_caches(AnimationData *p_anim, Node *p_root_ov
 	}
 }
 
-void AnimationPlayer::_animation_process_animation(AnimationData *p_anim, double p_time, double p_delta, float p_interp, bool p_is_current, bool p_seeked, bool p_started) {
-	_ensure_node_caches(p_anim);
+void AnimationPlayer::_animation_process_animation(AnimationData *p_anim, double p_time, double p_delta, float p_interp, bool p_is_current, bool p_seeked, bool p_started, TrackProcessMode p_tracks) {
+	if (p_tracks == TRACK_PROCESS_TRANSFORMS) {
+		// Running on a worker thread, remember the call so the other tracks are processed with the same state.
+		ParallelCall call;
+		call.anim = p_anim;
+		call.time = p_time;
+		call.delta = p_delta;
+		call.interp = p_interp;
+		call.is_current = p_is_current;
+		call.seeked = p_seeked;
+		call.started = p_started;
+		parallel_calls.push_back(call);
+
+		if (p_anim->node_cache.size() != p_anim->animation->get_track_count()) {
+			return; // Caches are only built on the main thread.
+		}
+	} else {
+		_ensure_node_caches(p_anim);
+	}
 	ERR_FAIL_COND(p_anim->node_cache.size() != p_anim->animation->get_track_count());
 
 	Animation *a = p_anim->animation.operator->();
@@ -352,9 +375,16 @@ void AnimationPlayer::_animation_process_animation(AnimationData *p_anim, double
 		// If an animation changes this animation (or it animates itself)
 		// we need to recreate our animation cache
 		if (p_anim->node_cache.size() != a->get_track_count()) {
+			if (p_tracks == TRACK_PROCESS_TRANSFORMS) {
+				return;
+			}
 			_ensure_node_caches(p_anim);
 		}
 
+		if (p_tracks != TRACK_PROCESS_ALL && (a->track_get_type(i) == Animation::TYPE_TRANSFORM3D) != (p_tracks == TRACK_PROCESS_TRANSFORMS)) {
+			continue;
+		}
+
 		TrackNodeCache *nc = p_anim->node_cache[i];
 
 		if (!nc) {
@@ -777,7 +807,7 @@ void AnimationPlayer::_animation_process_animation(AnimationData *p_anim, double
 	}
 }
 
-void AnimationPlayer::_animation_process_data(PlaybackData &cd, double p_delta, float p_blend, bool p_seeked, bool p_started) {
+void AnimationPlayer::_animation_process_data(PlaybackData &cd, double p_delta, float p_blend, bool p_seeked, bool p_started, TrackProcessMode p_tracks) {
 	double delta = p_delta * speed_scale * cd.speed_scale;
 	double next_pos = cd.pos + delta;
 
@@ -821,15 +851,15 @@ void AnimationPlayer::_animation_process_data(PlaybackData &cd, double p_delta,
 
 	cd.pos = next_pos;
 
-	_animation_process_animation(cd.from, cd.pos, delta, p_blend, &cd == &playback.current, p_seeked, p_started);
+	_animation_process_animation(cd.from, cd.pos, delta, p_blend, &cd == &playback.current, p_seeked, p_started, p_tracks);
 }
 
-void AnimationPlayer::_animation_process2(double p_delta, bool p_started) {
+void AnimationPlayer::_animation_process2(double p_delta, bool p_started, TrackProcessMode p_tracks) {
 	Playback &c = playback;
 
 	accum_pass++;
 
-	_animation_process_data(c.current, p_delta, 1.0f, c.seeked && p_delta != 0, p_started);
+	_animation_process_data(c.current, p_delta, 1.0f, c.seeked && p_delta != 0, p_started, p_tracks);
 	if (p_delta != 0) {
 		c.seeked = false;
 	}
@@ -838,7 +868,7 @@ void AnimationPlayer::_animation_process2(double p_delta, bool p_started) {
 	for (List<Blend>::Element *E = c.blend.back(); E; E = prev) {
 		Blend &b = E->get();
 		float blend = b.blend_left / b.blend_time;
-		_animation_process_data(b.data, p_delta, blend, false, false);
+		_animation_process_data(b.data, p_delta, blend, false, false, p_tracks);
 
 		b.blend_left -= Math::absf(speed_scale * p_delta);
 
@@ -928,39 +958,151 @@ void AnimationPlayer::_animation_update_transforms() {
 	cache_update_bezier_size = 0;
 }
 
+void AnimationPlayer::_animation_process_end() {
+	if (playback.started) {
+		playback.started = false;
+	}
+
+	_animation_update_transforms();
+	if (end_reached) {
+		if (queued.size()) {
+			String old = playback.assigned;
+			play(queued.front()->get());
+			String new_name = playback.assigned;
+			queued.pop_front();
+			if (end_notify) {
+				emit_signal(SceneStringNames::get_singleton()->animation_changed, old, new_name);
+			}
+		} else {
+			//stop();
+			playing = false;
+			_set_process(false);
+			if (end_notify) {
+				emit_signal(SceneStringNames::get_singleton()->animation_finished, playback.assigned);
+			}
+		}
+		end_reached = false;
+	}
+}
+
 void AnimationPlayer::_animation_process(double p_delta) {
+	_parallel_cancel(); // Processed directly (e.g. advance()) while part of a pending batch.
+
 	if (playback.current.from) {
 		end_reached = false;
 		end_notify = false;
 		_animation_process2(p_delta, playback.started);
+		_animation_process_end();
+	} else {
+		_set_process(false);
+	}
+}
+
+LocalVector<AnimationPlayer *> AnimationPlayer::parallel_players;
+LocalVector<AnimationPlayer *> AnimationPlayer::parallel_batch;
+uint64_t AnimationPlayer::parallel_batch_pass = UINT64_MAX;
 
-		if (playback.started) {
-			playback.started = false;
+bool AnimationPlayer::_process_parallel(bool p_physics) {
+	if (get_process_thread_group_owner()) {
+		// Already running on a process thread group, the shared pool isn't reentrant.
+		return false;
+	}
+
+	uint64_t pass = get_tree()->get_process_pass();
+	if (parallel_batch_pass != pass) {
+		parallel_batch_pass = pass;
+		_process_parallel_batch(p_physics, pass);
+	}
+	// Players that joined after the batch ran are processed on their own.
+	return parallel_pass == pass;
+}
+
+void AnimationPlayer::_process_parallel_batch(bool p_physics, uint64_t p_pass) {
+	AnimationProcessCallback callback = p_physics ? ANIMATION_PROCESS_PHYSICS : ANIMATION_PROCESS_IDLE;
+
+	parallel_batch.clear();
+	for (uint32_t i = 0; i < parallel_players.size(); i++) {
+		AnimationPlayer *player = parallel_players[i];
+		if (player->process_callback != callback || !player->playback.current.from) {
+			continue;
+		}
+		if (!(p_physics ? player->is_physics_processing_internal() : player->is_processing_internal()) || !player->can_process() || player->get_process_thread_group_owner()) {
+			continue;
 		}
 
-		_animation_update_transforms();
-		if (end_reached) {
-			if (queued.size()) {
-				String old = playback.assigned;
-				play(queued.front()->get());
-				String new_name = playback.assigned;
-				queued.pop_front();
-				if (end_notify) {
-					emit_signal(SceneStringNames::get_singleton()->animation_changed, old, new_name);
-				}
-			} else {
-				//stop();
-				playing = false;
-				_set_process(false);
-				if (end_notify) {
-					emit_signal(SceneStringNames::get_singleton()->animation_finished, playback.assigned);
-				}
-			}
-			end_reached = false;
+		// Everything that may touch the scene happens here, before sampling starts.
+		player->_ensure_node_caches(player->playback.current.from);
+		for (const Blend &b : player->playback.blend) {
+			player->_ensure_node_caches(b.data.from);
 		}
 
-	} else {
-		_set_process(false);
+		player->parallel_delta = p_physics ? player->get_physics_process_delta_time() : player->get_process_delta_time();
+		player->parallel_pass = p_pass;
+		player->parallel_pending = true;
+		parallel_batch.push_back(player);
+	}
+
+	if (parallel_batch.size() > 1) {
+		get_tree()->get_work_pool()->do_work(parallel_batch.size(), this, &AnimationPlayer::_parallel_sample, parallel_batch.ptr());
+	} else if (parallel_batch.size() == 1) {
+		_parallel_sample(0, parallel_batch.ptr());
+	}
+
+	// Apply in order; players leaving the tree meanwhile are cleared from the batch.
+	for (uint32_t i = 0; i < parallel_batch.size(); i++) {
+		if (parallel_batch[i]) {
+			parallel_batch[i]->_parallel_finish();
+		}
+	}
+	parallel_batch.clear();
+}
+
+void AnimationPlayer::_parallel_sample(uint32_t p_index, AnimationPlayer **p_players) {
+	AnimationPlayer *player = p_players[p_index];
+	player->end_reached = false;
+	player->end_notify = false;
+	player->parallel_calls.clear();
+	player->_animation_process2(player->parallel_delta, player->playback.started, TRACK_PROCESS_TRANSFORMS);
+}
+
+void AnimationPlayer::_parallel_finish() {
+	if (!parallel_pending) {
+		return;
+	}
+	parallel_pending = false;
+
+	for (uint32_t i = 0; i < parallel_calls.size(); i++) {
+		const ParallelCall &call = parallel_calls[i];
+		_animation_process_animation(call.anim, call.time, call.delta, call.interp, call.is_current, call.seeked, call.started, TRACK_PROCESS_NON_TRANSFORMS);
+	}
+	parallel_calls.clear();
+
+	_animation_process_end();
+}
+
+void AnimationPlayer::_parallel_cancel() {
+	// Sampled results reference caches that are about to change, drop them.
+	if (!parallel_pending) {
+		return;
+	}
+	parallel_pending = false;
+	parallel_calls.clear();
+	cache_update_size = 0;
+	cache_update_prop_size = 0;
+	cache_update_bezier_size = 0;
+}
+
+void AnimationPlayer::_parallel_unregister() {
+	int64_t idx = parallel_players.find(this);
+	if (idx >= 0) {
+		parallel_players.remove_unordered(idx);
+	}
+	if (parallel_pending) {
+		idx = parallel_batch.find(this);
+		if (idx >= 0) {
+			parallel_batch[idx] = nullptr;
+		}
+		_parallel_cancel();
 	}
 }
 
@@ -1256,6 +1398,7 @@ String AnimationPlayer::get_assigned_animation() const {
 }
 
 void AnimationPlayer::stop(bool p_reset) {
+	_parallel_cancel();
 	_stop_playing_caches();
 	Playback &c = playback;
 	c.blend.clear();
@@ -1361,6 +1504,7 @@ void AnimationPlayer::_node_removed(Node *p_node) {
 }
 
 void AnimationPlayer::clear_caches() {
+	_parallel_cancel();
 	_stop_playing_caches();
 
 	node_cache_map.clear();
@@ -1417,6 +1561,25 @@ bool AnimationPlayer::is_reset_on_save_enabled() const {
 	return reset_on_save;
 }
 
+void AnimationPlayer::set_parallel_evaluation_enabled(bool p_enabled) {
+	if (parallel_evaluation == p_enabled) {
+		return;
+	}
+
+	if (is_inside_tree()) {
+		if (p_enabled) {
+			parallel_players.push_back(this);
+		} else {
+			_parallel_unregister();
+		}
+	}
+	parallel_evaluation = p_enabled;
+}
+
+bool AnimationPlayer::is_parallel_evaluation_enabled() const {
+	return parallel_evaluation;
+}
+
 void AnimationPlayer::set_process_callback(AnimationProcessCallback p_mode) {
 	if (process_callback == p_mode) {
 		return;
@@ -1644,6 +1807,9 @@ void AnimationPlayer::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_reset_on_save_enabled", "enabled"), &AnimationPlayer::set_reset_on_save_enabled);
 	ClassDB::bind_method(D_METHOD("is_reset_on_save_enabled"), &AnimationPlayer::is_reset_on_save_enabled);
 
+	ClassDB::bind_method(D_METHOD("set_parallel_evaluation_enabled", "enabled"), &AnimationPlayer::set_parallel_evaluation_enabled);
+	ClassDB::bind_method(D_METHOD("is_parallel_evaluation_enabled"), &AnimationPlayer::is_parallel_evaluation_enabled);
+
 	ClassDB::bind_method(D_METHOD("set_root", "path"), &AnimationPlayer::set_root);
 	ClassDB::bind_method(D_METHOD("get_root"), &AnimationPlayer::get_root);
 
@@ -1676,6 +1842,7 @@ void AnimationPlayer::_bind_methods() {
 	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "playback_default_blend_time", PROPERTY_HINT_RANGE, "0,4096,0.01"), "set_default_blend_time", "get_default_blend_time");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "playback_active", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NONE), "set_active", "is_active");
 	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "playback_speed", PROPERTY_HINT_RANGE, "-64,64,0.01"), "set_speed_scale", "get_speed_scale");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "playback_parallel_evaluation"), "set_parallel_evaluation_enabled", "is_parallel_evaluation_enabled");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "method_call_mode", PROPERTY_HINT_ENUM, "Deferred,Immediate"), "set_method_call_mode", "get_method_call_mode");
 
 	ADD_SIGNAL(MethodInfo("animation_finished", PropertyInfo(Variant::STRING_NAME, "anim_name")));
@@ -215,12 +215,50 @@ private:
 
 	NodePath root;
 
-	void _animation_process_animation(AnimationData *p_anim, double p_time, double p_delta, float p_interp, bool p_is_current = true, bool p_seeked = false, bool p_started = false);
+	enum TrackProcessMode {
+		TRACK_PROCESS_ALL,
+		TRACK_PROCESS_TRANSFORMS, // Only touches this player's caches, safe to run on a worker thread.
+		TRACK_PROCESS_NON_TRANSFORMS,
+	};
+
+	// Parallel evaluation: players that opt in are processed as a batch by the first of them
+	// to receive its process notification. Transform tracks of every player in the batch are
+	// sampled and blended on the scene tree work pool, then the remaining tracks are processed
+	// and all results are applied on the main thread.
+	struct ParallelCall {
+		AnimationData *anim = nullptr;
+		double time = 0.0;
+		double delta = 0.0;
+		float interp = 0.0;
+		bool is_current = true;
+		bool seeked = false;
+		bool started = false;
+	};
+
+	bool parallel_evaluation = false;
+	bool parallel_pending = false;
+	uint64_t parallel_pass = 0;
+	double parallel_delta = 0.0;
+	LocalVector<ParallelCall> parallel_calls;
+
+	static LocalVector<AnimationPlayer *> parallel_players;
+	static LocalVector<AnimationPlayer *> parallel_batch;
+	static uint64_t parallel_batch_pass;
+
+	bool _process_parallel(bool p_physics);
+	void _process_parallel_batch(bool p_physics, uint64_t p_pass);
+	void _parallel_sample(uint32_t p_index, AnimationPlayer **p_players);
+	void _parallel_finish();
+	void _parallel_cancel();
+	void _parallel_unregister();
+
+	void _animation_process_animation(AnimationData *p_anim, double p_time, double p_delta, float p_interp, bool p_is_current = true, bool p_seeked = false, bool p_started = false, TrackProcessMode p_tracks = TRACK_PROCESS_ALL);
 
 	void _ensure_node_caches(AnimationData *p_anim, Node *p_root_override = nullptr);
-	void _animation_process_data(PlaybackData &cd, double p_delta, float p_blend, bool p_seeked, bool p_started);
-	void _animation_process2(double p_delta, bool p_started);
+	void _animation_process_data(PlaybackData &cd, double p_delta, float p_blend, bool p_seeked, bool p_started, TrackProcessMode p_tracks = TRACK_PROCESS_ALL);
+	void _animation_process2(double p_delta, bool p_started, TrackProcessMode p_tracks = TRACK_PROCESS_ALL);
 	void _animation_update_transforms();
+	void _animation_process_end();
 	void _animation_process(double p_delta);
 
 	void _node_removed(Node *p_node);
@@ -300,6 +338,9 @@ public:
 	void set_reset_on_save_enabled(bool p_enabled);
 	bool is_reset_on_save_enabled() const;
 
+	void set_parallel_evaluation_enabled(bool p_enabled);
+	bool is_parallel_evaluation_enabled() const;
+
 	void set_process_callback(AnimationProcessCallback p_mode);
 	AnimationProcessCallback get_process_callback() const;
 
@@ -457,6 +457,7 @@ void AnimationTree::set_tree_root(const Ref<AnimationNode> &p_root) {
 	}
 
 	root = p_root;
+	parallel_pending = false; // Blends of a pending batch point into the old graph.
 
 	if (root.is_valid()) {
 		root->connect("tree_changed", callable_mp(this, &AnimationTree::_tree_changed));
@@ -521,6 +522,25 @@ AnimationTree::AnimationProcessCallback AnimationTree::get_process_callback() co
 	return process_callback;
 }
 
+void AnimationTree::set_parallel_evaluation_enabled(bool p_enabled) {
+	if (parallel_evaluation == p_enabled) {
+		return;
+	}
+
+	if (is_inside_tree()) {
+		if (p_enabled) {
+			parallel_trees.push_back(this);
+		} else {
+			_parallel_unregister();
+		}
+	}
+	parallel_evaluation = p_enabled;
+}
+
+bool AnimationTree::is_parallel_evaluation_enabled() const {
+	return parallel_evaluation;
+}
+
 void AnimationTree::_node_removed(Node *p_node) {
 	cache_valid = false;
 }
@@ -718,9 +738,21 @@ void AnimationTree::_clear_caches() {
 
 	track_cache.clear();
 	cache_valid = false;
+	parallel_pending = false;
 }
 
 void AnimationTree::_process_graph(real_t p_delta) {
+	parallel_pending = false;
+
+	if (!_process_graph_begin(p_delta)) {
+		return;
+	}
+
+	_blend_transform_tracks();
+	_process_graph_end();
+}
+
+bool AnimationTree::_process_graph_begin(real_t p_delta) {
 	_update_properties(); //if properties need updating, update them
 
 	//check all tracks, see if they need modification
@@ -731,14 +763,14 @@ void AnimationTree::_process_graph(real_t p_delta) {
 		ERR_PRINT("AnimationTree: root AnimationNode is not set, disabling playback.");
 		set_active(false);
 		cache_valid = false;
-		return;
+		return false;
 	}
 
 	if (!has_node(animation_player)) {
 		ERR_PRINT("AnimationTree: no valid AnimationPlayer path set, disabling playback");
 		set_active(false);
 		cache_valid = false;
-		return;
+		return false;
 	}
 
 	AnimationPlayer *player = Object::cast_to<AnimationPlayer>(get_node(animation_player));
@@ -768,12 +800,12 @@ void AnimationTree::_process_graph(real_t p_delta) {
 		ERR_PRINT("AnimationTree: path points to a node not an AnimationPlayer, disabling playback");
 		set_active(false);
 		cache_valid = false;
-		return;
+		return false;
 	}
 
 	if (!cache_valid) {
 		if (!_update_caches(player)) {
-			return;
+			return false;
 		}
 	}
 
@@ -811,9 +843,142 @@ void AnimationTree::_process_graph(real_t p_delta) {
 	}
 
 	if (!state.valid) {
-		return; //state is not valid. do nothing.
+		return false; //state is not valid. do nothing.
 	}
-	//apply value/transform/bezier blends to track caches and execute method/audio/animation tracks
+
+	return true;
+}
+
+void AnimationTree::_blend_transform_tracks() {
+#ifndef _3D_DISABLED
+	// Only reads the animations and writes this tree's transform caches, so trees can be blended in parallel.
+	for (const AnimationNode::AnimationState &as : state.animation_states) {
+		const Animation *a = as.animation.ptr();
+		double time = as.time;
+		double delta = as.delta;
+		real_t weight = as.blend;
+
+		for (int i = 0; i < a->get_track_count(); i++) {
+			if (a->track_get_type(i) != Animation::TYPE_TRANSFORM3D) {
+				continue;
+			}
+
+			NodePath path = a->track_get_path(i);
+
+			TrackCache *const *track_ptr = track_cache.getptr(path);
+			ERR_CONTINUE(!track_ptr);
+
+			TrackCache *track = *track_ptr;
+			if (track->type != Animation::TYPE_TRANSFORM3D) {
+				continue; //may happen should not
+			}
+
+			track->root_motion = root_motion_track == path;
+
+			const int *blend_idx_ptr = state.track_map.getptr(path);
+			ERR_CONTINUE(!blend_idx_ptr);
+			int blend_idx = *blend_idx_ptr;
+
+			ERR_CONTINUE(blend_idx < 0 || blend_idx >= state.track_count);
+
+			real_t blend = (*as.track_blends)[blend_idx] * weight;
+
+			if (blend < CMP_EPSILON) {
+				continue; //nothing to blend
+			}
+
+			TrackCacheTransform *t = static_cast<TrackCacheTransform *>(track);
+
+			if (track->root_motion) {
+				if (t->process_pass != process_pass) {
+					t->process_pass = process_pass;
+					t->loc = Vector3();
+					t->rot = Quaternion();
+					t->rot_blend_accum = 0;
+					t->scale = Vector3(1, 1, 1);
+				}
+
+				real_t prev_time = time - delta;
+				if (prev_time < 0) {
+					if (!a->has_loop()) {
+						prev_time = 0;
+					} else {
+						prev_time = a->get_length() + prev_time;
+					}
+				}
+
+				Vector3 loc[2];
+				Quaternion rot[2];
+				Vector3 scale[2];
+
+				if (prev_time > time) {
+					Error err = a->transform_track_interpolate(i, prev_time, &loc[0], &rot[0], &scale[0]);
+					if (err != OK) {
+						continue;
+					}
+
+					a->transform_track_interpolate(i, a->get_length(), &loc[1], &rot[1], &scale[1]);
+
+					t->loc += (loc[1] - loc[0]) * blend;
+					t->scale += (scale[1] - scale[0]) * blend;
+					Quaternion q = Quaternion().slerp(rot[0].normalized().inverse() * rot[1].normalized(), blend).normalized();
+					t->rot = (t->rot * q).normalized();
+
+					prev_time = 0;
+				}
+
+				Error err = a->transform_track_interpolate(i, prev_time, &loc[0], &rot[0], &scale[0]);
+				if (err != OK) {
+					continue;
+				}
+
+				a->transform_track_interpolate(i, time, &loc[1], &rot[1], &scale[1]);
+
+				t->loc += (loc[1] - loc[0]) * blend;
+				t->scale += (scale[1] - scale[0]) * blend;
+				Quaternion q = Quaternion().slerp(rot[0].normalized().inverse() * rot[1].normalized(), blend).normalized();
+				t->rot = (t->rot * q).normalized();
+
+				prev_time = 0;
+
+			} else {
+				Vector3 loc;
+				Quaternion rot;
+				Vector3 scale;
+
+				Error err = a->transform_track_interpolate(i, time, &loc, &rot, &scale);
+				//ERR_CONTINUE(err!=OK); //used for testing, should be removed
+
+				if (t->process_pass != process_pass) {
+					t->process_pass = process_pass;
+					t->loc = loc;
+					t->rot = rot;
+					t->rot_blend_accum = 0;
+					t->scale = scale;
+				}
+
+				if (err != OK) {
+					continue;
+				}
+
+				t->loc = t->loc.lerp(loc, blend);
+				if (t->rot_blend_accum == 0) {
+					t->rot = rot;
+					t->rot_blend_accum = blend;
+				} else {
+					real_t rot_total = t->rot_blend_accum + blend;
+					t->rot = rot.slerp(t->rot, t->rot_blend_accum / rot_total).normalized();
+					t->rot_blend_accum = rot_total;
+				}
+				t->scale = t->scale.lerp(scale, blend);
+			}
+		}
+	}
+#endif // _3D_DISABLED
+}
+
+void AnimationTree::_process_graph_end() {
+	//apply value/bezier blends to track caches and execute method/audio/animation tracks
 
 	{
 		bool can_call = is_inside_tree() && !Engine::get_singleton()->is_editor_hint();
@@ -831,12 +996,10 @@ void AnimationTree::_process_graph(real_t p_delta) {
 				ERR_CONTINUE(!track_cache.has(path));
 
 				TrackCache *track = track_cache[path];
-				if (track->type != a->track_get_type(i)) {
-					continue; //may happen should not
+				if (track->type != a->track_get_type(i) || track->type == Animation::TYPE_TRANSFORM3D) {
+					continue; //transforms are blended beforehand, type mismatch may happen should not
 				}
 
-				track->root_motion = root_motion_track == path;
-
 				ERR_CONTINUE(!state.track_map.has(path));
 				int blend_idx = state.track_map[path];
 
@@ -849,95 +1012,6 @@ void AnimationTree::_process_graph(real_t p_delta) {
 				}
 
 				switch (track->type) {
-					case Animation::TYPE_TRANSFORM3D: {
-#ifndef _3D_DISABLED
-						TrackCacheTransform *t = static_cast<TrackCacheTransform *>(track);
-
-						if (track->root_motion) {
-							if (t->process_pass != process_pass) {
-								t->process_pass = process_pass;
-								t->loc = Vector3();
-								t->rot = Quaternion();
-								t->rot_blend_accum = 0;
-								t->scale = Vector3(1, 1, 1);
-							}
-
-							real_t prev_time = time - delta;
-							if (prev_time < 0) {
-								if (!a->has_loop()) {
-									prev_time = 0;
-								} else {
-									prev_time = a->get_length() + prev_time;
-								}
-							}
-
-							Vector3 loc[2];
-							Quaternion rot[2];
-							Vector3 scale[2];
-
-							if (prev_time > time) {
-								Error err = a->transform_track_interpolate(i, prev_time, &loc[0], &rot[0], &scale[0]);
-								if (err != OK) {
-									continue;
-								}
-
-								a->transform_track_interpolate(i, a->get_length(), &loc[1], &rot[1], &scale[1]);
-
-								t->loc += (loc[1] - loc[0]) * blend;
-								t->scale += (scale[1] - scale[0]) * blend;
-								Quaternion q = Quaternion().slerp(rot[0].normalized().inverse() * rot[1].normalized(), blend).normalized();
-								t->rot = (t->rot * q).normalized();
-
-								prev_time = 0;
-							}
-
-							Error err = a->transform_track_interpolate(i, prev_time, &loc[0], &rot[0], &scale[0]);
-							if (err != OK) {
-								continue;
-							}
-
-							a->transform_track_interpolate(i, time, &loc[1], &rot[1], &scale[1]);
-
-							t->loc += (loc[1] - loc[0]) * blend;
-							t->scale += (scale[1] - scale[0]) * blend;
-							Quaternion q = Quaternion().slerp(rot[0].normalized().inverse() * rot[1].normalized(), blend).normalized();
-							t->rot = (t->rot * q).normalized();
-
-							prev_time = 0;
-
-						} else {
-							Vector3 loc;
-							Quaternion rot;
-							Vector3 scale;
-
-							Error err = a->transform_track_interpolate(i, time, &loc, &rot, &scale);
-							//ERR_CONTINUE(err!=OK); //used for testing, should be removed
-
-							if (t->process_pass != process_pass) {
-								t->process_pass = process_pass;
-								t->loc = loc;
-								t->rot = rot;
-								t->rot_blend_accum = 0;
-								t->scale = scale;
-							}
-
-							if (err != OK) {
-								continue;
-							}
-
-							t->loc = t->loc.lerp(loc, blend);
-							if (t->rot_blend_accum == 0) {
-								t->rot = rot;
-								t->rot_blend_accum = blend;
-							} else {
-								real_t rot_total = t->rot_blend_accum + blend;
-								t->rot = rot.slerp(t->rot, t->rot_blend_accum / rot_total).normalized();
-								t->rot_blend_accum = rot_total;
-							}
-							t->scale = t->scale.lerp(scale, blend);
-						}
-#endif // _3D_DISABLED
-					} break;
 					case Animation::TYPE_VALUE: {
 						TrackCacheValue *t = static_cast<TrackCacheValue *>(track);
 
@@ -1240,20 +1314,114 @@ void AnimationTree::_process_graph(real_t p_delta) {
 	}
 }
 
+LocalVector<AnimationTree *> AnimationTree::parallel_trees;
+LocalVector<AnimationTree *> AnimationTree::parallel_batch;
+uint64_t AnimationTree::parallel_batch_pass = UINT64_MAX;
+
+bool AnimationTree::_process_parallel(bool p_physics) {
+	if (get_process_thread_group_owner()) {
+		// Already running on a process thread group, the shared pool isn't reentrant.
+		return false;
+	}
+
+	uint64_t pass = get_tree()->get_process_pass();
+	if (parallel_batch_pass != pass) {
+		parallel_batch_pass = pass;
+		_process_parallel_batch(p_physics, pass);
+	}
+	// Trees that joined after the batch ran are processed on their own.
+	return parallel_pass == pass;
+}
+
+void AnimationTree::_process_parallel_batch(bool p_physics, uint64_t p_pass) {
+	AnimationProcessCallback callback = p_physics ? ANIMATION_PROCESS_PHYSICS : ANIMATION_PROCESS_IDLE;
+
+	parallel_batch.clear();
+	for (uint32_t i = 0; i < parallel_trees.size(); i++) {
+		AnimationTree *tree = parallel_trees[i];
+		if (!tree->active || tree->process_callback != callback) {
+			continue;
+		}
+		if (!(p_physics ? tree->is_physics_processing_internal() : tree->is_processing_internal()) || !tree->can_process() || tree->get_process_thread_group_owner()) {
+			continue;
+		}
+		tree->parallel_pass = p_pass;
+		parallel_batch.push_back(tree);
+	}
+
+	// Graphs may call into scripts, so they are evaluated here. Trees leaving the scene
+	// meanwhile are cleared from the batch.
+	uint32_t count = 0;
+	for (uint32_t i = 0; i < parallel_batch.size(); i++) {
+		AnimationTree *tree = parallel_batch[i];
+		if (!tree) {
+			continue;
+		}
+		parallel_batch[i] = nullptr;
+		if (tree->_process_graph_begin(p_physics ? tree->get_physics_process_delta_time() : tree->get_process_delta_time())) {
+			tree->parallel_pending = true;
+			parallel_batch[count++] = tree;
+		}
+	}
+	parallel_batch.resize(count);
+
+	if (count > 1) {
+		get_tree()->get_work_pool()->do_work(count, this, &AnimationTree::_parallel_blend, parallel_batch.ptr());
+	} else if (count == 1) {
+		_parallel_blend(0, parallel_batch.ptr());
+	}
+
+	for (uint32_t i = 0; i < parallel_batch.size(); i++) {
+		AnimationTree *tree = parallel_batch[i];
+		if (tree && tree->parallel_pending) {
+			tree->parallel_pending = false;
+			tree->_process_graph_end();
+		}
+	}
+	parallel_batch.clear();
+}
+
+void AnimationTree::_parallel_blend(uint32_t p_index, AnimationTree **p_trees) {
+	AnimationTree *tree = p_trees[p_index];
+	// Trees removed by another tree's graph are cleared from the batch.
+	if (tree && tree->parallel_pending) {
+		tree->_blend_transform_tracks();
+	}
+}
+
+void AnimationTree::_parallel_unregister() {
+	int64_t idx = parallel_trees.find(this);
+	if (idx >= 0) {
+		parallel_trees.remove_unordered(idx);
+	}
+	idx = parallel_batch.find(this);
+	if (idx >= 0) {
+		parallel_batch[idx] = nullptr;
+	}
+	parallel_pending = false;
+}
+
 void AnimationTree::advance(real_t p_time) {
 	_process_graph(p_time);
 }
 
 void AnimationTree::_notification(int p_what) {
 	if (active && p_what == NOTIFICATION_INTERNAL_PHYSICS_PROCESS && process_callback == ANIMATION_PROCESS_PHYSICS) {
-		_process_graph(get_physics_process_delta_time());
+		if (!(parallel_evaluation && _process_parallel(true))) {
+			_process_graph(get_physics_process_delta_time());
+		}
 	}
 
 	if (active && p_what == NOTIFICATION_INTERNAL_PROCESS && process_callback == ANIMATION_PROCESS_IDLE) {
-		_process_graph(get_process_delta_time());
+		if (!(parallel_evaluation && _process_parallel(false))) {
+			_process_graph(get_process_delta_time());
+		}
 	}
 
 	if (p_what == NOTIFICATION_EXIT_TREE) {
+		if (parallel_evaluation) {
+			_parallel_unregister();
+		}
 		_clear_caches();
 		if (last_animation_player.is_valid()) {
 			Object *player = ObjectDB::get_instance(last_animation_player);
@@ -1262,6 +1430,9 @@ void AnimationTree::_notification(int p_what) {
 			}
 		}
 	} else if (p_what == NOTIFICATION_ENTER_TREE) {
+		if (parallel_evaluation) {
+			parallel_trees.push_back(this);
+		}
 		if (last_animation_player.is_valid()) {
 			Object *player = ObjectDB::get_instance(last_animation_player);
 			if (player) {
@@ -1472,6 +1643,9 @@ void AnimationTree::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_process_callback", "mode"), &AnimationTree::set_process_callback);
 	ClassDB::bind_method(D_METHOD("get_process_callback"), &AnimationTree::get_process_callback);
 
+	ClassDB::bind_method(D_METHOD("set_parallel_evaluation_enabled", "enabled"), &AnimationTree::set_parallel_evaluation_enabled);
+	ClassDB::bind_method(D_METHOD("is_parallel_evaluation_enabled"), &AnimationTree::is_parallel_evaluation_enabled);
+
 	ClassDB::bind_method(D_METHOD("set_animation_player", "root"), &AnimationTree::set_animation_player);
 	ClassDB::bind_method(D_METHOD("get_animation_player"), &AnimationTree::get_animation_player);
 
@@ -1490,6 +1664,7 @@ void AnimationTree::_bind_methods() {
 	ADD_PROPERTY(PropertyInfo(Variant::NODE_PATH, "anim_player", PROPERTY_HINT_NODE_PATH_VALID_TYPES, "AnimationPlayer"), "set_animation_player", "get_animation_player");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "active"), "set_active", "is_active");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "process_callback", PROPERTY_HINT_ENUM, "Physics,Idle,Manual"), "set_process_callback", "get_process_callback");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "parallel_evaluation"), "set_parallel_evaluation_enabled", "is_parallel_evaluation_enabled");
 	ADD_GROUP("Root Motion", "root_motion_");
 	ADD_PROPERTY(PropertyInfo(Variant::NODE_PATH, "root_motion_track"), "set_root_motion_track", "get_root_motion_track");
 
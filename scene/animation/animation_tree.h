@@ -260,6 +260,25 @@ private:
 	void _clear_caches();
 	bool _update_caches(AnimationPlayer *player);
 	void _process_graph(real_t p_delta);
+	bool _process_graph_begin(real_t p_delta);
+	void _blend_transform_tracks();
+	void _process_graph_end();
+
+	// Parallel evaluation: trees that opt in are processed as a batch by the first of them to
+	// receive its process notification. Graphs are evaluated on the main thread, transform
+	// tracks are blended on the scene tree work pool, then the rest is applied serially.
+	bool parallel_evaluation = false;
+	bool parallel_pending = false;
+	uint64_t parallel_pass = 0;
+
+	static LocalVector<AnimationTree *> parallel_trees;
+	static LocalVector<AnimationTree *> parallel_batch;
+	static uint64_t parallel_batch_pass;
+
+	bool _process_parallel(bool p_physics);
+	void _process_parallel_batch(bool p_physics, uint64_t p_pass);
+	void _parallel_blend(uint32_t p_index, AnimationTree **p_trees);
+	void _parallel_unregister();
 
 	uint64_t setup_pass = 1;
 	uint64_t process_pass = 1;
@@ -307,6 +326,9 @@ public:
 	void set_process_callback(AnimationProcessCallback p_mode);
 	AnimationProcessCallback get_process_callback() const;
 
+	void set_parallel_evaluation_enabled(bool p_enabled);
+	bool is_parallel_evaluation_enabled() const;
+
 	void set_animation_player(const NodePath &p_player);
 	NodePath get_animation_player() const;
 
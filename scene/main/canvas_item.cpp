@@ -683,6 +683,7 @@ void CanvasItem::_notify_transform(CanvasItem *p_node) {
 	if (p_node->notify_transform && !p_node->xform_change.in_list()) {
 		if (!p_node->block_transform_notify) {
 			if (p_node->is_inside_tree()) {
+				MutexLock lock(get_tree()->xform_change_list_mutex);
 				get_tree()->xform_change_list.add(&p_node->xform_change);
 			}
 		}
@@ -820,7 +821,10 @@ void CanvasItem::force_update_transform() {
 		return;
 	}
 
-	get_tree()->xform_change_list.remove(&xform_change);
+	{
+		MutexLock lock(get_tree()->xform_change_list_mutex);
+		get_tree()->xform_change_list.remove(&xform_change);
+	}
 
 	notification(NOTIFICATION_TRANSFORM_CHANGED);
 }
@@ -33,6 +33,7 @@
 #include "core/core_string_names.h"
 #include "core/io/resource_loader.h"
 #include "core/object/message_queue.h"
+#include "core/os/thread.h"
 #include "core/string/print_string.h"
 #include "instance_placeholder.h"
 #include "scene/animation/tween.h"
@@ -48,6 +49,7 @@
 #include <stdint.h>
 
 VARIANT_ENUM_CAST(Node::ProcessMode);
+VARIANT_ENUM_CAST(Node::ProcessThreadGroup);
 VARIANT_ENUM_CAST(Node::InternalMode);
 
 int Node::orphan_node_count = 0;
@@ -77,6 +79,12 @@ void Node::_notification(int p_notification) {
 			} else {
 				data.process_owner = this;
 			}
+			data.process_mode_cache = data.process_owner->data.process_mode;
+
+			data.process_thread_group_owner = _find_process_thread_group_owner();
+			if (data.process_thread_group_owner == this) {
+				get_tree()->_add_thread_group(this);
+			}
 
 			if (data.input) {
 				add_to_group("_vp_input" + itos(get_viewport()->get_instance_id()));
@@ -110,6 +118,11 @@ void Node::_notification(int p_notification) {
 			}
 
 			data.process_owner = nullptr;
+			data.process_mode_cache = PROCESS_MODE_PAUSABLE;
+			if (data.process_thread_group_owner == this) {
+				get_tree()->_remove_thread_group(this);
+			}
+			data.process_thread_group_owner = nullptr;
 			if (data.path_cache) {
 				memdelete(data.path_cache);
 				data.path_cache = nullptr;
@@ -214,6 +227,7 @@ void Node::_propagate_enter_tree() {
 	for (Map<StringName, GroupData>::Element *E = data.grouped.front(); E; E = E->next()) {
 		E->get().group = data.tree->add_to_group(E->key(), this);
 	}
+	_update_process_lists(true);
 
 	notification(NOTIFICATION_ENTER_TREE);
 
@@ -240,6 +254,21 @@ void Node::_propagate_enter_tree() {
 	// enter groups
 }
 
+void Node::_update_process_lists(bool p_add) {
+	const bool processing[SceneTree::PROCESS_LIST_MAX] = { data.process, data.process_internal, data.physics_process, data.physics_process_internal };
+
+	for (int i = 0; i < SceneTree::PROCESS_LIST_MAX; i++) {
+		if (!processing[i]) {
+			continue;
+		}
+		if (p_add) {
+			data.tree->_add_to_process_list(SceneTree::ProcessListType(i), this);
+		} else {
+			data.tree->_remove_from_process_list(SceneTree::ProcessListType(i), this);
+		}
+	}
+}
+
 void Node::_propagate_after_exit_tree() {
 	data.blocked++;
 	for (int i = 0; i < data.children.size(); i++) {
@@ -278,6 +307,7 @@ void Node::_propagate_exit_tree() {
 		data.tree->remove_from_group(E->key(), this);
 		E->get().group = nullptr;
 	}
+	_update_process_lists(false);
 
 	data.viewport = nullptr;
 
@@ -358,6 +388,9 @@ void Node::_move_child(Node *p_child, int p_pos, bool p_ignore_end) {
 			E->get().group->changed = true;
 		}
 	}
+	if (data.tree) {
+		data.tree->_make_process_lists_changed(p_child);
+	}
 
 	data.blocked--;
 }
@@ -396,10 +429,14 @@ void Node::set_physics_process(bool p_process) {
 
 	data.physics_process = p_process;
 
+	if (!data.inside_tree) {
+		return;
+	}
+
 	if (data.physics_process) {
-		add_to_group("physics_process", false);
+		data.tree->_add_to_process_list(SceneTree::PROCESS_LIST_PHYSICS_PROCESS, this);
 	} else {
-		remove_from_group("physics_process");
+		data.tree->_remove_from_process_list(SceneTree::PROCESS_LIST_PHYSICS_PROCESS, this);
 	}
 }
 
@@ -414,10 +451,14 @@ void Node::set_physics_process_internal(bool p_process_internal) {
 
 	data.physics_process_internal = p_process_internal;
 
+	if (!data.inside_tree) {
+		return;
+	}
+
 	if (data.physics_process_internal) {
-		add_to_group("physics_process_internal", false);
+		data.tree->_add_to_process_list(SceneTree::PROCESS_LIST_PHYSICS_PROCESS_INTERNAL, this);
 	} else {
-		remove_from_group("physics_process_internal");
+		data.tree->_remove_from_process_list(SceneTree::PROCESS_LIST_PHYSICS_PROCESS_INTERNAL, this);
 	}
 }
 
@@ -449,6 +490,7 @@ void Node::set_process_mode(ProcessMode p_mode) {
 	}
 
 	data.process_mode = p_mode;
+	data.process_mode_cache = data.process_owner->data.process_mode;
 
 	bool next_can_process = can_process();
 	bool next_enabled = _is_enabled();
@@ -501,6 +543,7 @@ Node::ProcessMode Node::get_process_mode() const {
 
 void Node::_propagate_process_owner(Node *p_owner, int p_pause_notification, int p_enabled_notification) {
 	data.process_owner = p_owner;
+	data.process_mode_cache = p_owner->data.process_mode;
 
 	if (p_pause_notification != 0) {
 		notification(p_pause_notification);
@@ -691,51 +734,6 @@ bool Node::can_process() const {
 	return _can_process(get_tree()->is_paused());
 }
 
-bool Node::_can_process(bool p_paused) const {
-	ProcessMode process_mode;
-
-	if (data.process_mode == PROCESS_MODE_INHERIT) {
-		if (!data.process_owner) {
-			process_mode = PROCESS_MODE_PAUSABLE;
-		} else {
-			process_mode = data.process_owner->data.process_mode;
-		}
-	} else {
-		process_mode = data.process_mode;
-	}
-
-	// The owner can't be set to inherit, must be a bug.
-	ERR_FAIL_COND_V(process_mode == PROCESS_MODE_INHERIT, false);
-
-	if (process_mode == PROCESS_MODE_DISABLED) {
-		return false;
-	} else if (process_mode == PROCESS_MODE_ALWAYS) {
-		return true;
-	}
-
-	if (p_paused) {
-		return process_mode == PROCESS_MODE_WHEN_PAUSED;
-	} else {
-		return process_mode == PROCESS_MODE_PAUSABLE;
-	}
-}
-
-bool Node::_is_enabled() const {
-	ProcessMode process_mode;
-
-	if (data.process_mode == PROCESS_MODE_INHERIT) {
-		if (!data.process_owner) {
-			process_mode = PROCESS_MODE_PAUSABLE;
-		} else {
-			process_mode = data.process_owner->data.process_mode;
-		}
-	} else {
-		process_mode = data.process_mode;
-	}
-
-	return (process_mode != PROCESS_MODE_DISABLED);
-}
-
 bool Node::is_enabled() const {
 	ERR_FAIL_COND_V(!is_inside_tree(), false);
 	return _is_enabled();
@@ -764,10 +762,14 @@ void Node::set_process(bool p_process) {
 
 	data.process = p_process;
 
+	if (!data.inside_tree) {
+		return;
+	}
+
 	if (data.process) {
-		add_to_group("process", false);
+		data.tree->_add_to_process_list(SceneTree::PROCESS_LIST_PROCESS, this);
 	} else {
-		remove_from_group("process");
+		data.tree->_remove_from_process_list(SceneTree::PROCESS_LIST_PROCESS, this);
 	}
 }
 
@@ -782,10 +784,14 @@ void Node::set_process_internal(bool p_process_internal) {
 
 	data.process_internal = p_process_internal;
 
+	if (!data.inside_tree) {
+		return;
+	}
+
 	if (data.process_internal) {
-		add_to_group("process_internal", false);
+		data.tree->_add_to_process_list(SceneTree::PROCESS_LIST_PROCESS_INTERNAL, this);
 	} else {
-		remove_from_group("process_internal");
+		data.tree->_remove_from_process_list(SceneTree::PROCESS_LIST_PROCESS_INTERNAL, this);
 	}
 }
 
@@ -801,25 +807,114 @@ void Node::set_process_priority(int p_priority) {
 		return;
 	}
 
-	if (is_processing()) {
-		data.tree->make_group_changed("process");
+	data.tree->_make_process_lists_changed(this);
+}
+
+int Node::get_process_priority() const {
+	return data.process_priority;
+}
+
+Node *Node::_find_process_thread_group_owner() const {
+	switch (data.process_thread_group) {
+		case PROCESS_THREAD_GROUP_INHERIT:
+			return data.parent ? data.parent->data.process_thread_group_owner : nullptr;
+		case PROCESS_THREAD_GROUP_MAIN_THREAD:
+			return nullptr;
+		case PROCESS_THREAD_GROUP_SUB_THREAD:
+			return const_cast<Node *>(this);
+	}
+	return nullptr;
+}
+
+void Node::_propagate_process_thread_group_owner(Node *p_owner) {
+	data.process_thread_group_owner = p_owner;
+
+	for (int i = 0; i < data.children.size(); i++) {
+		Node *c = data.children[i];
+		if (c->data.process_thread_group == PROCESS_THREAD_GROUP_INHERIT) {
+			c->_propagate_process_thread_group_owner(p_owner);
+		}
+	}
+}
+
+void Node::set_process_thread_group(ProcessThreadGroup p_group) {
+	if (data.process_thread_group == p_group) {
+		return;
+	}
+
+	if (!is_inside_tree()) {
+		data.process_thread_group = p_group;
+		return;
 	}
 
-	if (is_processing_internal()) {
-		data.tree->make_group_changed("process_internal");
+	ERR_FAIL_COND_MSG(data.tree->is_processing_thread_groups(), "Can't change the process thread group while thread groups are being processed.");
+
+	if (data.process_thread_group_owner == this) {
+		data.tree->_remove_thread_group(this);
 	}
 
-	if (is_physics_processing()) {
-		data.tree->make_group_changed("physics_process");
+	data.process_thread_group = p_group;
+
+	Node *owner = _find_process_thread_group_owner();
+	if (owner == this) {
+		data.tree->_add_thread_group(this);
 	}
+	_propagate_process_thread_group_owner(owner);
+}
+
+Node::ProcessThreadGroup Node::get_process_thread_group() const {
+	return data.process_thread_group;
+}
 
-	if (is_physics_processing_internal()) {
-		data.tree->make_group_changed("physics_process_internal");
+void Node::call_thread_safe(const StringName &p_method, const Variant **p_args, int p_argcount) {
+	if (Thread::get_caller_id() == Thread::get_main_id() && !(data.tree && data.tree->is_processing_thread_groups())) {
+		Callable::CallError ce;
+		call(p_method, p_args, p_argcount, ce);
+		if (ce.error != Callable::CallError::CALL_OK) {
+			ERR_PRINT("Error calling thread-safe method: " + Variant::get_call_error_text(this, p_method, p_args, p_argcount, ce));
+		}
+	} else if (data.tree) {
+		data.tree->push_thread_safe_call(Callable(this, p_method), p_args, p_argcount);
+	} else {
+		MessageQueue::get_singleton()->push_call(get_instance_id(), p_method, p_args, p_argcount, true);
 	}
 }
 
-int Node::get_process_priority() const {
-	return data.process_priority;
+void Node::set_thread_safe(const StringName &p_property, const Variant &p_value) {
+	if (Thread::get_caller_id() == Thread::get_main_id() && !(data.tree && data.tree->is_processing_thread_groups())) {
+		set(p_property, p_value);
+		return;
+	}
+
+	const Variant property = p_property;
+	const Variant *args[2] = { &property, &p_value };
+	call_thread_safe(SNAME("set"), args, 2);
+}
+
+Variant Node::_call_thread_safe_bind(const Variant **p_args, int p_argcount, Callable::CallError &r_error) {
+	if (p_argcount < 1) {
+		r_error.error = Callable::CallError::CALL_ERROR_TOO_FEW_ARGUMENTS;
+		r_error.argument = 0;
+		return Variant();
+	}
+
+	if (p_args[0]->get_type() != Variant::STRING_NAME && p_args[0]->get_type() != Variant::STRING) {
+		r_error.error = Callable::CallError::CALL_ERROR_INVALID_ARGUMENT;
+		r_error.argument = 0;
+		r_error.expected = Variant::STRING_NAME;
+		return Variant();
+	}
+
+	r_error.error = Callable::CallError::CALL_OK;
+
+	StringName method = *p_args[0];
+
+	if (Thread::get_caller_id() == Thread::get_main_id()) {
+		return call(method, &p_args[1], p_argcount - 1, r_error);
+	}
+
+	call_thread_safe(method, &p_args[1], p_argcount - 1);
+	return Variant();
 }
 
 void Node::set_process_input(bool p_enable) {
@@ -1120,6 +1215,7 @@ void Node::add_child(Node *p_child, bool p_legible_unique_name, InternalMode p_i
 	ERR_FAIL_COND_MSG(p_child->is_ancestor_of(this), vformat("Can't add child '%s' to '%s' as it would result in a cyclic dependency since '%s' is already a parent of '%s'.", p_child->get_name(), get_name(), p_child->get_name(), get_name()));
 #endif
 	ERR_FAIL_COND_MSG(data.blocked > 0, "Parent node is busy setting up children, add_node() failed. Consider using call_deferred(\"add_child\", child) instead.");
+	ERR_FAIL_COND_MSG(data.tree && data.tree->is_processing_thread_groups(), "Can't add children while process thread groups are running. Consider using call_thread_safe(\"add_child\", child) instead.");
 
 	_validate_child_name(p_child, p_legible_unique_name);
 	_add_child_nocheck(p_child, p_child->data.name);
@@ -1135,6 +1231,40 @@ void Node::add_child(Node *p_child, bool p_legible_unique_name, InternalMode p_i
 	}
 }
 
+void Node::_add_children_batch(const Vector<Node *> &p_children) {
+	ERR_FAIL_COND_MSG(data.blocked > 0, "Parent node is busy setting up children, add_node() failed. Consider using call_deferred(\"add_child\", child) instead.");
+	ERR_FAIL_COND_MSG(data.tree && data.tree->is_processing_thread_groups(), "Can't add children while process thread groups are running. Consider using call_thread_safe(\"add_child\", child) instead.");
+
+	if (node_hrcr) {
+		for (int i = 0; i < p_children.size(); i++) {
+			add_child(p_children[i]);
+		}
+		return;
+	}
+
+	//same as add_child, but existing names are gathered once instead of scanning the children for each one added
+	Set<StringName> used_names;
+	for (int i = 0; i < data.children.size(); i++) {
+		used_names.insert(data.children[i]->data.name);
+	}
+
+	for (int i = 0; i < p_children.size(); i++) {
+		Node *child = p_children[i];
+		ERR_CONTINUE(!child);
+		ERR_CONTINUE_MSG(child == this, vformat("Can't add child '%s' to itself.", child->get_name()));
+		ERR_CONTINUE_MSG(child->data.parent, vformat("Can't add child '%s' to '%s', already has a parent '%s'.", child->get_name(), get_name(), child->data.parent->get_name()));
+
+		if (child->data.name == StringName() || used_names.has(child->data.name)) {
+			ERR_FAIL_COND(!node_hrcr_count.ref());
+			child->data.name = "@" + String(child->get_name()) + "@" + itos(node_hrcr_count.get());
+		} else {
+			used_names.insert(child->data.name);
+		}
+
+		_add_child_nocheck(child, child->data.name);
+	}
+}
+
 void Node::add_sibling(Node *p_sibling, bool p_legible_unique_name) {
 	ERR_FAIL_NULL(p_sibling);
 	ERR_FAIL_NULL(data.parent);
@@ -1180,6 +1310,7 @@ void Node::_propagate_validate_owner() {
 void Node::remove_child(Node *p_child) {
 	ERR_FAIL_NULL(p_child);
 	ERR_FAIL_COND_MSG(data.blocked > 0, "Parent node is busy setting up children, remove_node() failed. Consider using call_deferred(\"remove_child\", child) instead.");
+	ERR_FAIL_COND_MSG(data.tree && data.tree->is_processing_thread_groups(), "Can't remove children while process thread groups are running. Consider using call_thread_safe(\"remove_child\", child) instead.");
 
 	int child_count = data.children.size();
 	Node **children = data.children.ptrw();
@@ -2713,6 +2844,8 @@ void Node::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("is_processing_unhandled_key_input"), &Node::is_processing_unhandled_key_input);
 	ClassDB::bind_method(D_METHOD("set_process_mode", "mode"), &Node::set_process_mode);
 	ClassDB::bind_method(D_METHOD("get_process_mode"), &Node::get_process_mode);
+	ClassDB::bind_method(D_METHOD("set_process_thread_group", "group"), &Node::set_process_thread_group);
+	ClassDB::bind_method(D_METHOD("get_process_thread_group"), &Node::get_process_thread_group);
 	ClassDB::bind_method(D_METHOD("can_process"), &Node::can_process);
 	ClassDB::bind_method(D_METHOD("print_stray_nodes"), &Node::_print_stray_nodes);
 
@@ -2774,6 +2907,16 @@ void Node::_bind_methods() {
 		ClassDB::bind_vararg_method(METHOD_FLAGS_DEFAULT, "rpc_id", &Node::_rpc_id_bind, mi);
 	}
 
+	{
+		MethodInfo mi;
+		mi.name = "call_thread_safe";
+		mi.arguments.push_back(PropertyInfo(Variant::STRING_NAME, "method"));
+
+		ClassDB::bind_vararg_method(METHOD_FLAGS_DEFAULT, "call_thread_safe", &Node::_call_thread_safe_bind, mi);
+	}
+
+	ClassDB::bind_method(D_METHOD("set_thread_safe", "property", "value"), &Node::set_thread_safe);
+
 	ClassDB::bind_method(D_METHOD("update_configuration_warnings"), &Node::update_configuration_warnings);
 
 	BIND_CONSTANT(NOTIFICATION_ENTER_TREE);
@@ -2823,6 +2966,10 @@ void Node::_bind_methods() {
 	BIND_ENUM_CONSTANT(PROCESS_MODE_ALWAYS);
 	BIND_ENUM_CONSTANT(PROCESS_MODE_DISABLED);
 
+	BIND_ENUM_CONSTANT(PROCESS_THREAD_GROUP_INHERIT);
+	BIND_ENUM_CONSTANT(PROCESS_THREAD_GROUP_MAIN_THREAD);
+	BIND_ENUM_CONSTANT(PROCESS_THREAD_GROUP_SUB_THREAD);
+
 	BIND_ENUM_CONSTANT(DUPLICATE_SIGNALS);
 	BIND_ENUM_CONSTANT(DUPLICATE_GROUPS);
 	BIND_ENUM_CONSTANT(DUPLICATE_SCRIPTS);
@@ -2847,6 +2994,7 @@ void Node::_bind_methods() {
 	ADD_GROUP("Process", "process_");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "process_mode", PROPERTY_HINT_ENUM, "Inherit,Pausable,When Paused,Always,Disabled"), "set_process_mode", "get_process_mode");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "process_priority"), "set_process_priority", "get_process_priority");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "process_thread_group", PROPERTY_HINT_ENUM, "Inherit,Main Thread,Sub Thread"), "set_process_thread_group", "get_process_thread_group");
 
 	ADD_GROUP("Editor Description", "editor_");
 	ADD_PROPERTY(PropertyInfo(Variant::STRING, "editor_description", PROPERTY_HINT_MULTILINE_TEXT, "", PROPERTY_USAGE_EDITOR | PROPERTY_USAGE_INTERNAL), "set_editor_description", "get_editor_description");
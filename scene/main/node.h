@@ -57,6 +57,12 @@ public:
 		PROCESS_MODE_DISABLED, // never process
 	};
 
+	enum ProcessThreadGroup {
+		PROCESS_THREAD_GROUP_INHERIT, // same as parent node
+		PROCESS_THREAD_GROUP_MAIN_THREAD,
+		PROCESS_THREAD_GROUP_SUB_THREAD, // this node and the nodes inheriting from it are processed on a worker thread
+	};
+
 	enum DuplicateFlags {
 		DUPLICATE_SIGNALS = 1,
 		DUPLICATE_GROUPS = 2,
@@ -126,6 +132,11 @@ private:
 
 		ProcessMode process_mode = PROCESS_MODE_INHERIT;
 		Node *process_owner = nullptr;
+		ProcessMode process_mode_cache = PROCESS_MODE_PAUSABLE; // Effective mode, taken from the process owner.
+
+		ProcessThreadGroup process_thread_group = PROCESS_THREAD_GROUP_INHERIT;
+		Node *process_thread_group_owner = nullptr; // Null when processed on the main thread.
+		int process_thread_group_index = -1; // Only valid on group owners, index in the tree's thread groups.
 
 		int multiplayer_authority = 1; // Server by default.
 		Vector<Multiplayer::RPCConfig> rpc_methods;
@@ -138,6 +149,7 @@ private:
 
 		bool physics_process_internal = false;
 		bool process_internal = false;
+		int process_list_index[SceneTree::PROCESS_LIST_MAX] = { -1, -1, -1, -1 }; // Position in the tree's process lists.
 
 		bool input = false;
 		bool unhandled_input = false;
@@ -175,6 +187,8 @@ private:
 	void _propagate_validate_owner();
 	void _print_stray_nodes();
 	void _propagate_process_owner(Node *p_owner, int p_pause_notification, int p_enabled_notification);
+	void _propagate_process_thread_group_owner(Node *p_owner);
+	Node *_find_process_thread_group_owner() const;
 	Array _get_node_and_resource(const NodePath &p_path);
 
 	void _duplicate_signals(const Node *p_original, Node *p_copy) const;
@@ -184,6 +198,7 @@ private:
 	Array _get_groups() const;
 
 	Variant _rpc_bind(const Variant **p_args, int p_argcount, Callable::CallError &r_error);
+	Variant _call_thread_safe_bind(const Variant **p_args, int p_argcount, Callable::CallError &r_error);
 	Variant _rpc_id_bind(const Variant **p_args, int p_argcount, Callable::CallError &r_error);
 
 	_FORCE_INLINE_ bool _is_internal_front() const { return data.parent && data.pos < data.parent->data.internal_children_front; }
@@ -194,8 +209,20 @@ private:
 	void _set_tree(SceneTree *p_tree);
 	void _propagate_pause_notification(bool p_enable);
 
-	_FORCE_INLINE_ bool _can_process(bool p_paused) const;
-	_FORCE_INLINE_ bool _is_enabled() const;
+	_FORCE_INLINE_ bool _can_process(bool p_paused) const {
+		switch (data.process_mode_cache) {
+			case PROCESS_MODE_ALWAYS:
+				return true;
+			case PROCESS_MODE_PAUSABLE:
+				return !p_paused;
+			case PROCESS_MODE_WHEN_PAUSED:
+				return p_paused;
+			default:
+				return false;
+		}
+	}
+	_FORCE_INLINE_ bool _is_enabled() const { return data.process_mode_cache != PROCESS_MODE_DISABLED; }
+	void _update_process_lists(bool p_add);
 
 protected:
 	void _block() { data.blocked++; }
@@ -213,9 +240,11 @@ protected:
 	static String _get_name_num_separator();
 
 	friend class SceneState;
+	friend class PackedScene;
 	friend class MultiplayerReplicator;
 
 	void _add_child_nocheck(Node *p_child, const StringName &p_name);
+	void _add_children_batch(const Vector<Node *> &p_children);
 	void _set_owner_nocheck(Node *p_owner);
 	void _set_name_nocheck(const StringName &p_name);
 
@@ -389,6 +418,13 @@ public:
 	void set_process_priority(int p_priority);
 	int get_process_priority() const;
 
+	void set_process_thread_group(ProcessThreadGroup p_group);
+	ProcessThreadGroup get_process_thread_group() const;
+	_FORCE_INLINE_ Node *get_process_thread_group_owner() const { return data.process_thread_group_owner; }
+
+	void call_thread_safe(const StringName &p_method, const Variant **p_args = nullptr, int p_argcount = 0);
+	void set_thread_safe(const StringName &p_property, const Variant &p_value);
+
 	void set_process_input(bool p_enable);
 	bool is_processing_input() const;
 
@@ -54,6 +54,10 @@
 #include "servers/physics_server_3d.h"
 #include "window.h"
 
+#ifndef _3D_DISABLED
+#include "scene/3d/node_3d.h"
+#endif // _3D_DISABLED
+
 #include <stdio.h>
 #include <stdlib.h>
 
@@ -125,36 +129,41 @@ void SceneTree::node_renamed(Node *p_node) {
 }
 
 SceneTree::Group *SceneTree::add_to_group(const StringName &p_group, Node *p_node) {
-	Map<StringName, Group>::Element *E = group_map.find(p_group);
-	if (!E) {
-		E = group_map.insert(p_group, Group());
-	}
+	_THREAD_SAFE_METHOD_ // Nodes in process thread groups may start or stop processing.
+	// Element pointers are stable in the HashMap, nodes keep them as handles.
+	Group &g = group_map[p_group];
 
-	ERR_FAIL_COND_V_MSG(E->get().nodes.find(p_node) != -1, &E->get(), "Already in group: " + p_group + ".");
-	E->get().nodes.push_back(p_node);
-	//E->get().last_tree_version=0;
-	E->get().changed = true;
-	return &E->get();
+	ERR_FAIL_COND_V_MSG(g.nodes.find(p_node) != -1, &g, "Already in group: " + p_group + ".");
+	g.nodes.push_back(p_node);
+	g.changed = true;
+	return &g;
 }
 
 void SceneTree::remove_from_group(const StringName &p_group, Node *p_node) {
-	Map<StringName, Group>::Element *E = group_map.find(p_group);
-	ERR_FAIL_COND(!E);
+	_THREAD_SAFE_METHOD_
+	Group *g = group_map.getptr(p_group);
+	ERR_FAIL_COND(!g);
 
-	E->get().nodes.erase(p_node);
-	if (E->get().nodes.is_empty()) {
-		group_map.erase(E);
+	g->nodes.erase(p_node);
+	if (g->nodes.is_empty()) {
+		group_map.erase(p_group);
 	}
 }
 
 void SceneTree::make_group_changed(const StringName &p_group) {
-	Map<StringName, Group>::Element *E = group_map.find(p_group);
-	if (E) {
-		E->get().changed = true;
+	Group *g = group_map.getptr(p_group);
+	if (g) {
+		g->changed = true;
 	}
 }
 
 void SceneTree::flush_transform_notifications() {
+#ifndef _3D_DISABLED
+	if (transform_update_mode != TRANSFORM_UPDATE_LAZY) {
+		_update_node_3d_transforms();
+	}
+#endif
+
 	SelfList<Node> *n = xform_change_list.first();
 	while (n) {
 		Node *node = n->self();
@@ -165,6 +174,57 @@ void SceneTree::flush_transform_notifications() {
 	}
 }
 
+#ifndef _3D_DISABLED
+void SceneTree::_update_node_3d_transforms() {
+	xform_batch.clear();
+	int min_depth = INT32_MAX;
+	int max_depth = 0;
+	for (SelfList<Node> *E = xform_change_list.first(); E; E = E->next()) {
+		Node3D *node = Object::cast_to<Node3D>(E->self());
+		if (!node) {
+			continue;
+		}
+		xform_batch.push_back(node);
+		int depth = static_cast<Node *>(node)->data.depth;
+		min_depth = MIN(min_depth, depth);
+		max_depth = MAX(max_depth, depth);
+	}
+	if (xform_batch.size() < 2) {
+		return; // Nothing to gain over computing it on demand.
+	}
+
+	// Counting sort on the depth, a level only reads transforms of the levels before it.
+	uint32_t level_count = max_depth - min_depth + 1;
+	xform_batch_levels.resize(level_count + 1);
+	for (uint32_t i = 0; i <= level_count; i++) {
+		xform_batch_levels[i] = 0;
+	}
+	for (uint32_t i = 0; i < xform_batch.size(); i++) {
+		xform_batch_levels[static_cast<Node *>(xform_batch[i])->data.depth - min_depth + 1]++;
+	}
+	for (uint32_t i = 1; i <= level_count; i++) {
+		xform_batch_levels[i] += xform_batch_levels[i - 1];
+	}
+
+	xform_batch_sorted.resize(xform_batch.size());
+	for (uint32_t i = 0; i < xform_batch.size(); i++) {
+		uint32_t &offset = xform_batch_levels[static_cast<Node *>(xform_batch[i])->data.depth - min_depth];
+		xform_batch_sorted[offset++] = xform_batch[i];
+	}
+	// Each level offset now points to the end of its level.
+
+	ThreadWorkPool *pool = transform_update_mode == TRANSFORM_UPDATE_BATCHED_THREADED ? get_work_pool() : nullptr;
+	uint32_t begin = 0;
+	for (uint32_t i = 0; i < level_count; i++) {
+		uint32_t end = xform_batch_levels[i];
+		if (end > begin) {
+			Node3D::_update_global_transforms(&xform_batch_sorted[begin], end - begin, pool);
+		}
+		begin = end;
+	}
+}
+#endif // _3D_DISABLED
+
 void SceneTree::_flush_ugc() {
 	ugc_locked = true;
 
@@ -185,7 +245,7 @@ void SceneTree::_flush_ugc() {
 	ugc_locked = false;
 }
 
-void SceneTree::_update_group_order(Group &g, bool p_use_priority) {
+void SceneTree::_update_group_order(Group &g) {
 	if (!g.changed) {
 		return;
 	}
@@ -196,22 +256,17 @@ void SceneTree::_update_group_order(Group &g, bool p_use_priority) {
 	Node **nodes = g.nodes.ptrw();
 	int node_count = g.nodes.size();
 
-	if (p_use_priority) {
-		SortArray<Node *, Node::ComparatorWithPriority> node_sort;
-		node_sort.sort(nodes, node_count);
-	} else {
-		SortArray<Node *, Node::Comparator> node_sort;
-		node_sort.sort(nodes, node_count);
-	}
+	SortArray<Node *, Node::Comparator> node_sort;
+	node_sort.sort(nodes, node_count);
 	g.changed = false;
 }
 
 void SceneTree::call_group_flags(uint32_t p_call_flags, const StringName &p_group, const StringName &p_function, VARIANT_ARG_DECLARE) {
-	Map<StringName, Group>::Element *E = group_map.find(p_group);
-	if (!E) {
+	Group *group = group_map.getptr(p_group);
+	if (!group) {
 		return;
 	}
-	Group &g = E->get();
+	Group &g = *group;
 	if (g.nodes.is_empty()) {
 		return;
 	}
@@ -283,11 +338,11 @@ void SceneTree::call_group_flags(uint32_t p_call_flags, const StringName &p_grou
 }
 
 void SceneTree::notify_group_flags(uint32_t p_call_flags, const StringName &p_group, int p_notification) {
-	Map<StringName, Group>::Element *E = group_map.find(p_group);
-	if (!E) {
+	Group *group = group_map.getptr(p_group);
+	if (!group) {
 		return;
 	}
-	Group &g = E->get();
+	Group &g = *group;
 	if (g.nodes.is_empty()) {
 		return;
 	}
@@ -334,11 +389,11 @@ void SceneTree::notify_group_flags(uint32_t p_call_flags, const StringName &p_gr
 }
 
 void SceneTree::set_group_flags(uint32_t p_call_flags, const StringName &p_group, const String &p_name, const Variant &p_value) {
-	Map<StringName, Group>::Element *E = group_map.find(p_group);
-	if (!E) {
+	Group *group = group_map.getptr(p_group);
+	if (!group) {
 		return;
 	}
-	Group &g = E->get();
+	Group &g = *group;
 	if (g.nodes.is_empty()) {
 		return;
 	}
@@ -407,6 +462,12 @@ bool SceneTree::physics_process(double p_time) {
 	root_lock++;
 
 	current_frame++;
+	process_pass++;
+
+	thread_groups_physics_process_usec = 0;
+	for (uint32_t i = 0; i < thread_groups.size(); i++) {
+		thread_groups[i].physics_process_usec = 0;
+	}
 
 	flush_transform_notifications();
 
@@ -415,9 +476,9 @@ bool SceneTree::physics_process(double p_time) {
 
 	emit_signal(SNAME("physics_frame"));
 
-	_notify_group_pause(SNAME("physics_process_internal"), Node::NOTIFICATION_INTERNAL_PHYSICS_PROCESS);
+	_notify_process_list(PROCESS_LIST_PHYSICS_PROCESS_INTERNAL, Node::NOTIFICATION_INTERNAL_PHYSICS_PROCESS);
 	call_group_flags(GROUP_CALL_REALTIME, SNAME("_picking_viewports"), SNAME("_process_picking"));
-	_notify_group_pause(SNAME("physics_process"), Node::NOTIFICATION_PHYSICS_PROCESS);
+	_notify_process_list(PROCESS_LIST_PHYSICS_PROCESS, Node::NOTIFICATION_PHYSICS_PROCESS);
 	_flush_ugc();
 	MessageQueue::get_singleton()->flush(); //small little hack
 
@@ -434,6 +495,12 @@ bool SceneTree::physics_process(double p_time) {
 
 bool SceneTree::process(double p_time) {
 	root_lock++;
+	process_pass++;
+
+	thread_groups_process_usec = 0;
+	for (uint32_t i = 0; i < thread_groups.size(); i++) {
+		thread_groups[i].process_usec = 0;
+	}
 
 	MainLoop::process(p_time);
 
@@ -449,8 +516,8 @@ bool SceneTree::process(double p_time) {
 
 	flush_transform_notifications();
 
-	_notify_group_pause(SNAME("process_internal"), Node::NOTIFICATION_INTERNAL_PROCESS);
-	_notify_group_pause(SNAME("process"), Node::NOTIFICATION_PROCESS);
+	_notify_process_list(PROCESS_LIST_PROCESS_INTERNAL, Node::NOTIFICATION_INTERNAL_PROCESS);
+	_notify_process_list(PROCESS_LIST_PROCESS, Node::NOTIFICATION_PROCESS);
 
 	_flush_ugc();
 	MessageQueue::get_singleton()->flush(); //small little hack
@@ -570,6 +637,11 @@ void SceneTree::finalize() {
 		root = nullptr;
 	}
 
+	if (work_pool_initialized) {
+		work_pool.finish();
+		work_pool_initialized = false;
+	}
+
 	// cleanup timers
 	for (Ref<SceneTreeTimer> &timer : timers) {
 		timer->release_connections();
@@ -814,56 +886,252 @@ bool SceneTree::is_paused() const {
 	return paused;
 }
 
-void SceneTree::_notify_group_pause(const StringName &p_group, int p_notification) {
-	Map<StringName, Group>::Element *E = group_map.find(p_group);
-	if (!E) {
+void SceneTree::_add_to_process_list(ProcessListType p_list, Node *p_node) {
+	_THREAD_SAFE_METHOD_ // Nodes in process thread groups may start or stop processing.
+	ERR_FAIL_COND(p_node->data.process_list_index[p_list] != -1);
+
+	ProcessList &list = process_lists[p_list];
+	p_node->data.process_list_index[p_list] = list.nodes.size();
+	list.nodes.push_back(p_node);
+	list.changed = true;
+}
+
+void SceneTree::_remove_from_process_list(ProcessListType p_list, Node *p_node) {
+	_THREAD_SAFE_METHOD_
+	int index = p_node->data.process_list_index[p_list];
+	if (index == -1) {
 		return;
 	}
-	Group &g = E->get();
-	if (g.nodes.is_empty()) {
+
+	// Leave a hole, so removing doesn't shift the list while it's being dispatched.
+	ProcessList &list = process_lists[p_list];
+	list.nodes[index] = nullptr;
+	list.removed++;
+	p_node->data.process_list_index[p_list] = -1;
+}
+
+void SceneTree::_make_process_lists_changed(Node *p_node) {
+	for (int i = 0; i < PROCESS_LIST_MAX; i++) {
+		if (p_node->data.process_list_index[i] != -1) {
+			process_lists[i].changed = true;
+		}
+	}
+}
+
+void SceneTree::_update_process_list(ProcessListType p_list) {
+	ProcessList &list = process_lists[p_list];
+	if (list.dispatching || (!list.changed && list.removed == 0)) {
 		return;
 	}
 
-	_update_group_order(g, p_notification == Node::NOTIFICATION_PROCESS || p_notification == Node::NOTIFICATION_INTERNAL_PROCESS || p_notification == Node::NOTIFICATION_PHYSICS_PROCESS || p_notification == Node::NOTIFICATION_INTERNAL_PHYSICS_PROCESS);
+	if (list.removed > 0) {
+		uint32_t count = 0;
+		for (uint32_t i = 0; i < list.nodes.size(); i++) {
+			if (list.nodes[i]) {
+				list.nodes[count++] = list.nodes[i];
+			}
+		}
+		list.nodes.resize(count);
+		list.removed = 0;
+	}
 
-	//copy, so copy on write happens in case something is removed from process while being called
-	//performance is not lost because only if something is added/removed the vector is copied.
-	Vector<Node *> nodes_copy = g.nodes;
+	if (list.changed) {
+		SortArray<Node *, Node::ComparatorWithPriority> node_sort;
+		node_sort.sort(list.nodes.ptr(), list.nodes.size());
+		list.changed = false;
+	}
 
-	int node_count = nodes_copy.size();
-	Node **nodes = nodes_copy.ptrw();
+	for (uint32_t i = 0; i < list.nodes.size(); i++) {
+		list.nodes[i]->data.process_list_index[p_list] = i;
+	}
+}
 
-	call_lock++;
+void SceneTree::_notify_process_list(ProcessListType p_list, int p_notification) {
+	_update_process_list(p_list);
 
-	for (int i = 0; i < node_count; i++) {
-		Node *n = nodes[i];
-		if (call_lock && call_skip.has(n)) {
+	ProcessList &list = process_lists[p_list];
+	// Nodes added from here on are appended past the end and wait for the next step.
+	uint32_t node_count = list.nodes.size();
+	if (node_count == 0) {
+		return;
+	}
+
+	list.dispatching = true;
+
+	if (!thread_groups.is_empty()) {
+		_process_thread_groups(list.nodes.ptr(), node_count, p_notification);
+	}
+
+	for (uint32_t i = 0; i < node_count; i++) {
+		// Read back on every step, the list may grow (and move) while processing.
+		Node *n = list.nodes[i];
+		if (!n) {
+			continue; // Removed meanwhile.
+		}
+
+		if (n->data.process_thread_group_owner) {
+			continue; // Already processed by its thread group.
+		}
+
+		if (!n->_can_process(paused)) {
 			continue;
 		}
 
-		if (!n->can_process()) {
+		n->notification(p_notification);
+	}
+
+	list.dispatching = false;
+}
+
+void SceneTree::_add_thread_group(Node *p_owner) {
+	ERR_FAIL_COND(p_owner->data.process_thread_group_index != -1);
+
+	p_owner->data.process_thread_group_index = thread_groups.size();
+	ThreadGroup group;
+	group.owner = p_owner;
+	thread_groups.push_back(group);
+}
+
+void SceneTree::_remove_thread_group(Node *p_owner) {
+	int index = p_owner->data.process_thread_group_index;
+	ERR_FAIL_INDEX(index, (int)thread_groups.size());
+
+	thread_groups.remove_unordered(index);
+	if (index < (int)thread_groups.size()) {
+		thread_groups[index].owner->data.process_thread_group_index = index;
+	}
+	p_owner->data.process_thread_group_index = -1;
+}
+
+void SceneTree::_process_thread_groups(Node *const *p_nodes, uint32_t p_node_count, int p_notification) {
+	for (uint32_t i = 0; i < thread_groups.size(); i++) {
+		thread_groups[i].nodes.clear();
+	}
+
+	// Filter on the main thread, keeping the process order within each group.
+	for (uint32_t i = 0; i < p_node_count; i++) {
+		Node *n = p_nodes[i];
+		if (!n || !n->data.process_thread_group_owner) {
 			continue;
 		}
-		if (!n->can_process_notification(p_notification)) {
+		if (!n->_can_process(paused)) {
 			continue;
 		}
+		Node *owner = n->data.process_thread_group_owner;
+		thread_groups[owner->data.process_thread_group_index].nodes.push_back(n);
+	}
 
-		n->notification(p_notification);
-		//ERR_FAIL_COND(node_count != g.nodes.size());
+	active_thread_groups.clear();
+	for (uint32_t i = 0; i < thread_groups.size(); i++) {
+		if (!thread_groups[i].nodes.is_empty()) {
+			active_thread_groups.push_back(i);
+		}
+	}
+	if (active_thread_groups.is_empty()) {
+		return;
 	}
 
-	call_lock--;
-	if (call_lock == 0) {
-		call_skip.clear();
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+
+	// Even a single group goes to the pool, so its nodes never run on the main thread and
+	// Node::call_thread_safe() always queues from them.
+	processing_thread_groups = true;
+	get_work_pool()->do_work(active_thread_groups.size(), this, &SceneTree::_process_thread_group, p_notification);
+	processing_thread_groups = false;
+
+	uint64_t usec = OS::get_singleton()->get_ticks_usec() - begin;
+	if (p_notification == Node::NOTIFICATION_PHYSICS_PROCESS || p_notification == Node::NOTIFICATION_INTERNAL_PHYSICS_PROCESS) {
+		thread_groups_physics_process_usec += usec;
+	} else {
+		thread_groups_process_usec += usec;
+	}
+
+	// Sync point, apply what the groups deferred.
+	_flush_thread_safe_calls();
+}
+
+void SceneTree::_process_thread_group(uint32_t p_index, int p_notification) {
+	ThreadGroup &group = thread_groups[active_thread_groups[p_index]];
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	for (uint32_t i = 0; i < group.nodes.size(); i++) {
+		group.nodes[i]->notification(p_notification);
+	}
+
+	uint64_t usec = OS::get_singleton()->get_ticks_usec() - begin;
+	if (p_notification == Node::NOTIFICATION_PHYSICS_PROCESS || p_notification == Node::NOTIFICATION_INTERNAL_PHYSICS_PROCESS) {
+		group.physics_process_usec += usec;
+	} else {
+		group.process_usec += usec;
+	}
+}
+
+void SceneTree::push_thread_safe_call(const Callable &p_callable, const Variant **p_args, int p_argcount) {
+	ThreadSafeCall call;
+	call.callable = p_callable;
+	call.args.resize(p_argcount);
+	for (int i = 0; i < p_argcount; i++) {
+		call.args.write[i] = *p_args[i];
+	}
+
+	MutexLock lock(thread_safe_call_mutex);
+	thread_safe_calls.push_back(call);
+}
+
+void SceneTree::_flush_thread_safe_calls() {
+	thread_safe_call_mutex.lock();
+	LocalVector<ThreadSafeCall> calls = thread_safe_calls;
+	thread_safe_calls.clear();
+	thread_safe_call_mutex.unlock();
+
+	LocalVector<const Variant *> argptrs;
+	for (uint32_t i = 0; i < calls.size(); i++) {
+		const ThreadSafeCall &call = calls[i];
+		if (!call.callable.get_object()) {
+			continue; // Freed meanwhile.
+		}
+
+		int argc = call.args.size();
+		argptrs.resize(argc);
+		for (int j = 0; j < argc; j++) {
+			argptrs[j] = &call.args[j];
+		}
+
+		Callable::CallError ce;
+		Variant ret;
+		call.callable.call(argptrs.ptr(), argc, ret, ce);
+		if (ce.error != Callable::CallError::CALL_OK) {
+			ERR_PRINT("Error calling thread-safe method: " + Variant::get_callable_error_text(call.callable, argptrs.ptr(), argc, ce));
+		}
 	}
 }
 
+double SceneTree::get_thread_groups_process_time() const {
+	return thread_groups_process_usec / 1000000.0;
+}
+
+double SceneTree::get_thread_groups_physics_process_time() const {
+	return thread_groups_physics_process_usec / 1000000.0;
+}
+
+Dictionary SceneTree::get_thread_group_process_times() const {
+	Dictionary times;
+	for (uint32_t i = 0; i < thread_groups.size(); i++) {
+		const ThreadGroup &group = thread_groups[i];
+		Dictionary group_times;
+		group_times["process"] = group.process_usec / 1000000.0;
+		group_times["physics_process"] = group.physics_process_usec / 1000000.0;
+		times[group.owner->get_path()] = group_times;
+	}
+	return times;
+}
+
 void SceneTree::_call_input_pause(const StringName &p_group, CallInputType p_call_type, const Ref<InputEvent> &p_input, Viewport *p_viewport) {
-	Map<StringName, Group>::Element *E = group_map.find(p_group);
-	if (!E) {
+	Group *group = group_map.getptr(p_group);
+	if (!group) {
 		return;
 	}
-	Group &g = E->get();
+	Group &g = *group;
 	if (g.nodes.is_empty()) {
 		return;
 	}
@@ -960,20 +1228,20 @@ int64_t SceneTree::get_frame() const {
 
 Array SceneTree::_get_nodes_in_group(const StringName &p_group) {
 	Array ret;
-	Map<StringName, Group>::Element *E = group_map.find(p_group);
+	Group *E = group_map.getptr(p_group);
 	if (!E) {
 		return ret;
 	}
 
-	_update_group_order(E->get()); //update order just in case
-	int nc = E->get().nodes.size();
+	_update_group_order(*E); //update order just in case
+	int nc = E->nodes.size();
 	if (nc == 0) {
 		return ret;
 	}
 
 	ret.resize(nc);
 
-	Node **ptr = E->get().nodes.ptrw();
+	Node **ptr = E->nodes.ptrw();
 	for (int i = 0; i < nc; i++) {
 		ret[i] = ptr[i];
 	}
@@ -986,32 +1254,32 @@ bool SceneTree::has_group(const StringName &p_identifier) const {
 }
 
 Node *SceneTree::get_first_node_in_group(const StringName &p_group) {
-	Map<StringName, Group>::Element *E = group_map.find(p_group);
+	Group *E = group_map.getptr(p_group);
 	if (!E) {
 		return nullptr; //no group
 	}
 
-	_update_group_order(E->get()); //update order just in case
+	_update_group_order(*E); //update order just in case
 
-	if (E->get().nodes.size() == 0) {
+	if (E->nodes.size() == 0) {
 		return nullptr;
 	}
 
-	return E->get().nodes[0];
+	return E->nodes[0];
 }
 
 void SceneTree::get_nodes_in_group(const StringName &p_group, List<Node *> *p_list) {
-	Map<StringName, Group>::Element *E = group_map.find(p_group);
+	Group *E = group_map.getptr(p_group);
 	if (!E) {
 		return;
 	}
 
-	_update_group_order(E->get()); //update order just in case
-	int nc = E->get().nodes.size();
+	_update_group_order(*E); //update order just in case
+	int nc = E->nodes.size();
 	if (nc == 0) {
 		return;
 	}
-	Node **ptr = E->get().nodes.ptrw();
+	Node **ptr = E->nodes.ptrw();
 	for (int i = 0; i < nc; i++) {
 		p_list->push_back(ptr[i]);
 	}
@@ -1040,6 +1308,14 @@ int SceneTree::get_node_count() const {
 	return node_count;
 }
 
+ThreadWorkPool *SceneTree::get_work_pool() {
+	if (!work_pool_initialized) {
+		work_pool.init();
+		work_pool_initialized = true;
+	}
+	return &work_pool;
+}
+
 void SceneTree::set_edited_scene_root(Node *p_node) {
 #ifdef TOOLS_ENABLED
 	edited_scene_root = p_node;
@@ -1317,6 +1593,9 @@ SceneTree::SceneTree() {
 
 	GLOBAL_DEF("debug/shapes/collision/draw_2d_outlines", true);
 
+	transform_update_mode = TransformUpdateMode(int(GLOBAL_DEF("application/run/transform_update_mode", TRANSFORM_UPDATE_BATCHED_THREADED)));
+	ProjectSettings::get_singleton()->set_custom_property_info("application/run/transform_update_mode", PropertyInfo(Variant::INT, "application/run/transform_update_mode", PROPERTY_HINT_ENUM, "Lazy,Batched,Batched Threaded"));
+
 	Math::randomize();
 
 	// Create with mainloop.
@@ -34,7 +34,10 @@
 #include "core/multiplayer/multiplayer_api.h"
 #include "core/os/main_loop.h"
 #include "core/os/thread_safe.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
 #include "core/templates/self_list.h"
+#include "core/templates/thread_work_pool.h"
 #include "scene/resources/mesh.h"
 #include "scene/resources/world_2d.h"
 #include "scene/resources/world_3d.h"
@@ -43,6 +46,7 @@
 
 class PackedScene;
 class Node;
+class Node3D;
 class Window;
 class Material;
 class Mesh;
@@ -82,12 +86,36 @@ class SceneTree : public MainLoop {
 public:
 	typedef void (*IdleCallback)();
 
+	enum TransformUpdateMode {
+		TRANSFORM_UPDATE_LAZY, // Computed on demand, walking up the parents.
+		TRANSFORM_UPDATE_BATCHED,
+		TRANSFORM_UPDATE_BATCHED_THREADED,
+	};
+
 private:
 	struct Group {
 		Vector<Node *> nodes;
 		bool changed = false;
 	};
 
+	// Nodes with a processing callback enabled. Kept apart from the named groups, so
+	// dispatching needs no lookup or copy: removals leave a null slot, compacted on
+	// the next step, and nodes added while dispatching wait for the next step.
+	enum ProcessListType {
+		PROCESS_LIST_PROCESS,
+		PROCESS_LIST_PROCESS_INTERNAL,
+		PROCESS_LIST_PHYSICS_PROCESS,
+		PROCESS_LIST_PHYSICS_PROCESS_INTERNAL,
+		PROCESS_LIST_MAX
+	};
+
+	struct ProcessList {
+		LocalVector<Node *> nodes;
+		uint32_t removed = 0;
+		bool changed = false;
+		bool dispatching = false;
+	};
+
 	Window *root = nullptr;
 
 	uint64_t tree_version = 1;
@@ -103,7 +131,8 @@ private:
 	bool paused = false;
 	int root_lock = 0;
 
-	Map<StringName, Group> group_map;
+	HashMap<StringName, Group> group_map;
+	ProcessList process_lists[PROCESS_LIST_MAX];
 	bool _quit = false;
 	bool initialized = false;
 
@@ -113,8 +142,15 @@ private:
 	StringName node_renamed_name = "node_renamed";
 
 	int64_t current_frame = 0;
+	uint64_t process_pass = 0; // Increased on every process and physics process step.
 	int node_count = 0;
 
+	// Shared by nodes that process in parallel (e.g. animation), created on first use.
+	ThreadWorkPool work_pool;
+	bool work_pool_initialized = false;
+
+	TransformUpdateMode transform_update_mode = TRANSFORM_UPDATE_BATCHED_THREADED;
+
 #ifdef TOOLS_ENABLED
 	Node *edited_scene_root;
 #endif
@@ -135,7 +171,7 @@ private:
 	bool ugc_locked = false;
 	void _flush_ugc();
 
-	_FORCE_INLINE_ void _update_group_order(Group &g, bool p_use_priority = false);
+	_FORCE_INLINE_ void _update_group_order(Group &g);
 	void _update_listener();
 
 	Array _get_nodes_in_group(const StringName &p_group);
@@ -176,7 +212,41 @@ private:
 	void remove_from_group(const StringName &p_group, Node *p_node);
 	void make_group_changed(const StringName &p_group);
 
-	void _notify_group_pause(const StringName &p_group, int p_notification);
+	// Process thread groups: subtrees whose owner uses Node::PROCESS_THREAD_GROUP_SUB_THREAD.
+	// Each group processes its nodes in order on one worker, groups run in parallel before
+	// the main thread nodes. Calls queued with Node::call_thread_safe() are flushed after.
+	struct ThreadGroup {
+		Node *owner = nullptr;
+		LocalVector<Node *> nodes; // Filled on each process step.
+		uint64_t process_usec = 0;
+		uint64_t physics_process_usec = 0;
+	};
+
+	struct ThreadSafeCall {
+		Callable callable;
+		Vector<Variant> args;
+	};
+
+	LocalVector<ThreadGroup> thread_groups;
+	LocalVector<uint32_t> active_thread_groups;
+	bool processing_thread_groups = false;
+	uint64_t thread_groups_process_usec = 0;
+	uint64_t thread_groups_physics_process_usec = 0;
+
+	Mutex thread_safe_call_mutex;
+	LocalVector<ThreadSafeCall> thread_safe_calls;
+
+	void _add_thread_group(Node *p_owner);
+	void _remove_thread_group(Node *p_owner);
+	void _process_thread_groups(Node *const *p_nodes, uint32_t p_node_count, int p_notification);
+	void _process_thread_group(uint32_t p_index, int p_notification);
+	void _flush_thread_safe_calls();
+
+	void _add_to_process_list(ProcessListType p_list, Node *p_node);
+	void _remove_from_process_list(ProcessListType p_list, Node *p_node);
+	void _make_process_lists_changed(Node *p_node);
+	void _update_process_list(ProcessListType p_list);
+	void _notify_process_list(ProcessListType p_list, int p_notification);
 	Variant _call_group_flags(const Variant **p_args, int p_argcount, Callable::CallError &r_error);
 	Variant _call_group(const Variant **p_args, int p_argcount, Callable::CallError &r_error);
 
@@ -187,6 +257,16 @@ private:
 	friend class Viewport;
 
 	SelfList<Node>::List xform_change_list;
+	Mutex xform_change_list_mutex; // Transforms may change from process thread groups.
+
+#ifndef _3D_DISABLED
+	// Node3Ds waiting for a transform notification, flattened and ordered by tree depth,
+	// so their global transforms are computed level by level before notifying.
+	LocalVector<Node3D *> xform_batch;
+	LocalVector<Node3D *> xform_batch_sorted;
+	LocalVector<uint32_t> xform_batch_levels;
+	void _update_node_3d_transforms();
+#endif
 
 #ifdef DEBUG_ENABLED // No live editor in release build.
 	friend class LiveEditor;
@@ -241,6 +321,9 @@ public:
 
 	void flush_transform_notifications();
 
+	void set_transform_update_mode(TransformUpdateMode p_mode) { transform_update_mode = p_mode; }
+	TransformUpdateMode get_transform_update_mode() const { return transform_update_mode; }
+
 	virtual void initialize() override;
 
 	virtual bool physics_process(double p_time) override;
@@ -302,9 +385,18 @@ public:
 	int get_collision_debug_contact_count() { return collision_debug_contacts; }
 
 	int64_t get_frame() const;
+	uint64_t get_process_pass() const { return process_pass; }
 
 	int get_node_count() const;
 
+	ThreadWorkPool *get_work_pool();
+
+	_FORCE_INLINE_ bool is_processing_thread_groups() const { return processing_thread_groups; }
+	void push_thread_safe_call(const Callable &p_callable, const Variant **p_args, int p_argcount);
+	double get_thread_groups_process_time() const;
+	double get_thread_groups_physics_process_time() const;
+	Dictionary get_thread_group_process_times() const;
+
 	void queue_delete(Object *p_object);
 
 	void get_nodes_in_group(const StringName &p_group, List<Node *> *p_list);
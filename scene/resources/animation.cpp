@@ -84,6 +84,7 @@ bool Animation::_set(const StringName &p_name, const Variant &p_value) {
 				const real_t *r = values.ptr();
 
 				int64_t count = vcount / TRANSFORM_TRACK_SIZE;
+				tt->compressed = CompressedTransforms();
 				tt->transforms.resize(count);
 
 				for (int i = 0; i < count; i++) {
@@ -780,16 +781,24 @@ Error Animation::transform_track_get_key(int p_track, int p_key, Vector3 *r_loc,
 
 	TransformTrack *tt = static_cast<TransformTrack *>(t);
 	ERR_FAIL_COND_V(t->type != TYPE_TRANSFORM3D, ERR_INVALID_PARAMETER);
-	ERR_FAIL_INDEX_V(p_key, tt->transforms.size(), ERR_INVALID_PARAMETER);
+
+	TransformKey key;
+	if (tt->is_compressed()) {
+		ERR_FAIL_INDEX_V(p_key, tt->compressed.size(), ERR_INVALID_PARAMETER);
+		key = tt->compressed[p_key].value;
+	} else {
+		ERR_FAIL_INDEX_V(p_key, tt->transforms.size(), ERR_INVALID_PARAMETER);
+		key = tt->transforms[p_key].value;
+	}
 
 	if (r_loc) {
-		*r_loc = tt->transforms[p_key].value.loc;
+		*r_loc = key.loc;
 	}
 	if (r_rot) {
-		*r_rot = tt->transforms[p_key].value.rot;
+		*r_rot = key.rot;
 	}
 	if (r_scale) {
-		*r_scale = tt->transforms[p_key].value.scale;
+		*r_scale = key.scale;
 	}
 
 	return OK;
@@ -808,6 +817,7 @@ int Animation::transform_track_insert_key(int p_track, double p_time, const Vect
 	tkey.value.rot = p_rot;
 	tkey.value.scale = p_scale;
 
+	_transform_track_decompress(tt);
 	int ret = _insert(p_time, tt->transforms, tkey);
 	emit_changed();
 	return ret;
@@ -826,6 +836,7 @@ void Animation::track_remove_key(int p_track, int p_idx) {
 	switch (t->type) {
 		case TYPE_TRANSFORM3D: {
 			TransformTrack *tt = static_cast<TransformTrack *>(t);
+			_transform_track_decompress(tt);
 			ERR_FAIL_INDEX(p_idx, tt->transforms.size());
 			tt->transforms.remove(p_idx);
 
@@ -872,6 +883,21 @@ int Animation::track_find_key(int p_track, double p_time, bool p_exact) const {
 	switch (t->type) {
 		case TYPE_TRANSFORM3D: {
 			TransformTrack *tt = static_cast<TransformTrack *>(t);
+			if (tt->is_compressed()) {
+				const CompressedTransforms &ct = tt->compressed;
+				int k = _find(ct, p_time);
+				// Stored times are quantized, the key at this time may be stored slightly after it.
+				if (p_exact && k + 1 < ct.size() && Math::abs(ct.get_time(k + 1) - p_time) <= ct.get_time_tolerance(k + 1)) {
+					k++;
+				}
+				if (k < 0 || k >= ct.size()) {
+					return -1;
+				}
+				if (p_exact && Math::abs(ct.get_time(k) - p_time) > ct.get_time_tolerance(k)) {
+					return -1;
+				}
+				return k;
+			}
 			int k = _find(tt->transforms, p_time);
 			if (k < 0 || k >= tt->transforms.size()) {
 				return -1;
@@ -1056,7 +1082,7 @@ int Animation::track_get_key_count(int p_track) const {
 	switch (t->type) {
 		case TYPE_TRANSFORM3D: {
 			TransformTrack *tt = static_cast<TransformTrack *>(t);
-			return tt->transforms.size();
+			return tt->is_compressed() ? tt->compressed.size() : tt->transforms.size();
 		} break;
 		case TYPE_VALUE: {
 			ValueTrack *vt = static_cast<ValueTrack *>(t);
@@ -1091,12 +1117,19 @@ Variant Animation::track_get_key_value(int p_track, int p_key_idx) const {
 	switch (t->type) {
 		case TYPE_TRANSFORM3D: {
 			TransformTrack *tt = static_cast<TransformTrack *>(t);
-			ERR_FAIL_INDEX_V(p_key_idx, tt->transforms.size(), Variant());
+			TransformKey key;
+			if (tt->is_compressed()) {
+				ERR_FAIL_INDEX_V(p_key_idx, tt->compressed.size(), Variant());
+				key = tt->compressed[p_key_idx].value;
+			} else {
+				ERR_FAIL_INDEX_V(p_key_idx, tt->transforms.size(), Variant());
+				key = tt->transforms[p_key_idx].value;
+			}
 
 			Dictionary d;
-			d["location"] = tt->transforms[p_key_idx].value.loc;
-			d["rotation"] = tt->transforms[p_key_idx].value.rot;
-			d["scale"] = tt->transforms[p_key_idx].value.scale;
+			d["location"] = key.loc;
+			d["rotation"] = key.rot;
+			d["scale"] = key.scale;
 
 			return d;
 		} break;
@@ -1159,6 +1192,10 @@ double Animation::track_get_key_time(int p_track, int p_key_idx) const {
 	switch (t->type) {
 		case TYPE_TRANSFORM3D: {
 			TransformTrack *tt = static_cast<TransformTrack *>(t);
+			if (tt->is_compressed()) {
+				ERR_FAIL_INDEX_V(p_key_idx, tt->compressed.size(), -1);
+				return tt->compressed.get_time(p_key_idx);
+			}
 			ERR_FAIL_INDEX_V(p_key_idx, tt->transforms.size(), -1);
 			return tt->transforms[p_key_idx].time;
 		} break;
@@ -1204,6 +1241,7 @@ void Animation::track_set_key_time(int p_track, int p_key_idx, double p_time) {
 	switch (t->type) {
 		case TYPE_TRANSFORM3D: {
 			TransformTrack *tt = static_cast<TransformTrack *>(t);
+			_transform_track_decompress(tt);
 			ERR_FAIL_INDEX(p_key_idx, tt->transforms.size());
 			TKey<TransformKey> key = tt->transforms[p_key_idx];
 			key.time = p_time;
@@ -1268,6 +1306,10 @@ real_t Animation::track_get_key_transition(int p_track, int p_key_idx) const {
 	switch (t->type) {
 		case TYPE_TRANSFORM3D: {
 			TransformTrack *tt = static_cast<TransformTrack *>(t);
+			if (tt->is_compressed()) {
+				ERR_FAIL_INDEX_V(p_key_idx, tt->compressed.size(), -1);
+				return tt->compressed.transition;
+			}
 			ERR_FAIL_INDEX_V(p_key_idx, tt->transforms.size(), -1);
 			return tt->transforms[p_key_idx].transition;
 		} break;
@@ -1304,6 +1346,7 @@ void Animation::track_set_key_value(int p_track, int p_key_idx, const Variant &p
 	switch (t->type) {
 		case TYPE_TRANSFORM3D: {
 			TransformTrack *tt = static_cast<TransformTrack *>(t);
+			_transform_track_decompress(tt);
 			ERR_FAIL_INDEX(p_key_idx, tt->transforms.size());
 
 			Dictionary d = p_value;
@@ -1387,6 +1430,7 @@ void Animation::track_set_key_transition(int p_track, int p_key_idx, real_t p_tr
 	switch (t->type) {
 		case TYPE_TRANSFORM3D: {
 			TransformTrack *tt = static_cast<TransformTrack *>(t);
+			_transform_track_decompress(tt);
 			ERR_FAIL_INDEX(p_key_idx, tt->transforms.size());
 			tt->transforms.write[p_key_idx].transition = p_transition;
 		} break;
@@ -1450,6 +1494,47 @@ int Animation::_find(const Vector<K> &p_keys, double p_time) const {
 	return middle;
 }
 
+int Animation::_find(const CompressedTransforms &p_keys, double p_time) const {
+	if (p_keys.key_count == 0) {
+		return -2;
+	}
+
+	// Find the last page starting before the time, then its last key before the time.
+	int page = -1;
+	int low = 0;
+	int high = int(p_keys.pages.size()) - 1;
+	while (low <= high) {
+		int middle = (low + high) / 2;
+		double time = p_keys.pages[middle].time;
+		if (time <= p_time || Math::is_equal_approx(p_time, time)) {
+			page = middle;
+			low = middle + 1;
+		} else {
+			high = middle - 1;
+		}
+	}
+
+	if (page < 0) {
+		return -1;
+	}
+
+	int key = page * CompressedTransforms::PAGE_KEYS;
+	low = key + 1;
+	high = MIN(key + int(CompressedTransforms::PAGE_KEYS), p_keys.size()) - 1;
+	while (low <= high) {
+		int middle = (low + high) / 2;
+		double time = p_keys.get_time(middle);
+		if (time <= p_time || Math::is_equal_approx(p_time, time)) {
+			key = middle;
+			low = middle + 1;
+		} else {
+			high = middle - 1;
+		}
+	}
+
+	return key;
+}
+
 Animation::TransformKey Animation::_interpolate(const Animation::TransformKey &p_a, const Animation::TransformKey &p_b, real_t p_c) const {
 	TransformKey ret;
 	ret.loc = _interpolate(p_a.loc, p_b.loc, p_c);
@@ -1584,8 +1669,8 @@ real_t Animation::_cubic_interpolate(const real_t &p_pre_a, const real_t &p_a, c
 	return _interpolate(p_a, p_b, p_c);
 }
 
-template <class T>
-T Animation::_interpolate(const Vector<TKey<T>> &p_keys, double p_time, InterpolationType p_interp, bool p_loop_wrap, bool *p_ok) const {
+template <class T, class C>
+T Animation::_interpolate(const C &p_keys, double p_time, InterpolationType p_interp, bool p_loop_wrap, bool *p_ok) const {
 	int len = _find(p_keys, length) + 1; // try to find last key (there may be more past the end)
 
 	if (len <= 0) {
@@ -1600,7 +1685,7 @@ T Animation::_interpolate(const Vector<TKey<T>> &p_keys, double p_time, Interpol
 		if (p_ok) {
 			*p_ok = true;
 		}
-		return p_keys[0].value;
+		return _get_key_value(p_keys, 0);
 	}
 
 	int idx = _find(p_keys, p_time);
@@ -1617,8 +1702,8 @@ T Animation::_interpolate(const Vector<TKey<T>> &p_keys, double p_time, Interpol
 		if (idx >= 0) {
 			if ((idx + 1) < len) {
 				next = idx + 1;
-				real_t delta = p_keys[next].time - p_keys[idx].time;
-				real_t from = p_time - p_keys[idx].time;
+				real_t delta = _get_key_time(p_keys, next) - _get_key_time(p_keys, idx);
+				real_t from = p_time - _get_key_time(p_keys, idx);
 
 				if (Math::is_zero_approx(delta)) {
 					c = 0;
@@ -1628,8 +1713,8 @@ T Animation::_interpolate(const Vector<TKey<T>> &p_keys, double p_time, Interpol
 
 			} else {
 				next = 0;
-				real_t delta = (length - p_keys[idx].time) + p_keys[next].time;
-				real_t from = p_time - p_keys[idx].time;
+				real_t delta = (length - _get_key_time(p_keys, idx)) + _get_key_time(p_keys, next);
+				real_t from = p_time - _get_key_time(p_keys, idx);
 
 				if (Math::is_zero_approx(delta)) {
 					c = 0;
@@ -1642,11 +1727,11 @@ T Animation::_interpolate(const Vector<TKey<T>> &p_keys, double p_time, Interpol
 			// on loop, behind first key
 			idx = len - 1;
 			next = 0;
-			real_t endtime = (length - p_keys[idx].time);
+			real_t endtime = (length - _get_key_time(p_keys, idx));
 			if (endtime < 0) { // may be keys past the end
 				endtime = 0;
 			}
-			real_t delta = endtime + p_keys[next].time;
+			real_t delta = endtime + _get_key_time(p_keys, next);
 			real_t from = endtime + p_time;
 
 			if (Math::is_zero_approx(delta)) {
@@ -1661,8 +1746,8 @@ T Animation::_interpolate(const Vector<TKey<T>> &p_keys, double p_time, Interpol
 		if (idx >= 0) {
 			if ((idx + 1) < len) {
 				next = idx + 1;
-				real_t delta = p_keys[next].time - p_keys[idx].time;
-				real_t from = p_time - p_keys[idx].time;
+				real_t delta = _get_key_time(p_keys, next) - _get_key_time(p_keys, idx);
+				real_t from = p_time - _get_key_time(p_keys, idx);
 
 				if (Math::is_zero_approx(delta)) {
 					c = 0;
@@ -1691,11 +1776,11 @@ T Animation::_interpolate(const Vector<TKey<T>> &p_keys, double p_time, Interpol
 		return T();
 	}
 
-	real_t tr = p_keys[idx].transition;
+	real_t tr = _get_key_transition(p_keys, idx);
 
 	if (tr == 0 || idx == next) {
 		// don't interpolate if not needed
-		return p_keys[idx].value;
+		return _get_key_value(p_keys, idx);
 	}
 
 	if (tr != 1.0) {
@@ -1704,10 +1789,10 @@ T Animation::_interpolate(const Vector<TKey<T>> &p_keys, double p_time, Interpol
 
 	switch (p_interp) {
 		case INTERPOLATION_NEAREST: {
-			return p_keys[idx].value;
+			return _get_key_value(p_keys, idx);
 		} break;
 		case INTERPOLATION_LINEAR: {
-			return _interpolate(p_keys[idx].value, p_keys[next].value, c);
+			return _interpolate(_get_key_value(p_keys, idx), _get_key_value(p_keys, next), c);
 		} break;
 		case INTERPOLATION_CUBIC: {
 			int pre = idx - 1;
@@ -1719,11 +1804,11 @@ T Animation::_interpolate(const Vector<TKey<T>> &p_keys, double p_time, Interpol
 				post = next;
 			}
 
-			return _cubic_interpolate(p_keys[pre].value, p_keys[idx].value, p_keys[next].value, p_keys[post].value, c);
+			return _cubic_interpolate(_get_key_value(p_keys, pre), _get_key_value(p_keys, idx), _get_key_value(p_keys, next), _get_key_value(p_keys, post), c);
 
 		} break;
 		default:
-			return p_keys[idx].value;
+			return _get_key_value(p_keys, idx);
 	}
 
 	// do a barrel roll
@@ -1738,7 +1823,12 @@ Error Animation::transform_track_interpolate(int p_track, double p_time, Vector3
 
 	bool ok = false;
 
-	TransformKey tk = _interpolate(tt->transforms, p_time, tt->interpolation, tt->loop_wrap, &ok);
+	TransformKey tk;
+	if (tt->is_compressed()) {
+		tk = _interpolate<TransformKey>(tt->compressed, p_time, tt->interpolation, tt->loop_wrap, &ok);
+	} else {
+		tk = _interpolate<TransformKey>(tt->transforms, p_time, tt->interpolation, tt->loop_wrap, &ok);
+	}
 
 	if (!ok) {
 		return ERR_UNAVAILABLE;
@@ -1767,7 +1857,7 @@ Variant Animation::value_track_interpolate(int p_track, double p_time) const {
 
 	bool ok = false;
 
-	Variant res = _interpolate(vt->values, p_time, (vt->update_mode == UPDATE_CONTINUOUS || vt->update_mode == UPDATE_CAPTURE) ? vt->interpolation : INTERPOLATION_NEAREST, vt->loop_wrap, &ok);
+	Variant res = _interpolate<Variant>(vt->values, p_time, (vt->update_mode == UPDATE_CONTINUOUS || vt->update_mode == UPDATE_CAPTURE) ? vt->interpolation : INTERPOLATION_NEAREST, vt->loop_wrap, &ok);
 
 	if (ok) {
 		return res;
@@ -1875,8 +1965,8 @@ Animation::UpdateMode Animation::value_track_get_update_mode(int p_track) const
 	return vt->update_mode;
 }
 
-template <class T>
-void Animation::_track_get_key_indices_in_range(const Vector<T> &p_array, double from_time, double to_time, List<int> *p_indices) const {
+template <class C>
+void Animation::_track_get_key_indices_in_range(const C &p_array, double from_time, double to_time, List<int> *p_indices) const {
 	if (from_time != length && to_time == length) {
 		to_time = length * 1.01; //include a little more if at the end
 	}
@@ -1886,7 +1976,7 @@ void Animation::_track_get_key_indices_in_range(const Vector<T> &p_array, double
 	// can't really send the events == time, will be sent in the next frame.
 	// if event>=len then it will probably never be requested by the anim player.
 
-	if (to >= 0 && p_array[to].time >= to_time) {
+	if (to >= 0 && _get_key_time(p_array, to) >= to_time) {
 		to--;
 	}
 
@@ -1897,7 +1987,7 @@ void Animation::_track_get_key_indices_in_range(const Vector<T> &p_array, double
 	int from = _find(p_array, from_time);
 
 	// position in the right first event.+
-	if (from < 0 || p_array[from].time < from_time) {
+	if (from < 0 || _get_key_time(p_array, from) < from_time) {
 		from++;
 	}
 
@@ -1935,8 +2025,13 @@ void Animation::track_get_key_indices_in_range(int p_track, double p_time, doubl
 			switch (t->type) {
 				case TYPE_TRANSFORM3D: {
 					const TransformTrack *tt = static_cast<const TransformTrack *>(t);
-					_track_get_key_indices_in_range(tt->transforms, from_time, length, p_indices);
-					_track_get_key_indices_in_range(tt->transforms, 0, to_time, p_indices);
+					if (tt->is_compressed()) {
+						_track_get_key_indices_in_range(tt->compressed, from_time, length, p_indices);
+						_track_get_key_indices_in_range(tt->compressed, 0, to_time, p_indices);
+					} else {
+						_track_get_key_indices_in_range(tt->transforms, from_time, length, p_indices);
+						_track_get_key_indices_in_range(tt->transforms, 0, to_time, p_indices);
+					}
 
 				} break;
 				case TYPE_VALUE: {
@@ -1991,7 +2086,11 @@ void Animation::track_get_key_indices_in_range(int p_track, double p_time, doubl
 	switch (t->type) {
 		case TYPE_TRANSFORM3D: {
 			const TransformTrack *tt = static_cast<const TransformTrack *>(t);
-			_track_get_key_indices_in_range(tt->transforms, from_time, to_time, p_indices);
+			if (tt->is_compressed()) {
+				_track_get_key_indices_in_range(tt->compressed, from_time, to_time, p_indices);
+			} else {
+				_track_get_key_indices_in_range(tt->transforms, from_time, to_time, p_indices);
+			}
 
 		} break;
 		case TYPE_VALUE: {
@@ -2608,6 +2707,8 @@ void Animation::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("track_set_enabled", "track_idx", "enabled"), &Animation::track_set_enabled);
 	ClassDB::bind_method(D_METHOD("track_is_enabled", "track_idx"), &Animation::track_is_enabled);
 
+	ClassDB::bind_method(D_METHOD("track_is_compressed", "track_idx"), &Animation::track_is_compressed);
+
 	ClassDB::bind_method(D_METHOD("transform_track_insert_key", "track_idx", "time", "location", "rotation", "scale"), &Animation::transform_track_insert_key);
 	ClassDB::bind_method(D_METHOD("track_insert_key", "track_idx", "time", "key", "transition"), &Animation::track_insert_key, DEFVAL(1));
 	ClassDB::bind_method(D_METHOD("track_remove_key", "track_idx", "key_idx"), &Animation::track_remove_key);
@@ -2674,6 +2775,7 @@ void Animation::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("clear"), &Animation::clear);
 	ClassDB::bind_method(D_METHOD("copy_track", "track_idx", "to_animation"), &Animation::copy_track);
+	ClassDB::bind_method(D_METHOD("compress"), &Animation::compress);
 
 	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "length", PROPERTY_HINT_RANGE, "0.001,99999,0.001"), "set_length", "get_length");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "loop"), "set_loop", "has_loop");
@@ -2880,6 +2982,7 @@ void Animation::_transform_track_optimize(int p_idx, real_t p_allowed_linear_err
 	ERR_FAIL_INDEX(p_idx, tracks.size());
 	ERR_FAIL_COND(tracks[p_idx]->type != TYPE_TRANSFORM3D);
 	TransformTrack *tt = static_cast<TransformTrack *>(tracks[p_idx]);
+	_transform_track_decompress(tt);
 	bool prev_erased = false;
 	TKey<TransformKey> first_erased;
 
@@ -2924,6 +3027,158 @@ void Animation::optimize(real_t p_allowed_linear_err, real_t p_allowed_angular_e
 	}
 }
 
+static _FORCE_INLINE_ uint16_t _quantize_unit(real_t p_value) {
+	return uint16_t(Math::round(CLAMP(p_value, (real_t)0.0, (real_t)1.0) * 65535.0));
+}
+
+static _FORCE_INLINE_ real_t _dequantize_unit(uint16_t p_value) {
+	return p_value / (real_t)65535.0;
+}
+
+static _FORCE_INLINE_ uint16_t _quantize_in_range(real_t p_value, real_t p_min, real_t p_range) {
+	return p_range > 0 ? _quantize_unit((p_value - p_min) / p_range) : 0;
+}
+
+Animation::TransformKey Animation::CompressedTransforms::get_value(int p_key) const {
+	TransformKey value;
+
+	const uint16_t *v = values.ptr() + p_key * stride;
+
+	if (loc_varies) {
+		value.loc = loc_min + loc_range * Vector3(_dequantize_unit(v[0]), _dequantize_unit(v[1]), _dequantize_unit(v[2]));
+		v += 3;
+	} else {
+		value.loc = loc_min;
+	}
+
+	if (rot_varies) {
+		value.rot = Quaternion(_dequantize_unit(v[0]) * 2 - 1, _dequantize_unit(v[1]) * 2 - 1, _dequantize_unit(v[2]) * 2 - 1, _dequantize_unit(v[3]) * 2 - 1).normalized();
+		v += 4;
+	} else {
+		value.rot = rot;
+	}
+
+	if (scale_varies) {
+		value.scale = scale_min + scale_range * Vector3(_dequantize_unit(v[0]), _dequantize_unit(v[1]), _dequantize_unit(v[2]));
+	} else {
+		value.scale = scale_min;
+	}
+
+	return value;
+}
+
+Animation::TKey<Animation::TransformKey> Animation::CompressedTransforms::operator[](int p_key) const {
+	TKey<TransformKey> key;
+	key.time = get_time(p_key);
+	key.transition = transition;
+	key.value = get_value(p_key);
+	return key;
+}
+
+void Animation::_transform_track_compress(TransformTrack *tt) {
+	const int count = tt->transforms.size();
+	if (tt->is_compressed() || count == 0) {
+		return;
+	}
+
+	const TKey<TransformKey> *keys = tt->transforms.ptr();
+	for (int i = 1; i < count; i++) {
+		if (keys[i].transition != keys[0].transition) {
+			return; // Would need the transitions stored per key, not worth it for the few tracks using them.
+		}
+	}
+
+	CompressedTransforms &ct = tt->compressed;
+	ct.key_count = count;
+	ct.transition = keys[0].transition;
+	ct.rot = keys[0].value.rot;
+
+	Vector3 loc_max = keys[0].value.loc;
+	Vector3 scale_max = keys[0].value.scale;
+	ct.loc_min = loc_max;
+	ct.scale_min = scale_max;
+	for (int i = 1; i < count; i++) {
+		const TransformKey &tk = keys[i].value;
+		for (int j = 0; j < 3; j++) {
+			ct.loc_min[j] = MIN(ct.loc_min[j], tk.loc[j]);
+			loc_max[j] = MAX(loc_max[j], tk.loc[j]);
+			ct.scale_min[j] = MIN(ct.scale_min[j], tk.scale[j]);
+			scale_max[j] = MAX(scale_max[j], tk.scale[j]);
+		}
+		ct.loc_varies = ct.loc_varies || tk.loc != keys[0].value.loc;
+		ct.rot_varies = ct.rot_varies || tk.rot != keys[0].value.rot;
+		ct.scale_varies = ct.scale_varies || tk.scale != keys[0].value.scale;
+	}
+	ct.loc_range = loc_max - ct.loc_min;
+	ct.scale_range = scale_max - ct.scale_min;
+	ct.stride = (ct.loc_varies ? 3 : 0) + (ct.rot_varies ? 4 : 0) + (ct.scale_varies ? 3 : 0);
+
+	ct.pages.resize((count + CompressedTransforms::PAGE_KEYS - 1) / CompressedTransforms::PAGE_KEYS);
+	for (uint32_t i = 0; i < ct.pages.size(); i++) {
+		const int first = i * CompressedTransforms::PAGE_KEYS;
+		const int last = MIN(first + int(CompressedTransforms::PAGE_KEYS), count) - 1;
+		ct.pages[i].time = keys[first].time;
+		ct.pages[i].time_range = keys[last].time - keys[first].time;
+	}
+
+	ct.times.resize(count);
+	ct.values.resize(count * ct.stride);
+	uint16_t *v = ct.values.ptr();
+	for (int i = 0; i < count; i++) {
+		const CompressedTransforms::Page &page = ct.pages[i / CompressedTransforms::PAGE_KEYS];
+		ct.times[i] = page.time_range > 0 ? _quantize_unit((keys[i].time - page.time) / page.time_range) : 0;
+
+		const TransformKey &tk = keys[i].value;
+		if (ct.loc_varies) {
+			for (int j = 0; j < 3; j++) {
+				*v++ = _quantize_in_range(tk.loc[j], ct.loc_min[j], ct.loc_range[j]);
+			}
+		}
+		if (ct.rot_varies) {
+			for (int j = 0; j < 4; j++) {
+				*v++ = _quantize_unit((tk.rot[j] + 1) * 0.5);
+			}
+		}
+		if (ct.scale_varies) {
+			for (int j = 0; j < 3; j++) {
+				*v++ = _quantize_in_range(tk.scale[j], ct.scale_min[j], ct.scale_range[j]);
+			}
+		}
+	}
+
+	tt->transforms.clear();
+}
+
+void Animation::_transform_track_decompress(TransformTrack *tt) {
+	if (!tt->is_compressed()) {
+		return;
+	}
+
+	tt->transforms.resize(tt->compressed.size());
+	TKey<TransformKey> *w = tt->transforms.ptrw();
+	for (int i = 0; i < tt->compressed.size(); i++) {
+		w[i] = tt->compressed[i];
+	}
+	tt->compressed = CompressedTransforms();
+}
+
+void Animation::compress() {
+	for (int i = 0; i < tracks.size(); i++) {
+		if (tracks[i]->type == TYPE_TRANSFORM3D) {
+			_transform_track_compress(static_cast<TransformTrack *>(tracks[i]));
+		}
+	}
+	emit_changed();
+}
+
+bool Animation::track_is_compressed(int p_track) const {
+	ERR_FAIL_INDEX_V(p_track, tracks.size(), false);
+	if (tracks[p_track]->type != TYPE_TRANSFORM3D) {
+		return false;
+	}
+	return static_cast<const TransformTrack *>(tracks[p_track])->is_compressed();
+}
+
 Animation::Animation() {}
 
 Animation::~Animation() {
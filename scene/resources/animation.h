@@ -32,6 +32,7 @@
 #define ANIMATION_H
 
 #include "core/io/resource.h"
+#include "core/templates/local_vector.h"
 
 #define ANIM_MIN_LENGTH 0.001
 
@@ -97,8 +98,54 @@ private:
 
 	/* TRANSFORM TRACK */
 
+	// Transform keys quantized to 16 bits per number, in pages of `PAGE_KEYS` keys that are searched
+	// before the keys themselves. Built by `compress`, a track holds either these or its `transforms`.
+	struct CompressedTransforms {
+		enum {
+			PAGE_KEYS = 64,
+		};
+
+		struct Page {
+			double time = 0.0; // Time of the first key.
+			double time_range = 0.0; // The times of the keys are stored as fractions of it.
+		};
+
+		uint32_t key_count = 0;
+		real_t transition = 1.0; // Only tracks where all keys have the same transition are compressed.
+
+		// Parts that are the same in all keys are only stored here, the others as fractions of their range.
+		bool loc_varies = false;
+		bool rot_varies = false;
+		bool scale_varies = false;
+		Vector3 loc_min;
+		Vector3 loc_range;
+		Quaternion rot;
+		Vector3 scale_min;
+		Vector3 scale_range;
+		uint32_t stride = 0; // Numbers per key in `values`.
+
+		LocalVector<Page> pages;
+		LocalVector<uint16_t> times;
+		LocalVector<uint16_t> values;
+
+		_FORCE_INLINE_ int size() const { return key_count; }
+		_FORCE_INLINE_ double get_time(int p_key) const {
+			const Page &page = pages[p_key / PAGE_KEYS];
+			return page.time + page.time_range * (times[p_key] / 65535.0);
+		}
+		// Stored times are rounded to 1/65535 of their page range, so they can be off by half of that.
+		_FORCE_INLINE_ double get_time_tolerance(int p_key) const {
+			return pages[p_key / PAGE_KEYS].time_range * (0.5 / 65535.0) + CMP_EPSILON;
+		}
+		TransformKey get_value(int p_key) const;
+		TKey<TransformKey> operator[](int p_key) const;
+	};
+
 	struct TransformTrack : public Track {
 		Vector<TKey<TransformKey>> transforms;
+		CompressedTransforms compressed;
+
+		_FORCE_INLINE_ bool is_compressed() const { return compressed.key_count > 0; }
 
 		TransformTrack() { type = TYPE_TRANSFORM3D; }
 	};
@@ -185,6 +232,18 @@ private:
 
 	template <class K>
 	inline int _find(const Vector<K> &p_keys, double p_time) const;
+	int _find(const CompressedTransforms &p_keys, double p_time) const;
+
+	// Key accessors for the generic code, so compressed keys only decode the part that is read.
+	template <class K>
+	_FORCE_INLINE_ static double _get_key_time(const Vector<K> &p_keys, int p_key) { return p_keys[p_key].time; }
+	_FORCE_INLINE_ static double _get_key_time(const CompressedTransforms &p_keys, int p_key) { return p_keys.get_time(p_key); }
+	template <class K>
+	_FORCE_INLINE_ static real_t _get_key_transition(const Vector<K> &p_keys, int p_key) { return p_keys[p_key].transition; }
+	_FORCE_INLINE_ static real_t _get_key_transition(const CompressedTransforms &p_keys, int p_key) { return p_keys.transition; }
+	template <class T>
+	_FORCE_INLINE_ static const T &_get_key_value(const Vector<TKey<T>> &p_keys, int p_key) { return p_keys[p_key].value; }
+	_FORCE_INLINE_ static TransformKey _get_key_value(const CompressedTransforms &p_keys, int p_key) { return p_keys.get_value(p_key); }
 
 	_FORCE_INLINE_ Animation::TransformKey _interpolate(const Animation::TransformKey &p_a, const Animation::TransformKey &p_b, real_t p_c) const;
 
@@ -199,11 +258,11 @@ private:
 	_FORCE_INLINE_ Variant _cubic_interpolate(const Variant &p_pre_a, const Variant &p_a, const Variant &p_b, const Variant &p_post_b, real_t p_c) const;
 	_FORCE_INLINE_ real_t _cubic_interpolate(const real_t &p_pre_a, const real_t &p_a, const real_t &p_b, const real_t &p_post_b, real_t p_c) const;
 
-	template <class T>
-	_FORCE_INLINE_ T _interpolate(const Vector<TKey<T>> &p_keys, double p_time, InterpolationType p_interp, bool p_loop_wrap, bool *p_ok) const;
+	template <class T, class C>
+	_FORCE_INLINE_ T _interpolate(const C &p_keys, double p_time, InterpolationType p_interp, bool p_loop_wrap, bool *p_ok) const;
 
-	template <class T>
-	_FORCE_INLINE_ void _track_get_key_indices_in_range(const Vector<T> &p_array, double from_time, double to_time, List<int> *p_indices) const;
+	template <class C>
+	_FORCE_INLINE_ void _track_get_key_indices_in_range(const C &p_array, double from_time, double to_time, List<int> *p_indices) const;
 
 	_FORCE_INLINE_ void _value_track_get_key_indices_in_range(const ValueTrack *vt, double from_time, double to_time, List<int> *p_indices) const;
 	_FORCE_INLINE_ void _method_track_get_key_indices_in_range(const MethodTrack *mt, double from_time, double to_time, List<int> *p_indices) const;
@@ -247,6 +306,9 @@ private:
 		return idxr;
 	}
 
+	void _transform_track_compress(TransformTrack *tt);
+	void _transform_track_decompress(TransformTrack *tt);
+
 	bool _transform_track_optimize_key(const TKey<TransformKey> &t0, const TKey<TransformKey> &t1, const TKey<TransformKey> &t2, real_t p_alowed_linear_err, real_t p_alowed_angular_err, real_t p_max_optimizable_angle, const Vector3 &p_norm);
 	void _transform_track_optimize(int p_idx, real_t p_allowed_linear_err = 0.05, real_t p_allowed_angular_err = 0.01, real_t p_max_optimizable_angle = Math_PI * 0.125);
 
@@ -351,6 +413,8 @@ public:
 	void clear();
 
 	void optimize(real_t p_allowed_linear_err = 0.05, real_t p_allowed_angular_err = 0.01, real_t p_max_optimizable_angle = Math_PI * 0.125);
+	void compress();
+	bool track_is_compressed(int p_track) const;
 
 	Animation();
 	~Animation();
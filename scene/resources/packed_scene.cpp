@@ -45,18 +45,119 @@ bool SceneState::can_instantiate() const {
 	return nodes.size() > 0;
 }
 
+SceneState::InstantiationPlan *SceneState::_get_instantiation_plan(bool &r_paths_bound) const {
+	MutexLock lock(instantiation_plan_mutex);
+
+	if (!instantiation_plan) {
+		InstantiationPlan *plan = memnew(InstantiationPlan);
+		plan->nodes.resize(nodes.size());
+
+		// Reads ClassDB's tables directly, so it takes the same read lock as its getters (OBJTYPE_RLOCK).
+		RWLockRead class_db_lock(ClassDB::lock);
+
+		for (int i = 0; i < nodes.size(); i++) {
+			const NodeData &n = nodes[i];
+			if ((i == 0 && base_scene_idx >= 0) || n.instance >= 0 || n.type == TYPE_INSTANCED) {
+				continue; //node comes from another scene, its class is not known here
+			}
+			if (n.type < 0 || n.type >= names.size()) {
+				continue;
+			}
+
+			//only plain classes, anything needing special handling goes through ClassDB::instantiate
+			const ClassDB::ClassInfo *ti = ClassDB::classes.getptr(names[n.type]);
+			if (!ti || ti->disabled || !ti->creation_func || ti->native_extension || ti->api == ClassDB::API_EDITOR || ti->api == ClassDB::API_EDITOR_EXTENSION) {
+				continue;
+			}
+
+			InstantiationPlan::NodePlan &np = plan->nodes[i];
+			np.creation_func = ti->creation_func;
+			np.properties.resize(n.properties.size());
+
+			for (int j = 0; j < n.properties.size(); j++) {
+				int name = n.properties[j].name;
+				if (name < 0 || name >= names.size()) {
+					continue;
+				}
+				const ClassDB::PropertySetGet *psg = ClassDB::get_property_setget(names[n.type], names[name]);
+				if (psg && psg->setter != StringName() && psg->_setptr) {
+					np.properties[j].setter = psg->_setptr;
+					np.properties[j].index = psg->index;
+				}
+			}
+		}
+
+		instantiation_plan = plan;
+	}
+
+	r_paths_bound = instantiation_plan->paths_bound;
+	return instantiation_plan;
+}
+
+void SceneState::_clear_instantiation_plan() {
+	MutexLock lock(instantiation_plan_mutex);
+
+	if (instantiation_plan) {
+		memdelete(instantiation_plan);
+		instantiation_plan = nullptr;
+	}
+}
+
+Node *SceneState::_get_node_from_path(Node *p_root, int p_path, const LocalVector<InstantiationPlan::PathBinding> *p_bound, LocalVector<InstantiationPlan::PathBinding> *r_record) const {
+	if (p_bound) {
+		const InstantiationPlan::PathBinding &binding = (*p_bound)[p_path];
+		if (binding.valid) {
+			Node *node = p_root;
+			for (uint32_t i = 0; i < binding.indices.size(); i++) {
+				int idx = binding.indices[i];
+				if (idx >= node->data.children.size() || node->data.children[idx]->data.name != binding.names[i]) {
+					node = nullptr; //scene changed from what was bound, resolve normally
+					break;
+				}
+				node = node->data.children[idx];
+			}
+
+			if (node) {
+				return node;
+			}
+		}
+	}
+
+	Node *node = p_root->get_node_or_null(node_paths[p_path]);
+
+	if (r_record && node && !(*r_record)[p_path].valid) {
+		InstantiationPlan::PathBinding &binding = (*r_record)[p_path];
+		Node *n = node;
+		while (n && n != p_root) {
+			binding.indices.push_back(n->data.pos);
+			binding.names.push_back(n->data.name);
+			n = n->data.parent;
+		}
+
+		if (n) {
+			binding.indices.invert();
+			binding.names.invert();
+			binding.valid = true;
+		} else {
+			binding.indices.clear();
+			binding.names.clear();
+		}
+	}
+
+	return node;
+}
+
 Node *SceneState::instantiate(GenEditState p_edit_state) const {
 	// nodes where instancing failed (because something is missing)
 	List<Node *> stray_instances;
 
-#define NODE_FROM_ID(p_name, p_id)                      \
-	Node *p_name;                                       \
-	if (p_id & FLAG_ID_IS_PATH) {                       \
-		NodePath np = node_paths[p_id & FLAG_MASK];     \
-		p_name = ret_nodes[0]->get_node_or_null(np);    \
-	} else {                                            \
-		ERR_FAIL_INDEX_V(p_id &FLAG_MASK, nc, nullptr); \
-		p_name = ret_nodes[p_id & FLAG_MASK];           \
+#define NODE_FROM_ID(p_name, p_id)                                                                 \
+	Node *p_name;                                                                                  \
+	if (p_id & FLAG_ID_IS_PATH) {                                                                  \
+		p_name = _get_node_from_path(ret_nodes[0], p_id & FLAG_MASK, bound_paths, recorded_paths); \
+	} else {                                                                                       \
+		ERR_FAIL_INDEX_V(p_id &FLAG_MASK, nc, nullptr);                                            \
+		p_name = ret_nodes[p_id & FLAG_MASK];                                                      \
 	}
 
 	int nc = nodes.size();
@@ -84,8 +185,24 @@ Node *SceneState::instantiate(GenEditState p_edit_state) const {
 
 	Map<Ref<Resource>, Ref<Resource>> resources_local_to_scene;
 
+	// The editor needs everything to go through Object::set, so plans are only used at run-time.
+	const InstantiationPlan *plan = nullptr;
+	bool paths_bound = false;
+	LocalVector<InstantiationPlan::PathBinding> path_record;
+
+	if (p_edit_state == GEN_EDIT_STATE_DISABLED && !Engine::get_singleton()->is_editor_hint()) {
+		plan = _get_instantiation_plan(paths_bound);
+		if (!paths_bound) {
+			path_record.resize(node_paths.size());
+		}
+	}
+
+	const LocalVector<InstantiationPlan::PathBinding> *bound_paths = paths_bound ? &plan->paths : nullptr;
+	LocalVector<InstantiationPlan::PathBinding> *recorded_paths = plan && !paths_bound ? &path_record : nullptr;
+
 	for (int i = 0; i < nc; i++) {
 		const NodeData &n = nd[i];
+		const InstantiationPlan::NodePlan *node_plan = nullptr;
 
 		Node *parent = nullptr;
 
@@ -151,7 +268,12 @@ Node *SceneState::instantiate(GenEditState p_edit_state) const {
 		} else {
 			Object *obj = nullptr;
 
-			if (ClassDB::is_class_enabled(snames[n.type])) {
+			if (plan && plan->nodes[i].creation_func) {
+				obj = plan->nodes[i].creation_func();
+				if (Object::cast_to<Node>(obj)) {
+					node_plan = &plan->nodes[i];
+				}
+			} else if (ClassDB::is_class_enabled(snames[n.type])) {
 				//node belongs to this scene and must be created
 				obj = ClassDB::instantiate(snames[n.type]);
 			}
@@ -247,7 +369,22 @@ Node *SceneState::instantiate(GenEditState p_edit_state) const {
 						} else if (p_edit_state == GEN_EDIT_STATE_INSTANCE) {
 							value = value.duplicate(true); // Duplicate arrays and dictionaries for the editor
 						}
-						node->set(snames[nprops[j].name], value, &valid);
+
+						const InstantiationPlan::Property *pp = node_plan ? &node_plan->properties[j] : nullptr;
+						if (pp && pp->setter && !node->get_script_instance()) {
+							//call the setter Object::set would end up calling, without looking it up
+							Callable::CallError ce;
+							if (pp->index >= 0) {
+								Variant index = pp->index;
+								const Variant *arg[2] = { &index, &value };
+								pp->setter->call(node, arg, 2, ce);
+							} else {
+								const Variant *arg[1] = { &value };
+								pp->setter->call(node, arg, 1, ce);
+							}
+						} else {
+							node->set(snames[nprops[j].name], value, &valid);
+						}
 					}
 				}
 			}
@@ -346,6 +483,15 @@ Node *SceneState::instantiate(GenEditState p_edit_state) const {
 		}
 	}
 
+	if (plan && !paths_bound) {
+		//paths resolved this time are reused by the next instances
+		MutexLock lock(instantiation_plan_mutex);
+		if (instantiation_plan == plan && !instantiation_plan->paths_bound) {
+			instantiation_plan->paths = path_record;
+			instantiation_plan->paths_bound = true;
+		}
+	}
+
 	return ret_nodes[0];
 }
 
@@ -922,6 +1068,7 @@ String SceneState::get_path() const {
 }
 
 void SceneState::clear() {
+	_clear_instantiation_plan();
 	names.clear();
 	variants.clear();
 	nodes.clear();
@@ -1080,6 +1227,8 @@ void SceneState::set_bundled_scene(const Dictionary &p_dictionary) {
 	ERR_FAIL_COND(!p_dictionary.has("conns"));
 	//ERR_FAIL_COND( !p_dictionary.has("path"));
 
+	_clear_instantiation_plan();
+
 	int version = 1;
 	if (p_dictionary.has("version")) {
 		version = p_dictionary["version"];
@@ -1511,6 +1660,7 @@ int SceneState::add_value(const Variant &p_value) {
 }
 
 int SceneState::add_node_path(const NodePath &p_path) {
+	_clear_instantiation_plan();
 	node_paths.push_back(p_path);
 	return (node_paths.size() - 1) | FLAG_ID_IS_PATH;
 }
@@ -1524,6 +1674,7 @@ int SceneState::add_node(int p_parent, int p_owner, int p_type, int p_name, int
 	nd.instance = p_instance;
 	nd.index = p_index;
 
+	_clear_instantiation_plan();
 	nodes.push_back(nd);
 
 	return nodes.size() - 1;
@@ -1534,6 +1685,8 @@ void SceneState::add_node_property(int p_node, int p_name, int p_value) {
 	ERR_FAIL_INDEX(p_name, names.size());
 	ERR_FAIL_INDEX(p_value, variants.size());
 
+	_clear_instantiation_plan();
+
 	NodeData::Property prop;
 	prop.name = p_name;
 	prop.value = p_value;
@@ -1548,6 +1701,7 @@ void SceneState::add_node_group(int p_node, int p_group) {
 
 void SceneState::set_base_scene(int p_idx) {
 	ERR_FAIL_INDEX(p_idx, variants.size());
+	_clear_instantiation_plan();
 	base_scene_idx = p_idx;
 }
 
@@ -1615,6 +1769,10 @@ void SceneState::_bind_methods() {
 SceneState::SceneState() {
 }
 
+SceneState::~SceneState() {
+	_clear_instantiation_plan();
+}
+
 ////////////////
 
 void PackedScene::_set_bundled_scene(const Dictionary &p_scene) {
@@ -1660,6 +1818,34 @@ Node *PackedScene::instantiate(GenEditState p_edit_state) const {
 	return s;
 }
 
+TypedArray<Node> PackedScene::instantiate_many(int p_count, Node *p_parent) const {
+	TypedArray<Node> ret;
+	ERR_FAIL_COND_V(p_count < 0, ret);
+
+	Vector<Node *> instances;
+	instances.resize(p_count);
+	Node **instances_ptr = instances.ptrw();
+
+	for (int i = 0; i < p_count; i++) {
+		instances_ptr[i] = instantiate();
+		if (!instances_ptr[i]) {
+			instances.resize(i); //will fail the same way for all the others
+			break;
+		}
+	}
+
+	if (p_parent) {
+		p_parent->_add_children_batch(instances);
+	}
+
+	ret.resize(instances.size());
+	for (int i = 0; i < instances.size(); i++) {
+		ret[i] = instances[i];
+	}
+
+	return ret;
+}
+
 void PackedScene::replace_state(Ref<SceneState> p_by) {
 	state = p_by;
 	state->set_path(get_path());
@@ -1691,6 +1877,7 @@ void PackedScene::reset_state() {
 void PackedScene::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("pack", "path"), &PackedScene::pack);
 	ClassDB::bind_method(D_METHOD("instantiate", "edit_state"), &PackedScene::instantiate, DEFVAL(GEN_EDIT_STATE_DISABLED));
+	ClassDB::bind_method(D_METHOD("instantiate_many", "count", "parent"), &PackedScene::instantiate_many, DEFVAL(Variant()));
 	ClassDB::bind_method(D_METHOD("can_instantiate"), &PackedScene::can_instantiate);
 	ClassDB::bind_method(D_METHOD("_set_bundled_scene"), &PackedScene::_set_bundled_scene);
 	ClassDB::bind_method(D_METHOD("_get_bundled_scene"), &PackedScene::_get_bundled_scene);
@@ -32,6 +32,8 @@
 #define PACKED_SCENE_H
 
 #include "core/io/resource.h"
+#include "core/os/mutex.h"
+#include "core/templates/local_vector.h"
 #include "scene/main/node.h"
 
 class SceneState : public RefCounted {
@@ -87,6 +89,39 @@ class SceneState : public RefCounted {
 
 	Vector<ConnectionData> connections;
 
+	// Resolved form of the node data, built on first instantiation so it's
+	// not necessary to look up classes, setters and node paths every time.
+	struct InstantiationPlan {
+		struct Property {
+			MethodBind *setter = nullptr;
+			int index = -1;
+		};
+
+		struct NodePlan {
+			Object *(*creation_func)() = nullptr;
+			LocalVector<Property> properties;
+		};
+
+		// Child indices from the root to the node a path pointed to on the
+		// first instantiation, names are kept to validate them.
+		struct PathBinding {
+			bool valid = false;
+			LocalVector<int> indices;
+			LocalVector<StringName> names;
+		};
+
+		LocalVector<NodePlan> nodes;
+		LocalVector<PathBinding> paths;
+		bool paths_bound = false;
+	};
+
+	mutable InstantiationPlan *instantiation_plan = nullptr;
+	mutable Mutex instantiation_plan_mutex;
+
+	InstantiationPlan *_get_instantiation_plan(bool &r_paths_bound) const;
+	void _clear_instantiation_plan();
+	Node *_get_node_from_path(Node *p_root, int p_path, const LocalVector<InstantiationPlan::PathBinding> *p_bound, LocalVector<InstantiationPlan::PathBinding> *r_record) const;
+
 	Error _parse_node(Node *p_owner, Node *p_node, int p_parent_idx, Map<StringName, int> &name_map, HashMap<Variant, int, VariantHasher, VariantComparator> &variant_map, Map<Node *, int> &node_map, Map<Node *, int> &nodepath_map);
 	Error _parse_connections(Node *p_owner, Node *p_node, Map<StringName, int> &name_map, HashMap<Variant, int, VariantHasher, VariantComparator> &variant_map, Map<Node *, int> &node_map, Map<Node *, int> &nodepath_map);
 
@@ -184,6 +219,7 @@ public:
 	uint64_t get_last_modified_time() const { return last_modified_time; }
 
 	SceneState();
+	~SceneState();
 };
 
 VARIANT_ENUM_CAST(SceneState::GenEditState)
@@ -215,6 +251,7 @@ public:
 
 	bool can_instantiate() const;
 	Node *instantiate(GenEditState p_edit_state = GEN_EDIT_STATE_DISABLED) const;
+	TypedArray<Node> instantiate_many(int p_count, Node *p_parent = nullptr) const;
 
 	void recreate_state();
 	void replace_state(Ref<SceneState> p_by);
@@ -46,7 +46,13 @@ void NavigationServer3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("map_get_cell_size", "map"), &NavigationServer3D::map_get_cell_size);
 	ClassDB::bind_method(D_METHOD("map_set_edge_connection_margin", "map", "margin"), &NavigationServer3D::map_set_edge_connection_margin);
 	ClassDB::bind_method(D_METHOD("map_get_edge_connection_margin", "map"), &NavigationServer3D::map_get_edge_connection_margin);
+	ClassDB::bind_method(D_METHOD("map_get_sync_info", "map", "info"), &NavigationServer3D::map_get_sync_info);
 	ClassDB::bind_method(D_METHOD("map_get_path", "map", "origin", "destination", "optimize", "layers"), &NavigationServer3D::map_get_path, DEFVAL(1));
+	ClassDB::bind_method(D_METHOD("map_request_path", "map", "origin", "destination", "optimize", "layers", "receiver", "method", "userdata"), &NavigationServer3D::map_request_path, DEFVAL(1), DEFVAL(Variant()), DEFVAL(StringName()), DEFVAL(Variant()));
+	ClassDB::bind_method(D_METHOD("path_query_is_done", "query"), &NavigationServer3D::path_query_is_done);
+	ClassDB::bind_method(D_METHOD("path_query_get_path", "query"), &NavigationServer3D::path_query_get_path);
+	ClassDB::bind_method(D_METHOD("path_query_cancel", "query"), &NavigationServer3D::path_query_cancel);
+	ClassDB::bind_method(D_METHOD("get_path_query_queue_depth"), &NavigationServer3D::get_path_query_queue_depth);
 	ClassDB::bind_method(D_METHOD("map_get_closest_point_to_segment", "map", "start", "end", "use_collision"), &NavigationServer3D::map_get_closest_point_to_segment, DEFVAL(false));
 	ClassDB::bind_method(D_METHOD("map_get_closest_point", "map", "to_point"), &NavigationServer3D::map_get_closest_point);
 	ClassDB::bind_method(D_METHOD("map_get_closest_point_normal", "map", "to_point"), &NavigationServer3D::map_get_closest_point_normal);
@@ -59,6 +65,7 @@ void NavigationServer3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("region_set_transform", "region", "transform"), &NavigationServer3D::region_set_transform);
 	ClassDB::bind_method(D_METHOD("region_set_navmesh", "region", "nav_mesh"), &NavigationServer3D::region_set_navmesh);
 	ClassDB::bind_method(D_METHOD("region_bake_navmesh", "mesh", "node"), &NavigationServer3D::region_bake_navmesh);
+	ClassDB::bind_method(D_METHOD("region_bake_navmesh_area", "mesh", "node", "area"), &NavigationServer3D::region_bake_navmesh_area);
 	ClassDB::bind_method(D_METHOD("region_get_connections_count", "region"), &NavigationServer3D::region_get_connections_count);
 	ClassDB::bind_method(D_METHOD("region_get_connection_pathway_start", "region", "connection"), &NavigationServer3D::region_get_connection_pathway_start);
 	ClassDB::bind_method(D_METHOD("region_get_connection_pathway_end", "region", "connection"), &NavigationServer3D::region_get_connection_pathway_end);
@@ -82,6 +89,12 @@ void NavigationServer3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("process", "delta_time"), &NavigationServer3D::process);
 
 	ADD_SIGNAL(MethodInfo("map_changed", PropertyInfo(Variant::RID, "map")));
+
+	BIND_ENUM_CONSTANT(MAP_SYNC_INFO_POLYGON_COUNT);
+	BIND_ENUM_CONSTANT(MAP_SYNC_INFO_DIRTY_REGIONS);
+	BIND_ENUM_CONSTANT(MAP_SYNC_INFO_RELINKED_POLYGONS);
+	BIND_ENUM_CONSTANT(MAP_SYNC_INFO_FULL_RELINK);
+	BIND_ENUM_CONSTANT(MAP_SYNC_INFO_TIME_USEC);
 }
 
 NavigationServer3D *NavigationServer3D::get_singleton() {
@@ -87,9 +87,36 @@ public:
 	/// Returns the edge connection margin of this map.
 	virtual real_t map_get_edge_connection_margin(RID p_map) const = 0;
 
+	enum MapSyncInfo {
+		MAP_SYNC_INFO_POLYGON_COUNT,
+		MAP_SYNC_INFO_DIRTY_REGIONS,
+		MAP_SYNC_INFO_RELINKED_POLYGONS,
+		MAP_SYNC_INFO_FULL_RELINK,
+		MAP_SYNC_INFO_TIME_USEC,
+	};
+
+	/// Returns statistics about the last sync that changed the map.
+	virtual int64_t map_get_sync_info(RID p_map, MapSyncInfo p_info) const = 0;
+
 	/// Returns the navigation path to reach the destination from the origin.
 	virtual Vector<Vector3> map_get_path(RID p_map, Vector3 p_origin, Vector3 p_destination, bool p_optimize, uint32_t p_navigable_layers = 1) const = 0;
 
+	/// Queues a path request against the map, processed in parallel during the next `process` call.
+	/// When a receiver is given the result is delivered to `p_method`, otherwise poll the returned query id.
+	virtual int64_t map_request_path(RID p_map, Vector3 p_origin, Vector3 p_destination, bool p_optimize, uint32_t p_navigable_layers = 1, Object *p_receiver = nullptr, StringName p_method = StringName(), Variant p_udata = Variant()) const = 0;
+
+	/// Returns true once the path of a polled query is available.
+	virtual bool path_query_is_done(int64_t p_query) const = 0;
+
+	/// Returns the path of a finished polled query and releases it.
+	virtual Vector<Vector3> path_query_get_path(int64_t p_query) const = 0;
+
+	/// Discards a queued or finished query.
+	virtual void path_query_cancel(int64_t p_query) const = 0;
+
+	/// Returns the number of path requests waiting to be processed.
+	virtual int get_path_query_queue_depth() const = 0;
+
 	virtual Vector3 map_get_closest_point_to_segment(RID p_map, const Vector3 &p_from, const Vector3 &p_to, const bool p_use_collision = false) const = 0;
 	virtual Vector3 map_get_closest_point(RID p_map, const Vector3 &p_point) const = 0;
 	virtual Vector3 map_get_closest_point_normal(RID p_map, const Vector3 &p_point) const = 0;
@@ -114,6 +141,9 @@ public:
 	/// Bake the navigation mesh.
 	virtual void region_bake_navmesh(Ref<NavigationMesh> r_mesh, Node *p_node) const = 0;
 
+	/// Bake the navigation mesh again after the geometry changed in the given global area.
+	virtual void region_bake_navmesh_area(Ref<NavigationMesh> r_mesh, Node *p_node, const AABB &p_area) const = 0;
+
 	/// Get a list of a region's connection to other regions.
 	virtual int region_get_connections_count(RID p_region) const = 0;
 	virtual Vector3 region_get_connection_pathway_start(RID p_region, int p_connection_id) const = 0;
@@ -194,6 +224,8 @@ public:
 	virtual ~NavigationServer3D();
 };
 
+VARIANT_ENUM_CAST(NavigationServer3D::MapSyncInfo);
+
 typedef NavigationServer3D *(*NavigationServer3DCallback)();
 
 /// Manager used for the server singleton registration
@@ -269,7 +269,7 @@ void ClusterBuilderRD::setup(Size2i p_screen_size, uint32_t p_max_elements, RID
 	cluster_render_buffer = RD::get_singleton()->storage_buffer_create(cluster_render_buffer_size);
 	cluster_buffer = RD::get_singleton()->storage_buffer_create(cluster_buffer_size);
 
-	render_elements = (RenderElementData *)memalloc(sizeof(RenderElementData *) * render_element_max);
+	render_elements = (RenderElementData *)memalloc(sizeof(RenderElementData) * render_element_max);
 	render_element_count = 0;
 
 	element_buffer = RD::get_singleton()->storage_buffer_create(sizeof(RenderElementData) * render_element_max);
@@ -397,6 +397,87 @@ void ClusterBuilderRD::begin(const Transform3D &p_view_transform, const CameraMa
 	}
 }
 
+void ClusterBuilderRD::add_lights(LightType p_type, const Transform3D *p_transforms, const float *p_radii, const float *p_spot_apertures, uint32_t p_count) {
+	ElementType element_type = p_type == LIGHT_TYPE_OMNI ? ELEMENT_TYPE_OMNI_LIGHT : ELEMENT_TYPE_SPOT_LIGHT;
+	uint32_t count = MIN(p_count, max_elements_by_type - cluster_count_by_type[element_type]);
+	if (count == 0) {
+		return;
+	}
+
+	ERR_FAIL_COND(p_transforms == nullptr || p_radii == nullptr);
+
+	if (p_type == LIGHT_TYPE_SPOT) {
+		ERR_FAIL_COND(p_spot_apertures == nullptr);
+		//spot bounds depend on the cone shape, nothing to gain from batching other than the capacity check
+		for (uint32_t i = 0; i < count; i++) {
+			add_light(LIGHT_TYPE_SPOT, p_transforms[i], p_radii[i], p_spot_apertures[i]);
+		}
+		return;
+	}
+
+	//omni lights are processed in chunks: view space transforms are computed first, then the
+	//near/far tests run over plain float arrays so the compiler can vectorize them
+	const uint32_t chunk_max = 64;
+	float depth[chunk_max];
+	float radius[chunk_max];
+	float origin_len2[chunk_max];
+	uint32_t touches_near[chunk_max];
+	uint32_t touches_far[chunk_max];
+
+	const float overfit = shared->sphere_overfit;
+
+	for (uint32_t from = 0; from < count; from += chunk_max) {
+		uint32_t chunk = MIN(count - from, chunk_max);
+		RenderElementData *elements = &render_elements[render_element_count];
+
+		for (uint32_t i = 0; i < chunk; i++) {
+			Transform3D xform = view_xform * p_transforms[from + i];
+
+			float scale = xform.basis.get_uniform_scale();
+			if (scale < 0.98 || scale > 1.02) {
+				xform.basis.orthonormalize();
+			}
+
+			radius[i] = scale * p_radii[from + i] * overfit; // overfit icosphere
+			depth[i] = -xform.origin.z;
+			origin_len2[i] = xform.origin.length_squared();
+
+			RendererStorageRD::store_transform_transposed_3x4(xform, elements[i].transform_inv);
+		}
+
+		if (orthogonal) {
+			for (uint32_t i = 0; i < chunk; i++) {
+				touches_near[i] = (depth[i] - radius[i]) < z_near;
+			}
+		} else {
+			//contains camera inside light, overfit again for outer size (camera may be outside actual sphere but behind an icosphere vertex)
+			for (uint32_t i = 0; i < chunk; i++) {
+				float radius2 = radius[i] * overfit;
+				touches_near[i] = origin_len2[i] < radius2 * radius2;
+			}
+		}
+
+		for (uint32_t i = 0; i < chunk; i++) {
+			touches_far[i] = (depth[i] + radius[i]) > z_far;
+		}
+
+		uint32_t base_index = cluster_count_by_type[ELEMENT_TYPE_OMNI_LIGHT];
+		for (uint32_t i = 0; i < chunk; i++) {
+			RenderElementData &e = elements[i];
+			e.type = ELEMENT_TYPE_OMNI_LIGHT;
+			e.touches_near = touches_near[i];
+			e.touches_far = touches_far[i];
+			e.original_index = base_index + i;
+			e.scale[0] = radius[i];
+			e.scale[1] = radius[i];
+			e.scale[2] = radius[i];
+		}
+
+		cluster_count_by_type[ELEMENT_TYPE_OMNI_LIGHT] += chunk;
+		render_element_count += chunk;
+	}
+}
+
 void ClusterBuilderRD::bake_cluster() {
 	RENDER_TIMESTAMP(">Bake Cluster");
 
@@ -362,6 +362,10 @@ public:
 		render_element_count++;
 	}
 
+	// Batched version of add_light(), all lights must be of the same type.
+	// p_spot_apertures is only read for spot lights and can be null for omni lights.
+	void add_lights(LightType p_type, const Transform3D *p_transforms, const float *p_radii, const float *p_spot_apertures, uint32_t p_count);
+
 	void bake_cluster();
 	void debug(ElementType p_element);
 
@@ -3270,13 +3270,18 @@ void RendererSceneRenderRD::_setup_lights(const PagedArray<RID> &p_lights, const
 
 		li->cull_mask = storage->light_get_cull_mask(base);
 
-		if (current_cluster_builder != nullptr) {
-			current_cluster_builder->add_light(type == RS::LIGHT_SPOT ? ClusterBuilderRD::LIGHT_TYPE_SPOT : ClusterBuilderRD::LIGHT_TYPE_OMNI, light_transform, radius, spot_angle);
-		}
+		cluster.light_cluster_transforms[i] = light_transform;
+		cluster.light_cluster_radii[i] = radius;
+		cluster.light_cluster_spot_angles[i] = spot_angle;
 
 		r_positional_light_count++;
 	}
 
+	if (current_cluster_builder != nullptr) {
+		current_cluster_builder->add_lights(ClusterBuilderRD::LIGHT_TYPE_OMNI, cluster.light_cluster_transforms, cluster.light_cluster_radii, nullptr, cluster.omni_light_count);
+		current_cluster_builder->add_lights(ClusterBuilderRD::LIGHT_TYPE_SPOT, cluster.light_cluster_transforms + cluster.omni_light_count, cluster.light_cluster_radii + cluster.omni_light_count, cluster.light_cluster_spot_angles + cluster.omni_light_count, cluster.spot_light_count);
+	}
+
 	//update without barriers
 	if (cluster.omni_light_count) {
 		RD::get_singleton()->buffer_update(cluster.omni_light_buffer, 0, sizeof(Cluster::LightData) * cluster.omni_light_count, cluster.omni_lights, RD::BARRIER_MASK_RASTER | RD::BARRIER_MASK_COMPUTE);
@@ -4739,6 +4744,9 @@ void RendererSceneRenderRD::init() {
 		cluster.spot_lights = memnew_arr(Cluster::LightData, cluster.max_lights);
 		cluster.spot_light_buffer = RD::get_singleton()->storage_buffer_create(light_buffer_size);
 		cluster.spot_light_sort = memnew_arr(Cluster::InstanceSort<LightInstance>, cluster.max_lights);
+		cluster.light_cluster_transforms = memnew_arr(Transform3D, cluster.max_lights * 2);
+		cluster.light_cluster_radii = memnew_arr(float, cluster.max_lights * 2);
+		cluster.light_cluster_spot_angles = memnew_arr(float, cluster.max_lights * 2);
 		//defines += "\n#define MAX_LIGHT_DATA_STRUCTS " + itos(cluster.max_lights) + "\n";
 
 		cluster.max_directional_lights = MAX_DIRECTIONAL_LIGHTS;
@@ -4841,6 +4849,9 @@ RendererSceneRenderRD::~RendererSceneRenderRD() {
 		memdelete_arr(cluster.spot_lights);
 		memdelete_arr(cluster.omni_light_sort);
 		memdelete_arr(cluster.spot_light_sort);
+		memdelete_arr(cluster.light_cluster_transforms);
+		memdelete_arr(cluster.light_cluster_radii);
+		memdelete_arr(cluster.light_cluster_spot_angles);
 		memdelete_arr(cluster.reflections);
 		memdelete_arr(cluster.reflection_sort);
 		memdelete_arr(cluster.decals);
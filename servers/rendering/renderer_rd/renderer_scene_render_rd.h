@@ -676,6 +676,10 @@ private:
 
 		InstanceSort<LightInstance> *omni_light_sort;
 		InstanceSort<LightInstance> *spot_light_sort;
+		//omni lights first, then spot lights, submitted to the cluster builder in one batch per type
+		Transform3D *light_cluster_transforms;
+		float *light_cluster_radii;
+		float *light_cluster_spot_angles;
 		uint32_t max_lights;
 		RID omni_light_buffer;
 		RID spot_light_buffer;
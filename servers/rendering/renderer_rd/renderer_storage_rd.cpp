@@ -34,6 +34,7 @@
 #include "core/config/project_settings.h"
 #include "core/io/resource_loader.h"
 #include "core/math/math_defs.h"
+#include "core/templates/sort_array.h"
 #include "renderer_compositor_rd.h"
 #include "servers/rendering/rendering_server_globals.h"
 #include "servers/rendering/shader_language.h"
@@ -2645,10 +2646,17 @@ void RendererStorageRD::mesh_add_surface(RID p_mesh, const RS::SurfaceData &p_su
 
 			for (int i = 0; i < p_surface.lods.size(); i++) {
 				uint32_t indices = p_surface.lods[i].index_data.size() / (is_index_16 ? 2 : 4);
-				s->lods[i].index_buffer = RD::get_singleton()->index_buffer_create(indices, is_index_16 ? RD::INDEX_BUFFER_FORMAT_UINT16 : RD::INDEX_BUFFER_FORMAT_UINT32, p_surface.lods[i].index_data);
-				s->lods[i].index_array = RD::get_singleton()->index_array_create(s->lods[i].index_buffer, 0, indices);
 				s->lods[i].edge_length = p_surface.lods[i].edge_length;
 				s->lods[i].index_count = indices;
+				s->lods[i].index_16 = is_index_16;
+
+				if (mesh_lod_streaming.enabled) {
+					s->lods[i].index_data = p_surface.lods[i].index_data; //uploaded when first used
+					s->lods[i].index_data_size = p_surface.lods[i].index_data.size();
+				} else {
+					s->lods[i].index_buffer = RD::get_singleton()->index_buffer_create(indices, is_index_16 ? RD::INDEX_BUFFER_FORMAT_UINT16 : RD::INDEX_BUFFER_FORMAT_UINT32, p_surface.lods[i].index_data);
+					s->lods[i].index_array = RD::get_singleton()->index_array_create(s->lods[i].index_buffer, 0, indices);
+				}
 			}
 		}
 	}
@@ -2831,7 +2839,11 @@ RS::SurfaceData RendererStorageRD::mesh_get_surface(RID p_mesh, int p_surface) c
 	for (uint32_t i = 0; i < s.lod_count; i++) {
 		RS::SurfaceData::LOD lod;
 		lod.edge_length = s.lods[i].edge_length;
-		lod.index_data = RD::get_singleton()->buffer_get_data(s.lods[i].index_buffer);
+		if (s.lods[i].index_buffer.is_valid()) {
+			lod.index_data = RD::get_singleton()->buffer_get_data(s.lods[i].index_buffer);
+		} else {
+			lod.index_data = s.lods[i].index_data;
+		}
 		sd.lods.push_back(lod);
 	}
 
@@ -3008,7 +3020,11 @@ void RendererStorageRD::mesh_clear(RID p_mesh) {
 
 		if (s.lod_count) {
 			for (uint32_t j = 0; j < s.lod_count; j++) {
-				RD::get_singleton()->free(s.lods[j].index_buffer);
+				if (mesh_lod_streaming.enabled) {
+					_mesh_lod_release(&s.lods[j]);
+				} else {
+					RD::get_singleton()->free(s.lods[j].index_buffer);
+				}
 			}
 			memdelete_arr(s.lods);
 		}
@@ -3047,6 +3063,131 @@ bool RendererStorageRD::mesh_needs_instance(RID p_mesh, bool p_has_skeleton) {
 	return mesh->blend_shape_count > 0 || (mesh->has_bone_weights && p_has_skeleton);
 }
 
+void RendererStorageRD::_mesh_lod_request(Mesh::Surface::LOD *p_lod) const {
+	mesh_lod_streaming.request_lock.lock();
+	if (!p_lod->requested) {
+		p_lod->requested = true;
+		mesh_lod_streaming.requests.push_back(p_lod);
+	}
+	mesh_lod_streaming.request_lock.unlock();
+}
+
+bool RendererStorageRD::_mesh_lod_make_resident(Mesh::Surface::LOD *p_lod) {
+	uint64_t size = p_lod->index_data_size;
+	if (mesh_lod_streaming.resident_size + size > mesh_lod_streaming.budget) {
+		return false;
+	}
+
+	p_lod->index_buffer = RD::get_singleton()->index_buffer_create(p_lod->index_count, p_lod->index_16 ? RD::INDEX_BUFFER_FORMAT_UINT16 : RD::INDEX_BUFFER_FORMAT_UINT32, p_lod->index_data);
+	p_lod->index_array = RD::get_singleton()->index_array_create(p_lod->index_buffer, 0, p_lod->index_count);
+	p_lod->last_used_frame = mesh_lod_streaming.frame;
+	mesh_lod_streaming.resident_size += size;
+
+	if (mesh_lod_streaming.pinned_size + size <= mesh_lod_streaming.budget / 2) {
+		//pinned, it is never evicted so the system memory copy is not needed anymore
+		p_lod->pinned = true;
+		p_lod->index_data = Vector<uint8_t>();
+		mesh_lod_streaming.pinned_size += size;
+	} else {
+		p_lod->resident_index = mesh_lod_streaming.resident.size();
+		mesh_lod_streaming.resident.push_back(p_lod);
+	}
+	return true;
+}
+
+void RendererStorageRD::_mesh_lod_release(Mesh::Surface::LOD *p_lod) {
+	if (p_lod->requested) {
+		mesh_lod_streaming.request_lock.lock();
+		mesh_lod_streaming.requests.erase(p_lod);
+		p_lod->requested = false;
+		mesh_lod_streaming.request_lock.unlock();
+	}
+
+	if (p_lod->index_buffer.is_null()) {
+		return;
+	}
+
+	RD::get_singleton()->free(p_lod->index_buffer); //frees the index array too
+	p_lod->index_buffer = RID();
+	p_lod->index_array = RID();
+	mesh_lod_streaming.resident_size -= p_lod->index_data_size;
+
+	if (p_lod->pinned) {
+		//only released with its mesh
+		p_lod->pinned = false;
+		mesh_lod_streaming.pinned_size -= p_lod->index_data_size;
+		return;
+	}
+
+	//swap with last to remove
+	uint32_t last = mesh_lod_streaming.resident.size() - 1;
+	if (p_lod->resident_index != last) {
+		Mesh::Surface::LOD *moved = mesh_lod_streaming.resident[last];
+		mesh_lod_streaming.resident[p_lod->resident_index] = moved;
+		moved->resident_index = p_lod->resident_index;
+	}
+	mesh_lod_streaming.resident.resize(last);
+}
+
+void RendererStorageRD::_update_mesh_lod_streaming() {
+	mesh_lod_streaming.frame++;
+
+	if (!mesh_lod_streaming.enabled) {
+		return;
+	}
+
+	mesh_lod_streaming.request_lock.lock();
+	LocalVector<Mesh::Surface::LOD *> requests = mesh_lod_streaming.requests;
+	for (uint32_t i = 0; i < requests.size(); i++) {
+		requests[i]->requested = false;
+	}
+	mesh_lod_streaming.requests.clear();
+	mesh_lod_streaming.request_lock.unlock();
+
+	if (requests.is_empty()) {
+		return;
+	}
+
+	uint64_t requested_size = 0;
+	for (uint32_t i = 0; i < requests.size(); i++) {
+		requested_size += requests[i]->index_data_size;
+	}
+
+	if (mesh_lod_streaming.resident_size + requested_size > mesh_lod_streaming.budget) {
+		//make room by releasing the least recently used LODs, but never the ones used last frame
+		struct LODSort {
+			Mesh::Surface::LOD *lod;
+			bool operator<(const LODSort &p_sort) const {
+				return lod->last_used_frame < p_sort.lod->last_used_frame;
+			}
+		};
+
+		LocalVector<LODSort> candidates;
+		for (uint32_t i = 0; i < mesh_lod_streaming.resident.size(); i++) {
+			Mesh::Surface::LOD *lod = mesh_lod_streaming.resident[i];
+			if (lod->last_used_frame + 1 < mesh_lod_streaming.frame) {
+				LODSort ls;
+				ls.lod = lod;
+				candidates.push_back(ls);
+			}
+		}
+
+		if (candidates.size()) {
+			SortArray<LODSort> sorter;
+			sorter.sort(candidates.ptr(), candidates.size());
+		}
+
+		for (uint32_t i = 0; i < candidates.size() && mesh_lod_streaming.resident_size + requested_size > mesh_lod_streaming.budget; i++) {
+			_mesh_lod_release(candidates[i].lod);
+		}
+	}
+
+	for (uint32_t i = 0; i < requests.size(); i++) {
+		//if it does not fit, it will be requested again when used in a later frame
+		_mesh_lod_make_resident(requests[i]);
+	}
+}
+
 /* MESH INSTANCE */
 
 RID RendererStorageRD::mesh_instance_create(RID p_base) {
@@ -8612,6 +8753,7 @@ void RendererStorageRD::update_dirty_resources() {
 	_update_dirty_multimeshes();
 	_update_dirty_skeletons();
 	_update_decal_atlas();
+	_update_mesh_lod_streaming();
 }
 
 bool RendererStorageRD::has_os_feature(const String &p_feature) const {
@@ -9327,6 +9469,9 @@ RendererStorageRD::RendererStorageRD() {
 
 	lightmap_probe_capture_update_speed = GLOBAL_GET("rendering/lightmapping/probe_capture/update_speed");
 
+	mesh_lod_streaming.enabled = GLOBAL_GET("rendering/mesh_lod/streaming/enabled");
+	mesh_lod_streaming.budget = uint64_t(int(GLOBAL_GET("rendering/mesh_lod/streaming/memory_budget_mb"))) * 1024 * 1024;
+
 	/* Particles */
 
 	{
@@ -450,6 +450,16 @@ private:
 				uint32_t index_count = 0;
 				RID index_buffer;
 				RID index_array;
+
+				//used when LOD streaming is enabled, the GPU buffers above are only valid while resident
+				//and the indices are kept in system memory unless pinned
+				Vector<uint8_t> index_data;
+				uint32_t index_data_size = 0;
+				bool index_16 = false;
+				bool requested = false;
+				bool pinned = false;
+				uint32_t resident_index = 0;
+				uint64_t last_used_frame = 0;
 			};
 
 			LOD *lods = nullptr;
@@ -500,6 +510,30 @@ private:
 
 	mutable RID_Owner<Mesh, true> mesh_owner;
 
+	// LOD index buffers are uploaded on demand when a renderer first selects them. The first
+	// ones uploaded are pinned until half the memory budget is used: they stay resident and
+	// drop their system memory copy. The others keep it, and the least recently used ones are
+	// released when the budget is exceeded, so evicting never has to read back from the GPU.
+	// The full detail index buffer is always resident and used as fallback.
+	struct MeshLODStreaming {
+		bool enabled = false;
+		uint64_t budget = 0;
+		uint64_t resident_size = 0;
+		uint64_t pinned_size = 0;
+		uint64_t frame = 1;
+
+		SpinLock request_lock;
+		LocalVector<Mesh::Surface::LOD *> requests;
+		LocalVector<Mesh::Surface::LOD *> resident;
+	};
+
+	mutable MeshLODStreaming mesh_lod_streaming;
+
+	void _mesh_lod_request(Mesh::Surface::LOD *p_lod) const;
+	bool _mesh_lod_make_resident(Mesh::Surface::LOD *p_lod);
+	void _mesh_lod_release(Mesh::Surface::LOD *p_lod);
+	void _update_mesh_lod_streaming();
+
 	struct MeshInstance {
 		Mesh *mesh;
 		RID skeleton;
@@ -1549,6 +1583,18 @@ public:
 			}
 			current_lod = i;
 		}
+		if (current_lod != -1 && mesh_lod_streaming.enabled) {
+			if (s->lods[current_lod].index_array.is_null()) {
+				//not resident, request it and use the closest finer LOD meanwhile
+				_mesh_lod_request(&s->lods[current_lod]);
+				while (current_lod != -1 && s->lods[current_lod].index_array.is_null()) {
+					current_lod--;
+				}
+			}
+			if (current_lod != -1) {
+				s->lods[current_lod].last_used_frame = mesh_lod_streaming.frame;
+			}
+		}
 		if (current_lod == -1) {
 			return 0;
 		} else {
@@ -2932,6 +2932,10 @@ RenderingServer::RenderingServer() {
 	GLOBAL_DEF("rendering/limits/forward_renderer/threaded_render_minimum_instances", 500);
 	ProjectSettings::get_singleton()->set_custom_property_info("rendering/limits/forward_renderer/threaded_render_minimum_instances", PropertyInfo(Variant::INT, "rendering/limits/forward_renderer/threaded_render_minimum_instances", PROPERTY_HINT_RANGE, "32,65536,1"));
 
+	GLOBAL_DEF_RST("rendering/mesh_lod/streaming/enabled", false);
+	GLOBAL_DEF_RST("rendering/mesh_lod/streaming/memory_budget_mb", 256);
+	ProjectSettings::get_singleton()->set_custom_property_info("rendering/mesh_lod/streaming/memory_budget_mb", PropertyInfo(Variant::INT, "rendering/mesh_lod/streaming/memory_budget_mb", PROPERTY_HINT_RANGE, "1,16384,1"));
+
 	GLOBAL_DEF("rendering/limits/cluster_builder/max_clustered_elements", 512);
 	ProjectSettings::get_singleton()->set_custom_property_info("rendering/limits/cluster_builder/max_clustered_elements", PropertyInfo(Variant::FLOAT, "rendering/limits/cluster_builder/max_clustered_elements", PROPERTY_HINT_RANGE, "32,8192,1"));
 
@@ -0,0 +1,144 @@
+/*************************************************************************/
+/*  test_animation.h                                                     */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_ANIMATION_H
+#define TEST_ANIMATION_H
+
+#include "core/os/os.h"
+#include "scene/resources/animation.h"
+
+#include "tests/test_macros.h"
+
+namespace TestAnimation {
+
+static Ref<Animation> create_transform_animation(int p_key_count) {
+	Ref<Animation> animation = memnew(Animation);
+	animation->set_length((p_key_count - 1) / 30.0);
+
+	// Moving and turning, with a constant scale.
+	animation->add_track(Animation::TYPE_TRANSFORM3D);
+	// Not moving at all.
+	animation->add_track(Animation::TYPE_TRANSFORM3D);
+	for (int i = 0; i < p_key_count; i++) {
+		const real_t time = i / 30.0;
+		animation->transform_track_insert_key(0, time, Vector3(Math::sin(time) * 4, time, Math::cos(time)), Quaternion(Vector3(0, 1, 0), time), Vector3(2, 2, 2));
+		animation->transform_track_insert_key(1, time, Vector3(1, 2, 3), Quaternion(), Vector3(1, 1, 1));
+	}
+
+	return animation;
+}
+
+TEST_CASE("[Animation] Compressed transform tracks") {
+	const int key_count = 200; // Several pages.
+	Ref<Animation> animation = create_transform_animation(key_count);
+	Ref<Animation> reference = create_transform_animation(key_count);
+
+	animation->compress();
+	CHECK(animation->track_is_compressed(0));
+	CHECK(animation->track_is_compressed(1));
+	CHECK(animation->track_get_key_count(0) == key_count);
+
+	for (int i = 0; i < key_count; i++) {
+		CHECK(animation->track_get_key_time(0, i) == doctest::Approx(reference->track_get_key_time(0, i)).epsilon(0.0001));
+	}
+	CHECK(animation->track_find_key(0, 100 / 30.0 + 0.001) == 100);
+	CHECK(animation->track_find_key(0, -1.0) == -1);
+	// Stored times are quantized, exact searches still find the keys at their original times.
+	for (int i = 0; i < key_count; i++) {
+		CHECK(animation->track_find_key(0, reference->track_get_key_time(0, i), true) == i);
+	}
+	CHECK(animation->track_find_key(0, 100 / 30.0 + 0.01, true) == -1);
+
+	for (real_t time = 0; time < animation->get_length(); time += 0.01) {
+		for (int track = 0; track < 2; track++) {
+			Vector3 loc;
+			Quaternion rot;
+			Vector3 scale;
+			CHECK(animation->transform_track_interpolate(track, time, &loc, &rot, &scale) == OK);
+			Vector3 reference_loc;
+			Quaternion reference_rot;
+			Vector3 reference_scale;
+			reference->transform_track_interpolate(track, time, &reference_loc, &reference_rot, &reference_scale);
+
+			CHECK(loc.distance_to(reference_loc) < 0.001);
+			CHECK(Math::abs(rot.dot(reference_rot)) > 0.99999);
+			CHECK(scale.is_equal_approx(reference_scale));
+		}
+	}
+
+	// Editing a compressed track decompresses it first.
+	animation->transform_track_insert_key(0, 10.0, Vector3(), Quaternion(), Vector3(1, 1, 1));
+	CHECK_FALSE(animation->track_is_compressed(0));
+	CHECK(animation->track_is_compressed(1));
+	CHECK(animation->track_get_key_count(0) == key_count + 1);
+	Vector3 loc;
+	animation->transform_track_get_key(0, 100, &loc, nullptr, nullptr);
+	Vector3 reference_loc;
+	reference->transform_track_get_key(0, 100, &reference_loc, nullptr, nullptr);
+	CHECK(loc.distance_to(reference_loc) < 0.001);
+}
+
+TEST_CASE("[Animation] Tracks with varying transitions are not compressed") {
+	Ref<Animation> animation = memnew(Animation);
+	animation->add_track(Animation::TYPE_TRANSFORM3D);
+	animation->transform_track_insert_key(0, 0.0, Vector3(), Quaternion(), Vector3(1, 1, 1));
+	animation->transform_track_insert_key(0, 0.5, Vector3(1, 0, 0), Quaternion(), Vector3(1, 1, 1));
+	animation->track_set_key_transition(0, 1, 0.5);
+	animation->add_track(Animation::TYPE_VALUE);
+
+	animation->compress();
+	CHECK_FALSE(animation->track_is_compressed(0));
+	CHECK_FALSE(animation->track_is_compressed(1));
+	CHECK(animation->track_get_key_transition(0, 1) == doctest::Approx(0.5));
+}
+
+TEST_CASE("[Stress][Animation] Sample compressed transform tracks") {
+	const int key_count = 30 * 60;
+	Ref<Animation> uncompressed = create_transform_animation(key_count);
+	Ref<Animation> compressed = create_transform_animation(key_count);
+	compressed->compress();
+
+	const Ref<Animation> animations[2] = { uncompressed, compressed };
+	const char *names[2] = { "uncompressed", "compressed" };
+	for (int i = 0; i < 2; i++) {
+		const uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		Vector3 loc;
+		Quaternion rot;
+		Vector3 scale;
+		for (int sample = 0; sample < 100000; sample++) {
+			animations[i]->transform_track_interpolate(0, (sample % key_count) / 30.0 + 0.01, &loc, &rot, &scale);
+		}
+		print_verbose(vformat("100000 samples of %s tracks: %d usec.", names[i], OS::get_singleton()->get_ticks_usec() - begin));
+	}
+}
+
+} // namespace TestAnimation
+
+#endif // TEST_ANIMATION_H
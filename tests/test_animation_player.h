@@ -0,0 +1,233 @@
+/*************************************************************************/
+/*  test_animation_player.h                                              */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_ANIMATION_PLAYER_H
+#define TEST_ANIMATION_PLAYER_H
+
+#include "core/os/os.h"
+#include "scene/3d/node_3d.h"
+#include "scene/animation/animation_blend_tree.h"
+#include "scene/animation/animation_player.h"
+#include "scene/animation/animation_tree.h"
+#include "scene/main/window.h"
+
+#include "tests/test_macros.h"
+
+namespace TestAnimationPlayer {
+
+static Ref<Animation> create_walk_animation(int p_bone_count) {
+	Ref<Animation> animation = memnew(Animation);
+	animation->set_length(1.0);
+	animation->set_loop(true);
+
+	for (int i = 0; i < p_bone_count; i++) {
+		int track = animation->add_track(Animation::TYPE_TRANSFORM3D);
+		animation->track_set_path(track, vformat("Bone%d", i));
+		for (int key = 0; key <= 10; key++) {
+			const real_t time = key / 10.0;
+			animation->transform_track_insert_key(track, time, Vector3(Math::sin(time + i), time, 0), Quaternion(Vector3(0, 1, 0), time * Math_TAU), Vector3(1, 1, 1) * (1 + time));
+		}
+	}
+
+	int track = animation->add_track(Animation::TYPE_VALUE);
+	animation->track_set_path(track, NodePath("Bone0:visible"));
+	animation->value_track_set_update_mode(track, Animation::UPDATE_DISCRETE);
+	animation->track_insert_key(track, 0.0, true);
+	animation->track_insert_key(track, 0.5, false);
+
+	return animation;
+}
+
+// A root with one child per bone, animated either by its player or through an AnimationTree.
+static Node3D *create_character(const Ref<Animation> &p_animation, int p_bone_count, bool p_use_tree, bool p_parallel) {
+	Node3D *character = memnew(Node3D);
+	for (int i = 0; i < p_bone_count; i++) {
+		Node3D *bone = memnew(Node3D);
+		bone->set_name(vformat("Bone%d", i));
+		character->add_child(bone);
+	}
+
+	AnimationPlayer *player = memnew(AnimationPlayer);
+	player->set_name("Player");
+	player->add_animation("walk", p_animation);
+	character->add_child(player);
+
+	if (p_use_tree) {
+		Ref<AnimationNodeAnimation> node;
+		node.instantiate();
+		node->set_animation("walk");
+
+		AnimationTree *tree = memnew(AnimationTree);
+		tree->set_name("AnimationTree");
+		tree->set_tree_root(node);
+		tree->set_animation_player(NodePath("../Player"));
+		tree->set_parallel_evaluation_enabled(p_parallel);
+		character->add_child(tree);
+		tree->set_active(true);
+	} else {
+		player->set_parallel_evaluation_enabled(p_parallel);
+	}
+
+	SceneTree::get_singleton()->get_root()->add_child(character);
+	if (!p_use_tree) {
+		player->play("walk");
+	}
+	return character;
+}
+
+static Node3D *get_bone(Node3D *p_character, int p_bone) {
+	return Object::cast_to<Node3D>(p_character->get_node(NodePath(vformat("Bone%d", p_bone))));
+}
+
+static void check_parallel_evaluation(bool p_use_tree) {
+	const int bone_count = 3;
+	Ref<Animation> animation = create_walk_animation(bone_count);
+	Node3D *serial = create_character(animation, bone_count, p_use_tree, false);
+	// More than one, so the batch goes through the work pool.
+	Node3D *parallel[3];
+	for (int i = 0; i < 3; i++) {
+		parallel[i] = create_character(animation, bone_count, p_use_tree, true);
+	}
+
+	for (int step = 0; step < 15; step++) {
+		SceneTree::get_singleton()->process(0.1);
+
+		for (int i = 0; i < 3; i++) {
+			for (int bone = 0; bone < bone_count; bone++) {
+				CHECK(get_bone(parallel[i], bone)->get_transform().is_equal_approx(get_bone(serial, bone)->get_transform()));
+			}
+			CHECK(get_bone(parallel[i], 0)->is_visible() == get_bone(serial, 0)->is_visible());
+		}
+	}
+	// Make sure something actually moved.
+	CHECK_FALSE(get_bone(serial, 0)->get_transform().is_equal_approx(Transform3D()));
+
+	memdelete(serial);
+	for (int i = 0; i < 3; i++) {
+		memdelete(parallel[i]);
+	}
+}
+
+TEST_CASE("[SceneTree][AnimationPlayer] Parallel evaluation matches serial evaluation") {
+	check_parallel_evaluation(false);
+}
+
+TEST_CASE("[SceneTree][AnimationTree] Parallel evaluation matches serial evaluation") {
+	check_parallel_evaluation(true);
+}
+
+TEST_CASE("[SceneTree][AnimationPlayer] Parallel players finishing and leaving the batch") {
+	Ref<Animation> animation = create_walk_animation(1);
+	animation->set_loop(false);
+	Node3D *characters[2] = {
+		create_character(animation, 1, false, true),
+		create_character(animation, 1, false, true),
+	};
+	AnimationPlayer *player = Object::cast_to<AnimationPlayer>(characters[1]->get_node(NodePath("Player")));
+
+	SceneTree::get_singleton()->process(0.5);
+	CHECK(player->is_playing());
+	SceneTree::get_singleton()->process(1.0);
+	CHECK_FALSE(player->is_playing());
+
+	// Removing a player from the scene takes it out of the batch.
+	SceneTree::get_singleton()->get_root()->remove_child(characters[0]);
+	player->play("walk");
+	SceneTree::get_singleton()->process(0.5);
+	CHECK(player->get_current_animation_position() == doctest::Approx(0.5));
+
+	memdelete(characters[0]);
+	memdelete(characters[1]);
+}
+
+// Removes a node from the scene the first time the graph is evaluated.
+class _TestRemovingAnimationNode : public AnimationNodeAnimation {
+public:
+	Node *to_remove = nullptr;
+
+	virtual double process(double p_time, bool p_seek) override {
+		if (to_remove && to_remove->get_parent()) {
+			to_remove->get_parent()->remove_child(to_remove);
+		}
+		return AnimationNodeAnimation::process(p_time, p_seek);
+	}
+};
+
+TEST_CASE("[SceneTree][AnimationTree] Parallel trees removed from inside the batch") {
+	Ref<Animation> animation = create_walk_animation(1);
+	// The removed tree joins the batch first, so it's already queued when the graph removes it.
+	Node3D *removed = create_character(animation, 1, true, true);
+	Node3D *other = create_character(animation, 1, true, true);
+	Node3D *remover = create_character(animation, 1, true, true);
+
+	Ref<_TestRemovingAnimationNode> node;
+	node.instantiate();
+	node->set_animation("walk");
+	node->to_remove = removed;
+	Object::cast_to<AnimationTree>(remover->get_node(NodePath("AnimationTree")))->set_tree_root(node);
+
+	const Transform3D removed_transform = get_bone(removed, 0)->get_transform();
+	SceneTree::get_singleton()->process(0.5);
+	CHECK(removed->get_parent() == nullptr);
+	CHECK(get_bone(removed, 0)->get_transform() == removed_transform);
+	CHECK_FALSE(get_bone(other, 0)->get_transform().is_equal_approx(Transform3D()));
+	CHECK(get_bone(remover, 0)->get_transform().is_equal_approx(get_bone(other, 0)->get_transform()));
+
+	memdelete(removed);
+	memdelete(other);
+	memdelete(remover);
+}
+
+TEST_CASE("[Stress][SceneTree][AnimationPlayer] Crowd of animated characters") {
+	const int character_count = 500;
+	const int bone_count = 30;
+	Ref<Animation> animation = create_walk_animation(bone_count);
+
+	for (int parallel = 0; parallel < 2; parallel++) {
+		LocalVector<Node3D *> characters;
+		for (int i = 0; i < character_count; i++) {
+			characters.push_back(create_character(animation, bone_count, false, parallel));
+		}
+
+		const uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		for (int step = 0; step < 60; step++) {
+			SceneTree::get_singleton()->process(1.0 / 60.0);
+		}
+		print_verbose(vformat("60 frames of %d characters with %d bones, %s: %d usec.", character_count, bone_count, parallel ? "parallel" : "serial", OS::get_singleton()->get_ticks_usec() - begin));
+
+		for (uint32_t i = 0; i < characters.size(); i++) {
+			memdelete(characters[i]);
+		}
+	}
+}
+
+} // namespace TestAnimationPlayer
+
+#endif // TEST_ANIMATION_PLAYER_H
@@ -218,6 +218,244 @@ TEST_CASE("[AStar] Add/Remove") {
 	// It's been great work, cheers. \(^ ^)/
 }
 
+TEST_CASE("[AStar] Connections changed between searches") {
+	AStar a;
+	a.add_point(0, Vector3(0, 0, 0));
+	a.add_point(1, Vector3(1, 0, 0));
+	a.add_point(2, Vector3(2, 0, 0));
+	a.add_point(3, Vector3(1, 1, 0));
+	a.connect_points(0, 1);
+	a.connect_points(1, 2);
+	a.connect_points(0, 3);
+	a.connect_points(3, 2);
+
+	Vector<int> path = a.get_id_path(0, 2);
+	REQUIRE(path.size() == 3);
+	CHECK(path[1] == 1);
+
+	a.disconnect_points(1, 2);
+	path = a.get_id_path(0, 2);
+	REQUIRE(path.size() == 3);
+	CHECK(path[1] == 3);
+
+	a.remove_point(3);
+	CHECK(a.get_id_path(0, 2).size() == 0);
+
+	a.add_point(3, Vector3(1, -1, 0));
+	a.connect_points(0, 3);
+	a.connect_points(3, 2, false);
+	path = a.get_id_path(0, 2);
+	REQUIRE(path.size() == 3);
+	CHECK(path[1] == 3);
+	CHECK(a.get_id_path(2, 0).size() == 0);
+
+	a.clear();
+	a.add_point(0, Vector3(0, 0, 0));
+	a.add_point(1, Vector3(1, 0, 0));
+	CHECK(a.get_id_path(0, 1).size() == 0);
+	a.connect_points(0, 1);
+	CHECK(a.get_id_path(0, 1).size() == 2);
+}
+
+TEST_CASE("[AStar] Removed points are replaced by the last one") {
+	AStar a;
+	// 0 - 1 - 2 - 3 - 4 -> 5
+	for (int i = 0; i < 6; i++) {
+		a.add_point(i, Vector3(i, 0, 0));
+		if (i > 0) {
+			a.connect_points(i - 1, i, i < 5);
+		}
+	}
+	CHECK(a.get_id_path(0, 5).size() == 6);
+
+	// Point 5 takes the place of point 1, and keeps its one way connection.
+	a.remove_point(1);
+	CHECK(a.get_point_count() == 5);
+	CHECK(a.get_point_position(5) == Vector3(5, 0, 0));
+	CHECK(a.are_points_connected(4, 5, false));
+	CHECK_FALSE(a.are_points_connected(5, 4, false));
+	CHECK_FALSE(a.are_points_connected(0, 1));
+	CHECK(a.get_point_connections(0).size() == 0);
+	CHECK(a.get_point_connections(2).size() == 1); // 3
+	CHECK(a.get_point_connections(4).size() == 2); // 3, 5
+	CHECK(a.get_point_connections(5).size() == 0);
+
+	Vector<int> path = a.get_id_path(2, 5);
+	REQUIRE(path.size() == 4);
+	CHECK(path[3] == 5);
+	CHECK(a.get_id_path(5, 2).size() == 0);
+	CHECK(a.get_id_path(0, 2).size() == 0);
+	CHECK(a.get_closest_position_in_segment(Vector3(4.5, 1, 0)) == Vector3(4.5, 0, 0));
+
+	// The freed id can be used again, without the old connections.
+	a.add_point(1, Vector3(1, 1, 0));
+	CHECK(a.get_point_connections(1).size() == 0);
+	a.connect_points(0, 1);
+	a.connect_points(1, 2);
+	CHECK(a.get_id_path(0, 5).size() == 6);
+
+	Array ids = a.get_points();
+	CHECK(ids.size() == 6);
+	for (int i = 0; i < 6; i++) {
+		CHECK(ids.has(i));
+	}
+}
+
+TEST_CASE("[AStar] Batch paths") {
+	AStar a;
+	for (int i = 0; i < 8; i++) {
+		a.add_point(i, Vector3(i, i % 2, 0));
+		if (i > 0) {
+			a.connect_points(i - 1, i, i % 3 != 0);
+		}
+	}
+	a.set_point_disabled(5);
+	a.add_point(8, Vector3(5, 2, 0));
+	a.connect_points(4, 8);
+	a.connect_points(8, 6);
+
+	Vector<int> from_ids;
+	Vector<int> to_ids;
+	for (int from = 0; from < 9; from++) {
+		for (int to = 0; to < 9; to++) {
+			from_ids.push_back(from);
+			to_ids.push_back(to);
+		}
+	}
+
+	// Every batched path matches the one found on its own.
+	Array id_paths = a.get_id_paths_batch(from_ids, to_ids);
+	Array point_paths = a.get_point_paths_batch(from_ids, to_ids);
+	REQUIRE(id_paths.size() == from_ids.size());
+	REQUIRE(point_paths.size() == from_ids.size());
+	for (int i = 0; i < from_ids.size(); i++) {
+		CHECK(Vector<int>(id_paths[i]) == a.get_id_path(from_ids[i], to_ids[i]));
+		CHECK(Vector<Vector3>(point_paths[i]) == a.get_point_path(from_ids[i], to_ids[i]));
+	}
+
+	ERR_PRINT_OFF;
+	CHECK(a.get_id_paths_batch(from_ids, Vector<int>()).is_empty());
+	to_ids.set(0, 100);
+	CHECK(a.get_id_paths_batch(from_ids, to_ids).is_empty());
+	ERR_PRINT_ON;
+}
+
+TEST_CASE("[AStar] Flow field") {
+	AStar a;
+	// 0 - 1 - 2
+	// |       |
+	// 3 - 4 - 5 - 6
+	a.add_point(0, Vector3(0, 0, 0));
+	a.add_point(1, Vector3(1, 0, 0));
+	a.add_point(2, Vector3(2, 0, 0));
+	a.add_point(3, Vector3(0, 1, 0));
+	a.add_point(4, Vector3(1, 1, 0));
+	a.add_point(5, Vector3(2, 1, 0));
+	a.add_point(6, Vector3(3, 1, 0));
+	a.connect_points(0, 1);
+	a.connect_points(1, 2);
+	a.connect_points(0, 3);
+	a.connect_points(3, 4);
+	a.connect_points(4, 5);
+	a.connect_points(2, 5);
+	a.connect_points(5, 6, false);
+
+	CHECK(a.get_flow_field_next_id(6, 6) == 6);
+	CHECK(a.get_flow_field_next_id(5, 6) == 6);
+	CHECK(a.get_flow_field_next_id(4, 6) == 5);
+	CHECK(a.get_flow_field_next_id(2, 6) == 5);
+	CHECK(a.get_flow_field_next_id(6, 0) == -1); // One way connection.
+
+	// Following the field takes the shortest path.
+	int id = 0;
+	Vector<int> walked;
+	walked.push_back(id);
+	while (id != 6) {
+		id = a.get_flow_field_next_id(id, 6);
+		REQUIRE(id != -1);
+		walked.push_back(id);
+	}
+	CHECK(walked.size() == a.get_id_path(0, 6).size());
+
+	// Changes to the graph are picked up.
+	a.set_point_weight_scale(5, 10);
+	CHECK(a.get_flow_field_next_id(5, 6) == 6);
+	a.set_point_disabled(5);
+	CHECK(a.get_flow_field_next_id(4, 6) == -1);
+	CHECK(a.get_flow_field_next_id(5, 6) == 6); // Paths can still start at a disabled point.
+	a.set_point_disabled(5, false);
+	a.disconnect_points(4, 5);
+	CHECK(a.get_flow_field_next_id(4, 6) == 3);
+
+	// More goals than the cache holds.
+	for (int goal = 0; goal < 6; goal++) {
+		CHECK(a.get_flow_field_next_id(goal, goal) == goal);
+		CHECK(a.get_flow_field_next_id(3, 0) == 0);
+	}
+}
+
+TEST_CASE("[AStar2D] Grid path") {
+	const int size = 16;
+	AStar2D a;
+	for (int y = 0; y < size; y++) {
+		for (int x = 0; x < size; x++) {
+			a.add_point(y * size + x, Vector2(x, y));
+			if (x > 0) {
+				a.connect_points(y * size + x, y * size + x - 1);
+			}
+			if (y > 0) {
+				a.connect_points(y * size + x, (y - 1) * size + x);
+			}
+		}
+	}
+
+	// A wall across the middle with a single gap at the bottom.
+	for (int y = 0; y < size - 1; y++) {
+		a.set_point_disabled(y * size + size / 2);
+	}
+
+	Vector<Vector2> path = a.get_point_path(0, size - 1);
+	// Down to the gap, across and back up: every step moves by one.
+	REQUIRE(path.size() == 1 + (size - 1) + (size - 1) + (size - 1));
+	CHECK(path[0] == Vector2(0, 0));
+	CHECK(path[path.size() - 1] == Vector2(size - 1, 0));
+	for (int i = 1; i < path.size(); i++) {
+		CHECK(path[i - 1].distance_to(path[i]) == doctest::Approx(1.0));
+	}
+}
+
+TEST_CASE("[Stress][AStar] Grid searches") {
+	// Times searches across a large grid, the shape of graph tile based games build.
+	const int size = 512;
+	AStar a;
+	a.reserve_space(size * size);
+	for (int y = 0; y < size; y++) {
+		for (int x = 0; x < size; x++) {
+			a.add_point(y * size + x, Vector3(x, y, 0));
+			if (x > 0) {
+				a.connect_points(y * size + x, y * size + x - 1);
+			}
+			if (y > 0) {
+				a.connect_points(y * size + x, (y - 1) * size + x);
+			}
+		}
+	}
+
+	Math::seed(0);
+	const int searches = 64;
+	const uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < searches; i++) {
+		const int from_x = Math::rand() % size;
+		const int from_y = Math::rand() % size;
+		const int to_x = Math::rand() % size;
+		const int to_y = Math::rand() % size;
+		Vector<int> path = a.get_id_path(from_y * size + from_x, to_y * size + to_x);
+		CHECK(path.size() == ABS(to_x - from_x) + ABS(to_y - from_y) + 1);
+	}
+	const uint64_t usec = OS::get_singleton()->get_ticks_usec() - begin;
+	print_verbose(vformat("%d searches on a %dx%d grid: %d usec per search.", searches, size, size, usec / searches));
+}
+
 TEST_CASE("[Stress][AStar] Find paths") {
 	// Random stress tests with Floyd-Warshall.
 	const int N = 30;
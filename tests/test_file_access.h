@@ -32,6 +32,9 @@
 #define TEST_FILE_ACCESS_H
 
 #include "core/io/file_access.h"
+#include "core/io/file_access_compressed.h"
+#include "core/io/file_access_memory.h"
+#include "core/os/os.h"
 #include "test_utils.h"
 
 namespace TestFileAccess {
@@ -79,6 +82,147 @@ TEST_CASE("[FileAccess] CSV read") {
 
 	f->close();
 }
+
+TEST_CASE("[FileAccess] Mapped region matches file contents") {
+	FileAccessRef f = FileAccess::open(TestUtils::get_data_path("translations.csv"), FileAccess::READ);
+	REQUIRE(f);
+
+	const uint64_t length = f->get_length();
+	Vector<uint8_t> contents;
+	contents.resize(length);
+	CHECK(f->get_buffer(contents.ptrw(), length) == length);
+
+	const uint8_t *region = f->map_region(0, length);
+	if (!region) {
+		// Not supported on this platform, nothing else to check.
+		return;
+	}
+	f->close();
+
+	CHECK_MESSAGE(memcmp(region, contents.ptr(), length) == 0, "The mapped region should stay valid after closing and match the file contents.");
+	f->unmap_region(region, length);
+}
+
+TEST_CASE("[FileAccess] Buffer view on memory files") {
+	const uint8_t data[8] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+	FileAccessMemory fm;
+	REQUIRE(fm.open_custom(data, 8) == OK);
+
+	const uint8_t *view = fm.get_buffer_view(6);
+	CHECK_MESSAGE(view == data, "The view should point to the file data without copying.");
+	CHECK(fm.get_position() == 6);
+
+	CHECK_MESSAGE(fm.get_buffer_view(4) == nullptr, "Requesting past the end should fail.");
+	CHECK_MESSAGE(fm.get_position() == 6, "A failed request should not advance.");
+
+	view = fm.get_buffer_view(2);
+	REQUIRE(view);
+	CHECK(view[0] == 7);
+	CHECK(view[1] == 8);
+}
+
+struct AsyncReadResult {
+	Error error = ERR_UNCONFIGURED;
+	uint64_t read = 0;
+};
+
+static void _async_read_done(void *p_userdata, Error p_error, uint64_t p_read) {
+	AsyncReadResult *result = (AsyncReadResult *)p_userdata;
+	result->error = p_error;
+	result->read = p_read;
+}
+
+TEST_CASE("[FileAccess] Asynchronous reads match synchronous reads") {
+	FileAccessRef f = FileAccess::open(TestUtils::get_data_path("translations.csv"), FileAccess::READ);
+	REQUIRE(f);
+
+	const uint64_t length = f->get_length();
+	REQUIRE(length > 8);
+	Vector<uint8_t> contents;
+	contents.resize(length);
+	CHECK(f->get_buffer(contents.ptrw(), length) == length);
+	f->seek(3);
+
+	const uint64_t half = length / 2;
+	Vector<uint8_t> async_contents;
+	async_contents.resize(length);
+	uint8_t tail[8] = {};
+	AsyncReadResult results[3];
+
+	FileAccess::ReadRequest requests[3];
+	requests[0].offset = half;
+	requests[0].length = length - half;
+	requests[0].dst = async_contents.ptrw() + half;
+	requests[0].callback = _async_read_done;
+	requests[0].userdata = &results[0];
+	requests[1].offset = 0;
+	requests[1].length = half;
+	requests[1].dst = async_contents.ptrw();
+	requests[1].callback = _async_read_done;
+	requests[1].userdata = &results[1];
+	// Runs past the end of the file.
+	requests[2].offset = length - 4;
+	requests[2].length = 8;
+	requests[2].dst = tail;
+	requests[2].callback = _async_read_done;
+	requests[2].userdata = &results[2];
+
+	CHECK(f->read_async(requests, 3) == OK);
+	f->wait_async();
+
+	CHECK(results[0].error == OK);
+	CHECK(results[0].read == length - half);
+	CHECK(results[1].error == OK);
+	CHECK(results[1].read == half);
+	CHECK(results[2].error == ERR_FILE_EOF);
+	CHECK(results[2].read == 4);
+	CHECK(memcmp(tail, contents.ptr() + length - 4, 4) == 0);
+	CHECK_MESSAGE(async_contents == contents, "Both batched reads should complete with the file contents.");
+	CHECK_MESSAGE(f->get_position() == 3, "Asynchronous reads should not move the file position.");
+}
+
+TEST_CASE("[FileAccess] Compressed files round trip across many blocks") {
+	// Large enough to need several read windows, with a partial last block.
+	const uint32_t size = 600 * 1024 + 123;
+	Vector<uint8_t> data;
+	data.resize(size);
+	for (uint32_t i = 0; i < size; i++) {
+		data.write[i] = (i * 7 + (i >> 10)) & 0xFF;
+	}
+
+	const Compression::Mode modes[4] = { Compression::MODE_FASTLZ, Compression::MODE_DEFLATE, Compression::MODE_ZSTD, Compression::MODE_GZIP };
+	const String path = OS::get_singleton()->get_cache_path().plus_file("file_access_compressed.bin");
+
+	for (int m = 0; m < 4; m++) {
+		FileAccessCompressed *fac = memnew(FileAccessCompressed);
+		fac->configure("GCPF", modes[m]);
+		REQUIRE(fac->_open(path, FileAccess::WRITE) == OK);
+		fac->store_buffer(data.ptr(), size);
+		fac->close();
+		memdelete(fac);
+
+		fac = memnew(FileAccessCompressed);
+		fac->configure("GCPF", modes[m]);
+		REQUIRE(fac->_open(path, FileAccess::READ) == OK);
+		CHECK(fac->get_length() == size);
+
+		Vector<uint8_t> read;
+		read.resize(size);
+		CHECK(fac->get_buffer(read.ptrw(), size) == size);
+		CHECK_MESSAGE(read == data, "Data read back should match what was written.");
+		CHECK(fac->get_buffer(read.ptrw(), 1) == 0);
+		CHECK(fac->eof_reached());
+
+		// Jump back outside of the decoded window.
+		fac->seek(4096 * 3 + 5);
+		CHECK(fac->get_8() == data[4096 * 3 + 5]);
+		fac->seek(size - 1);
+		CHECK(fac->get_8() == data[size - 1]);
+
+		fac->close();
+		memdelete(fac);
+	}
+}
 } // namespace TestFileAccess
 
 #endif // TEST_FILE_ACCESS_H
@@ -146,6 +146,150 @@ TEST_CASE("[JSON] Parsing objects (dictionaries)") {
 			dictionary["empty_object"].hash() == Dictionary().hash(),
 			"The parsed JSON should contain the expected values.");
 }
+
+class JSONEventRecorder : public JSON::Handler {
+public:
+	String events;
+	const char *data_begin = nullptr;
+	const char *data_end = nullptr;
+	int views_into_data = 0;
+
+	void _record(const String &p_event, const char *p_utf8 = nullptr, int p_len = 0) {
+		events += p_event;
+		if (p_utf8) {
+			String str;
+			str.parse_utf8(p_utf8, p_len);
+			events += "(" + str + ")";
+			if (p_utf8 >= data_begin && p_utf8 + p_len <= data_end) {
+				views_into_data++;
+			}
+		}
+		events += " ";
+	}
+
+	virtual bool begin_object() {
+		_record("{");
+		return true;
+	}
+	virtual bool key(const char *p_utf8, int p_len) {
+		_record("key", p_utf8, p_len);
+		return true;
+	}
+	virtual bool end_object() {
+		_record("}");
+		return true;
+	}
+	virtual bool begin_array() {
+		_record("[");
+		return true;
+	}
+	virtual bool end_array() {
+		_record("]");
+		return true;
+	}
+	virtual bool string_value(const char *p_utf8, int p_len) {
+		_record("str", p_utf8, p_len);
+		return true;
+	}
+	virtual bool number_value(double p_value) {
+		_record("num(" + rtos(p_value) + ")");
+		return true;
+	}
+	virtual bool bool_value(bool p_value) {
+		_record(p_value ? "true" : "false");
+		return true;
+	}
+	virtual bool null_value() {
+		_record("null");
+		return true;
+	}
+};
+
+TEST_CASE("[JSON] Streaming parser events") {
+	const CharString json = String(R"({"name": "Godot", "list": [1, -2.5, true, null], "escaped": "a\"\u00e9"})").utf8();
+	JSONEventRecorder recorder;
+	recorder.data_begin = json.get_data();
+	recorder.data_end = json.get_data() + json.length();
+
+	String err_str;
+	int err_line = 0;
+	CHECK(JSON::parse_utf8(json.get_data(), json.length(), &recorder, err_str, err_line) == OK);
+	CHECK(recorder.events == String::utf8("{ key(name) str(Godot) key(list) [ num(1) num(-2.5) true null ] key(escaped) str(a\"é) } "));
+	CHECK_MESSAGE(recorder.views_into_data == 4, "Strings without escape sequences should point into the parsed data.");
+
+	JSONEventRecorder error_recorder;
+	const char *invalid = "[1, 2}";
+	CHECK(JSON::parse_utf8(invalid, strlen(invalid), &error_recorder, err_str, err_line) == ERR_PARSE_ERROR);
+	CHECK(err_str == "Expected ','");
+}
+
+TEST_CASE("[JSON] Parsing numbers") {
+	JSON json;
+
+	CHECK(json.parse("[0, -0.5, 1e3, 2.5E-2, -7e+1]") == OK);
+	Array numbers = json.get_data();
+	REQUIRE(numbers.size() == 5);
+	CHECK(double(numbers[0]) == 0.0);
+	CHECK(double(numbers[1]) == -0.5);
+	CHECK(Math::is_equal_approx(double(numbers[2]), 1000.0));
+	CHECK(Math::is_equal_approx(double(numbers[3]), 0.025));
+	CHECK(Math::is_equal_approx(double(numbers[4]), -70.0));
+
+	// Numbers aren't truncated, however long they are written.
+	CHECK(json.parse("0." + String("0").repeat(80) + "1") == OK);
+	CHECK(double(json.get_data()) > 0.0);
+	CHECK(json.parse("1" + String("0").repeat(80)) == OK);
+	CHECK(Math::is_equal_approx(double(json.get_data()), 1e80));
+
+	const char *malformed[] = { "[1-2]", "[1.5.5]", "[1.]", "[.5]", "[-]", "[+1]", "[01]", "[1e]", "[1e+]", "[2ee3]", "-" };
+	for (const char *str : malformed) {
+		CHECK_MESSAGE(json.parse(str) == ERR_PARSE_ERROR, vformat("Parsing `%s` should fail.", str));
+	}
+}
+
+TEST_CASE("[JSON] Unknown escapes keep the whole character") {
+	JSON json;
+	CHECK(json.parse(String::utf8("\"\\é\\€\"")) == OK);
+	CHECK(json.get_data() == String::utf8("é€"));
+}
+
+TEST_CASE("[JSON] Writer matches stringify") {
+	Dictionary dictionary;
+	dictionary["text"] = String::utf8("Tab\t and \"quotes\" é");
+	Array array;
+	array.push_back(1);
+	array.push_back(0.5);
+	array.push_back(Variant());
+	array.push_back(Array());
+	dictionary["array"] = array;
+
+	JSON json;
+	const String indented = json.stringify(dictionary, "\t");
+	CHECK(indented == String::utf8("{\n\t\"array\": [\n\t\t1,\n\t\t0.5,\n\t\tnull,\n\t\t[\n\n\t\t]\n\t],\n\t\"text\": \"Tab\\t and \\\"quotes\\\" é\"\n}"));
+	CHECK(json.stringify(dictionary) == String::utf8("{\"array\":[1,0.5,null,[]],\"text\":\"Tab\\t and \\\"quotes\\\" é\"}"));
+	CHECK(json.parse(indented) == OK);
+	CHECK(json.stringify(json.get_data(), "\t") == indented);
+
+	JSON::Writer writer("\t");
+	writer.write(dictionary);
+	CHECK(writer.get_string() == indented);
+
+	// Written piece by piece, into the same buffer.
+	writer.clear();
+	writer.begin_object();
+	writer.key("array");
+	writer.write(array);
+	writer.key("text");
+	writer.write(dictionary["text"]);
+	writer.end_object();
+	CHECK(writer.get_string() == indented);
+
+	PackedByteArray buffer;
+	buffer.resize(writer.get_length());
+	memcpy(buffer.ptrw(), writer.get_data(), writer.get_length());
+	CHECK(json.parse_buffer(buffer) == OK);
+	CHECK(json.stringify(json.get_data(), "\t") == indented);
+}
 } // namespace TestJSON
 
 #endif // TEST_JSON_H
@@ -33,6 +33,8 @@
 #include "core/templates/list.h"
 
 #include "test_aabb.h"
+#include "test_animation.h"
+#include "test_animation_player.h"
 #include "test_array.h"
 #include "test_astar.h"
 #include "test_basis.h"
@@ -59,10 +61,12 @@
 #include "test_marshalls.h"
 #include "test_math.h"
 #include "test_method_bind.h"
+#include "test_node_3d.h"
 #include "test_node_path.h"
 #include "test_oa_hash_map.h"
 #include "test_object.h"
 #include "test_ordered_hash_map.h"
+#include "test_packed_scene.h"
 #include "test_paged_array.h"
 #include "test_path_3d.h"
 #include "test_pck_packer.h"
@@ -72,6 +76,8 @@
 #include "test_rect2.h"
 #include "test_render.h"
 #include "test_resource.h"
+#include "test_resource_loader.h"
+#include "test_scene_tree.h"
 #include "test_shader_lang.h"
 #include "test_string.h"
 #include "test_text_server.h"
@@ -0,0 +1,184 @@
+/*************************************************************************/
+/*  test_node_3d.h                                                       */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_NODE_3D_H
+#define TEST_NODE_3D_H
+
+#include "core/os/os.h"
+#include "scene/3d/node_3d.h"
+#include "scene/main/window.h"
+
+#include "tests/test_macros.h"
+
+// Declared in global namespace because of GDCLASS macro warning (Windows):
+// "Unqualified friend declaration referring to type outside of the nearest enclosing namespace
+// is a Microsoft extension; add a nested name specifier".
+// Reads its global transform when notified, like VisualInstance3D does.
+class _TestTransformNode : public Node3D {
+	GDCLASS(_TestTransformNode, Node3D);
+
+protected:
+	void _notification(int p_what) {
+		if (p_what == NOTIFICATION_TRANSFORM_CHANGED) {
+			notified_transform = get_global_transform();
+			notify_count++;
+		}
+	}
+
+public:
+	Transform3D notified_transform;
+	int notify_count = 0;
+
+	_TestTransformNode() {
+		set_notify_transform(true);
+	}
+};
+
+namespace TestNode3D {
+
+static _TestTransformNode *create_node(Node *p_parent, int p_index) {
+	_TestTransformNode *node = memnew(_TestTransformNode);
+	node->set_position(Vector3(p_index % 3, 0.5, -1));
+	node->set_rotation(Vector3(0, 0.1 * (p_index % 5), 0.2));
+	node->set_scale(Vector3(1, 1, 1) * (1.0 + 0.01 * (p_index % 4)));
+	p_parent->add_child(node);
+	return node;
+}
+
+// A wide level (so the threaded path kicks in) with deeper chains, a plain Node in between, a
+// top level node and one ignoring the parent scale.
+static Node3D *create_scene(LocalVector<_TestTransformNode *> &r_nodes) {
+	_TestTransformNode *root = memnew(_TestTransformNode);
+	SceneTree::get_singleton()->get_root()->add_child(root);
+	r_nodes.push_back(root);
+
+	for (int i = 0; i < 100; i++) {
+		Node *parent = root;
+		if (i == 10) {
+			parent = memnew(Node);
+			root->add_child(parent);
+		}
+		_TestTransformNode *node = create_node(parent, i);
+		r_nodes.push_back(node);
+		for (int j = 0; j < 3; j++) {
+			node = create_node(node, i + j);
+			r_nodes.push_back(node);
+		}
+		if (i == 20) {
+			node->set_as_top_level(true);
+		} else if (i == 30) {
+			node->set_disable_scale(true);
+		}
+	}
+	return root;
+}
+
+TEST_CASE("[SceneTree][Node3D] Batched transform updates match lazy updates") {
+	SceneTree::TransformUpdateMode previous_mode = SceneTree::get_singleton()->get_transform_update_mode();
+
+	LocalVector<Transform3D> expected;
+	const SceneTree::TransformUpdateMode modes[3] = { SceneTree::TRANSFORM_UPDATE_LAZY, SceneTree::TRANSFORM_UPDATE_BATCHED, SceneTree::TRANSFORM_UPDATE_BATCHED_THREADED };
+	for (int m = 0; m < 3; m++) {
+		SceneTree::get_singleton()->set_transform_update_mode(modes[m]);
+
+		LocalVector<_TestTransformNode *> nodes;
+		Node3D *root = create_scene(nodes);
+		SceneTree::get_singleton()->flush_transform_notifications();
+
+		root->set_position(Vector3(1, 2, 3));
+		root->rotate_y(0.5);
+		nodes[5]->set_scale(Vector3(2, 2, 2));
+		SceneTree::get_singleton()->flush_transform_notifications();
+
+		for (uint32_t i = 0; i < nodes.size(); i++) {
+			if (m == 0) {
+				expected.push_back(nodes[i]->notified_transform);
+			} else {
+				CHECK(nodes[i]->notified_transform.is_equal_approx(expected[i]));
+			}
+			// Notified once when entering, once after moving. The top level one doesn't follow.
+			CHECK(nodes[i]->notify_count == (i == 84 ? 1 : 2));
+			CHECK(nodes[i]->notified_transform.is_equal_approx(nodes[i]->get_global_transform()));
+		}
+
+		memdelete(root);
+	}
+
+	SceneTree::get_singleton()->set_transform_update_mode(previous_mode);
+}
+
+TEST_CASE("[SceneTree][Node3D][Stress] Moving a 10k node rig") {
+	SceneTree::TransformUpdateMode previous_mode = SceneTree::get_singleton()->get_transform_update_mode();
+
+	LocalVector<Transform3D> expected;
+	const SceneTree::TransformUpdateMode modes[3] = { SceneTree::TRANSFORM_UPDATE_LAZY, SceneTree::TRANSFORM_UPDATE_BATCHED, SceneTree::TRANSFORM_UPDATE_BATCHED_THREADED };
+	const char *mode_names[3] = { "lazy", "batched", "batched threaded" };
+	for (int m = 0; m < 3; m++) {
+		SceneTree::get_singleton()->set_transform_update_mode(modes[m]);
+
+		// 100 chains of 100 bones.
+		LocalVector<_TestTransformNode *> bones;
+		_TestTransformNode *rig = memnew(_TestTransformNode);
+		SceneTree::get_singleton()->get_root()->add_child(rig);
+		for (int i = 0; i < 100; i++) {
+			Node *parent = rig;
+			for (int j = 0; j < 100; j++) {
+				parent = create_node(parent, i + j);
+				bones.push_back(Object::cast_to<_TestTransformNode>(parent));
+			}
+		}
+		SceneTree::get_singleton()->flush_transform_notifications();
+
+		const int steps = 20;
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		for (int step = 0; step < steps; step++) {
+			rig->rotate_y(0.01);
+			SceneTree::get_singleton()->flush_transform_notifications();
+		}
+		uint64_t usec = OS::get_singleton()->get_ticks_usec() - begin;
+		print_verbose(vformat("Moving a %d node rig (%s): %d usec per step.", bones.size(), mode_names[m], usec / steps));
+
+		for (uint32_t i = 0; i < bones.size(); i += 101) {
+			if (m == 0) {
+				expected.push_back(bones[i]->notified_transform);
+			} else {
+				CHECK(bones[i]->notified_transform.is_equal_approx(expected[i / 101]));
+			}
+		}
+
+		memdelete(rig);
+	}
+
+	SceneTree::get_singleton()->set_transform_update_mode(previous_mode);
+}
+
+} // namespace TestNode3D
+
+#endif // TEST_NODE_3D_H
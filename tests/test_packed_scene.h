@@ -0,0 +1,243 @@
+/*************************************************************************/
+/*  test_packed_scene.h                                                  */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_PACKED_SCENE_H
+#define TEST_PACKED_SCENE_H
+
+#include "scene/2d/node_2d.h"
+#include "scene/2d/remote_transform_2d.h"
+#include "scene/resources/packed_scene.h"
+
+#include "tests/test_macros.h"
+
+namespace TestPackedScene {
+
+static Ref<PackedScene> _create_test_scene() {
+	Node *root = memnew(Node);
+	root->set_name("Root");
+
+	Node2D *child = memnew(Node2D);
+	child->set_name("Child");
+	child->set_position(Vector2(1, 2));
+	child->set_rotation(0.5);
+	root->add_child(child);
+	child->set_owner(root);
+
+	Node2D *grandchild = memnew(Node2D);
+	grandchild->set_name("Grandchild");
+	grandchild->set_scale(Vector2(3, 4));
+	child->add_child(grandchild);
+	grandchild->set_owner(root);
+
+	Ref<PackedScene> scene;
+	scene.instantiate();
+	scene->pack(root);
+
+	memdelete(root);
+	return scene;
+}
+
+TEST_CASE("[PackedScene] Repeated instantiation") {
+	Ref<PackedScene> scene = _create_test_scene();
+
+	// The first instance builds the instantiation plan, later ones reuse it.
+	for (int i = 0; i < 3; i++) {
+		Node *instance = scene->instantiate();
+		REQUIRE(instance != nullptr);
+		CHECK(instance->get_name() == "Root");
+
+		Node2D *child = Object::cast_to<Node2D>(instance->get_node_or_null(NodePath("Child")));
+		REQUIRE(child != nullptr);
+		CHECK(child->get_owner() == instance);
+		CHECK(child->get_position().is_equal_approx(Vector2(1, 2)));
+		CHECK(Math::is_equal_approx(child->get_rotation(), (real_t)0.5));
+
+		Node2D *grandchild = Object::cast_to<Node2D>(instance->get_node_or_null(NodePath("Child/Grandchild")));
+		REQUIRE(grandchild != nullptr);
+		CHECK(grandchild->get_owner() == instance);
+		CHECK(grandchild->get_scale().is_equal_approx(Vector2(3, 4)));
+
+		memdelete(instance);
+	}
+}
+
+TEST_CASE("[PackedScene] Instantiate many") {
+	Ref<PackedScene> scene = _create_test_scene();
+
+	SUBCASE("Without parent") {
+		TypedArray<Node> instances = scene->instantiate_many(4);
+		REQUIRE(instances.size() == 4);
+		for (int i = 0; i < instances.size(); i++) {
+			Node *instance = Object::cast_to<Node>(instances[i]);
+			REQUIRE(instance != nullptr);
+			CHECK(instance->get_parent() == nullptr);
+			CHECK(instance->get_node_or_null(NodePath("Child/Grandchild")) != nullptr);
+			memdelete(instance);
+		}
+	}
+
+	SUBCASE("With parent") {
+		Node *parent = memnew(Node);
+		Node *existing = memnew(Node);
+		existing->set_name("Existing");
+		parent->add_child(existing);
+
+		TypedArray<Node> instances = scene->instantiate_many(4, parent);
+		REQUIRE(instances.size() == 4);
+		CHECK(parent->get_child_count() == 5);
+		CHECK(Object::cast_to<Node>(instances[0])->get_name() == "Root");
+
+		Set<StringName> names;
+		for (int i = 0; i < parent->get_child_count(); i++) {
+			names.insert(parent->get_child(i)->get_name());
+		}
+		CHECK_MESSAGE(names.size() == 5, "All the children should have unique names.");
+
+		memdelete(parent);
+	}
+
+	SUBCASE("Zero count") {
+		TypedArray<Node> instances = scene->instantiate_many(0);
+		CHECK(instances.size() == 0);
+	}
+}
+
+static void _add_owned_child(Node *p_parent, Node *p_child, const String &p_name, Node *p_owner) {
+	p_child->set_name(p_name);
+	p_parent->add_child(p_child);
+	p_child->set_owner(p_owner);
+}
+
+TEST_CASE("[PackedScene] Instantiate many resolves node paths in every instance") {
+	Ref<PackedScene> scene;
+	{
+		Node *root = memnew(Node);
+		root->set_name("Root");
+		Node *a = memnew(Node);
+		_add_owned_child(root, a, "A", root);
+		Node *a1 = memnew(Node);
+		_add_owned_child(a, a1, "A1", root);
+		RemoteTransform2D *a2 = memnew(RemoteTransform2D);
+		_add_owned_child(a, a2, "A2", root);
+		a2->set_remote_node(NodePath("../../B/B1"));
+		Node *b = memnew(Node);
+		_add_owned_child(root, b, "B", root);
+		Node *b1 = memnew(Node);
+		_add_owned_child(b, b1, "B1", root);
+		a1->connect("renamed", Callable(b1, "update_configuration_warnings"), varray(), Object::CONNECT_PERSIST);
+
+		scene.instantiate();
+		scene->pack(root);
+		memdelete(root);
+	}
+
+	Node *parent = memnew(Node);
+	// The first instance records the node paths, the others go through the recorded ones.
+	TypedArray<Node> instances = scene->instantiate_many(3, parent);
+	REQUIRE(instances.size() == 3);
+	for (int i = 0; i < instances.size(); i++) {
+		Node *instance = Object::cast_to<Node>(instances[i]);
+		REQUIRE(instance != nullptr);
+		CHECK(instance->get_parent() == parent);
+
+		Node *a1 = instance->get_node_or_null(NodePath("A/A1"));
+		RemoteTransform2D *a2 = Object::cast_to<RemoteTransform2D>(instance->get_node_or_null(NodePath("A/A2")));
+		Node *b1 = instance->get_node_or_null(NodePath("B/B1"));
+		REQUIRE(a1 != nullptr);
+		REQUIRE(a2 != nullptr);
+		REQUIRE(b1 != nullptr);
+		CHECK(instance->get_child_count() == 2);
+		CHECK(instance->get_node(NodePath("A"))->get_child_count() == 2);
+		CHECK(a1->get_owner() == instance);
+		CHECK(b1->get_owner() == instance);
+
+		CHECK(a2->get_remote_node() == NodePath("../../B/B1"));
+		CHECK(a2->get_node_or_null(a2->get_remote_node()) == b1);
+		CHECK_MESSAGE(a1->is_connected("renamed", Callable(b1, "update_configuration_warnings")), "Connections are made between the nodes of the same instance.");
+	}
+
+	memdelete(parent);
+}
+
+TEST_CASE("[PackedScene] Instantiate many with editable children") {
+	Ref<PackedScene> inner = _create_test_scene();
+	inner->set_path("res://test_packed_scene_inner.tscn");
+
+	Ref<PackedScene> scene;
+	{
+		Node *root = memnew(Node);
+		root->set_name("Outer");
+		Node *inner_instance = inner->instantiate(PackedScene::GEN_EDIT_STATE_INSTANCE);
+		REQUIRE(inner_instance != nullptr);
+		_add_owned_child(root, inner_instance, "Inner", root);
+		root->set_editable_instance(inner_instance, true);
+
+		// An overridden property and a node added inside the instanced scene.
+		Object::cast_to<Node2D>(inner_instance->get_node(NodePath("Child")))->set_position(Vector2(5, 6));
+		Node *added = memnew(Node);
+		_add_owned_child(inner_instance->get_node(NodePath("Child")), added, "Added", root);
+
+		scene.instantiate();
+		CHECK(scene->pack(root) == OK);
+		memdelete(root);
+	}
+
+	Node *parent = memnew(Node);
+	TypedArray<Node> instances = scene->instantiate_many(3, parent);
+	REQUIRE(instances.size() == 3);
+	for (int i = 0; i < instances.size(); i++) {
+		Node *instance = Object::cast_to<Node>(instances[i]);
+		REQUIRE(instance != nullptr);
+
+		Node *inner_instance = instance->get_node_or_null(NodePath("Inner"));
+		REQUIRE(inner_instance != nullptr);
+		CHECK(inner_instance->get_owner() == instance);
+
+		Node2D *child = Object::cast_to<Node2D>(instance->get_node_or_null(NodePath("Inner/Child")));
+		REQUIRE(child != nullptr);
+		CHECK(child->get_owner() == inner_instance);
+		CHECK(child->get_position().is_equal_approx(Vector2(5, 6)));
+		CHECK(Math::is_equal_approx(child->get_rotation(), (real_t)0.5));
+
+		Node2D *grandchild = Object::cast_to<Node2D>(instance->get_node_or_null(NodePath("Inner/Child/Grandchild")));
+		REQUIRE(grandchild != nullptr);
+		CHECK(grandchild->get_scale().is_equal_approx(Vector2(3, 4)));
+
+		Node *added = instance->get_node_or_null(NodePath("Inner/Child/Added"));
+		REQUIRE(added != nullptr);
+		CHECK(added->get_owner() == instance);
+	}
+
+	memdelete(parent);
+}
+
+} // namespace TestPackedScene
+
+#endif // TEST_PACKED_SCENE_H
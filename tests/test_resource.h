@@ -31,6 +31,8 @@
 #ifndef TEST_RESOURCE
 #define TEST_RESOURCE
 
+#include "core/config/project_settings.h"
+#include "core/io/file_access.h"
 #include "core/io/resource.h"
 #include "core/io/resource_loader.h"
 #include "core/io/resource_saver.h"
@@ -109,6 +111,145 @@ TEST_CASE("[Resource] Saving and loading") {
 			loaded_child_resource_text->get_name() == "I'm a child resource",
 			"The loaded child resource name should be equal to the expected value.");
 }
+
+TEST_CASE("[Resource] Saving and loading packed arrays in binary format") {
+	PackedByteArray bytes;
+	PackedInt32Array ints;
+	PackedFloat64Array doubles;
+	PackedVector3Array vectors;
+	PackedColorArray colors;
+	// Large and repetitive enough to be compressed.
+	for (int i = 0; i < 10000; i++) {
+		bytes.push_back(i % 7);
+		ints.push_back(i / 3);
+		doubles.push_back(i * 0.5);
+		vectors.push_back(Vector3(i % 10, 1, -i));
+		colors.push_back(Color(1, 0.5, (i % 4) * 0.25));
+	}
+	PackedFloat32Array small_floats;
+	small_floats.push_back(1.5);
+	small_floats.push_back(-2.25);
+
+	Ref<Resource> child_resource = memnew(Resource);
+	child_resource->set_meta("vectors", vectors);
+
+	Ref<Resource> resource = memnew(Resource);
+	resource->set_meta("bytes", bytes);
+	resource->set_meta("ints", ints);
+	resource->set_meta("doubles", doubles);
+	resource->set_meta("colors", colors);
+	resource->set_meta("small_floats", small_floats);
+	resource->set_meta("other_resource", child_resource);
+
+	const uint32_t flags[2] = { 0, ResourceSaver::FLAG_COMPRESS_PACKED_ARRAYS };
+	for (int i = 0; i < 2; i++) {
+		const String save_path = OS::get_singleton()->get_cache_path().plus_file("resource_packed_arrays.res");
+		REQUIRE(ResourceSaver::save(save_path, resource, flags[i]) == OK);
+
+		const Ref<Resource> &loaded = ResourceLoader::load(save_path, "", ResourceFormatLoader::CACHE_MODE_IGNORE);
+		REQUIRE(loaded.is_valid());
+		CHECK(PackedByteArray(loaded->get_meta("bytes")) == bytes);
+		CHECK(PackedInt32Array(loaded->get_meta("ints")) == ints);
+		CHECK(PackedFloat64Array(loaded->get_meta("doubles")) == doubles);
+		CHECK(PackedColorArray(loaded->get_meta("colors")) == colors);
+		CHECK(PackedFloat32Array(loaded->get_meta("small_floats")) == small_floats);
+
+		const Ref<Resource> &loaded_child = loaded->get_meta("other_resource");
+		REQUIRE(loaded_child.is_valid());
+		CHECK(PackedVector3Array(loaded_child->get_meta("vectors")) == vectors);
+	}
+}
+
+TEST_CASE("[Resource] Cyclic built-in resources in binary format load as null") {
+	// The saver never writes cycles, so make one by patching the file: D is the only
+	// resource referenced from C, point C back at B instead.
+	Ref<Resource> d = memnew(Resource);
+	Ref<Resource> c = memnew(Resource);
+	c->set_meta("link", d);
+	Ref<Resource> b = memnew(Resource);
+	b->set_meta("link", c);
+	Ref<Resource> a = memnew(Resource);
+	a->set_meta("child", b);
+
+	const String save_path = OS::get_singleton()->get_cache_path().plus_file("resource_cyclic.res");
+	REQUIRE(ResourceSaver::save(save_path, a) == OK);
+
+	// Internal resources are saved children first: D, C, B, then A.
+	// Each reference is stored as VARIANT_OBJECT (24), OBJECT_INTERNAL_RESOURCE (2), index.
+	Vector<uint8_t> data = FileAccess::get_file_as_array(save_path);
+	const uint8_t reference_to_d[12] = { 24, 0, 0, 0, 2, 0, 0, 0, 0, 0, 0, 0 };
+	int found = -1;
+	for (int i = 0; i + 12 <= data.size(); i++) {
+		if (memcmp(data.ptr() + i, reference_to_d, 12) == 0) {
+			REQUIRE_MESSAGE(found == -1, "The reference to D should be unique.");
+			found = i;
+		}
+	}
+	REQUIRE(found != -1);
+	data.write[found + 8] = 2; // B.
+
+	FileAccess *f = FileAccess::open(save_path, FileAccess::WRITE);
+	REQUIRE(f);
+	f->store_buffer(data.ptr(), data.size());
+	f->close();
+	memdelete(f);
+
+	ERR_PRINT_OFF;
+	const Ref<Resource> &loaded = ResourceLoader::load(save_path, "", ResourceFormatLoader::CACHE_MODE_IGNORE);
+	REQUIRE(loaded.is_valid());
+	const Ref<Resource> &loaded_b = loaded->get_meta("child");
+	REQUIRE(loaded_b.is_valid());
+	const Ref<Resource> &loaded_c = loaded_b->get_meta("link");
+	REQUIRE(loaded_c.is_valid());
+	CHECK_MESSAGE(loaded_c->get_meta("link").get_type() == Variant::NIL, "The cyclic reference should resolve to null.");
+	ERR_PRINT_ON;
+}
+
+TEST_CASE("[Resource] Sharing identical built-in resources between binary files") {
+	const String save_path_a = OS::get_singleton()->get_cache_path().plus_file("resource_dedup_a.res");
+	const String save_path_b = OS::get_singleton()->get_cache_path().plus_file("resource_dedup_b.res");
+
+	for (int i = 0; i < 2; i++) {
+		Ref<Resource> child_resource = memnew(Resource);
+		child_resource->set_name("Identical child");
+		child_resource->set_meta("data", Vector3(1, 2, 3));
+		Ref<Resource> local_child_resource = memnew(Resource);
+		local_child_resource->set_local_to_scene(true);
+
+		Ref<Resource> resource = memnew(Resource);
+		resource->set_name(i == 0 ? "First" : "Second");
+		resource->set_meta("child", child_resource);
+		resource->set_meta("local_child", local_child_resource);
+		REQUIRE(ResourceSaver::save(i == 0 ? save_path_a : save_path_b, resource) == OK);
+	}
+
+	ProjectSettings::get_singleton()->set_setting("resource_loader/deduplicate_built_in_resources", true);
+
+	uint64_t count_before = 0;
+	uint64_t bytes_before = 0;
+	ResourceCache::get_deduplication_stats(&count_before, &bytes_before);
+
+	const Ref<Resource> &loaded_a = ResourceLoader::load(save_path_a);
+	const Ref<Resource> &loaded_b = ResourceLoader::load(save_path_b);
+	REQUIRE(loaded_a.is_valid());
+	REQUIRE(loaded_b.is_valid());
+	CHECK(loaded_a->get_name() == "First");
+	CHECK(loaded_b->get_name() == "Second");
+
+	const Ref<Resource> &child_a = loaded_a->get_meta("child");
+	const Ref<Resource> &child_b = loaded_b->get_meta("child");
+	CHECK_MESSAGE(child_a == child_b, "Identical built-in resources should be loaded once.");
+	CHECK(child_a->get_meta("data") == Vector3(1, 2, 3));
+	CHECK_MESSAGE(Ref<Resource>(loaded_a->get_meta("local_child")) != Ref<Resource>(loaded_b->get_meta("local_child")), "Resources local to scene should never be shared.");
+
+	uint64_t count_after = 0;
+	uint64_t bytes_after = 0;
+	ResourceCache::get_deduplication_stats(&count_after, &bytes_after);
+	CHECK(count_after == count_before + 1);
+	CHECK(bytes_after > bytes_before);
+
+	ProjectSettings::get_singleton()->set_setting("resource_loader/deduplicate_built_in_resources", false);
+}
 } // namespace TestResource
 
 #endif // TEST_RESOURCE
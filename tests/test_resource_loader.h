@@ -0,0 +1,192 @@
+/*************************************************************************/
+/*  test_resource_loader.h                                               */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_RESOURCE_LOADER_H
+#define TEST_RESOURCE_LOADER_H
+
+#include "core/io/resource_loader.h"
+#include "core/os/os.h"
+#include "core/os/semaphore.h"
+
+#include "tests/test_macros.h"
+
+namespace TestResourceLoader {
+
+// Loads any "*.testload" path without reading files. Paths containing "block" wait
+// until released, keeping their loading thread busy.
+class BlockingLoader : public ResourceFormatLoader {
+public:
+	Mutex mutex;
+	Semaphore release;
+	Vector<String> started;
+
+	virtual RES load(const String &p_path, const String &p_original_path, Error *r_error, bool p_use_sub_threads, float *r_progress, CacheMode p_cache_mode) override {
+		mutex.lock();
+		started.push_back(p_path);
+		mutex.unlock();
+
+		if (p_path.find("block") != -1) {
+			release.wait();
+		}
+
+		if (r_error) {
+			*r_error = OK;
+		}
+		Ref<Resource> resource;
+		resource.instantiate();
+		return resource;
+	}
+
+	virtual void get_recognized_extensions(List<String> *p_extensions) const override {
+		p_extensions->push_back("testload");
+	}
+
+	virtual bool handles_type(const String &p_type) const override {
+		return p_type == "Resource";
+	}
+
+	virtual String get_resource_type(const String &p_path) const override {
+		return p_path.get_extension() == "testload" ? "Resource" : "";
+	}
+
+	int get_start_index(const String &p_path) {
+		MutexLock lock(mutex);
+		return started.find(p_path);
+	}
+};
+
+// Occupies every loading thread.
+static void block_loading_threads(int p_count) {
+	for (int i = 0; i < p_count; i++) {
+		CHECK(ResourceLoader::load_threaded_request(vformat("res://block_%d.testload", i)) == OK);
+	}
+}
+
+static void release_loading_threads(const Ref<BlockingLoader> &p_loader, int p_count, int p_already_released = 0) {
+	for (int i = p_already_released; i < p_count; i++) {
+		p_loader->release.post();
+	}
+	for (int i = 0; i < p_count; i++) {
+		CHECK(ResourceLoader::load_threaded_get(vformat("res://block_%d.testload", i)).is_valid());
+	}
+}
+
+// Polls, unlike load_threaded_get() which lets queued loads take the waiting thread's place.
+static bool wait_until_loaded(const String &p_path) {
+	for (int i = 0; i < 10000; i++) {
+		if (ResourceLoader::load_threaded_get_status(p_path) == ResourceLoader::THREAD_LOAD_LOADED) {
+			return true;
+		}
+		OS::get_singleton()->delay_usec(1000);
+	}
+	return false;
+}
+
+TEST_CASE("[ResourceLoader] Threaded requests for the same path are shared") {
+	Ref<BlockingLoader> loader;
+	loader.instantiate();
+	ResourceLoader::add_resource_format_loader(loader, true);
+
+	const String path = "res://shared.testload";
+	CHECK(ResourceLoader::load_threaded_request(path) == OK);
+	CHECK(ResourceLoader::load_threaded_request(path) == OK);
+
+	// Each request takes its own result.
+	RES first = ResourceLoader::load_threaded_get(path);
+	CHECK(first.is_valid());
+	CHECK(ResourceLoader::load_threaded_get_status(path) == ResourceLoader::THREAD_LOAD_LOADED);
+	RES second = ResourceLoader::load_threaded_get(path);
+	CHECK(second == first);
+	CHECK(ResourceLoader::load_threaded_get_status(path) == ResourceLoader::THREAD_LOAD_INVALID_RESOURCE);
+
+	int loads = 0;
+	for (int i = 0; i < loader->started.size(); i++) {
+		loads += loader->started[i] == path ? 1 : 0;
+	}
+	CHECK_MESSAGE(loads == 1, "Requests for the same path should load it once.");
+
+	ResourceLoader::remove_resource_format_loader(loader);
+}
+
+TEST_CASE("[ResourceLoader] Queued threaded requests start by priority") {
+	Ref<BlockingLoader> loader;
+	loader.instantiate();
+	ResourceLoader::add_resource_format_loader(loader, true);
+
+	const int thread_count = OS::get_singleton()->get_processor_count();
+	block_loading_threads(thread_count);
+
+	CHECK(ResourceLoader::load_threaded_request("res://prefetch.testload", "", false, ResourceFormatLoader::CACHE_MODE_REUSE, String(), ResourceLoader::LOAD_PRIORITY_PREFETCH) == OK);
+	CHECK(ResourceLoader::load_threaded_request("res://critical.testload", "", false, ResourceFormatLoader::CACHE_MODE_REUSE, String(), ResourceLoader::LOAD_PRIORITY_CRITICAL) == OK);
+
+	ResourceLoader::ThreadLoadStats stats;
+	CHECK(ResourceLoader::load_threaded_get_stats("res://prefetch.testload", &stats));
+	CHECK(stats.priority == ResourceLoader::LOAD_PRIORITY_PREFETCH);
+	CHECK(stats.loading_usec == 0);
+
+	CHECK(loader->get_start_index("res://critical.testload") == -1);
+
+	// A single thread frees up, the most urgent request takes it. The other one can only
+	// start once it's done.
+	loader->release.post();
+	CHECK(wait_until_loaded("res://critical.testload"));
+
+	release_loading_threads(loader, thread_count, 1);
+	CHECK(ResourceLoader::load_threaded_get("res://prefetch.testload").is_valid());
+	CHECK(ResourceLoader::load_threaded_get("res://critical.testload").is_valid());
+	CHECK(loader->get_start_index("res://critical.testload") < loader->get_start_index("res://prefetch.testload"));
+
+	ResourceLoader::remove_resource_format_loader(loader);
+}
+
+TEST_CASE("[ResourceLoader] Cancelled threaded requests are dropped") {
+	Ref<BlockingLoader> loader;
+	loader.instantiate();
+	ResourceLoader::add_resource_format_loader(loader, true);
+
+	const int thread_count = OS::get_singleton()->get_processor_count();
+	block_loading_threads(thread_count);
+
+	const String path = "res://cancelled.testload";
+	CHECK(ResourceLoader::load_threaded_request(path) == OK);
+	CHECK(ResourceLoader::load_threaded_get_status(path) == ResourceLoader::THREAD_LOAD_IN_PROGRESS);
+	CHECK(ResourceLoader::load_threaded_cancel(path));
+	CHECK(ResourceLoader::load_threaded_get_status(path) == ResourceLoader::THREAD_LOAD_INVALID_RESOURCE);
+	CHECK_FALSE(ResourceLoader::load_threaded_cancel(path));
+
+	release_loading_threads(loader, thread_count);
+	CHECK_MESSAGE(loader->get_start_index(path) == -1, "Requests cancelled while queued should never load.");
+
+	ResourceLoader::remove_resource_format_loader(loader);
+}
+
+} // namespace TestResourceLoader
+
+#endif // TEST_RESOURCE_LOADER_H
@@ -0,0 +1,338 @@
+/*************************************************************************/
+/*  test_scene_tree.h                                                    */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_SCENE_TREE_H
+#define TEST_SCENE_TREE_H
+
+#include "core/os/os.h"
+#include "core/os/thread.h"
+#include "scene/main/window.h"
+
+#include "tests/test_macros.h"
+
+// Declared in global namespace because of GDCLASS macro warning (Windows):
+// "Unqualified friend declaration referring to type outside of the nearest enclosing namespace
+// is a Microsoft extension; add a nested name specifier".
+class _TestThreadGroupNode : public Node {
+	GDCLASS(_TestThreadGroupNode, Node);
+
+protected:
+	static void _bind_methods() {
+		ClassDB::bind_method(D_METHOD("apply"), &_TestThreadGroupNode::apply);
+	}
+
+	void _notification(int p_what) {
+		if (p_what != NOTIFICATION_PROCESS) {
+			return;
+		}
+		process_count++;
+		bool main_thread = Thread::get_caller_id() == Thread::get_main_id();
+		if (!main_thread) {
+			processed_on_sub_thread = true;
+		}
+
+		int applied = apply_count;
+		call_thread_safe("apply");
+		if (!main_thread && apply_count != applied) {
+			applied_from_sub_thread = true;
+		}
+
+		if (add_child_on_process) {
+			const Variant child = add_child_on_process;
+			const Variant *args[1] = { &child };
+			call_thread_safe("add_child", args, 1);
+			add_child_on_process = nullptr;
+		}
+	}
+
+public:
+	int process_count = 0;
+	int apply_count = 0;
+	bool processed_on_sub_thread = false;
+	bool applied_from_sub_thread = false;
+	Node *add_child_on_process = nullptr;
+
+	void apply() {
+		apply_count++;
+	}
+
+	_TestThreadGroupNode() {
+		set_process(true);
+	}
+};
+
+class _TestProcessNode : public Node {
+	GDCLASS(_TestProcessNode, Node);
+
+protected:
+	void _notification(int p_what) {
+		if (p_what != NOTIFICATION_PROCESS) {
+			return;
+		}
+		process_count++;
+		if (log) {
+			log->push_back(id);
+		}
+		if (stop_on_process) {
+			stop_on_process->set_process(false);
+		}
+		if (start_on_process) {
+			start_on_process->set_process(true);
+		}
+		if (free_on_process) {
+			memdelete(free_on_process);
+			free_on_process = nullptr;
+		}
+	}
+
+public:
+	int id = 0;
+	int process_count = 0;
+	LocalVector<int> *log = nullptr;
+	Node *stop_on_process = nullptr;
+	Node *start_on_process = nullptr;
+	Node *free_on_process = nullptr;
+};
+
+namespace TestSceneTree {
+
+TEST_CASE("[SceneTree] Process lists") {
+	Window *root = SceneTree::get_singleton()->get_root();
+	LocalVector<int> log;
+
+	_TestProcessNode *nodes[4];
+	for (int i = 0; i < 4; i++) {
+		nodes[i] = memnew(_TestProcessNode);
+		nodes[i]->id = i;
+		nodes[i]->log = &log;
+		root->add_child(nodes[i]);
+		nodes[i]->set_process(true);
+	}
+
+	SUBCASE("Priority, then tree order") {
+		nodes[3]->set_process_priority(-1);
+		SceneTree::get_singleton()->process(0.1);
+		REQUIRE(log.size() == 4);
+		CHECK(log[0] == 3);
+		CHECK(log[1] == 0);
+		CHECK(log[2] == 1);
+		CHECK(log[3] == 2);
+	}
+
+	SUBCASE("Changes while dispatching") {
+		// Stopped nodes are skipped right away, started ones wait for the next step.
+		nodes[0]->stop_on_process = nodes[1];
+		nodes[2]->set_process(false);
+		nodes[3]->start_on_process = nodes[2];
+		SceneTree::get_singleton()->process(0.1);
+		CHECK(nodes[1]->process_count == 0);
+		CHECK(nodes[2]->process_count == 0);
+		CHECK(nodes[3]->process_count == 1);
+
+		SceneTree::get_singleton()->process(0.1);
+		CHECK(nodes[1]->process_count == 0);
+		CHECK(nodes[2]->process_count == 1);
+	}
+
+	SUBCASE("Freed while dispatching") {
+		nodes[0]->free_on_process = nodes[1];
+		nodes[1] = nullptr;
+		SceneTree::get_singleton()->process(0.1);
+		CHECK(log.size() == 3);
+		SceneTree::get_singleton()->process(0.1);
+		CHECK(log.size() == 6);
+	}
+
+	SUBCASE("Pause") {
+		Node *pausable = memnew(Node);
+		root->add_child(pausable);
+		nodes[0]->get_parent()->remove_child(nodes[0]);
+		pausable->add_child(nodes[0]);
+		nodes[1]->set_process_mode(Node::PROCESS_MODE_WHEN_PAUSED);
+		nodes[2]->set_process_mode(Node::PROCESS_MODE_ALWAYS);
+		nodes[3]->set_process_mode(Node::PROCESS_MODE_DISABLED);
+
+		SceneTree::get_singleton()->set_pause(true);
+		SceneTree::get_singleton()->process(0.1);
+		CHECK(nodes[0]->process_count == 0);
+		CHECK(nodes[1]->process_count == 1);
+		CHECK(nodes[2]->process_count == 1);
+		CHECK(nodes[3]->process_count == 0);
+
+		// The effective mode follows the process owner.
+		pausable->set_process_mode(Node::PROCESS_MODE_WHEN_PAUSED);
+		SceneTree::get_singleton()->process(0.1);
+		CHECK(nodes[0]->process_count == 1);
+
+		SceneTree::get_singleton()->set_pause(false);
+		SceneTree::get_singleton()->process(0.1);
+		CHECK(nodes[0]->process_count == 1);
+		CHECK(nodes[1]->process_count == 2);
+		CHECK(nodes[2]->process_count == 3);
+		CHECK(nodes[3]->process_count == 0);
+
+		nodes[0]->get_parent()->remove_child(nodes[0]);
+		root->add_child(nodes[0]);
+		memdelete(pausable);
+	}
+
+	for (int i = 0; i < 4; i++) {
+		if (nodes[i]) {
+			memdelete(nodes[i]);
+		}
+	}
+}
+
+TEST_CASE("[SceneTree][Stress] Processing 100k nodes") {
+	const int node_count = 100000;
+	Window *root = SceneTree::get_singleton()->get_root();
+
+	// Chains of nested levels, so inherited process modes have some depth to them.
+	Node *top = memnew(Node);
+	root->add_child(top);
+	Node *parent = top;
+	LocalVector<_TestProcessNode *> nodes;
+	nodes.resize(node_count);
+	for (int i = 0; i < node_count; i++) {
+		if (i % 100 == 0) {
+			Node *level = memnew(Node);
+			(i % 1000 == 0 ? top : parent)->add_child(level);
+			parent = level;
+		}
+		nodes[i] = memnew(_TestProcessNode);
+		nodes[i]->set_process(true);
+		nodes[i]->set_process_priority(i % 7);
+		parent->add_child(nodes[i]);
+	}
+
+	const int steps = 20;
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	for (int step = 0; step < steps; step++) {
+		SceneTree::get_singleton()->process(0.016);
+	}
+	uint64_t usec = OS::get_singleton()->get_ticks_usec() - begin;
+	print_verbose(vformat("Processing %d nodes: %d usec per step.", node_count, usec / steps));
+
+	for (int i = 0; i < node_count; i += 997) {
+		CHECK(nodes[i]->process_count == steps);
+	}
+
+	memdelete(top);
+}
+
+TEST_CASE("[SceneTree] Process thread groups") {
+	Window *root = SceneTree::get_singleton()->get_root();
+
+	// Two groups, processed in parallel, and one node on the main thread.
+	_TestThreadGroupNode *groups[2];
+	_TestThreadGroupNode *children[2];
+	for (int i = 0; i < 2; i++) {
+		groups[i] = memnew(_TestThreadGroupNode);
+		groups[i]->set_process_thread_group(Node::PROCESS_THREAD_GROUP_SUB_THREAD);
+		children[i] = memnew(_TestThreadGroupNode);
+		groups[i]->add_child(children[i]);
+		root->add_child(groups[i]);
+	}
+	_TestThreadGroupNode *main_node = memnew(_TestThreadGroupNode);
+	root->add_child(main_node);
+
+	CHECK(children[0]->get_process_thread_group_owner() == groups[0]);
+	CHECK(children[1]->get_process_thread_group_owner() == groups[1]);
+	CHECK(main_node->get_process_thread_group_owner() == nullptr);
+
+	for (int step = 0; step < 5; step++) {
+		SceneTree::get_singleton()->process(0.1);
+	}
+
+	_TestThreadGroupNode *all[5] = { groups[0], groups[1], children[0], children[1], main_node };
+	for (int i = 0; i < 5; i++) {
+		// Processed exactly once per step, and every deferred call applied by the sync point.
+		CHECK(all[i]->process_count == 5);
+		CHECK(all[i]->apply_count == 5);
+		CHECK_FALSE(all[i]->applied_from_sub_thread);
+	}
+	CHECK_FALSE(main_node->processed_on_sub_thread);
+	for (int i = 0; i < 4; i++) {
+		CHECK(all[i]->processed_on_sub_thread);
+	}
+
+	Dictionary times = SceneTree::get_singleton()->get_thread_group_process_times();
+	CHECK(times.size() == 2);
+	CHECK(times.has(groups[0]->get_path()));
+
+	// Moving a group back to the main thread releases its children too.
+	groups[1]->set_process_thread_group(Node::PROCESS_THREAD_GROUP_INHERIT);
+	CHECK(children[1]->get_process_thread_group_owner() == nullptr);
+	SceneTree::get_singleton()->process(0.1);
+	CHECK(children[1]->process_count == 6);
+	CHECK(children[1]->apply_count == 6);
+
+	memdelete(main_node);
+	for (int i = 0; i < 2; i++) {
+		memdelete(groups[i]);
+	}
+	CHECK(SceneTree::get_singleton()->get_thread_group_process_times().is_empty());
+}
+
+TEST_CASE("[SceneTree] Single process thread group") {
+	Window *root = SceneTree::get_singleton()->get_root();
+
+	_TestThreadGroupNode *group = memnew(_TestThreadGroupNode);
+	group->set_process_thread_group(Node::PROCESS_THREAD_GROUP_SUB_THREAD);
+	_TestThreadGroupNode *child = memnew(_TestThreadGroupNode);
+	group->add_child(child);
+	root->add_child(group);
+
+	for (int step = 0; step < 3; step++) {
+		SceneTree::get_singleton()->process(0.1);
+	}
+
+	// A lone group still runs off the main thread, and its calls are deferred to the sync point.
+	_TestThreadGroupNode *all[2] = { group, child };
+	for (int i = 0; i < 2; i++) {
+		CHECK(all[i]->process_count == 3);
+		CHECK(all[i]->apply_count == 3);
+		CHECK(all[i]->processed_on_sub_thread);
+		CHECK_FALSE(all[i]->applied_from_sub_thread);
+	}
+
+	// Adding children from the group goes through call_thread_safe().
+	Node *added = memnew(Node);
+	group->add_child_on_process = added;
+	SceneTree::get_singleton()->process(0.1);
+	CHECK(added->get_parent() == group);
+	CHECK(added->get_process_thread_group_owner() == group);
+
+	memdelete(group);
+}
+
+} // namespace TestSceneTree
+
+#endif // TEST_SCENE_TREE_H
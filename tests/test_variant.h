@@ -107,6 +107,64 @@ TEST_CASE("[Variant] Writer and parser Variant::FLOAT") {
 	CHECK_MESSAGE(float_parsed == 1.0e+100, "Should match the double literal.");
 }
 
+TEST_CASE("[Variant] Writer and parser packed arrays") {
+	PackedInt32Array ints;
+	PackedFloat32Array floats;
+	PackedVector3Array vectors;
+	// Large enough to be converted on several threads.
+	for (int i = 0; i < 40000; i++) {
+		ints.push_back(i * 3 - 20000);
+		floats.push_back(i * 0.25);
+		vectors.push_back(Vector3(i, -i * 0.5, 0.125));
+	}
+
+	String errs;
+	int line = 1;
+	Variant parsed;
+	VariantParser::StreamString ss;
+
+	VariantWriter::write_to_string(ints, ss.s);
+	CHECK(VariantParser::parse(&ss, parsed, errs, line) == OK);
+	CHECK(PackedInt32Array(parsed) == ints);
+
+	VariantParser::StreamString fss;
+	VariantWriter::write_to_string(floats, fss.s);
+	CHECK(VariantParser::parse(&fss, parsed, errs, line) == OK);
+	CHECK(PackedFloat32Array(parsed) == floats);
+
+	VariantParser::StreamString vss;
+	VariantWriter::write_to_string(vectors, vss.s);
+	CHECK(VariantParser::parse(&vss, parsed, errs, line) == OK);
+	CHECK(PackedVector3Array(parsed) == vectors);
+
+	VariantParser::StreamString wss;
+	wss.s = "PackedFloat64Array ( 1,\n-2.5e2 ,3 ,\n\t4.0 )";
+	line = 1;
+	CHECK(VariantParser::parse(&wss, parsed, errs, line) == OK);
+	CHECK_MESSAGE(line == 3, "Newlines inside the array should be counted.");
+	PackedFloat64Array expected;
+	expected.push_back(1);
+	expected.push_back(-250);
+	expected.push_back(3);
+	expected.push_back(4);
+	CHECK(PackedFloat64Array(parsed) == expected);
+
+	VariantParser::StreamString ess;
+	ess.s = "PackedByteArray()";
+	CHECK(VariantParser::parse(&ess, parsed, errs, line) == OK);
+	CHECK(PackedByteArray(parsed).is_empty());
+
+	VariantParser::StreamString bss;
+	bss.s = "PackedInt32Array(1, 2,)";
+	CHECK(VariantParser::parse(&bss, parsed, errs, line) == ERR_PARSE_ERROR);
+	CHECK(errs == "Expected float in constructor");
+
+	VariantParser::StreamString css;
+	css.s = "PackedInt32Array(1 2)";
+	CHECK(VariantParser::parse(&css, parsed, errs, line) == ERR_PARSE_ERROR);
+	CHECK(errs == "Expected ',' or ')' in constructor");
+}
+
 TEST_CASE("[Variant] Assignment To Bool from Int,Float,String,Vec2,Vec2i,Vec3,Vec3i and Color") {
 	Variant int_v = 0;
 	Variant bool_v = true;